@@ -9,6 +9,10 @@
 
 #include "test.h"
 #include "avx256.h"
+#include "avx256_buffer.h"
+#include "avx256_color.h"
+#include "avx256_background.h"
+#include "avx256_framepool.h"
 #include "demo.h"
 
 #ifndef TEST
@@ -16,14 +20,14 @@
 // Create a mask over the pixels that show a difference from the previous frame using scalar operations, return fps performance metric
 int absDiffScalar(cv::Mat& previousFrame, cv::Mat& currentFrame, cv::Mat& mask)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	uint64_t size = static_cast<uint64_t>(currentFrame.rows) * currentFrame.cols * currentFrame.channels();
 
 	for (uint64_t i = 0; i < size; ++i)
 		mask.data[i] = abs(currentFrame.data[i] - previousFrame.data[i]);
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
@@ -31,7 +35,7 @@ int absDiffScalar(cv::Mat& previousFrame, cv::Mat& currentFrame, cv::Mat& mask)
 // Create a mask over the pixels that show a difference from the previous frame using AVX256, return fps performance metric
 int absDiffAVX256(cv::Mat& previousFrame, cv::Mat& currentFrame, cv::Mat& mask)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	AVX256<uint8_t> avxPreviousFrame{ previousFrame.data }, avxCurrentFrame{ currentFrame.data }, avxMask{ mask.data };
 
@@ -45,7 +49,7 @@ int absDiffAVX256(cv::Mat& previousFrame, cv::Mat& currentFrame, cv::Mat& mask)
 	for (uint64_t i = size - residualCount; i < size; ++i)
 		mask.data[i] = abs(currentFrame.data[i] - previousFrame.data[i]);
 		
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
@@ -53,52 +57,60 @@ int absDiffAVX256(cv::Mat& previousFrame, cv::Mat& currentFrame, cv::Mat& mask)
 // Create a mask over the pixels that show a difference from the previous frame using cv::absdiff(), return fps performance metric
 int absDiffOpenCVSIMD(cv::Mat& previousFrame, cv::Mat& currentFrame, cv::Mat& mask)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	cv::absdiff(currentFrame, previousFrame, mask);
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
 
-// Create a mask over the pixels that show a difference from the previous frame using scalar, AVX256, and cv::absdiff() (with SIMD acceleration)
+// Create a mask over the pixels that show a difference from the previous frame using scalar, AVX256, and cv::absdiff() (with SIMD acceleration), and show the foreground of a running-average background model
 void absDiffDemo(const std::string& videoPath)
 {
-	cv::Mat currentFrameBGR, currentFrameGray, previousFrameGray, result, currentFrameBGRSmall;
+	cv::Mat currentFrameBGR, result, currentFrameBGRSmall;
 	cv::VideoCapture video{ videoPath }; 
 	int width = video.get(cv::CAP_PROP_FRAME_WIDTH), height = video.get(cv::CAP_PROP_FRAME_HEIGHT);
+	AVX256Utils::FrameBufferPool pool{ static_cast<uint64_t>(width) * height, 2 };
+	AVX256Utils::DoubleBuffer grayFrames{ pool }; // Swapped rather than copied, the next frame's grey values overwrite the old previous frame
 	cv::Mat maskScalar(height, width, CV_8UC1), maskAVX256(height, width, CV_8UC1), maskOpenCVSIMD(height, width, CV_8UC1), maskBGR(height, width, CV_8UC3);
+	cv::Mat foreground(height, width, CV_8UC1), foregroundBGRSmall;
+	AVX256Utils::BackgroundModel background{ static_cast<uint64_t>(width) * height, 4, 25, 3 }; // Compares each frame against the running average of the previous frames, rather than only the last one
 
 	int xmax = video.get(cv::CAP_PROP_FRAME_COUNT) - 1, ymax = 10000, avgRange = 15;
 	cv::Mat plot = createFPSPlot(cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT) / 2.5), std::pair<int, int>{xmax, ymax}, avgRange);
 
 	std::vector<std::vector<int>> fpss(3, std::vector<int>(xmax));	
-	video.read(previousFrameGray), cv::cvtColor(previousFrameGray, previousFrameGray, cv::COLOR_BGR2GRAY);
+	video.read(currentFrameBGR), AVX256Utils::BGRToGray(currentFrameBGR.data, grayFrames.Previous(), static_cast<uint64_t>(width) * height);
 	int frameCount = 0;
 
 	while (true)
 	{
 		while (video.read(currentFrameBGR))
 		{
-			cv::cvtColor(currentFrameBGR, currentFrameGray, cv::COLOR_BGR2GRAY);
+			cv::Mat currentFrameGray(height, width, CV_8UC1, grayFrames.Current()), previousFrameGray(height, width, CV_8UC1, grayFrames.Previous());
+			AVX256Utils::BGRToGray(currentFrameBGR.data, currentFrameGray.data, static_cast<uint64_t>(width) * height);
 
 			fpss[0][frameCount] = absDiffScalar(previousFrameGray, currentFrameGray, maskScalar);
 			fpss[1][frameCount] = absDiffAVX256(previousFrameGray, currentFrameGray, maskAVX256);
 			fpss[2][frameCount] = absDiffOpenCVSIMD(previousFrameGray, currentFrameGray, maskOpenCVSIMD);
 
+			background.Update(currentFrameGray.data, foreground.data);
+
 			++frameCount;
 
-			previousFrameGray = currentFrameGray.clone();
+			grayFrames.Swap();
 
-			if (cv::sum(maskScalar != maskAVX256) != cv::Scalar(0) || cv::sum(maskScalar != maskOpenCVSIMD) != cv::Scalar(0)) return;			
+			if (!AVX256Utils::BuffersEqual(maskScalar.data, maskAVX256.data, static_cast<uint64_t>(width) * height) || !AVX256Utils::BuffersEqual(maskScalar.data, maskOpenCVSIMD.data, static_cast<uint64_t>(width) * height)) return;			
 			cv::cvtColor(maskScalar, maskBGR, cv::COLOR_GRAY2BGR);
 			plotFPS(plot, std::pair<int, int>{xmax, ymax}, frameCount, avgRange, fpss);
 			writeFPS(maskBGR, frameCount, fpss);
 			
 			cv::vconcat(std::array<cv::Mat, 2>{maskBGR, plot}, result);			
 			cv::resize(currentFrameBGR, currentFrameBGRSmall, cv::Size{ currentFrameBGR.cols / 3, currentFrameBGR.rows / 3 });			
-			cv::vconcat(std::array<cv::Mat, 2>{currentFrameBGRSmall, cv::Mat::zeros(cv::Size{ currentFrameBGRSmall.cols, result.rows - currentFrameBGRSmall.rows }, CV_8UC3)}, currentFrameBGRSmall);			
+			cv::resize(foreground, foregroundBGRSmall, currentFrameBGRSmall.size()), cv::cvtColor(foregroundBGRSmall, foregroundBGRSmall, cv::COLOR_GRAY2BGR);
+			cv::vconcat(std::array<cv::Mat, 3>{currentFrameBGRSmall, foregroundBGRSmall, cv::Mat::zeros(cv::Size{ currentFrameBGRSmall.cols, result.rows - 2 * currentFrameBGRSmall.rows }, CV_8UC3)}, currentFrameBGRSmall);			
 			cv::hconcat(std::array<cv::Mat, 2>{result, currentFrameBGRSmall}, result);
 
 			cv::imshow("Output", result);
@@ -108,7 +120,8 @@ void absDiffDemo(const std::string& videoPath)
 
 		frameCount = 0, video.set(cv::CAP_PROP_POS_FRAMES, 0);
 		plot = createFPSPlot(cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT) / 2.5), std::pair<int, int>{xmax, ymax}, avgRange);
-		video.read(previousFrameGray), cv::cvtColor(previousFrameGray, previousFrameGray, cv::COLOR_BGR2GRAY);
+		video.read(currentFrameBGR), AVX256Utils::BGRToGray(currentFrameBGR.data, grayFrames.Previous(), static_cast<uint64_t>(width) * height);
+		background.Reset();
 	}
 }
 
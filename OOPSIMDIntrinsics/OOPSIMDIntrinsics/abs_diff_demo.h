@@ -1,7 +1,7 @@
 #ifndef ABS_DIFF_DEMO_H
 #define ABS_DIFF_DEMO_H
 
-// Create a mask over the pixels that show a difference from the previous frame using scalar, AVX256, and cv::absdiff() (with SIMD acceleration)
+// Create a mask over the pixels that show a difference from the previous frame using scalar, AVX256, and cv::absdiff() (with SIMD acceleration), and show the foreground of a running-average background model
 void absDiffDemo(const std::string& videoPath);
 
 #endif 
@@ -3,175 +3,217 @@
 
 #include <type_traits>
 #include <cstdint>
-#include <intrin.h>
+#include <limits>
 #include <array>
+#include <ostream>
+#include <immintrin.h>
+
+#include "avx256_cpu.h"
+#include "avx256_simd.h"
+
+// A vector of 'Bits' bits of T (e.g. SIMD<float, 128> holds 4 floats), which points to Bits / 8 bytes of T data. Each operation is composed from the instructions of the width's backend
+// (see avx256_simd.h), so it has the same semantics at every width: SSE4.2 at 128 bits (SSE128<T>), AVX2 at 256 bits (AVX256<T>) and AVX-512 at 512 bits (AVX512<T>)
+template <typename T, int Bits = 256>
+class SIMD;
 
 namespace AVX256Utils
 {
-	extern "C" bool HasAVX2Support(void);
+	namespace SIMDDetail
+	{
+		// The operations of a 'Vector' (a SIMD<T, Bits>) that only exist at one width. At 256 bits these are the permutes, which AVX2 defines in terms of its two 128-bit lanes
+		template <typename Vector, typename T, int Bits>
+		class Permutes {};
+
+		template <typename Vector, typename T>
+		class Permutes<Vector, T, 256>
+		{
+			using Backend = SIMDDetail::Backend<256, T>;
+
+		public:
+			// Re-orders 64-bit elements using the specified order. Each template argument specifies the index of the element that will be copied to that element (one element can be copied to many elements)
+			template<int dst0, int dst1, int dst2, int dst3>
+			Vector& Permute64()
+			{
+				static_assert(dst0 >= 0 && dst0 <= 3 && dst1 >= 0 && dst1 <= 3 && dst2 >= 0 && dst2 <= 3 && dst3 >= 0 && dst3 <= 3, "AVX256: Indices must be between 0 and 3 inclusive");
+				constexpr uint8_t ORDER = dst0 | (dst1 << 2) | (dst2 << 4) | (dst3 << 6);
+				return Update(_mm256_permute4x64_epi64(Load(), ORDER));
+			}
+
+			// Re-orders 32-bit elements using the specified order. Each element in order specifies the index of the element that will be copied to that element (one element can be copied to many elements). Order indices should be between 0 and 7 inclusive
+			template <typename U>
+			Vector& Permute32(const U* order)
+			{
+				static_assert(std::is_same_v<U, uint32_t> || std::is_same_v<U, int32_t>, "AVX256: order must point to 32-bit integers");
+				return Update(_mm256_permutevar8x32_epi32(Load(), Backend::Load(order)));
+			}
+
+			// Re-orders 32-bit elements using the specified order. Each element in order specifies the index of the element that will be copied to that element (one element can be copied to many elements). Order indices should be between 0 and 7 inclusive
+			template <typename U>
+			Vector& Permute32(const std::array<U, 32 / sizeof(U)>& order)
+			{
+				static_assert(std::is_same_v<U, uint32_t> || std::is_same_v<U, int32_t>, "AVX256: order must be an array of 32-bit integers");
+				return Permute32(order.data());
+			}
+
+			// Re-orders 32-bit elements using the specified order. Each element in order specifies the index of the element that will be copied to that element (one element can be copied to many elements). Order indices should be between 0 and 7 inclusive
+			template <typename U>
+			Vector& Permute32(const SIMD<U, 256>& order)
+			{
+				static_assert(std::is_same_v<U, uint32_t> || std::is_same_v<U, int32_t>, "AVX256: order must be an AVX256<uint32_t> or AVX256<int32_t>");
+				return Permute32(order.Data);
+			}
+
+			// Re-orders 8-bit elements within 128-bit lanes using the specified order. order[0] to order[15] permute elements dst[0] to dst[15], while order[16] to order[31] permute elements dst[16] to dst[31]. If the MSB of an order element is set, the corresponding byte in dst is cleared. One element can be copied to many elements. Order indices should be between 0 and 15 inclusive.
+			template <typename U>
+			Vector& Permute8(const U* order)
+			{
+				static_assert(std::is_same_v<U, uint8_t> || std::is_same_v<U, int8_t>, "AVX256: order must point to 8-bit integers");
+				return Update(_mm256_shuffle_epi8(Load(), Backend::Load(order)));
+			}
+
+			// Re-orders 8-bit elements within 128-bit lanes using the specified order. order[0] to order[15] permute elements dst[0] to dst[15], while order[16] to order[31] permute elements dst[16] to dst[31]. If the MSB of an order element is set, the corresponding byte in dst is cleared. One element can be copied to many elements. Order indices should be between 0 and 15 inclusive.
+			template <typename U>
+			Vector& Permute8(const std::array<U, 32 / sizeof(U)>& order)
+			{
+				static_assert(std::is_same_v<U, uint8_t> || std::is_same_v<U, int8_t>, "AVX256: order must be an array of 8-bit integers");
+				return Permute8(order.data());
+			}
+
+			// Re-orders 8-bit elements within 128-bit lanes using the specified order. order[0] to order[15] permute elements dst[0] to dst[15], while order[16] to order[31] permute elements dst[16] to dst[31]. If the MSB of an order element is set, the corresponding byte in dst is cleared. One element can be copied to many elements. Order indices should be between 0 and 15 inclusive.
+			template <typename U>
+			Vector& Permute8(const SIMD<U, 256>& order)
+			{
+				static_assert(std::is_same_v<U, uint8_t> || std::is_same_v<U, int8_t>, "AVX256: order must be an AVX256<uint8_t> or AVX256<int8_t>");
+				return Permute8(order.Data);
+			}
+
+		private:
+			__m256i Load() { return Backend::Load(static_cast<Vector*>(this)->Data); }
+			Vector& Update(__m256i value) { Backend::Store(static_cast<Vector*>(this)->Data, value); return static_cast<Vector&>(*this); }
+		};
+	};
 };
 
-template <typename T>
-class AVX256
+template <typename T, int Bits>
+class SIMD : public AVX256Utils::SIMDDetail::Permutes<SIMD<T, Bits>, T, Bits>
 {
-public:	
+	static_assert(Bits == 128 || Bits == 256 || Bits == 512, "SIMD: Bits must be 128, 256 or 512");
+	static_assert(Bits != 512 || AVX256_HAS_AVX512, "SIMD: SIMD<T, 512> requires compiling for AVX-512F, BW and DQ (e.g. -mavx512f -mavx512bw -mavx512dq, or the AVX256_AVX512 CMake option)");
+
+	using Backend = AVX256Utils::SIMDDetail::Backend<Bits, T>;
+	using Register = typename Backend::Register;
+
+public:
 	T* Data;
 
-	// Creates an AVX256 that points to a newly allocated 32-bytes
-	AVX256() : Data{ new T[32 / sizeof(T)] }, OwnsData{ true } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "AVX256: AVX256 is only available for non-void primitive types!"); }
+	// The number of elements in the vector
+	static constexpr int Count = Bits / 8 / sizeof(T);
 
-	// Creates an AVX256 that points to the specified data
-	AVX256(T* const data) : Data{ data }, OwnsData{ false } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "AVX256: AVX256 is only available for non-void primitive types!"); }
+	// Creates a SIMD that points to newly allocated Bits / 8 bytes
+	SIMD() : Data{ new T[Count] }, OwnsData{ true } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "SIMD: SIMD is only available for non-void primitive types!"); }
 
-	// Creates an AVX256 that points to a newly created copy of the specified array. 
-	AVX256(const std::array<T, 32 / sizeof(T)>& data) : Data{ new T[32 / sizeof(T)] }, OwnsData{ true } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "AVX256: AVX256 is only available for non-void primitive types!"); this->Set(data); }
+	// Creates a SIMD that points to the specified data
+	SIMD(T* const data) : Data{ data }, OwnsData{ false } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "SIMD: SIMD is only available for non-void primitive types!"); }
 
-	// Creates an AVX256 that points to a newly created copy of the specified AVX256's data
-	AVX256(const AVX256& avx) : Data{ new T[32 / sizeof(T)] }, OwnsData{ true } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "AVX256: AVX256 is only available for non-void primitive types!"); this->Set(avx.Data); }
+	// Creates a SIMD that points to a newly created copy of the specified array
+	SIMD(const std::array<T, Count>& data) : Data{ new T[Count] }, OwnsData{ true } { static_assert(std::is_fundamental_v<T> && !std::is_void_v<T>, "SIMD: SIMD is only available for non-void primitive types!"); Set(data); }
 
-	T& operator[] (int index) const { return Data[index]; }	
+	// Creates a SIMD that points to a newly created copy of the specified SIMD's data
+	SIMD(const SIMD& simd) : Data{ new T[Count] }, OwnsData{ true } { Set(simd.Data); }
 
-	// Increments 'Data' to point to the next 32 bytes (or 256 bits). Should only be used if adjacent memory is safe to access.
-	void Next() { Data += (256 / 8) / sizeof(T); } 
-	
-	// Decrements 'Data' to point to the previous 32 bytes (or 256 bits). Should only be used if adjacent memory is safe to access.
-	void Previous() { Data -= (256 / 8) / sizeof(T); } 
+	~SIMD() { if (OwnsData) delete[] Data; }
 
-	~AVX256() { if (OwnsData) delete[] Data; }
+	T& operator[] (int index) const { return Data[index]; }
+
+	// Increments 'Data' to point to the next vector. Should only be used if adjacent memory is safe to access.
+	void Next() { Data += Count; }
+
+	// Decrements 'Data' to point to the previous vector. Should only be used if adjacent memory is safe to access.
+	void Previous() { Data -= Count; }
 
 
 	// Addition ////////////////////
 
-	AVX256& Add(const T* operand)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_add_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_add_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_add_epi64(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_add_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_add_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_add_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
-	}
+	SIMD& Add(const T* operand) { return Update(Backend::Add(Load(), Backend::Load(operand))); }
 
-	AVX256& Add(const std::array<T, 32 / sizeof(T)>& operand) { return Add(operand.data()); }
+	SIMD& Add(const std::array<T, Count>& operand) { return Add(operand.data()); }
 
-	AVX256& Add(const AVX256& operand) { return Add(operand.Data);}
+	SIMD& Add(const SIMD& operand) { return Add(operand.Data); }
 
-	AVX256& AddSaturate(const T* operand)
+	SIMD& AddSaturate(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_adds_epu16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_adds_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_adds_epu8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_adds_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		else if constexpr (true) static_assert(false, "AVX256: AddSaturate() is only available for 16 or 8 bit addition");
-		return *this;
+		static_assert(sizeof(T) <= 2 && std::is_integral_v<T>, "SIMD: AddSaturate() is only available for 16 or 8 bit addition");
+		return Update(Backend::AddSaturate(Load(), Backend::Load(operand)));
 	}
 
-	AVX256& AddSaturate(const std::array<T, 32 / sizeof(T)>& operand) { return AddSaturate(operand.data()); }
+	SIMD& AddSaturate(const std::array<T, Count>& operand) { return AddSaturate(operand.data()); }
 
-	AVX256& AddSaturate(const AVX256& operand) { return AddSaturate(operand.Data);}
+	SIMD& AddSaturate(const SIMD& operand) { return AddSaturate(operand.Data); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	AVX256& operator+=(const T* operand) 
-	{ 
-		if constexpr (sizeof(T) > 2) return Add(operand);
-		else if constexpr (std::is_same_v<T, uint16_t>) return AddSaturate(operand);
-		else if constexpr (std::is_same_v<T, int16_t>) return AddSaturate(static_cast<const T*>(operand));
-		else if constexpr (sizeof(T) <= 2) return AddSaturate(operand);
+	SIMD& operator+=(const T* operand)
+	{
+		if constexpr (sizeof(T) <= 2 && std::is_integral_v<T>) return AddSaturate(operand);
+		else return Add(operand);
 	}
 
-	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise. 
-	AVX256& operator+=(const std::array<T, 32 / sizeof(T)>& operand) { return operator+=(operand.data()); }
+	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
+	SIMD& operator+=(const std::array<T, Count>& operand) { return operator+=(operand.data()); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	AVX256& operator+=(const AVX256& operand) { return operator+=(operand.Data); }
+	SIMD& operator+=(const SIMD& operand) { return operator+=(operand.Data); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	std::array<T, 32 / sizeof(T)> operator+(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
-		
-		this->Set(dataOld);
-		*this += operand;
-
-		Data = dataOld;
-		return result; 
-	}
+	std::array<T, Count> operator+(const T* operand) const { return Apply([&](SIMD& result) { result += operand; }); }
 
-	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise. 
-	std::array<T, 32 / sizeof(T)> operator+(const std::array<T, 32 / sizeof(T)>& operand) { return *this + operand.data(); }
+	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
+	std::array<T, Count> operator+(const std::array<T, Count>& operand) const { return *this + operand.data(); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	std::array<T, 32 / sizeof(T)> operator+(const AVX256& operand) { return *this + operand.Data; }
+	std::array<T, Count> operator+(const SIMD& operand) const { return *this + operand.Data; }
 
 
 	// Subtraction ///////////////////
 
-	AVX256& Sub(const T* operand)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_sub_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_sub_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_sub_epi64(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_sub_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_sub_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_sub_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
-	}
+	SIMD& Sub(const T* operand) { return Update(Backend::Sub(Load(), Backend::Load(operand))); }
 
-	AVX256& Sub(const std::array<T, 32 / sizeof(T)>& operand) { return Sub(operand.data()); }
+	SIMD& Sub(const std::array<T, Count>& operand) { return Sub(operand.data()); }
 
-	AVX256& Sub(const AVX256& operand) { return Sub(operand.Data); }
+	SIMD& Sub(const SIMD& operand) { return Sub(operand.Data); }
 
-	AVX256& SubSaturate(const T* operand)
+	SIMD& SubSaturate(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_subs_epu16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_subs_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_subs_epu8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_subs_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		else if constexpr (true) static_assert(false, "AVX256: SubSaturate() is only available for 16 or 8 bit subtraction");
-		return *this;
+		static_assert(sizeof(T) <= 2 && std::is_integral_v<T>, "SIMD: SubSaturate() is only available for 16 or 8 bit subtraction");
+		return Update(Backend::SubSaturate(Load(), Backend::Load(operand)));
 	}
 
-	AVX256& SubSaturate(const std::array<T, 32 / sizeof(T)>& operand) { return SubSaturate(operand.data()); }
+	SIMD& SubSaturate(const std::array<T, Count>& operand) { return SubSaturate(operand.data()); }
 
-	AVX256& SubSaturate(const AVX256& operand) { return SubSaturate(operand.Data); }
+	SIMD& SubSaturate(const SIMD& operand) { return SubSaturate(operand.Data); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	AVX256& operator-=(const T* operand)
+	SIMD& operator-=(const T* operand)
 	{
-		if constexpr (sizeof(T) > 2) return Sub(operand);
-		else if constexpr (sizeof(T) <= 2) return SubSaturate(operand);
+		if constexpr (sizeof(T) <= 2 && std::is_integral_v<T>) return SubSaturate(operand);
+		else return Sub(operand);
 	}
 
-	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise. 
-	AVX256& operator-=(const std::array<T, 32 / sizeof(T)>& operand) { return operator-=(operand.data()); }
-
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	AVX256& operator-=(const AVX256& operand) { return operator-=(operand.Data); }
+	SIMD& operator-=(const std::array<T, Count>& operand) { return operator-=(operand.data()); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	std::array<T, 32 / sizeof(T)> operator-(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
-
-		this->Set(dataOld);
-		*this -= operand;
+	SIMD& operator-=(const SIMD& operand) { return operator-=(operand.Data); }
 
-		Data = dataOld;
-		return result;
-	}
+	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
+	std::array<T, Count> operator-(const T* operand) const { return Apply([&](SIMD& result) { result -= operand; }); }
 
-	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise. 
-	std::array<T, 32 / sizeof(T)> operator-(const std::array<T, 32 / sizeof(T)>& operand) { return *this - operand.data(); }
+	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
+	std::array<T, Count> operator-(const std::array<T, Count>& operand) const { return *this - operand.data(); }
 
 	// Performs saturation arithmetic on 16 and 8-bit integers, wraparound arithmetic otherwise
-	std::array<T, 32 / sizeof(T)> operator-(const AVX256& operand) { return *this - operand.Data; }
+	std::array<T, Count> operator-(const SIMD& operand) const { return *this - operand.Data; }
+
 
-	
 	// Multiplication //////////////////
 
 	/*
@@ -181,1116 +223,526 @@ public:
 	* 16-bit: 16-bits are multiplied, the low 16-bits of the result is saved
 	* 8-bit: 8-bits are multiplied, the low 8-bits of the result is saturated and saved
 	*/
-	AVX256& Mul(const T* operand)
+	SIMD& Mul(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_mul_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_mul_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_mul_epu32(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, int64_t>) _mm256_storeu_epi64(Data, _mm256_mul_epi32(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_mullo_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_mullo_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_mullo_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_mullo_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, uint8_t>)
-		{
-			_mm256_storeu_epi8(
-				Data,
-				_mm256_packus_epi16(
-					_mm256_mullo_epi16(
-						_mm256_unpacklo_epi8(_mm256_loadu_epi8(Data), _mm256_setzero_si256()),
-						_mm256_unpacklo_epi8(_mm256_loadu_epi8(operand), _mm256_setzero_si256())
-					),
-					_mm256_mullo_epi16(
-						_mm256_unpackhi_epi8(_mm256_loadu_epi8(Data), _mm256_setzero_si256()),
-						_mm256_unpackhi_epi8(_mm256_loadu_epi8(operand), _mm256_setzero_si256())
-					)
-				)
-			);
-		}
-		else if constexpr (std::is_same_v<T, int8_t>)
+		Register a = Load(), b = Backend::Load(operand);
+
+		if constexpr (sizeof(T) == 1) // Multiplied as 16-bit integers (sign or zero-extended), then packed with saturation
 		{
-			_mm256_storeu_epi8(
-				Data,
-				_mm256_packs_epi16(
-					_mm256_mullo_epi16(									// Sign extension
-						_mm256_unpacklo_epi8(_mm256_loadu_epi8(Data), _mm256_cmpgt_epi8(_mm256_setzero_si256(), _mm256_loadu_epi8(Data))),
-						_mm256_unpacklo_epi8(_mm256_loadu_epi8(operand), _mm256_cmpgt_epi8(_mm256_setzero_si256(), _mm256_loadu_epi8(operand)))
-					),
-					_mm256_mullo_epi16(									// Sign extension
-						_mm256_unpackhi_epi8(_mm256_loadu_epi8(Data), _mm256_cmpgt_epi8(_mm256_setzero_si256(), _mm256_loadu_epi8(Data))),
-						_mm256_unpackhi_epi8(_mm256_loadu_epi8(operand), _mm256_cmpgt_epi8(_mm256_setzero_si256(), _mm256_loadu_epi8(operand)))
-					)
-				)
-			);
+			using Wide = AVX256Utils::SIMDDetail::Backend<Bits, std::conditional_t<std::is_signed_v<T>, int16_t, uint16_t>>;
+			Register aHigh = std::is_signed_v<T> ? Backend::Greater(Backend::Zero(), a) : Backend::Zero();
+			Register bHigh = std::is_signed_v<T> ? Backend::Greater(Backend::Zero(), b) : Backend::Zero();
+			Register low = Wide::Mul(Backend::UnpackLow8(a, aHigh), Backend::UnpackLow8(b, bHigh));
+			Register high = Wide::Mul(Backend::UnpackHigh8(a, aHigh), Backend::UnpackHigh8(b, bHigh));
+			return Update(std::is_signed_v<T> ? Backend::PackSigned16(low, high) : Backend::PackUnsigned16(low, high));
 		}
-		return *this;
+		else return Update(Backend::Mul(a, b));
 	}
 
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used. 
-	AVX256& Mul(const std::array<T, 32 / sizeof(T)>& operand) { return Mul(operand.data()); }
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	SIMD& Mul(const std::array<T, Count>& operand) { return Mul(operand.data()); }
 
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used 
-	AVX256& Mul(const AVX256& operand) { return Mul(operand.Data); }
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	SIMD& Mul(const SIMD& operand) { return Mul(operand.Data); }
 
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used.
-	AVX256& operator*=(const T* operand) { return Mul(operand); }
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	SIMD& operator*=(const T* operand) { return Mul(operand); }
 
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used. 
-	AVX256& operator*=(const std::array<T, 32 / sizeof(T)>& operand) { return Mul(operand.data()); }
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	SIMD& operator*=(const std::array<T, Count>& operand) { return Mul(operand.data()); }
 
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used.
-	AVX256& operator*=(const AVX256& operand) { return Mul(operand.Data); }
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	SIMD& operator*=(const SIMD& operand) { return Mul(operand.Data); }
 
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used.
-	std::array<T, 32 / sizeof(T)> operator*(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	std::array<T, Count> operator*(const T* operand) const { return Apply([&](SIMD& result) { result.Mul(operand); }); }
 
-		this->Set(dataOld);
-		*this *= operand;
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	std::array<T, Count> operator*(const std::array<T, Count>& operand) const { return *this * operand.data(); }
 
-		Data = dataOld;
-		return result;
-	}
-
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used. 
-	std::array<T, 32 / sizeof(T)> operator*(const std::array<T, 32 / sizeof(T)>& operand) { return *this * operand.data(); }
-
-	// Call the Mul() method. For details on its operation, see the Mul() method for the AVX256 type being used.
-	std::array<T, 32 / sizeof(T)> operator*(const AVX256& operand) { return *this * operand.Data; }
+	// Call the Mul() method. For details on its operation, see the Mul() method for the SIMD type being used
+	std::array<T, Count> operator*(const SIMD& operand) const { return *this * operand.Data; }
 
 
 	// Division ///////////////////
 
 	// Available for floating point types only
-	AVX256& Div(const T* operand)
+	SIMD& Div(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_div_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_div_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (true) static_assert(false, "AVX256: Division is only available for double and float types");
-		return *this;
+		static_assert(std::is_floating_point_v<T>, "SIMD: Division is only available for double and float types");
+		return Update(Backend::Div(Load(), Backend::Load(operand)));
 	}
 
-	// Available for floating point types only. 
-	AVX256& Div(const std::array<T, 32 / sizeof(T)>& operand) { return Div(operand.data()); }
+	// Available for floating point types only
+	SIMD& Div(const std::array<T, Count>& operand) { return Div(operand.data()); }
 
 	// Available for floating point types only
-	AVX256& Div(const AVX256& operand) { return Div(operand.Data); }
-	
+	SIMD& Div(const SIMD& operand) { return Div(operand.Data); }
+
 	// Available for floating point types only
-	AVX256& operator/=(const T* operand) { return Div(operand); }
+	SIMD& operator/=(const T* operand) { return Div(operand); }
 
-	// Available for floating point types only. 
-	AVX256& operator/=(const std::array<T, 32 / sizeof(T)>& operand) { return Div(operand.data()); }
+	// Available for floating point types only
+	SIMD& operator/=(const std::array<T, Count>& operand) { return Div(operand.data()); }
 
 	// Available for floating point types only
-	AVX256& operator/=(const AVX256& operand) { return Div(operand.Data); }
+	SIMD& operator/=(const SIMD& operand) { return Div(operand.Data); }
 
-	// Available for floating point types only.
-	std::array<T, 32 / sizeof(T)> operator/(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	// Available for floating point types only
+	std::array<T, Count> operator/(const T* operand) const { return Apply([&](SIMD& result) { result.Div(operand); }); }
 
-		this->Set(dataOld);
-		*this /= operand;
+	// Available for floating point types only
+	std::array<T, Count> operator/(const std::array<T, Count>& operand) const { return *this / operand.data(); }
 
-		Data = dataOld;
-		return result;
-	}
+	// Available for floating point types only
+	std::array<T, Count> operator/(const SIMD& operand) const { return *this / operand.Data; }
 
-	// Available for floating point types only. 
-	std::array<T, 32 / sizeof(T)> operator/(const std::array<T, 32 / sizeof(T)>& operand) { return *this / operand.data(); }
 
-	// Available for floating point types only.
-	std::array<T, 32 / sizeof(T)> operator/(const AVX256& operand) { return *this / operand.Data; }
+	// Set ///////////////////
 
+	// Broadcast the specified value into all elements of the SIMD
+	SIMD& Set(const T value) { return Update(Backend::Set1(value)); }
 
-	// Set // //////////////////
+	// Copy the specified data into the data SIMD points to
+	SIMD& Set(const T* values) { return Update(Backend::Load(values)); }
 
-	// Broadcast the specified value into all elements of the AVX256 
-	AVX256& Set(const T value)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_set1_pd(value));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_set1_ps(value));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_set1_epi64x(value));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_set1_epi32(value));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_set1_epi16(value));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_set1_epi8(value));
-		return *this;
-	}
+	// Copy the specified data into the data SIMD points to
+	SIMD& Set(const std::array<T, Count>& values) { return Set(values.data()); }
 
-	// Copy the specified data into the data AVX256 points to
-	AVX256& Set(const T* values)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_loadu_pd(values));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_loadu_ps(values));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_loadu_epi64(values));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_loadu_epi32(values));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_loadu_epi16(values));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_loadu_epi8(values));
-		return *this;
-	}
+	// Copy the specified data into the data SIMD points to
+	SIMD& Set(const SIMD& values) { return Set(values.Data); }
 
-	// Copy the specified data into the data AVX256 points to. 
-	AVX256& Set(const std::array<T, 32 / sizeof(T)>& values) { return Set(values.data()); }
+	// Copy the first 'count' elements of the specified data into the data SIMD points to, and set the rest to 0. Only 'count' elements are read, e.g. from the end of a buffer
+	SIMD& Set(const T* values, uint64_t count) { return Update(Backend::LoadPartial(values, count * sizeof(T))); }
 
-	// Copy the specified data into the data AVX256 points to
-	AVX256& Set(const AVX256& values) { return Set(values.Data); }
+	// Copy the first 'count' elements of the data SIMD points to into 'destination', without writing past them
+	void Store(T* destination, uint64_t count) const { Backend::StorePartial(destination, Load(), count * sizeof(T)); }
 
-	// Broadcast the specified value into all elements of the AVX256 
-	AVX256& operator=(const T value) { return Set(value); }
+	// Broadcast the specified value into all elements of the SIMD
+	SIMD& operator=(const T value) { return Set(value); }
 
-	// Copy the specified data into the data AVX256 points to
-	AVX256& operator=(const T* values) { return Set(values); }
+	// Copy the specified data into the data SIMD points to
+	SIMD& operator=(const T* values) { return Set(values); }
 
-	// Copy the specified data into the data AVX256 points to. 
-	AVX256& operator=(const std::array<T, 32 / sizeof(T)>& values) { return Set(values.data()); }
+	// Copy the specified data into the data SIMD points to
+	SIMD& operator=(const std::array<T, Count>& values) { return Set(values.data()); }
 
-	// Copy the specified data into the data AVX256 points to
-	AVX256& operator=(const AVX256& values) { return Set(values.Data); }
+	// Copy the specified data into the data SIMD points to
+	SIMD& operator=(const SIMD& values) { return Set(values.Data); }
 
 
 	// Clear //////////////////
 
-	AVX256& Clear() 
-	{ 
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_setzero_pd());
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_setzero_ps());
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_setzero_si256());
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_setzero_si256());
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_setzero_si256());
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_setzero_si256());
-		return *this;
-	}
+	SIMD& Clear() { return Update(Backend::Zero()); }
 
 
 	// Negate ///////////
 
-	AVX256& Negate()
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_andnot_pd(_mm256_loadu_pd(Data), _mm256_castsi256_pd(_mm256_set1_epi64x(-1))));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_andnot_ps(_mm256_loadu_ps(Data), _mm256_castsi256_ps(_mm256_set1_epi32(-1))));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_andnot_si256(_mm256_loadu_epi64(Data), _mm256_set1_epi64x(-1)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_andnot_si256(_mm256_loadu_epi32(Data), _mm256_set1_epi32(-1)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_andnot_si256(_mm256_loadu_epi16(Data), _mm256_set1_epi16(-1)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_andnot_si256(_mm256_loadu_epi8(Data), _mm256_set1_epi8(-1)));
-		return *this;
-	}
+	SIMD& Negate() { return Update(Backend::Xor(Load(), Backend::Ones())); }
 
-	std::array<T, 32 / sizeof(T)> operator~() 
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	std::array<T, Count> operator~() const { return Apply([](SIMD& result) { result.Negate(); }); }
 
-		this->Set(dataOld);
-		*this->Negate();
 
-		Data = dataOld;
-		return result;
-	}
+	// And, Or, Xor ///////////
 
+	SIMD& And(const T* operand) { return Update(Backend::And(Load(), Backend::Load(operand))); }
 
-	// And ///////////
+	SIMD& And(const std::array<T, Count>& operand) { return And(operand.data()); }
 
-	AVX256& And(const T* operand)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_and_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_and_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_and_si256(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_and_si256(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_and_si256(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_and_si256(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
-	}
+	SIMD& And(const SIMD& operand) { return And(operand.Data); }
 
-	AVX256& And(const std::array<T, 32 / sizeof(T)>& operand) { return And(operand.data()); }
+	SIMD& operator&=(const T* operand) { return And(operand); }
 
-	AVX256& And(const AVX256& operand) { return And(operand.Data); }
+	SIMD& operator&=(const std::array<T, Count>& operand) { return And(operand.data()); }
 
-	AVX256& operator&=(const T* operand) { return And(operand); }
+	SIMD& operator&=(const SIMD& operand) { return And(operand.Data); }
 
-	AVX256& operator&=(const std::array<T, 32 / sizeof(T)>& operand) { return And(operand.data()); }
+	std::array<T, Count> operator&(const T* operand) const { return Apply([&](SIMD& result) { result.And(operand); }); }
 
-	AVX256& operator&=(const AVX256& operand) { return And(operand.Data); }
+	std::array<T, Count> operator&(const std::array<T, Count>& operand) const { return *this & operand.data(); }
 
-	std::array<T, 32 / sizeof(T)> operator&(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	std::array<T, Count> operator&(const SIMD& operand) const { return *this & operand.Data; }
 
-		this->Set(dataOld);
-		*this &= operand;
+	SIMD& Or(const T* operand) { return Update(Backend::Or(Load(), Backend::Load(operand))); }
 
-		Data = dataOld;
-		return result;
-	}
-
-	std::array<T, 32 / sizeof(T)> operator&(const std::array<T, 32 / sizeof(T)>& operand) { return *this & operand.data(); }
-
-	std::array<T, 32 / sizeof(T)> operator&(const AVX256& operand) { return *this & operand.Data; }
-
-
-	// Or ///////////
-
-	AVX256& Or(const T* operand)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_or_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_or_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_or_si256(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_or_si256(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_or_si256(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_or_si256(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
-	}
-
-	AVX256& Or(const std::array<T, 32 / sizeof(T)>& operand) { return Or(operand.data()); }
-
-	AVX256& Or(const AVX256& operand) { return Or(operand.Data); }
-
-	AVX256& operator|=(const T* operand) { return Or(operand); }
-
-	AVX256& operator|=(const std::array<T, 32 / sizeof(T)>& operand) { return Or(operand.data()); }
-
-	AVX256& operator|=(const AVX256& operand) { return Or(operand.Data); }
+	SIMD& Or(const std::array<T, Count>& operand) { return Or(operand.data()); }
 
-	std::array<T, 32 / sizeof(T)> operator|(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
-
-		this->Set(dataOld);
-		*this |= operand;
+	SIMD& Or(const SIMD& operand) { return Or(operand.Data); }
 
-		Data = dataOld;
-		return result;
-	}
+	SIMD& operator|=(const T* operand) { return Or(operand); }
 
-	std::array<T, 32 / sizeof(T)> operator|(const std::array<T, 32 / sizeof(T)>& operand) { return *this | operand.data(); }
+	SIMD& operator|=(const std::array<T, Count>& operand) { return Or(operand.data()); }
 
-	std::array<T, 32 / sizeof(T)> operator|(const AVX256& operand) { return *this | operand.Data; }
+	SIMD& operator|=(const SIMD& operand) { return Or(operand.Data); }
 
+	std::array<T, Count> operator|(const T* operand) const { return Apply([&](SIMD& result) { result.Or(operand); }); }
 
-	// Xor ///////////
-
-	AVX256& Xor(const T* operand)
-	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_xor_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_xor_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_xor_si256(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(operand)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_xor_si256(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_xor_si256(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_xor_si256(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
-	}
+	std::array<T, Count> operator|(const std::array<T, Count>& operand) const { return *this | operand.data(); }
 
-	AVX256& Xor(const std::array<T, 32 / sizeof(T)>& operand) { return Xor(operand.data()); }
+	std::array<T, Count> operator|(const SIMD& operand) const { return *this | operand.Data; }
 
-	AVX256& Xor(const AVX256& operand) { return Xor(operand.Data); }
+	SIMD& Xor(const T* operand) { return Update(Backend::Xor(Load(), Backend::Load(operand))); }
 
-	AVX256& operator^=(const T* operand) { return Xor(operand); }
+	SIMD& Xor(const std::array<T, Count>& operand) { return Xor(operand.data()); }
 
-	AVX256& operator^=(const std::array<T, 32 / sizeof(T)>& operand) { return Xor(operand.data()); }
+	SIMD& Xor(const SIMD& operand) { return Xor(operand.Data); }
 
-	AVX256& operator^=(const AVX256& operand) { return Xor(operand.Data); }
+	SIMD& operator^=(const T* operand) { return Xor(operand); }
 
-	std::array<T, 32 / sizeof(T)> operator^(const T* operand)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	SIMD& operator^=(const std::array<T, Count>& operand) { return Xor(operand.data()); }
 
-		this->Set(dataOld);
-		*this ^= operand;
+	SIMD& operator^=(const SIMD& operand) { return Xor(operand.Data); }
 
-		Data = dataOld;
-		return result;
-	}
+	std::array<T, Count> operator^(const T* operand) const { return Apply([&](SIMD& result) { result.Xor(operand); }); }
 
-	std::array<T, 32 / sizeof(T)> operator^(const std::array<T, 32 / sizeof(T)>& operand) { return *this ^ operand.data(); }
+	std::array<T, Count> operator^(const std::array<T, Count>& operand) const { return *this ^ operand.data(); }
 
-	std::array<T, 32 / sizeof(T)> operator^(const AVX256& operand) { return *this ^ operand.Data; }
+	std::array<T, Count> operator^(const SIMD& operand) const { return *this ^ operand.Data; }
 
 
 	// Shift /////////
 
 	// Performs a logical left shift. Available on 64, 32, and 16-bit integers only.
-	AVX256& ShiftLeft(const int shift)
+	SIMD& ShiftLeft(const int shift)
 	{
-		if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_slli_epi64(_mm256_loadu_epi64(Data), shift));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_slli_epi32(_mm256_loadu_epi32(Data), shift));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_slli_epi16(_mm256_loadu_epi16(Data), shift));
-		else if constexpr (true) static_assert(false, "AVX256: ShiftLeft(shift) is not available for floating-point types or 8-bit integers");
-		return *this;
+		static_assert(sizeof(T) >= 2 && std::is_integral_v<T>, "SIMD: ShiftLeft(shift) is not available for floating-point types or 8-bit integers");
+		return Update(Backend::ShiftLeft(Load(), shift));
 	}
 
-	// Performs a logical left shift. Available on 32 and 64-bit integers only.
-	AVX256& ShiftLeft(const T* shifts)
-	{
-		if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_sllv_epi64(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(shifts)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_sllv_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(shifts)));
-		else if constexpr (true) static_assert(false, "AVX256: ShiftLeft(shifts) is only 32 and 64-bit integers");
-		return *this;
-	}
-
-	// Performs a logical left shift. Available on 32 and 64-bit integers only. 
-	AVX256& ShiftLeft(const std::array<T, 32 / sizeof(T)>& shifts) { return ShiftLeft(shifts.data()); }
-
-	// Performs a logical left shift. Available on 32 and 64-bit integers only.
-	AVX256& ShiftLeft(const AVX256& shifts) { return ShiftLeft(shifts.Data); }
-
 	// Performs a logical left shift. Available on 64, 32, and 16-bit integers only.
-	AVX256& operator<<=(const int shift) { return ShiftLeft(shift); }
-
-	// Performs a logical left shift. Available on 32 and 64-bit integers only.
-	AVX256& operator<<=(const T* shifts) { return ShiftLeft(shifts); }
-
-	// Performs a logical left shift. Available on 32 and 64-bit integers only. 
-	AVX256& operator<<=(const std::array<T, 32 / sizeof(T)>& shifts) { return ShiftLeft(shifts.data()); }
-
-	// Performs a logical left shift. Available on 32 and 64-bit integers only.
-	AVX256& operator<<=(const AVX256& shifts) { return ShiftLeft(shifts.Data); }
+	SIMD& operator<<=(const int shift) { return ShiftLeft(shift); }
 
 	// Performs a logical left shift. Available on 64, 32, and 16-bit integers only.
-	std::array<T, 32 / sizeof(T)> operator<<(const int shift)
+	std::array<T, Count> operator<<(const int shift) const { return Apply([=](SIMD& result) { result.ShiftLeft(shift); }); }
+
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	SIMD& ShiftLeft(const T* shifts)
 	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+		static_assert(Bits != 128, "SIMD: ShiftLeft(shifts) is not available at 128 bits, as SSE4 has no variable shifts");
+		static_assert(std::is_integral_v<T> && (sizeof(T) >= 4 || (sizeof(T) == 2 && Bits == 512)), "SIMD: ShiftLeft(shifts) is only available for 64 and 32-bit integers (and 16-bit integers at 512 bits)");
+		return Update(Backend::ShiftLeft(Load(), Backend::Load(shifts)));
+	}
 
-		this->Set(dataOld);
-		*this <<= shift;
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	SIMD& ShiftLeft(const std::array<T, Count>& shifts) { return ShiftLeft(shifts.data()); }
 
-		Data = dataOld;
-		return result;
-	}
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	SIMD& ShiftLeft(const SIMD& shifts) { return ShiftLeft(shifts.Data); }
 
-	// Performs a logical left shift. Available on 64, 32, and 16-bit integers only.
-	std::array<T, 32 / sizeof(T)> operator<<(const T* shifts)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	SIMD& operator<<=(const T* shifts) { return ShiftLeft(shifts); }
 
-		this->Set(dataOld);
-		*this <<= shifts;
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	SIMD& operator<<=(const std::array<T, Count>& shifts) { return ShiftLeft(shifts.data()); }
 
-		Data = dataOld;
-		return result;
-	}
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	SIMD& operator<<=(const SIMD& shifts) { return ShiftLeft(shifts.Data); }
 
-	// Performs a logical left shift. Available on 64, 32, and 16-bit integers only. 
-	std::array<T, 32 / sizeof(T)> operator<<(const std::array<T, 32 / sizeof(T)>& shifts) { return *this << shifts.data(); }
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	std::array<T, Count> operator<<(const T* shifts) const { return Apply([=](SIMD& result) { result.ShiftLeft(shifts); }); }
 
-	// Performs a logical left shift. Available on 64, 32, and 16-bit integers only.
-	std::array<T, 32 / sizeof(T)> operator<<(const AVX256& shifts) { return *this << shifts.Data; }
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	std::array<T, Count> operator<<(const std::array<T, Count>& shifts) const { return *this << shifts.data(); }
+
+	// Performs a logical left shift of each element by the matching element of 'shifts'. Available on 64 and 32-bit integers, and on 16-bit integers at 512 bits
+	std::array<T, Count> operator<<(const SIMD& shifts) const { return *this << shifts.Data; }
 
 	/*
 	* Signed types (32 and 16-bit integers): Arithmetic shift
 	* Unsigned types (64, 32, and 16-bit integers): Logical shift
 	*/
-	AVX256& ShiftRight(const int shift)
+	SIMD& ShiftRight(const int shift)
 	{
-		if constexpr (std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_srli_epi64(_mm256_loadu_epi64(Data), shift));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_srli_epi32(_mm256_loadu_epi32(Data), shift));
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_srai_epi32(_mm256_loadu_epi32(Data), shift));
-		else if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_srli_epi16(_mm256_loadu_epi16(Data), shift));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_srai_epi16(_mm256_loadu_epi16(Data), shift));
-		else if constexpr (true) { static_assert(false, "AVX256: ShiftRight(shift) is only available for 64 (unsigned), 32, and 16-bit integers"); }
-		return *this;
+		static_assert(std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 2 || (sizeof(T) == 8 && !std::is_signed_v<T>)),
+			"SIMD: ShiftRight(shift) is only available for 64 (unsigned), 32, and 16-bit integers");
+		return Update(Backend::ShiftRight(Load(), shift));
 	}
 
-	/*
-	* Signed types (32-bit integers): Arithmetic shift
-	* Unsigned types (64 and 32-bit integers): Logical shift
-	*/
-	AVX256& ShiftRight(const T* shifts)
-	{
-		if constexpr (std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(Data, _mm256_srlv_epi64(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(shifts)));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_srlv_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(shifts)));
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_srav_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(shifts)));
-		else if constexpr (true) static_assert(false, "AVX256: ShiftRight(shifts) is only available for 64 (unsigned) and 32-bit integers");
-		return *this;
-	}
-
-	/*
-	* Signed types (32-bit integers): Arithmetic shift
-	* Unsigned types (64 and 32-bit integers): Logical shift
-	*/
-	AVX256& ShiftRight(const std::array<T, 32 / sizeof(T)>& shifts) { return ShiftRight(shifts.data()); }
-
-	/*
-	* Signed types (32-bit integers): Arithmetic shift
-	* Unsigned types (64 and 32-bit integers): Logical shift
-	*/
-	AVX256& ShiftRight(const AVX256& shifts) { return ShiftRight(shifts.Data); }
-
 	/*
 	* Signed types (32 and 16-bit integers): Arithmetic shift
 	* Unsigned types (64, 32, and 16-bit integers): Logical shift
 	*/
-	AVX256& operator>>=(const int shift) { return ShiftRight(shift); }
-
-	/*
-	* Signed types (32-bit integers): Arithmetic shift
-	* Unsigned types (64 and 32-bit integers): Logical shift
-	*/
-	AVX256& operator>>=(const T* shifts) { return ShiftRight(shifts); }
+	SIMD& operator>>=(const int shift) { return ShiftRight(shift); }
 
 	/*
-	* Signed types (32-bit integers): Arithmetic shift
-	* Unsigned types (64 and 32-bit integers): Logical shift
-	*/
-	AVX256& operator>>=(const std::array<T, 32 / sizeof(T)>& shifts) { return ShiftRight(shifts.data()); }
-
-	/*
-	* Signed types (32-bit integers): Arithmetic shift
-	* Unsigned types (64 and 32-bit integers): Logical shift
+	* Signed types (32 and 16-bit integers): Arithmetic shift
+	* Unsigned types (64, 32, and 16-bit integers): Logical shift
 	*/
-	AVX256& operator>>=(const AVX256& shifts) { return ShiftRight(shifts.Data); }
+	std::array<T, Count> operator>>(const int shift) const { return Apply([=](SIMD& result) { result.ShiftRight(shift); }); }
 
 	/*
-	* Signed types (32 and 16-bit integers): Arithmetic shift
-	* Unsigned types (64, 32, and 16-bit integers): Logical shift
+	* Shifts each element right by the matching element of 'shifts'. Not available at 128 bits
+	* Signed types (32-bit integers, and 16-bit integers at 512 bits): Arithmetic shift
+	* Unsigned types (64 and 32-bit integers, and 16-bit integers at 512 bits): Logical shift
 	*/
-	std::array<T, 32 / sizeof(T)> operator>>(const int shift)
+	SIMD& ShiftRight(const T* shifts)
 	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+		static_assert(Bits != 128, "SIMD: ShiftRight(shifts) is not available at 128 bits, as SSE4 has no variable shifts");
+		static_assert(std::is_integral_v<T> && (sizeof(T) == 4 || (sizeof(T) == 8 && !std::is_signed_v<T>) || (sizeof(T) == 2 && Bits == 512)),
+			"SIMD: ShiftRight(shifts) is only available for 64 (unsigned) and 32-bit integers (and 16-bit integers at 512 bits)");
+		return Update(Backend::ShiftRight(Load(), Backend::Load(shifts)));
+	}
 
-		this->Set(dataOld);
-		*this >>= shift;
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	SIMD& ShiftRight(const std::array<T, Count>& shifts) { return ShiftRight(shifts.data()); }
 
-		Data = dataOld;
-		return result;
-	}
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	SIMD& ShiftRight(const SIMD& shifts) { return ShiftRight(shifts.Data); }
 
-	/*
-	* Signed types (32 and 16-bit integers): Arithmetic shift
-	* Unsigned types (64, 32, and 16-bit integers): Logical shift
-	*/
-	std::array<T, 32 / sizeof(T)> operator>>(const T* shifts)
-	{
-		std::array<T, 32 / sizeof(T)> result{};
-		T* dataOld = Data;
-		Data = result.data();
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	SIMD& operator>>=(const T* shifts) { return ShiftRight(shifts); }
 
-		this->Set(dataOld);
-		*this >>= shifts;
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	SIMD& operator>>=(const std::array<T, Count>& shifts) { return ShiftRight(shifts.data()); }
 
-		Data = dataOld;
-		return result;
-	}
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	SIMD& operator>>=(const SIMD& shifts) { return ShiftRight(shifts.Data); }
 
-	/*
-	* Signed types (32 and 16-bit integers): Arithmetic shift
-	* Unsigned types (64, 32, and 16-bit integers): Logical shift
-	*/ 
-	std::array<T, 32 / sizeof(T)> operator>>(const std::array<T, 32 / sizeof(T)>& shifts) { return *this >> shifts.data(); }
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	std::array<T, Count> operator>>(const T* shifts) const { return Apply([=](SIMD& result) { result.ShiftRight(shifts); }); }
 
-	/*
-	* Signed types (32 and 16-bit integers): Arithmetic shift
-	* Unsigned types (64, 32, and 16-bit integers): Logical shift
-	*/
-	std::array<T, 32 / sizeof(T)> operator>>(const AVX256& shifts) { return *this >> shifts.Data; }
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	std::array<T, Count> operator>>(const std::array<T, Count>& shifts) const { return *this >> shifts.data(); }
+
+	// Calls ShiftRight(shifts). For details on its operation, see ShiftRight(const T* shifts)
+	std::array<T, Count> operator>>(const SIMD& shifts) const { return *this >> shifts.Data; }
 
 
 	// IsZero ///////////
 
 	// Returns true if all elements are 0, false otherwise
-	bool IsZero() 
-	{ 
-		if constexpr (std::is_same_v<T, double>) return static_cast<bool>(_mm256_testz_si256(_mm256_castpd_si256(_mm256_loadu_pd(Data)), _mm256_castpd_si256(_mm256_loadu_pd(Data))));
-		else if constexpr (std::is_same_v<T, float>) return static_cast<bool>(_mm256_testz_si256(_mm256_castps_si256(_mm256_loadu_ps(Data)), _mm256_castps_si256(_mm256_loadu_ps(Data))));
-		else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t>) return static_cast<bool>(_mm256_testz_si256(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(Data)));
-		else if constexpr (std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>) return static_cast<bool>(_mm256_testz_si256(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(Data)));
-		else if constexpr (std::is_same_v<T, int16_t> || std::is_same_v<T, uint16_t>) return static_cast<bool>(_mm256_testz_si256(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(Data)));
-		else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) return static_cast<bool>(_mm256_testz_si256(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(Data)));
-		return false;
-	}	
+	bool IsZero() const { return Backend::IsZero(Load()); }
 
 
-	// IsEqualTo /////////
+	// Comparison /////////
 
 	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling
-	std::array<T, 32 / sizeof(T)> IsEqualTo(const T* values)
-	{
-		std::array<T, 32 / sizeof(T)> mask{};
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(mask.data(), _mm256_cmp_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(values), _CMP_EQ_UQ));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(mask.data(), _mm256_cmp_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(values), _CMP_EQ_UQ));
-		else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) _mm256_storeu_epi64(mask.data(), _mm256_cmpeq_epi64(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(values)));
-		else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) _mm256_storeu_epi32(mask.data(), _mm256_cmpeq_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(values)));
-		else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) _mm256_storeu_epi16(mask.data(), _mm256_cmpeq_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(values)));
-		else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) _mm256_storeu_epi8(mask.data(), _mm256_cmpeq_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(values)));
-		return mask;
-	}
-
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling. 
-	std::array<T, 32 / sizeof(T)> IsEqualTo(const std::array<T, 32 / sizeof(T)>& values) { return IsEqualTo(values.data()); }
+	std::array<T, Count> IsEqualTo(const T* values) const { return Mask(Backend::Equal(Load(), Backend::Load(values))); }
 
 	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling
-	std::array<T, 32 / sizeof(T)> IsEqualTo(const AVX256& values) { return IsEqualTo(values.Data); }
+	std::array<T, Count> IsEqualTo(const std::array<T, Count>& values) const { return IsEqualTo(values.data()); }
 
 	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling
-	std::array<T, 32 / sizeof(T)> operator==(const T* values) { return IsEqualTo(values); }
-
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling. 
-	std::array<T, 32 / sizeof(T)> operator==(const std::array<T, 32 / sizeof(T)>& values) { return IsEqualTo(values.data()); }
+	std::array<T, Count> IsEqualTo(const SIMD& values) const { return IsEqualTo(values.Data); }
 
 	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling
-	std::array<T, 32 / sizeof(T)> operator==(const AVX256& values) { return IsEqualTo(values.Data); }
-
-
-	// IsGreaterThan /////////
+	std::array<T, Count> operator==(const T* values) const { return IsEqualTo(values); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> IsGreaterThan(const T* values)
-	{
-		std::array<T, 32 / sizeof(T)> mask{};
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(mask.data(), _mm256_cmp_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(values), _CMP_GT_OQ));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(mask.data(), _mm256_cmp_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(values), _CMP_GT_OQ));
-		else if constexpr (std::is_same_v<T, int64_t>) _mm256_storeu_epi64(mask.data(), _mm256_cmpgt_epi64(_mm256_loadu_epi64(Data), _mm256_loadu_epi64(values)));
-		else if constexpr (std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(mask.data(), _mm256_cmpgt_epi64(_mm256_xor_si256(_mm256_loadu_epi64(Data), _mm256_set1_epi64x(static_cast<uint64_t>(0x8000000000000000))), _mm256_xor_si256(_mm256_loadu_epi64(values), _mm256_set1_epi64x(static_cast<uint64_t>(0x8000000000000000)))));		
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(mask.data(), _mm256_cmpgt_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(values)));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(mask.data(), _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_loadu_epi32(Data), _mm256_set1_epi32(static_cast<uint32_t>(0x80000000))), _mm256_xor_si256(_mm256_loadu_epi32(values), _mm256_set1_epi32(static_cast<uint32_t>(0x80000000)))));		
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(mask.data(), _mm256_cmpgt_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(values)));
-		else if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(mask.data(), _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_epi16(Data), _mm256_set1_epi16(static_cast<uint16_t>(0x8000))), _mm256_xor_si256(_mm256_loadu_epi16(values), _mm256_set1_epi16(static_cast<uint16_t>(0x8000)))));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(mask.data(), _mm256_cmpgt_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(values)));
-		else if constexpr (std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(mask.data(), _mm256_cmpgt_epi8(_mm256_xor_si256(_mm256_loadu_epi8(Data), _mm256_set1_epi8(static_cast<uint8_t>(0x80))), _mm256_xor_si256(_mm256_loadu_epi8(values), _mm256_set1_epi8(static_cast<uint8_t>(0x80)))));
-		return mask;
-	}
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling
+	std::array<T, Count> operator==(const std::array<T, Count>& values) const { return IsEqualTo(values.data()); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling. 
-	std::array<T, 32 / sizeof(T)> IsGreaterThan(const std::array<T, 32 / sizeof(T)>& values) { return IsGreaterThan(values.data()); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are unordered and non-signaling
+	std::array<T, Count> operator==(const SIMD& values) const { return IsEqualTo(values.Data); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> IsGreaterThan(const AVX256& values) { return IsGreaterThan(values.Data); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> IsGreaterThan(const T* values) const { return Mask(Backend::Greater(Load(), Backend::Load(values))); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> operator>(const T* values) { return IsGreaterThan(values); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> IsGreaterThan(const std::array<T, Count>& values) const { return IsGreaterThan(values.data()); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling. 
-	std::array<T, 32 / sizeof(T)> operator>(const std::array<T, 32 / sizeof(T)>& values) { return IsGreaterThan(values.data()); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> IsGreaterThan(const SIMD& values) const { return IsGreaterThan(values.Data); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> operator>(const AVX256& values) { return IsGreaterThan(values.Data); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> operator>(const T* values) const { return IsGreaterThan(values); }
 
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> operator>(const std::array<T, Count>& values) const { return IsGreaterThan(values.data()); }
 
-	// IsLessThan /////////
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> operator>(const SIMD& values) const { return IsGreaterThan(values.Data); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> IsLessThan(const T* values)
-	{
-		std::array<T, 32 / sizeof(T)> mask{};
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(mask.data(), _mm256_cmp_pd(_mm256_loadu_pd(values), _mm256_loadu_pd(Data), _CMP_GT_OQ));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(mask.data(), _mm256_cmp_ps(_mm256_loadu_ps(values), _mm256_loadu_ps(Data), _CMP_GT_OQ));
-		else if constexpr (std::is_same_v<T, int64_t>) _mm256_storeu_epi64(mask.data(), _mm256_cmpgt_epi64(_mm256_loadu_epi64(values), _mm256_loadu_epi64(Data)));
-		else if constexpr (std::is_same_v<T, uint64_t>) _mm256_storeu_epi64(mask.data(), _mm256_cmpgt_epi64(_mm256_xor_si256(_mm256_loadu_epi64(values), _mm256_set1_epi64x(static_cast<uint64_t>(0x8000000000000000))), _mm256_xor_si256(_mm256_loadu_epi64(Data), _mm256_set1_epi64x(static_cast<uint64_t>(0x8000000000000000)))));
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(mask.data(), _mm256_cmpgt_epi32(_mm256_loadu_epi32(values), _mm256_loadu_epi32(Data)));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(mask.data(), _mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_loadu_epi32(values), _mm256_set1_epi32(static_cast<uint32_t>(0x80000000))), _mm256_xor_si256(_mm256_loadu_epi32(Data), _mm256_set1_epi32(static_cast<uint32_t>(0x80000000)))));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(mask.data(), _mm256_cmpgt_epi16(_mm256_loadu_epi16(values), _mm256_loadu_epi16(Data)));
-		else if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(mask.data(), _mm256_cmpgt_epi16(_mm256_xor_si256(_mm256_loadu_epi16(values), _mm256_set1_epi16(static_cast<uint16_t>(0x8000))), _mm256_xor_si256(_mm256_loadu_epi16(Data), _mm256_set1_epi16(static_cast<uint16_t>(0x8000)))));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(mask.data(), _mm256_cmpgt_epi8(_mm256_loadu_epi8(values), _mm256_loadu_epi8(Data)));
-		else if constexpr (std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(mask.data(), _mm256_cmpgt_epi8(_mm256_xor_si256(_mm256_loadu_epi8(values), _mm256_set1_epi8(static_cast<uint8_t>(0x80))), _mm256_xor_si256(_mm256_loadu_epi8(Data), _mm256_set1_epi8(static_cast<uint8_t>(0x80)))));
-		return mask;
-	}
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> IsLessThan(const T* values) const { return Mask(Backend::Greater(Backend::Load(values), Load())); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling. 
-	std::array<T, 32 / sizeof(T)> IsLessThan(const std::array<T, 32 / sizeof(T)>& values) { return IsLessThan(values.data()); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> IsLessThan(const std::array<T, Count>& values) const { return IsLessThan(values.data()); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> IsLessThan(const AVX256& values) { return IsLessThan(values.Data); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> IsLessThan(const SIMD& values) const { return IsLessThan(values.Data); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> operator<(const T* values) { return IsLessThan(values); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> operator<(const T* values) const { return IsLessThan(values); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling. 
-	std::array<T, 32 / sizeof(T)> operator<(const std::array<T, 32 / sizeof(T)>& values) { return IsLessThan(values.data()); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> operator<(const std::array<T, Count>& values) const { return IsLessThan(values.data()); }
 
-	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered and non-signaling
-	std::array<T, 32 / sizeof(T)> operator<(const AVX256& values) { return IsLessThan(values.Data); }
+	// Returns a condition mask where each element whose corresponding condition evaluated to true is set to all 1's, otherwise to all 0's. Floating-point comparisons are ordered
+	std::array<T, Count> operator<(const SIMD& values) const { return IsLessThan(values.Data); }
 
 
 	// Absolute ///////////
 
 	// This function is only available for 32, 16, and 8-bit signed integers
-	AVX256& Absolute()
+	SIMD& Absolute()
 	{
-		if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_abs_epi32(_mm256_loadu_epi32(Data)));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_abs_epi16(_mm256_loadu_epi16(Data)));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_abs_epi8(_mm256_loadu_epi8(Data)));
-		else if constexpr (true) static_assert(false, "AVX256: Absolute() is only available for 32, 16, and 8-bit signed integers");
-		return *this;
+		static_assert(std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) <= 4, "SIMD: Absolute() is only available for 32, 16, and 8-bit signed integers");
+		return Update(Backend::Abs(Load()));
 	}
 
 
 	// AbsoluteDifference ///////////
 
-	AVX256& AbsoluteDifference(const T* operand)
+	SIMD& AbsoluteDifference(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, double>)
-			_mm256_storeu_pd(
-				Data,
-				_mm256_sub_pd(
-					_mm256_max_pd(
-						_mm256_loadu_pd(Data),
-						_mm256_loadu_pd(operand)
-					),
-					_mm256_min_pd(
-						_mm256_loadu_pd(Data),
-						_mm256_loadu_pd(operand)
-					)
-				)
-			);
-		else if constexpr (std::is_same_v<T, float>)
-			_mm256_storeu_ps(
-				Data,
-				_mm256_sub_ps(
-					_mm256_max_ps(
-						_mm256_loadu_ps(Data),
-						_mm256_loadu_ps(operand)
-					),
-					_mm256_min_ps(
-						_mm256_loadu_ps(Data),
-						_mm256_loadu_ps(operand)
-					)
-				)
-			);		
-		else if constexpr (std::is_same_v<T, uint32_t>) 
-			_mm256_storeu_epi32(
-				Data,
-				_mm256_sub_epi32(
-					_mm256_max_epu32(
-						_mm256_loadu_epi32(Data),
-						_mm256_loadu_epi32(operand)
-					),
-					_mm256_min_epu32(
-						_mm256_loadu_epi32(Data),
-						_mm256_loadu_epi32(operand)
-					)
-				)
-			);
-		else if constexpr (std::is_same_v<T, uint16_t>) 
-			_mm256_storeu_epi16(
-				Data,
-				_mm256_or_si256(
-					_mm256_subs_epu16(
-						_mm256_loadu_epi16(Data),
-						_mm256_loadu_epi16(operand)
-					),
-					_mm256_subs_epu16(
-						_mm256_loadu_epi16(operand),
-						_mm256_loadu_epi16(Data)
-					)
-				)
-			);
-		else if constexpr (std::is_same_v<T, uint8_t>) 
-			_mm256_storeu_epi8(
-				Data,
-				_mm256_or_si256(
-					_mm256_subs_epu8(
-						_mm256_loadu_epi8(Data),
-						_mm256_loadu_epi8(operand)
-					),
-					_mm256_subs_epu8(
-						_mm256_loadu_epi8(operand),
-						_mm256_loadu_epi8(Data)
-					)
-				)
-			);		
-		else if constexpr (true) static_assert(false, "AVX256: AbsoluteDifference() is not available for signed (and unsigned 64-bit) integers");
-		return *this;
+		static_assert(std::is_floating_point_v<T> || (std::is_unsigned_v<T> && sizeof(T) <= 4), "SIMD: AbsoluteDifference() is not available for signed (and unsigned 64-bit) integers");
+
+		Register a = Load(), b = Backend::Load(operand);
+		if constexpr (sizeof(T) <= 2 && std::is_integral_v<T>) return Update(Backend::Or(Backend::SubSaturate(a, b), Backend::SubSaturate(b, a)));
+		else return Update(Backend::Sub(Backend::Max(a, b), Backend::Min(a, b)));
 	}
 
-	AVX256& AbsoluteDifference(const std::array<T, 32 / sizeof(T)>& operand) { return AbsoluteDifference(operand.data()); }
+	SIMD& AbsoluteDifference(const std::array<T, Count>& operand) { return AbsoluteDifference(operand.data()); }
 
-	AVX256& AbsoluteDifference(const AVX256& operand) { return AbsoluteDifference(operand.Data); }
+	SIMD& AbsoluteDifference(const SIMD& operand) { return AbsoluteDifference(operand.Data); }
 
 
-	// Min ///////////
+	// Min, Max ///////////
 
 	// This function is not available for 64-bit integers
-	AVX256& Min(const T* operand)
+	SIMD& Min(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, double>)  _mm256_storeu_pd(Data, _mm256_min_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_min_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_min_epu32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_min_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_min_epu16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_min_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_min_epu8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_min_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
+		static_assert(std::is_floating_point_v<T> || sizeof(T) <= 4, "SIMD: Min() is not available for 64-bit integers");
+		return Update(Backend::Min(Load(), Backend::Load(operand)));
 	}
 
-	AVX256& Min(const std::array<T, 32 / sizeof(T)>& operand) { return Min(operand.data()); }
-
-	AVX256& Min(const AVX256& operand) { return Min(operand.Data); }
+	SIMD& Min(const std::array<T, Count>& operand) { return Min(operand.data()); }
 
-
-	// Max ///////////
+	SIMD& Min(const SIMD& operand) { return Min(operand.Data); }
 
 	// This function is not available for 64-bit integers
-	AVX256& Max(const T* operand)
+	SIMD& Max(const T* operand)
 	{
-		if constexpr (std::is_same_v<T, double>)  _mm256_storeu_pd(Data, _mm256_max_pd(_mm256_loadu_pd(Data), _mm256_loadu_pd(operand)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_max_ps(_mm256_loadu_ps(Data), _mm256_loadu_ps(operand)));
-		else if constexpr (std::is_same_v<T, uint32_t>) _mm256_storeu_epi32(Data, _mm256_max_epu32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_max_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(operand)));
-		else if constexpr (std::is_same_v<T, uint16_t>) _mm256_storeu_epi16(Data, _mm256_max_epu16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_max_epi16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand)));
-		else if constexpr (std::is_same_v<T, uint8_t>) _mm256_storeu_epi8(Data, _mm256_max_epu8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		else if constexpr (std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_max_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand)));
-		return *this;
+		static_assert(std::is_floating_point_v<T> || sizeof(T) <= 4, "SIMD: Max() is not available for 64-bit integers");
+		return Update(Backend::Max(Load(), Backend::Load(operand)));
 	}
 
-	AVX256& Max(const std::array<T, 32 / sizeof(T)>& operand) { return Max(operand.data()); }
+	SIMD& Max(const std::array<T, Count>& operand) { return Max(operand.data()); }
 
-	AVX256& Max(const AVX256& operand) { return Max(operand.Data); }
+	SIMD& Max(const SIMD& operand) { return Max(operand.Data); }
 
 
-	// Floor ///////////
+	// Floor, Ceil, Sqrt, Inverse, InverseSqrt ///////////
 
 	// This function is only available for floating point types
-	AVX256& Floor()
+	SIMD& Floor()
 	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_floor_pd(_mm256_loadu_pd(Data)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_floor_ps(_mm256_loadu_ps(Data)));
-		else if constexpr (true) static_assert(false, "AVX256: Floor() is only available for floating point types");
-		return *this;
+		static_assert(std::is_floating_point_v<T>, "SIMD: Floor() is only available for floating point types");
+		return Update(Backend::Floor(Load()));
 	}
 
-
-	// Ceil ///////////
-
 	// This function is only available for floating point types
-	AVX256& Ceil()
+	SIMD& Ceil()
 	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_ceil_pd(_mm256_loadu_pd(Data)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_ceil_ps(_mm256_loadu_ps(Data)));
-		else if constexpr (true) static_assert(false, "AVX256: Ceil() is only available for floating point types");
-		return *this;
+		static_assert(std::is_floating_point_v<T>, "SIMD: Ceil() is only available for floating point types");
+		return Update(Backend::Ceil(Load()));
 	}
 
-
-	// Sum ///////////
-
-	// Returns the sum of all packed elements. The result is returned in full precision except with 32-bit integers, whose sum is accumulated into 32-bits and hence can overflow. This function is not available for 64-bit integers.
-	auto Sum() 
+	// This function is only available for floating point types
+	SIMD& Sqrt()
 	{
-		if constexpr (std::is_same_v<T, uint8_t>)
-		{			
-			__m256i sums = _mm256_sad_epu8(_mm256_loadu_epi8(Data), _mm256_setzero_si256()); // sums = |0|0|0|s3|0|0|0|s2|0|0|0|s1|0|0|0|s0| (16-bit packing)
-			sums = _mm256_add_epi64(_mm256_permute4x64_epi64(sums, 0b00011011), sums); // sums = |0|0|0|s0|0|0|0|s1|0|0|0|s2|0|0|0|s3| + |0|0|0|s3|0|0|0|s2|0|0|0|s1|0|0|0|s0| = |0|s0+s3|0|s1+s2|0|s2+s1|0|s3+s0| (32-bit packing)			
-			sums = _mm256_add_epi32(sums, _mm256_shuffle_epi32(sums, 0b01010110)); // sums = |0|s0+s3|0|s1+s2|0|s2+s1|0|s3+s0| + |0|0|0|s0+s3|0|0|0|s2+s1| = |0|0|0|s1+s2+s0+s3|0|s2+s1|0|s3+s0+s2+s1|				
-			return sums.m256i_u32[0];
-		}
-		else if constexpr (std::is_same_v<T, int8_t>)
-		{
-			__m256i sums = _mm256_sad_epu8( // sums = |0|0|0|s3+8*128|0|0|0|s2+8*128|0|0|0|s1+8*128|0|0|0|s0+8*128| (16-bit packing)
-				_mm256_xor_si256(_mm256_loadu_epi8(Data), _mm256_set1_epi8(static_cast<int8_t>(0x80))), // Add 128
-				_mm256_setzero_si256()
-			);
-			sums = _mm256_add_epi64(_mm256_permute4x64_epi64(sums, 0b00011011), sums); // sums = |0|0|0|s0+8*128|0|0|0|s1+8*128|0|0|0|s2+8*128|0|0|0|s3+8*128| + |0|0|0|s3+8*128|0|0|0|s2+8*128|0|0|0|s1+8*128|0|0|0|s0+8*128| = |0|s0+s3+16*128|0|s1+s2+16*128|0|s2+s1+16*128|0|s3+s0+16*128| (32-bit packing)			
-			sums = _mm256_add_epi64(sums, _mm256_shuffle_epi32(sums, 0b01010110)); // sums = |0|s0+s3+16*128|0|s1+s2+16*128|0|s2+s1+16*128|0|s3+s0+16*128| + |0|0|0|s0+s3+16*128|0|0|0|s2+s1+16*128| = |0|0|0|s1+s2+s0+s3+32*128|0|s2+s1+16*128|0|s3+s0+s2+s1+32*128|				
-			return sums.m256i_i32[0] - (32 * 128);
-		}
-		else if constexpr (std::is_same_v<T, uint16_t>)
-		{
-			return _mm256_hadd_epi32( // = |0|0|0|0|0|0|0|s7+s6+s5+s4+s3+s2+s1+s0|
-				_mm256_hadd_epi32( // = |0|0|0|0|0|0|s7+s6+s5+s4|s3+s2+s1+s0| 
-					_mm256_permute4x64_epi64( // = |0|0|0|0|s7+s6|s5+s4|s3+s2|s1+s0| 
-						_mm256_hadd_epi32( // = |0|0|s7+s6|s5+s4|0|0|s3+s2|s1+s0| 
-							_mm256_hadd_epi32( // = |s7|s6|s5|s4|s3|s2|s1|s0| (32-bit packing)
-								_mm256_unpacklo_epi16(
-									_mm256_loadu_epi16(Data),
-									_mm256_setzero_si256()
-								),
-								_mm256_unpackhi_epi16(
-									_mm256_loadu_epi16(Data),
-									_mm256_setzero_si256()
-								)
-							),
-							_mm256_setzero_si256()
-						),
-						0b01011000
-					),
-					_mm256_setzero_si256()
-				),
-				_mm256_setzero_si256()
-			).m256i_u32[0];
-		}
-		else if constexpr (std::is_same_v<T, int16_t>)
-		{
-			return _mm256_hadd_epi32( // = |0|0|0|0|0|0|0|s7+s6+s5+s4+s3+s2+s1+s0|
-				_mm256_hadd_epi32( // = |0|0|0|0|0|0|s7+s6+s5+s4|s3+s2+s1+s0|
-					_mm256_permute4x64_epi64( // = |0|0|0|0|s7+s6|s5+s4|s3+s2|s1+s0|
-						_mm256_hadd_epi32( // = |0|0|s7+s6|s5+s4|0|0|s3+s2|s1+s0|
-							_mm256_madd_epi16( // = |s7|s6|s5|s4|s3|s2|s1|s0| (32-bit packing)
-								_mm256_loadu_epi16(Data), 
-								_mm256_set1_epi16(1)), 
-							_mm256_setzero_si256()), 
-						0b01011000
-					),
-					_mm256_setzero_si256()
-				), 
-				_mm256_setzero_si256()
-			).m256i_i32[0];
-		}	
-		else if constexpr (std::is_same_v<T, uint32_t>)
-		{
-			return _mm256_hadd_epi32( // = |0|0|0|0|0|0|0|s3+s2+s1+s0|
-				_mm256_hadd_epi32( // = |0|0|0|0|0|0|s3+s2|s1+s0|
-					_mm256_permute4x64_epi64( // = |0|0|0|0|s3|s2|s1|s0|
-						_mm256_hadd_epi32( // = |0|0|s3|s2|0|0|s1|s0| (32-bit packing)
-							_mm256_loadu_epi16(Data),
-							_mm256_setzero_si256()
-						),
-						0b01011000
-					),
-					_mm256_setzero_si256()
-				),
-				_mm256_setzero_si256()
-			).m256i_u32[0];
-		}
-		else if constexpr (std::is_same_v<T, int32_t>)
-		{
-			return _mm256_hadd_epi32( // = |0|0|0|0|0|0|0|s3+s2+s1+s0|
-				_mm256_hadd_epi32( // = |0|0|0|0|0|0|s3+s2|s1+s0|
-					_mm256_permute4x64_epi64( // = |0|0|0|0|s3|s2|s1|s0|
-						_mm256_hadd_epi32( // = |0|0|s3|s2|0|0|s1|s0| (32-bit packing)
-							_mm256_loadu_epi16(Data),
-							_mm256_setzero_si256()
-						),
-						0b01011000
-					),
-					_mm256_setzero_si256()
-				),
-				_mm256_setzero_si256()
-			).m256i_i32[0];
-		}
-		else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) { static_assert(false, "AVX256: Sum() is not available for 64-bit integers"); }
-		else if constexpr (std::is_same_v<T, float>)
-		{
-			return _mm256_hadd_ps( // = |0|0|0|0|0|0|0|s3+s2+s1+s0|
-				_mm256_hadd_ps( // = |0|0|0|0|0|0|s3+s2|s1+s0|					
-					_mm256_castpd_ps(_mm256_permute4x64_pd( // = |0|0|0|0|s3|s2|s1|s0|
-						_mm256_castps_pd(_mm256_hadd_ps( // = |0|0|s3|s2|0|0|s1|s0| (32-bit packing)
-							_mm256_loadu_ps(Data),
-							_mm256_setzero_ps()							
-						)),
-						0b01011000
-					)),
-					_mm256_setzero_ps()
-				),
-				_mm256_setzero_ps()
-			).m256_f32[0];
-		}
-		else if constexpr (std::is_same_v<T, double>)
-		{
-			return _mm256_hadd_pd( // = |0|0|0|s1+s0|
-						_mm256_permute4x64_pd( // = |0|0|s1|s0|
-							_mm256_hadd_pd( // = |0|s1|0|s0| (64-bit packing)
-								_mm256_loadu_pd(Data),
-								_mm256_setzero_pd()
-							),
-							0b01011000
-						),
-						_mm256_setzero_pd()			
-				).m256d_f64[0];
-		}
+		static_assert(std::is_floating_point_v<T>, "SIMD: Sqrt() is only available for floating point types");
+		return Update(Backend::Sqrt(Load()));
 	}
 
-	
-	// Average ///////////
-
-	// Computes the mean of corresponding elements, fractional results are rounded up to the nearest integer. This function is only available for 16 and 8-bit integers
-	AVX256& Average(const T* operand)
+	// Computes an approximation of the inverse (i.e. reciprocal) of each element (max relative error < 1.5*2^-12). This function is only available for 32-bit floating point types
+	SIMD& Inverse()
 	{
-		if constexpr (std::is_same_v<T, uint16_t>) { _mm256_storeu_epi16(Data, _mm256_avg_epu16(_mm256_loadu_epi16(Data), _mm256_loadu_epi16(operand))); }
-		else if constexpr (std::is_same_v<T, int16_t>)
-		{
-			_mm256_storeu_epi16(
-				Data,
-				_mm256_xor_si256( // Subrtract 32768
-					_mm256_avg_epu16(
-						_mm256_xor_si256( // Add 32768
-							_mm256_loadu_epi16(Data), 
-							_mm256_set1_epi16(static_cast<int16_t>(0x8000))
-						),
-						_mm256_xor_si256( // Add 32768
-							_mm256_loadu_epi16(operand),
-							_mm256_set1_epi16(static_cast<int16_t>(0x8000))
-						)
-					),
-					_mm256_set1_epi16(static_cast<int16_t>(0x8000))
-				)
-			);
-		}
-		else if constexpr (std::is_same_v<T, uint8_t>) { _mm256_storeu_epi8(Data, _mm256_avg_epu8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(operand))); }
-		else if constexpr (std::is_same_v<T, int8_t>) 
-		{ 
-			_mm256_storeu_epi8(
-				Data,
-				_mm256_xor_si256( // Subract 128
-					_mm256_avg_epu8(
-						_mm256_xor_si256( // Add 128
-							_mm256_loadu_epi8(Data),
-							_mm256_set1_epi8(static_cast<int8_t>(0x80))
-						),
-						_mm256_xor_si256( // Add 128
-							_mm256_loadu_epi8(operand),
-							_mm256_set1_epi8(static_cast<int8_t>(0x80))
-						)
-					),
-					_mm256_set1_epi8(static_cast<int8_t>(0x80))
-				)
-			);
-		}
-		else if constexpr (true) { static_assert(false, "AVX256: Average() is only available for 16 and 8-bit integers"); }
-		return *this;
+		static_assert(std::is_same_v<T, float>, "SIMD: Inverse() is only available for 32-bit floating point types");
+		return Update(Backend::Inverse(Load()));
 	}
 
-	// Computes the mean of corresponding elements, fractional results are rounded up to the nearest integer. This function is only available for 16 and 8-bit integers
-	AVX256& Average(const std::array<T, 32 / sizeof(T)>& operand) { return Average(operand.data()); }
-
-	// Computes the mean of corresponding elements, fractional results are rounded up to the nearest integer. This function is only available for 16 and 8-bit integers
-	AVX256& Average(const AVX256& operand) { return Average(operand.Data); }
-
-
-	// Sqrt ///////////
-
-	// This function is only available for floating point types
-	AVX256& Sqrt()
+	// Computes an approximation of the inverse square root of each element (max relative error < 1.5*2^-12). This function is only available for 32-bit floating point types
+	SIMD& InverseSqrt()
 	{
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_sqrt_pd(_mm256_loadu_pd(Data)));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_sqrt_ps(_mm256_loadu_ps(Data)));
-		else if constexpr (true) static_assert(false, "AVX256: Sqrt() is only available for floating point types");
-		return *this;
+		static_assert(std::is_same_v<T, float>, "SIMD: InverseSqrt() is only available for 32-bit floating point types");
+		return Update(Backend::InverseSqrt(Load()));
 	}
 
 
-	// Inverse ///////////
+	// Sum ///////////
 
-	// Computes an approximation of the inverse (i.e. reciprocal) of each element (max relative error < 1.5*2^-12). This function is only available for 32-bit floating point types
-	AVX256& Inverse()
+	// Returns the sum of all packed elements. The result is returned in full precision except with 32-bit integers, whose sum is accumulated into 32-bits and hence can overflow. This function is not available for 64-bit integers.
+	auto Sum() const
 	{
-		if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_rcp_ps(_mm256_loadu_ps(Data)));
-		else if constexpr (true) static_assert(false, "AVX256: Inverse() is only available for 32-bit floating point types");
-		return *this;
-	}
-
+		static_assert(std::is_floating_point_v<T> || sizeof(T) <= 4, "SIMD: Sum() is not available for 64-bit integers");
+		Register a = Load();
 
-	// InverseSqrt ///////////
-
-	// Computes an approximation of the inverse square root of each element (max relative error < 1.5*2^-12). This function is only available for 32-bit floating point types
-	AVX256& InverseSqrt()
-	{
-		if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_rsqrt_ps(_mm256_loadu_ps(Data)));
-		else if constexpr (true) static_assert(false, "AVX256: InverseSqrt() is only available for 32-bit floating point types");
-		return *this;
+		if constexpr (std::is_floating_point_v<T>) return Backend::ReduceAdd(a);
+		else if constexpr (std::is_same_v<T, uint8_t>) return static_cast<uint32_t>(Backend::ReduceAdd64(Backend::SumBytes(a)));
+		else if constexpr (std::is_same_v<T, int8_t>) return static_cast<int>(Backend::ReduceAdd64(Backend::SumBytes(Backend::Xor(a, Backend::Set1(INT8_MIN))))) - Count * 128; // Add 128 to each
+		else if constexpr (std::is_same_v<T, uint16_t>) // Subtract 32768 from each, so that pairs can be summed as signed integers
+			return static_cast<uint32_t>(Backend::ReduceAdd32(Backend::MulAdd16(Backend::Xor(a, Backend::Set1(0x8000)), Backend::Set1(1))) + 32768u * Count);
+		else if constexpr (std::is_same_v<T, int16_t>) return static_cast<int>(Backend::ReduceAdd32(Backend::MulAdd16(a, Backend::Set1(1))));
+		else if constexpr (std::is_same_v<T, uint32_t>) return Backend::ReduceAdd32(a);
+		else return static_cast<int>(Backend::ReduceAdd32(a));
 	}
 
 
-	// Permute ///////////
+	// Average ///////////
 
-	// Re-orders 64-bit elements using the specified order. Each template argument specifies the index of the element that will be copied to that element (one element can be copied to many elements)
-	template<int dst0, int dst1, int dst2, int dst3>
-	AVX256& Permute64()
+	// Computes the mean of corresponding elements, fractional results are rounded up to the nearest integer. This function is only available for 16 and 8-bit integers
+	SIMD& Average(const T* operand)
 	{
-		static_assert(dst0 >= 0 && dst0 <= 3 && dst1 >= 0 && dst1 <= 3 && dst2 >= 0 && dst2 <= 3 && dst3 >= 0 && dst3 <= 3, "AVX256: Indices must be between 0 and 3 inclusive");
-		constexpr uint8_t ORDER = dst0 | (dst1 << 2) | (dst2 << 4) | (dst3 << 6);
-
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_permute4x64_pd(_mm256_loadu_pd(Data), ORDER));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(Data)), ORDER)));
-		else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) _mm256_storeu_epi64(Data, _mm256_permute4x64_epi64(_mm256_loadu_epi64(Data), ORDER));
-		else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_permute4x64_epi64(_mm256_loadu_epi32(Data), ORDER));
-		else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_permute4x64_epi64(_mm256_loadu_epi16(Data), ORDER));
-		else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_permute4x64_epi64(_mm256_loadu_epi8(Data), ORDER));
+		static_assert(std::is_integral_v<T> && sizeof(T) <= 2, "SIMD: Average() is only available for 16 and 8-bit integers");
 
-		return *this;
+		if constexpr (std::is_signed_v<T>) // Add then subtract 2^15 or 2^7, so the unsigned average can be used
+		{
+			Register sign = Backend::Set1(std::numeric_limits<T>::min());
+			return Update(Backend::Xor(Backend::Average(Backend::Xor(Load(), sign), Backend::Xor(Backend::Load(operand), sign)), sign));
+		}
+		else return Update(Backend::Average(Load(), Backend::Load(operand)));
 	}
 
-	// Re-orders 32-bit elements using the specified order. Each element in order specifies the index of the element that will be copied to that element (one element can be copied to many elements). Order indices should be between 0 and 7 inclusive
-	template <typename U>
-	AVX256& Permute32(const U* order)
-	{
-		if constexpr (!std::is_same_v<U, uint32_t> && !std::is_same_v<U, int32_t>) static_assert(false, "AVX256: order must point to 32-bit integers");
-
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(_mm256_loadu_pd(Data)), _mm256_loadu_epi32(order))));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_permutevar8x32_ps(_mm256_loadu_ps(Data), _mm256_loadu_epi32(order)));
-		else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) _mm256_storeu_epi64(Data, _mm256_permutevar8x32_epi32(_mm256_loadu_epi64(Data), _mm256_loadu_epi32(order)));
-		else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_permutevar8x32_epi32(_mm256_loadu_epi32(Data), _mm256_loadu_epi32(order)));
-		else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_permutevar8x32_epi32(_mm256_loadu_epi16(Data), _mm256_loadu_epi32(order)));
-		else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_permutevar8x32_epi32(_mm256_loadu_epi8(Data), _mm256_loadu_epi32(order)));
-		return *this;
-	}
+	// Computes the mean of corresponding elements, fractional results are rounded up to the nearest integer. This function is only available for 16 and 8-bit integers
+	SIMD& Average(const std::array<T, Count>& operand) { return Average(operand.data()); }
 
-	// Re-orders 32-bit elements using the specified order. Each element in order specifies the index of the element that will be copied to that element (one element can be copied to many elements). Order indices should be between 0 and 7 inclusive. 
-	template <typename U>
-	AVX256& Permute32(const std::array<U, 32 / sizeof(U)>& order)
-	{
-		if constexpr (!std::is_same_v<U, uint32_t> && !std::is_same_v<U, int32_t>) static_assert(false, "AVX256: order must be an array of 32-bit integers");
-		else if constexpr (true) return Permute32(order.data());
-	}
+	// Computes the mean of corresponding elements, fractional results are rounded up to the nearest integer. This function is only available for 16 and 8-bit integers
+	SIMD& Average(const SIMD& operand) { return Average(operand.Data); }
 
-	// Re-orders 32-bit elements using the specified order. Each element in order specifies the index of the element that will be copied to that element (one element can be copied to many elements). Order indices should be between 0 and 7 inclusive
-	template <typename U>
-	AVX256& Permute32(const AVX256<U>& order)
-	{
-		if constexpr (!std::is_same_v<U, uint32_t> && !std::is_same_v<U, int32_t>) static_assert(false, "AVX256: order must be an AVX256<uint32_t> or AVX256<int32_t>");
-		else if constexpr (true) return Permute32(order.Data);
-	}
+	friend void testAVX256Constructor();
 
-	// Re-orders 8-bit elements within 128-bit lanes using the specified order. order[0] to order[15] permute elements dst[0] to dst[15], while order[16] to order[31] permute elements dst[16] to dst[31]. If the MSB of an order element is set, the corresponding byte in dst is cleared. One element can be copied to many elements. Order indices should be between 0 and 15 inclusive. 
-	template <typename U>
-	AVX256& Permute8(const U* order)
-	{
-		if constexpr (!std::is_same_v<U, uint8_t> && !std::is_same_v<U, int8_t>) static_assert(false, "AVX256: order must point to 8-bit integers");
-
-		if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(Data, _mm256_castsi256_pd(_mm256_shuffle_epi8(_mm256_castpd_si256(_mm256_loadu_pd(Data)), _mm256_loadu_epi8(order))));
-		else if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(Data, _mm256_castsi256_ps(_mm256_shuffle_epi8(_mm256_castps_si256(_mm256_loadu_ps(Data)), _mm256_loadu_epi8(order))));
-		else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) _mm256_storeu_epi64(Data, _mm256_shuffle_epi8(_mm256_loadu_epi64(Data), _mm256_loadu_epi8(order)));
-		else if constexpr (std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t>) _mm256_storeu_epi32(Data, _mm256_shuffle_epi8(_mm256_loadu_epi32(Data), _mm256_loadu_epi8(order)));
-		else if constexpr (std::is_same_v<T, uint16_t> || std::is_same_v<T, int16_t>) _mm256_storeu_epi16(Data, _mm256_shuffle_epi8(_mm256_loadu_epi16(Data), _mm256_loadu_epi8(order)));
-		else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) _mm256_storeu_epi8(Data, _mm256_shuffle_epi8(_mm256_loadu_epi8(Data), _mm256_loadu_epi8(order)));
-		return *this;
-	}
+private:
+	bool OwnsData; // Specifies whether the memory 'Data' points to was allocated at the constructor
+
+	Register Load() const { return Backend::Load(Data); }
+	SIMD& Update(Register value) { Backend::Store(Data, value); return *this; }
 
-	// Re-orders 8-bit the elements within 128-bit lanes using the specified order. order[0] to order[15] permute elements dst[0] to dst[15], while order[16] to order[31] permute elements dst[16] to dst[31]. If the MSB of an order element is set, the corresponding byte in dst is cleared. One element can be copied to many elements. Order indices should be between 0 and 15 inclusive. 
-	template <typename U>
-	AVX256& Permute8(const std::array<U, 32 / sizeof(U)>& order)
+	// Returns the elements of a comparison result
+	static std::array<T, Count> Mask(Register value)
 	{
-		if constexpr (!std::is_same_v<U, uint8_t> && !std::is_same_v<U, int8_t>) static_assert(false, "AVX256: order must be an array of 8-bit integers");
-		else if constexpr (true) return Permute8(order.data());
+		std::array<T, Count> mask;
+		Backend::Store(mask.data(), value);
+		return mask;
 	}
 
-	// Re-orders 8-bit the elements within 128-bit lanes using the specified order. order[0] to order[15] permute elements dst[0] to dst[15], while order[16] to order[31] permute elements dst[16] to dst[31]. If the MSB of an order element is set, the corresponding byte in dst is cleared. One element can be copied to many elements. Order indices should be between 0 and 15 inclusive. 
-	template <typename U>
-	AVX256& Permute8(const AVX256<U>& order)
+	// Returns the result of applying 'operation' to a copy of the elements
+	template <typename Operation>
+	std::array<T, Count> Apply(const Operation& operation) const
 	{
-		if constexpr (!std::is_same_v<U, uint8_t> && !std::is_same_v<U, int8_t>) static_assert(false, "AVX256: order must be an AVX256<uint8_t> or AVX256<int8_t>");
-		else if constexpr (true) return Permute8(order.Data);
+		std::array<T, Count> result;
+		SIMD copy{ result.data() };
+		operation(copy.Set(Data));
+		return result;
 	}
+};
 
+// The 128-bit vector, implemented with SSE4.2
+template <typename T>
+using SSE128 = SIMD<T, 128>;
 
-	friend void testAVX256Constructor();
+// The 256-bit vector, implemented with AVX2
+template <typename T>
+using AVX256 = SIMD<T, 256>;
 
-	private:		
-		bool OwnsData; // Specifies whether the memory 'Data' points to was allocated at the constructor
-};
+// The 512-bit vector, implemented with AVX-512F, BW and DQ
+template <typename T>
+using AVX512 = SIMD<T, 512>;
 
-template<typename T>
-std::ostream& operator<<(std::ostream& out, const AVX256<T>& myAvx)
+template<typename T, int Bits>
+std::ostream& operator<<(std::ostream& out, const SIMD<T, Bits>& myAvx)
 {
-	for (int i = 0; i < (256 / 8) / sizeof(T); ++i)
+	for (int i = 0; i < (Bits / 8) / sizeof(T); ++i)
 		out << "|" << myAvx[i];
 
 	out << '|';
@@ -1298,4 +750,4 @@ std::ostream& operator<<(std::ostream& out, const AVX256<T>& myAvx)
 	return out;
 }
 
-#endif
\ No newline at end of file
+#endif
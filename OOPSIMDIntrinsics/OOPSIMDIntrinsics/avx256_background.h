@@ -0,0 +1,111 @@
+#ifndef AVX256_BACKGROUND_H
+#define AVX256_BACKGROUND_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <immintrin.h>
+
+#include "avx256.h"
+
+namespace AVX256Utils
+{
+	// A per-pixel background model of a grey video: an exponentially weighted running average (and optionally running variance) of each pixel, updated in place with every frame.
+	// Each frame's pixels are compared against the model before it is updated, in the same pass, producing a foreground mask without keeping a copy of the previous frame.
+	// The averages are kept as 8.8 fixed-point uint16_ts and the variances as uint16_ts (in whole grey levels squared), and are updated 16 pixels at a time with AVX256<uint16_t> operations:
+	// model += (value - model) >> decayShift, i.e. each frame is weighted by 1 / 2^decayShift. The subtraction is split into the two saturating differences (one of which is 0), so no
+	// signed or 32-bit arithmetic is needed. Due to truncation, averages settle within 2^decayShift / 256 grey levels of a constant pixel, so 'decayShift' should be between 1 and 8
+	class BackgroundModel
+	{
+	public:
+		// If 'varianceFactor' (k) is 0, pixels that differ from their average by more than 'threshold' grey levels are foreground. Otherwise, they must also differ by more than k standard deviations
+		BackgroundModel(uint64_t pixels, int decayShift, uint8_t threshold, uint8_t varianceFactor = 0) : Pixels{ pixels }, DecayShift{ decayShift }, Threshold{ threshold }, VarianceFactor{ varianceFactor }
+		{
+			Averages.assign((pixels + 15) / 16 * 16, 0); // Whole vectors, the last one is padded
+			if (varianceFactor != 0) Variances.assign(Averages.size(), 0);
+		}
+
+		// Writes 255 for the foreground pixels of the frame and 0 otherwise to 'mask' (which may be the frame), then updates the model with the frame. Returns the number of foreground pixels.
+		// The first frame after construction (or Reset()) initialises the averages to its pixels and the variances to threshold^2, and has no foreground pixels
+		uint64_t Update(const uint8_t* frame, uint8_t* mask)
+		{
+			if (!Initialised)
+			{
+				for (uint64_t i = 0; i < Pixels; ++i) Averages[i] = static_cast<uint16_t>(frame[i] << 8);
+				std::fill(Variances.begin(), Variances.end(), static_cast<uint16_t>(Threshold * Threshold));
+				std::memset(mask, 0, Pixels);
+				Initialised = true;
+				return 0;
+			}
+
+			uint64_t foreground = 0, i = 0;
+
+			for (; i + 16 <= Pixels; i += 16)
+				foreground += _mm_popcnt_u32(UpdateBlock(frame + i, mask + i, i));
+
+			if (i != Pixels) // The last partial vector is copied out first so that nothing past the end of the frame and mask is accessed
+			{
+				std::array<uint8_t, 16> frameTail{}, maskTail{};
+				std::memcpy(frameTail.data(), frame + i, Pixels - i);
+				foreground += _mm_popcnt_u32(UpdateBlock(frameTail.data(), maskTail.data(), i) & ((1u << (Pixels - i)) - 1));
+				std::memcpy(mask + i, maskTail.data(), Pixels - i);
+			}
+
+			return foreground;
+		}
+
+		// Writes the rounded running average of each pixel (the background image) to 'out'
+		void Background(uint8_t* out) const
+		{
+			for (uint64_t i = 0; i < Pixels; ++i) out[i] = static_cast<uint8_t>(std::min((Averages[i] + 128) >> 8, 255));
+		}
+
+		// Discards the model, the next frame will initialise it
+		void Reset() { Initialised = false; }
+
+	private:
+		uint64_t Pixels;
+		int DecayShift;
+		uint8_t Threshold, VarianceFactor;
+		bool Initialised = false;
+		std::vector<uint16_t> Averages, Variances;
+
+		// Updates the model of the 16 pixels from pixel i, and returns the movemask of their 16 mask bytes
+		uint32_t UpdateBlock(const uint8_t* frame, uint8_t* mask, uint64_t i)
+		{
+			std::array<uint16_t, 16> values{}, rise{}, fall{}, difference{}, isForeground{}, thresholds{};
+			AVX256<uint16_t> averages{ Averages.data() + i }, avxRise{ rise.data() }, avxFall{ fall.data() }, avxDifference{ difference.data() }, avxIsForeground{ isForeground.data() };
+
+			thresholds.fill(Threshold);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(values.data()), _mm256_slli_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(frame))), 8));
+
+			avxRise.Set(values).SubSaturate(averages), avxFall.Set(averages).SubSaturate(values);
+			avxDifference.Set(avxRise).Or(avxFall).ShiftRight(8); // |pixel - average| in whole grey levels
+			avxIsForeground = avxDifference > thresholds;
+			averages.Add(avxRise.ShiftRight(DecayShift)).Sub(avxFall.ShiftRight(DecayShift));
+
+			if (VarianceFactor != 0)
+			{
+				std::array<uint16_t, 16> squares{}, bounds{}, limits{}, factors{};
+				AVX256<uint16_t> variances{ Variances.data() + i }, avxSquares{ squares.data() }, avxBounds{ bounds.data() };
+				limits.fill(static_cast<uint16_t>(UINT16_MAX / (VarianceFactor * VarianceFactor))), factors.fill(static_cast<uint16_t>(VarianceFactor * VarianceFactor));
+
+				avxSquares.Set(avxDifference).Mul(avxDifference); // At most 255^2, so it cannot overflow
+				avxBounds.Set(variances).Min(limits).Mul(factors); // k^2 * variance, saturated to 65535
+				avxIsForeground &= avxSquares > avxBounds;
+
+				avxRise.Set(avxSquares).SubSaturate(variances).ShiftRight(DecayShift), avxFall.Set(variances).SubSaturate(avxSquares).ShiftRight(DecayShift);
+				variances.Add(avxRise).Sub(avxFall);
+			}
+
+			__m256i isForegroundWords = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(isForeground.data()));
+			__m128i isForegroundBytes = _mm_packs_epi16(_mm256_castsi256_si128(isForegroundWords), _mm256_extracti128_si256(isForegroundWords, 1)); // 0xFFFF -> 0xFF
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(mask), isForegroundBytes);
+			return static_cast<uint32_t>(_mm_movemask_epi8(isForegroundBytes));
+		}
+	};
+};
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef AVX256_BASELINE_H
+#define AVX256_BASELINE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <istream>
+#include <iterator>
+#include <iomanip>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include "avx256_bench.h"
+
+namespace AVX256Utils
+{
+	// The samples of one benchmark (e.g. "blend/AVX256" or "Sum<float>/register"), in seconds per run or per operation
+	struct BaselineEntry
+	{
+		std::string Name;
+		std::vector<double> Samples;
+	};
+
+	// The samples of a benchmark run, tagged with the machine and compiler that produced them (see MachineTag()) since results only compare on the same machine
+	struct Baseline
+	{
+		std::string Machine, Suite;
+		std::vector<BaselineEntry> Entries;
+	};
+
+	// A benchmark's median in a baseline and in the current run, and whether the current samples are significantly slower (see CompareBaseline())
+	struct BaselineComparison
+	{
+		std::string Name;
+		double BaselineMedian = 0, Median = 0;
+		double PValue = 1; // Of the current samples being no slower than the baseline samples
+		bool Regression = false;
+
+		double Change() const { return BaselineMedian == 0 ? 0 : Median / BaselineMedian - 1; } // Positive when slower
+	};
+
+	namespace BaselineDetail
+	{
+		inline double Median(std::vector<double> samples)
+		{
+			std::sort(samples.begin(), samples.end());
+			return BenchDetail::Percentile(samples, 0.5);
+		}
+
+		// Reads the JSON written by WriteBaseline(), skipping whitespace between tokens
+		class Reader
+		{
+		public:
+			explicit Reader(const std::string& text) : Text{ text }, Position{ 0 } {}
+
+			// Consumes 'c' if it is the next token, returning whether it was
+			bool Expect(char c)
+			{
+				SkipWhitespace();
+				if (Position == Text.size() || Text[Position] != c) return false;
+				++Position;
+				return true;
+			}
+
+			bool String(std::string& value)
+			{
+				if (!Expect('"')) return false;
+
+				value.clear();
+				for (; Position < Text.size() && Text[Position] != '"'; ++Position)
+				{
+					if (Text[Position] == '\\' && ++Position == Text.size()) return false;
+					value += Text[Position];
+				}
+
+				return Position < Text.size() && Text[Position++] == '"';
+			}
+
+			bool Number(double& value)
+			{
+				SkipWhitespace();
+				const char* start = Text.c_str() + Position;
+				char* end = nullptr;
+				value = std::strtod(start, &end);
+				Position += end - start;
+				return end != start;
+			}
+
+			bool AtEnd()
+			{
+				SkipWhitespace();
+				return Position == Text.size();
+			}
+
+		private:
+			void SkipWhitespace() { while (Position < Text.size() && std::strchr(" \t\r\n", Text[Position]) != nullptr) ++Position; }
+
+			const std::string& Text;
+			uint64_t Position;
+		};
+
+		inline bool ReadEntry(Reader& reader, BaselineEntry& entry)
+		{
+			std::string key;
+			if (!reader.Expect('{') || !reader.String(key) || key != "name" || !reader.Expect(':') || !reader.String(entry.Name)) return false;
+			if (!reader.Expect(',') || !reader.String(key) || key != "samples" || !reader.Expect(':') || !reader.Expect('[')) return false;
+
+			if (!reader.Expect(']'))
+			{
+				do
+				{
+					double sample = 0;
+					if (!reader.Number(sample)) return false;
+					entry.Samples.push_back(sample);
+				} while (reader.Expect(','));
+
+				if (!reader.Expect(']')) return false;
+			}
+
+			return reader.Expect('}');
+		}
+	};
+
+	// Returns the CPU brand string and the compiler that built the benchmark, e.g. "Intel(R) Core(TM) i7-9700K CPU @ 3.60GHz / GCC 12.2.0"
+	inline std::string MachineTag()
+	{
+		unsigned brand[12] = {};
+		for (unsigned leaf = 0; leaf < 3; ++leaf)
+		{
+#ifdef _MSC_VER
+			__cpuid(reinterpret_cast<int*>(brand + 4 * leaf), 0x80000002 + leaf);
+#else
+			__get_cpuid(0x80000002 + leaf, brand + 4 * leaf, brand + 4 * leaf + 1, brand + 4 * leaf + 2, brand + 4 * leaf + 3);
+#endif
+		}
+
+		std::string cpu{ reinterpret_cast<const char*>(brand), sizeof(brand) };
+		cpu.erase(cpu.find_last_not_of(std::string{ '\0', ' ' }) + 1), cpu.erase(0, cpu.find_first_not_of(' '));
+
+#if defined(__clang__)
+		std::string compiler = "Clang " __clang_version__;
+#elif defined(__GNUC__)
+		std::string compiler = "GCC " __VERSION__;
+#elif defined(_MSC_VER)
+		std::string compiler = "MSVC " + std::to_string(_MSC_FULL_VER);
+#else
+		std::string compiler = "Unknown compiler";
+#endif
+
+		return (cpu.empty() ? "Unknown CPU" : cpu) + " / " + compiler;
+	}
+
+	// Returns a baseline of the samples of each kernel variant, named "<kernel>/<variant>"
+	inline Baseline MakeBaseline(const std::vector<BenchmarkResult>& results)
+	{
+		Baseline baseline{ MachineTag(), "kernels", {} };
+		for (const BenchmarkResult& result : results) baseline.Entries.push_back({ result.Kernel + '/' + result.Variant, result.Samples });
+		return baseline;
+	}
+
+	// Returns a baseline of the throughput samples of each operation, named "<operation><<type>>/<mode>", e.g. "Sum<float>/register"
+	inline Baseline MakeBaseline(const std::vector<OperationResult>& results)
+	{
+		Baseline baseline{ MachineTag(), "operations", {} };
+		for (const OperationResult& result : results)
+			baseline.Entries.push_back({ result.Operation + '<' + result.Type + ">/" + (result.Mode == OperationMode::Memory ? "memory" : "register"), result.Samples });
+		return baseline;
+	}
+
+	inline void WriteBaseline(std::ostream& out, const Baseline& baseline)
+	{
+		out << "{\n  \"machine\": \"" << BenchDetail::EscapeJSON(baseline.Machine) << "\",\n  \"suite\": \"" << BenchDetail::EscapeJSON(baseline.Suite) << "\",\n  \"results\": ["
+			<< std::setprecision(9);
+
+		for (uint64_t i = 0; i < baseline.Entries.size(); ++i)
+		{
+			out << (i == 0 ? "\n" : ",\n") << "    { \"name\": \"" << BenchDetail::EscapeJSON(baseline.Entries[i].Name) << "\", \"samples\": [";
+			for (uint64_t j = 0; j < baseline.Entries[i].Samples.size(); ++j) out << (j == 0 ? "" : ", ") << baseline.Entries[i].Samples[j];
+			out << "] }";
+		}
+
+		out << "\n  ]\n}\n";
+	}
+
+	// Reads a baseline written by WriteBaseline(), returning false if it is malformed
+	inline bool ReadBaseline(std::istream& in, Baseline& baseline)
+	{
+		std::string text{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} }, key;
+		BaselineDetail::Reader reader{ text };
+		baseline = Baseline{};
+
+		if (!reader.Expect('{') || !reader.String(key) || key != "machine" || !reader.Expect(':') || !reader.String(baseline.Machine)) return false;
+		if (!reader.Expect(',') || !reader.String(key) || key != "suite" || !reader.Expect(':') || !reader.String(baseline.Suite)) return false;
+		if (!reader.Expect(',') || !reader.String(key) || key != "results" || !reader.Expect(':') || !reader.Expect('[')) return false;
+
+		if (!reader.Expect(']'))
+		{
+			do
+			{
+				baseline.Entries.emplace_back();
+				if (!BaselineDetail::ReadEntry(reader, baseline.Entries.back())) return false;
+			} while (reader.Expect(','));
+
+			if (!reader.Expect(']')) return false;
+		}
+
+		return reader.Expect('}') && reader.AtEnd();
+	}
+
+	// Returns the one-sided p-value of the Mann-Whitney U test that 'samples' tend to be larger than 'baselineSamples', from the normal approximation of U with tie and
+	// continuity corrections. Returns 1 if either is empty or all samples are equal
+	inline double MannWhitneyPValue(const std::vector<double>& baselineSamples, const std::vector<double>& samples)
+	{
+		uint64_t n1 = samples.size(), n2 = baselineSamples.size(), n = n1 + n2;
+		if (n1 == 0 || n2 == 0) return 1;
+
+		std::vector<std::pair<double, bool>> pooled; // Sample, and whether it is from 'samples'
+		for (double sample : samples) pooled.emplace_back(sample, true);
+		for (double sample : baselineSamples) pooled.emplace_back(sample, false);
+		std::sort(pooled.begin(), pooled.end());
+
+		// Sum the ranks of 'samples', giving tied samples the mean of their ranks
+		double rankSum = 0, ties = 0;
+		for (uint64_t i = 0, j = 0; i < n; i = j)
+		{
+			while (j < n && pooled[j].first == pooled[i].first) ++j;
+
+			double rank = (i + 1 + j) / 2.0, count = static_cast<double>(j - i);
+			for (uint64_t k = i; k < j; ++k) if (pooled[k].second) rankSum += rank;
+			ties += count * count * count - count;
+		}
+
+		double u = rankSum - n1 * (n1 + 1) / 2.0, mean = n1 * n2 / 2.0;
+		double variance = n1 * n2 / 12.0 * ((n + 1) - ties / (static_cast<double>(n) * (n - 1)));
+		if (variance <= 0) return 1;
+
+		double z = (u - mean - 0.5) / std::sqrt(variance);
+		return 0.5 * std::erfc(z / std::sqrt(2.0));
+	}
+
+	// Compares each benchmark in 'current' with the one of the same name in 'baseline'. A benchmark regresses if its samples are significantly slower (see MannWhitneyPValue())
+	// at options.Significance and its median is more than options.Threshold percent slower. Benchmarks missing from either are skipped
+	inline std::vector<BaselineComparison> CompareBaseline(const Baseline& baseline, const Baseline& current, const BenchmarkOptions& options)
+	{
+		std::vector<BaselineComparison> comparisons;
+
+		for (const BaselineEntry& entry : current.Entries)
+		{
+			auto match = std::find_if(baseline.Entries.begin(), baseline.Entries.end(), [&](const BaselineEntry& other) { return other.Name == entry.Name; });
+			if (match == baseline.Entries.end()) continue;
+
+			BaselineComparison comparison;
+			comparison.Name = entry.Name;
+			comparison.BaselineMedian = BaselineDetail::Median(match->Samples), comparison.Median = BaselineDetail::Median(entry.Samples);
+			comparison.PValue = MannWhitneyPValue(match->Samples, entry.Samples);
+			comparison.Regression = comparison.PValue < options.Significance && comparison.Change() * 100 > options.Threshold;
+			comparisons.push_back(comparison);
+		}
+
+		return comparisons;
+	}
+
+	// Writes one row per comparison, with a header row. Medians are in seconds and changes in percent
+	inline void WriteCSV(std::ostream& out, const std::vector<BaselineComparison>& comparisons)
+	{
+		out << "name,baseline_median_s,median_s,change_percent,p_value,regression\n" << std::setprecision(6);
+
+		for (const BaselineComparison& comparison : comparisons)
+			out << comparison.Name << ',' << comparison.BaselineMedian << ',' << comparison.Median << ',' << comparison.Change() * 100 << ',' << comparison.PValue << ','
+				<< (comparison.Regression ? "true" : "false") << '\n';
+	}
+
+	// Writes the options of the comparison and an array of comparisons. Medians are in seconds and changes in percent
+	inline void WriteJSON(std::ostream& out, const BenchmarkOptions& options, const std::vector<BaselineComparison>& comparisons)
+	{
+		out << "{\n  \"baseline\": \"" << BenchDetail::EscapeJSON(options.Baseline) << "\",\n  \"threshold_percent\": " << options.Threshold << ",\n  \"significance\": "
+			<< options.Significance << ",\n  \"comparisons\": [" << std::setprecision(6);
+
+		for (uint64_t i = 0; i < comparisons.size(); ++i)
+		{
+			const BaselineComparison& comparison = comparisons[i];
+			out << (i == 0 ? "\n" : ",\n") << "    { \"name\": \"" << BenchDetail::EscapeJSON(comparison.Name) << "\", \"baseline_median_s\": " << comparison.BaselineMedian
+				<< ", \"median_s\": " << comparison.Median << ", \"change_percent\": " << comparison.Change() * 100 << ", \"p_value\": " << comparison.PValue
+				<< ", \"regression\": " << (comparison.Regression ? "true" : "false") << " }";
+		}
+
+		out << "\n  ]\n}\n";
+	}
+
+	// Writes a Markdown table of the comparisons, marking the regressions. Medians are in microseconds
+	inline void WriteTable(std::ostream& out, const std::vector<BaselineComparison>& comparisons)
+	{
+		out << "| Benchmark | Baseline us | Current us | Change | p-value | |\n|---|--:|--:|--:|--:|---|\n" << std::fixed;
+
+		for (const BaselineComparison& comparison : comparisons)
+			out << "| " << comparison.Name << " | " << std::setprecision(3) << comparison.BaselineMedian * 1e6 << " | " << comparison.Median * 1e6 << " | " << std::showpos
+				<< std::setprecision(1) << comparison.Change() * 100 << '%' << std::noshowpos << " | " << std::setprecision(4) << comparison.PValue << " | "
+				<< (comparison.Regression ? "Regression" : "") << " |\n";
+
+		out << std::defaultfloat;
+	}
+};
+
+#endif
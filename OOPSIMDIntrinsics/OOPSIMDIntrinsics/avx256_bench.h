@@ -0,0 +1,549 @@
+#ifndef AVX256_BENCH_H
+#define AVX256_BENCH_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+#include "avx256_perf.h"
+
+namespace AVX256Utils
+{
+	enum class BenchmarkFormat { Table, CSV, JSON };
+
+	// Kernels runs the demo kernels on frame-sized buffers, Operations runs every AVX256<T> method for every type it is available for (see MeasureOperation()), and Roofline runs
+	// the kernels at L1, L2, L3 and DRAM working-set sizes against the bandwidth STREAM attains at each (see avx256_roofline.h)
+	enum class BenchmarkSuite { Kernels, Operations, Roofline };
+
+	// The settings of a benchmark run, set from the command line by ParseBenchmarkOptions()
+	struct BenchmarkOptions
+	{
+		uint64_t Size = 1920 * 1080 * 3; // Bytes per buffer, a 1080p BGR frame by default
+		uint32_t Warmup = 10, Repetitions = 100;
+		BenchmarkFormat Format = BenchmarkFormat::Table;
+		BenchmarkSuite Suite = BenchmarkSuite::Kernels;
+		std::string Input; // A file to fill the input buffers from instead of synthetic data (repeated to fill 'Size' bytes)
+		std::string Output; // A file to write the results to instead of the standard output
+		std::string Filter; // Only kernels whose name contains this are run (operations are selected by name and/or exact type, e.g. "Mul", "int8_t" or "Mul<int8_t>")
+		bool Counters = false; // Whether to count hardware events (see PerfProbe) over the timed runs of kernels
+		std::string SaveBaseline; // A file to save the samples of the run to as a baseline (see avx256_baseline.h)
+		std::string Baseline; // A baseline file to compare the run against, writing the comparison instead of the results
+		double Threshold = 5; // The slowdown in percent of the median above which a significant difference is a regression
+		double Significance = 0.01; // The p-value below which a difference is significant
+		bool Help = false; // Whether --help was given, in which case only the usage should be written (see WriteBenchmarkUsage())
+	};
+
+	// The timings of one variant (e.g. scalar, AVX256, OpenCV) of a kernel over 'Repetitions' runs, after 'Warmup' untimed runs
+	struct BenchmarkResult
+	{
+		std::string Kernel, Variant;
+		uint64_t Bytes = 0; // Bytes read and written per run
+		uint64_t Elements = 0; // Elements (e.g. pixels) processed per run
+		std::vector<double> Samples; // Seconds per run, in the order they ran
+		double MinSeconds = 0, MeanSeconds = 0, MedianSeconds = 0, P95Seconds = 0, P99Seconds = 0;
+		double MedianCycles = 0; // Time stamp counter cycles per run, which tick at a constant (reference) rate rather than the core's current clock
+		PerfCounters Counters; // Hardware events summed over the timed runs, if BenchmarkOptions::Counters is set
+
+		double GBPerSecond() const { return MedianSeconds == 0 ? 0 : Bytes / MedianSeconds / 1e9; }
+		double ElementsPerSecond() const { return MedianSeconds == 0 ? 0 : Elements / MedianSeconds; }
+		double CyclesPerByte() const { return Bytes == 0 ? 0 : MedianCycles / Bytes; }
+	};
+
+	namespace BenchDetail
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// Returns the 'p'th percentile (0 to 1) of the sorted values, interpolating linearly between the closest ranks
+		inline double Percentile(const std::vector<double>& sorted, double p)
+		{
+			if (sorted.empty()) return 0;
+
+			double rank = p * (sorted.size() - 1);
+			uint64_t lower = static_cast<uint64_t>(rank);
+			if (lower + 1 >= sorted.size()) return sorted.back();
+
+			return sorted[lower] + (rank - lower) * (sorted[lower + 1] - sorted[lower]);
+		}
+
+		// Parses a byte count with an optional K, M or G (binary) suffix, returning false if it is malformed
+		inline bool ParseSize(const char* text, uint64_t& size)
+		{
+			char* end = nullptr;
+			unsigned long long value = std::strtoull(text, &end, 10);
+			if (end == text) return false;
+
+			switch (*end)
+			{
+			case 'K': case 'k': value <<= 10, ++end; break;
+			case 'M': case 'm': value <<= 20, ++end; break;
+			case 'G': case 'g': value <<= 30, ++end; break;
+			}
+
+			if (*end != '\0') return false;
+			size = value;
+			return true;
+		}
+
+		// Parses a plain decimal count (digits only, no sign or suffix), returning false if it is malformed or overflows
+		inline bool ParseCount(const char* text, uint64_t& count)
+		{
+			uint64_t value = 0;
+			if (*text == '\0') return false;
+
+			for (; *text != '\0'; ++text)
+			{
+				if (*text < '0' || *text > '9' || value > (UINT64_MAX - (*text - '0')) / 10) return false;
+				value = value * 10 + (*text - '0');
+			}
+
+			count = value;
+			return true;
+		}
+
+		// Parses a decimal number, returning false if it is malformed
+		inline bool ParseNumber(const char* text, double& number)
+		{
+			char* end = nullptr;
+			double value = std::strtod(text, &end);
+			if (end == text || *end != '\0') return false;
+
+			number = value;
+			return true;
+		}
+
+		inline std::string EscapeJSON(const std::string& text)
+		{
+			std::string escaped;
+			for (char c : text)
+			{
+				if (c == '"' || c == '\\') escaped += '\\';
+				escaped += c;
+			}
+			return escaped;
+		}
+
+		// Makes the compiler assume 'value' is read and written in memory here, so it must store it beforehand and reload it afterwards
+		template <typename T>
+		inline void DoNotOptimize(T& value)
+		{
+#ifdef _MSC_VER
+			static const void* volatile escaped;
+			escaped = &value;
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : "+m"(value) : : "memory");
+#endif
+		}
+
+		// Makes the compiler assume all memory that has escaped (see DoNotOptimize()) is read and written here
+		inline void ClobberMemory()
+		{
+#ifdef _MSC_VER
+			_ReadWriteBarrier();
+#else
+			asm volatile("" : : : "memory");
+#endif
+		}
+
+		// Makes the compiler assume 'value' is changed here while keeping it in a register, so that a scalar loop can't be vectorised or folded. MSVC has no inline assembly on x64,
+		// so the value is reloaded from memory instead
+		template <typename T>
+		inline void HideValue(T& value)
+		{
+#ifdef _MSC_VER
+			value = *static_cast<volatile T*>(&value);
+#else
+			if constexpr (std::is_floating_point_v<T>) asm volatile("" : "+x"(value));
+			else asm volatile("" : "+r"(value));
+#endif
+		}
+
+		template <typename Function, size_t... I>
+		inline void Unroll(const Function& function, std::index_sequence<I...>) { (function(I), ...); }
+
+		// Returns the name, availability and value of each metric derived from hardware event counts, in the order they are written
+		inline std::vector<std::tuple<const char*, bool, double>> CounterMetrics(const PerfCounters& counters)
+		{
+			bool cycles = counters.IsAvailable(PerfEvent::Cycles);
+			return {
+				{ "ipc", cycles && counters.IsAvailable(PerfEvent::Instructions), counters.IPC() },
+				{ "bytes_per_cycle", cycles, counters.BytesPerCycle() },
+				{ "l1d_misses_per_kb", counters.IsAvailable(PerfEvent::L1DMisses), counters.PerKB(PerfEvent::L1DMisses) },
+				{ "llc_misses_per_kb", counters.IsAvailable(PerfEvent::LLCMisses), counters.PerKB(PerfEvent::LLCMisses) },
+				{ "branch_misses_per_kb", counters.IsAvailable(PerfEvent::BranchMisses), counters.PerKB(PerfEvent::BranchMisses) },
+				{ "level1_license_fraction", cycles && counters.IsAvailable(PerfEvent::Level1License), counters.CycleFraction(PerfEvent::Level1License) },
+				{ "level2_license_fraction", cycles && counters.IsAvailable(PerfEvent::Level2License), counters.CycleFraction(PerfEvent::Level2License) },
+				{ "throttle_fraction", cycles && counters.IsAvailable(PerfEvent::Throttle), counters.CycleFraction(PerfEvent::Throttle) }
+			};
+		}
+	};
+
+	// Sets the statistics of 'result' from its samples
+	inline void Summarise(BenchmarkResult& result)
+	{
+		std::vector<double> sorted = result.Samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		result.MinSeconds = sorted.empty() ? 0 : sorted.front();
+		result.MeanSeconds = 0;
+		for (double sample : sorted) result.MeanSeconds += sample;
+		if (!sorted.empty()) result.MeanSeconds /= sorted.size();
+
+		result.MedianSeconds = BenchDetail::Percentile(sorted, 0.5);
+		result.P95Seconds = BenchDetail::Percentile(sorted, 0.95);
+		result.P99Seconds = BenchDetail::Percentile(sorted, 0.99);
+	}
+
+	// Runs prepare() then run() 'Warmup' times untimed and 'Repetitions' times timed, and returns the timings of run(). prepare() resets the buffers of in-place kernels
+	// and is never timed. 'bytes' and 'elements' are the bytes accessed and elements processed per run, from which throughput is derived. If 'Counters' is set, hardware events
+	// are also counted over each timed run (starting and stopping the counters outside the timed region)
+	template <typename Prepare, typename Run>
+	BenchmarkResult Benchmark(const std::string& kernel, const std::string& variant, uint64_t bytes, uint64_t elements, const BenchmarkOptions& options, const Prepare& prepare, const Run& run)
+	{
+		using BenchDetail::Clock;
+
+		BenchmarkResult result;
+		result.Kernel = kernel, result.Variant = variant, result.Bytes = bytes, result.Elements = elements;
+
+		std::vector<double> cycles;
+		result.Samples.reserve(options.Repetitions), cycles.reserve(options.Repetitions);
+
+		for (uint32_t i = 0; i < options.Warmup; ++i) prepare(), run();
+
+		for (uint32_t i = 0; i < options.Repetitions; ++i)
+		{
+			prepare();
+
+			Clock::time_point start, end;
+			uint64_t startCycles = 0, endCycles = 0;
+			auto timed = [&]
+			{
+				start = Clock::now();
+				startCycles = __rdtsc();
+				run();
+				endCycles = __rdtsc();
+				end = Clock::now();
+			};
+
+			if (options.Counters)
+			{
+				PerfProbe probe(result.Counters, bytes);
+				timed();
+			}
+			else timed();
+
+			result.Samples.push_back(std::chrono::duration<double>(end - start).count());
+			cycles.push_back(static_cast<double>(endCycles - startCycles));
+		}
+
+		Summarise(result);
+		std::sort(cycles.begin(), cycles.end());
+		result.MedianCycles = BenchDetail::Percentile(cycles, 0.5);
+		return result;
+	}
+
+	// Where the vectors an operation updates are kept between operations: in memory (stored and reloaded around every operation, as AVX256 objects over buffers are),
+	// or in registers (when the compiler can keep an AVX256 over a local array in a register)
+	enum class OperationMode { Memory, Register };
+
+	// The cost of an operation on one vector (32 bytes of elements) in time stamp counter cycles, and that of the equivalent scalar loop over the same elements
+	struct OperationResult
+	{
+		std::string Operation, Type;
+		OperationMode Mode = OperationMode::Memory;
+		double Latency = 0; // Per operation when each operation depends on the previous one's result
+		double Throughput = 0; // Reciprocal throughput: per operation when many independent operations are in flight
+		double ScalarLatency = 0, ScalarThroughput = 0;
+		std::vector<double> Samples; // Seconds per operation of each throughput run
+
+		double Speedup() const { return Throughput == 0 ? 0 : ScalarThroughput / Throughput; }
+	};
+
+	namespace BenchDetail
+	{
+		constexpr unsigned CHAINS = 8; // Independent vectors updated in turn when measuring throughput, enough to cover the latency of most operations
+		constexpr uint64_t STEPS = 256; // Operations per vector per run
+		constexpr uint64_t OPERANDS = 16; // Operand vectors cycled through, so that operations can't be folded together
+
+		// Updates CHAINS_ vectors, starting as 'initial', with kernel(vector, operand) STEPS times each
+		template <unsigned CHAINS_, OperationMode MODE, typename T, typename Kernel>
+		void RunChains(const Kernel& kernel, const T* initial, const T* operands)
+		{
+			constexpr uint64_t LANES = 32 / sizeof(T);
+			alignas(32) T values[CHAINS_][LANES];
+
+			for (unsigned chain = 0; chain < CHAINS_; ++chain) std::memcpy(values[chain], initial, 32);
+			if constexpr (MODE == OperationMode::Memory) DoNotOptimize(values);
+
+			for (uint64_t step = 0; step < STEPS; ++step)
+			{
+				const T* operand = operands + step % OPERANDS * LANES;
+				Unroll([&](size_t chain) { kernel(values[chain], operand); }, std::make_index_sequence<CHAINS_>{});
+				if constexpr (MODE == OperationMode::Memory) ClobberMemory();
+			}
+
+			DoNotOptimize(values);
+		}
+
+		// Returns the median cycles per operation of one chain (latency) and of CHAINS independent chains (reciprocal throughput), and sets 'samples' (if given) to the seconds
+		// per operation of each throughput run
+		template <OperationMode MODE, typename T, typename Kernel>
+		std::pair<double, double> MeasureChains(const Kernel& kernel, const T* initial, const T* operands, const BenchmarkOptions& options, std::vector<double>* samples = nullptr)
+		{
+			double latency = Benchmark("", "", 0, 0, options, [] {}, [&] { RunChains<1, MODE>(kernel, initial, operands); }).MedianCycles / STEPS;
+			BenchmarkResult throughput = Benchmark("", "", 0, 0, options, [] {}, [&] { RunChains<CHAINS, MODE>(kernel, initial, operands); });
+
+			if (samples != nullptr)
+			{
+				samples->clear();
+				for (double sample : throughput.Samples) samples->push_back(sample / (STEPS * CHAINS));
+			}
+
+			return { latency, throughput.MedianCycles / (STEPS * CHAINS) };
+		}
+	};
+
+	// Measures the latency and reciprocal throughput of 'kernel' and of the equivalent 'scalar' kernel, in memory and register modes (see OperationMode), and returns a result for each mode.
+	// Each kernel(vector, operand) updates the 32 bytes of 'vector' using the 32 bytes of 'operand', e.g. AVX256<T>{ vector }.Add(operand). Vectors start as 'initial', and operands
+	// are taken in turn from the BenchDetail::OPERANDS vectors of 'operands', which should keep the vectors in a range where the operation runs at full speed (e.g. no denormals)
+	template <typename T, typename Kernel, typename Scalar>
+	std::vector<OperationResult> MeasureOperation(const std::string& operation, const std::string& type, const Kernel& kernel, const Scalar& scalar, const T* initial, const T* operands,
+		const BenchmarkOptions& options)
+	{
+		using namespace BenchDetail;
+
+		OperationResult memory, registers;
+		memory.Operation = registers.Operation = operation, memory.Type = registers.Type = type, registers.Mode = OperationMode::Register;
+
+		std::tie(memory.Latency, memory.Throughput) = MeasureChains<OperationMode::Memory>(kernel, initial, operands, options, &memory.Samples);
+		std::tie(memory.ScalarLatency, memory.ScalarThroughput) = MeasureChains<OperationMode::Memory>(scalar, initial, operands, options);
+		std::tie(registers.Latency, registers.Throughput) = MeasureChains<OperationMode::Register>(kernel, initial, operands, options, &registers.Samples);
+		std::tie(registers.ScalarLatency, registers.ScalarThroughput) = MeasureChains<OperationMode::Register>(scalar, initial, operands, options);
+
+		return { memory, registers };
+	}
+
+	// Writes the command line arguments ParseBenchmarkOptions() accepts
+	inline void WriteBenchmarkUsage(std::ostream& out)
+	{
+		out << "Usage: benchmark [options]\n"
+			"  --size <bytes>[K|M|G]                   Bytes per buffer (default 1920 * 1080 * 3)\n"
+			"  --warmup <runs>                         Untimed runs before timing (default 10)\n"
+			"  --repetitions <runs>                    Timed runs (default 100)\n"
+			"  --suite kernels|operations|roofline     What to benchmark (default kernels)\n"
+			"  --format table|csv|json                 Output format (default table)\n"
+			"  --input <file>                          Fill the input buffers from a file instead of synthetic data\n"
+			"  --output <file>                         Write the results to a file instead of the standard output\n"
+			"  --filter <name>                         Only run the kernels (or operations) matching the name\n"
+			"  --counters on|off                       Count hardware events over the timed runs (default off)\n"
+			"  --save-baseline <file>                  Save the run as a baseline\n"
+			"  --baseline <file>                       Compare the run against a baseline\n"
+			"  --threshold <percent>                   Slowdown above which a significant difference is a regression (default 5)\n"
+			"  --significance <p-value>                P-value below which a difference is significant (default 0.01)\n"
+			"  --help                                  Write this usage and exit\n";
+	}
+
+	// Sets 'options' from the command line arguments, returning false (after writing the error to 'errors') if an argument is unknown or malformed. Arguments are
+	// --size <bytes>[K|M|G], --warmup <runs>, --repetitions <runs>, --suite kernels|operations|roofline, --format table|csv|json, --input <file>, --output <file>, --filter <kernel>,
+	// --counters on|off, --save-baseline <file>, --baseline <file>, --threshold <percent>, --significance <p-value>, and --help (which takes no value and sets options.Help).
+	// Run counts are plain decimal integers
+	inline bool ParseBenchmarkOptions(int argc, const char* const* argv, BenchmarkOptions& options, std::ostream& errors)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string argument = argv[i];
+			if (argument == "--help" || argument == "-h") { options.Help = true; continue; }
+			if (i + 1 == argc) { errors << "Missing value for " << argument << '\n'; return false; }
+
+			const char* value = argv[++i];
+			uint64_t number = 0;
+			bool valid = true;
+
+			if (argument == "--size") valid = BenchDetail::ParseSize(value, options.Size) && options.Size != 0;
+			else if (argument == "--warmup" || argument == "--repetitions")
+			{
+				valid = BenchDetail::ParseCount(value, number) && number <= UINT32_MAX && (number != 0 || argument == "--warmup");
+				(argument == "--warmup" ? options.Warmup : options.Repetitions) = static_cast<uint32_t>(number);
+			}
+			else if (argument == "--input") options.Input = value;
+			else if (argument == "--output") options.Output = value;
+			else if (argument == "--filter") options.Filter = value;
+			else if (argument == "--save-baseline") options.SaveBaseline = value;
+			else if (argument == "--baseline") options.Baseline = value;
+			else if (argument == "--threshold") valid = BenchDetail::ParseNumber(value, options.Threshold) && options.Threshold >= 0;
+			else if (argument == "--significance") valid = BenchDetail::ParseNumber(value, options.Significance) && options.Significance > 0 && options.Significance < 1;
+			else if (argument == "--suite")
+			{
+				std::string suite = value;
+				if (suite == "kernels") options.Suite = BenchmarkSuite::Kernels;
+				else if (suite == "operations") options.Suite = BenchmarkSuite::Operations;
+				else if (suite == "roofline") options.Suite = BenchmarkSuite::Roofline;
+				else valid = false;
+			}
+			else if (argument == "--counters")
+			{
+				std::string counters = value;
+				options.Counters = counters == "on";
+				valid = counters == "on" || counters == "off";
+			}
+			else if (argument == "--format")
+			{
+				std::string format = value;
+				if (format == "table") options.Format = BenchmarkFormat::Table;
+				else if (format == "csv") options.Format = BenchmarkFormat::CSV;
+				else if (format == "json") options.Format = BenchmarkFormat::JSON;
+				else valid = false;
+			}
+			else { errors << "Unknown argument " << argument << '\n'; return false; }
+
+			if (!valid) { errors << "Invalid value " << value << " for " << argument << '\n'; return false; }
+		}
+
+		return true;
+	}
+
+	// Writes one row per result, with a header row. Times are in seconds. Hardware event metrics are left empty where they weren't counted
+	inline void WriteCSV(std::ostream& out, const std::vector<BenchmarkResult>& results)
+	{
+		out << "kernel,variant,bytes,elements,repetitions,min_s,mean_s,median_s,p95_s,p99_s,gb_per_s,elements_per_s,cycles_per_byte";
+		for (const auto& metric : BenchDetail::CounterMetrics(PerfCounters{})) out << ',' << std::get<0>(metric);
+		out << '\n';
+
+		for (const BenchmarkResult& result : results)
+		{
+			out << result.Kernel << ',' << result.Variant << ',' << result.Bytes << ',' << result.Elements << ',' << result.Samples.size() << ',' << std::setprecision(9)
+				<< result.MinSeconds << ',' << result.MeanSeconds << ',' << result.MedianSeconds << ',' << result.P95Seconds << ',' << result.P99Seconds << ','
+				<< result.GBPerSecond() << ',' << result.ElementsPerSecond() << ',' << result.CyclesPerByte();
+
+			for (const auto& metric : BenchDetail::CounterMetrics(result.Counters))
+			{
+				out << ',';
+				if (std::get<1>(metric)) out << std::get<2>(metric);
+			}
+			out << '\n';
+		}
+	}
+
+	// Writes the options of the run and an array of results. Times are in seconds
+	inline void WriteJSON(std::ostream& out, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results)
+	{
+		out << "{\n  \"size\": " << options.Size << ",\n  \"warmup\": " << options.Warmup << ",\n  \"repetitions\": " << options.Repetitions
+			<< ",\n  \"input\": \"" << BenchDetail::EscapeJSON(options.Input) << "\",\n  \"results\": [" << std::setprecision(9);
+
+		for (uint64_t i = 0; i < results.size(); ++i)
+		{
+			const BenchmarkResult& result = results[i];
+			out << (i == 0 ? "\n" : ",\n") << "    { \"kernel\": \"" << BenchDetail::EscapeJSON(result.Kernel) << "\", \"variant\": \"" << BenchDetail::EscapeJSON(result.Variant)
+				<< "\", \"bytes\": " << result.Bytes << ", \"elements\": " << result.Elements << ", \"repetitions\": " << result.Samples.size()
+				<< ", \"min_s\": " << result.MinSeconds << ", \"mean_s\": " << result.MeanSeconds << ", \"median_s\": " << result.MedianSeconds << ", \"p95_s\": " << result.P95Seconds
+				<< ", \"p99_s\": " << result.P99Seconds << ", \"gb_per_s\": " << result.GBPerSecond() << ", \"elements_per_s\": " << result.ElementsPerSecond()
+				<< ", \"cycles_per_byte\": " << result.CyclesPerByte();
+
+			if (result.Counters.Regions != 0)
+			{
+				out << ", \"counters\": {";
+				std::vector<std::tuple<const char*, bool, double>> metrics = BenchDetail::CounterMetrics(result.Counters);
+				for (uint64_t j = 0; j < metrics.size(); ++j)
+				{
+					out << (j == 0 ? " \"" : ", \"") << std::get<0>(metrics[j]) << "\": ";
+					if (std::get<1>(metrics[j])) out << std::get<2>(metrics[j]);
+					else out << "null";
+				}
+				out << " }";
+			}
+			out << " }";
+		}
+
+		out << "\n  ]\n}\n";
+	}
+
+	// Writes an aligned table for reading in a terminal. Times are in microseconds. If hardware events were counted, IPC, bytes per core cycle and L1D and LLC misses per KB
+	// are added, with "-" where an event wasn't available
+	inline void WriteTable(std::ostream& out, const std::vector<BenchmarkResult>& results)
+	{
+		bool counters = std::any_of(results.begin(), results.end(), [](const BenchmarkResult& result) { return result.Counters.Regions != 0; });
+
+		out << std::left << std::setw(14) << "Kernel" << std::setw(10) << "Variant" << std::right << std::setw(12) << "Median us" << std::setw(12) << "P95 us" << std::setw(12) << "P99 us"
+			<< std::setw(10) << "GB/s" << std::setw(14) << "Melements/s" << std::setw(12) << "Cycles/B";
+		if (counters) out << std::setw(8) << "IPC" << std::setw(10) << "B/cycle" << std::setw(12) << "L1D miss/KB" << std::setw(12) << "LLC miss/KB";
+		out << '\n' << std::fixed;
+
+		for (const BenchmarkResult& result : results)
+		{
+			out << std::left << std::setw(14) << result.Kernel << std::setw(10) << result.Variant << std::right << std::setprecision(1)
+				<< std::setw(12) << result.MedianSeconds * 1e6 << std::setw(12) << result.P95Seconds * 1e6 << std::setw(12) << result.P99Seconds * 1e6 << std::setprecision(2)
+				<< std::setw(10) << result.GBPerSecond() << std::setw(14) << result.ElementsPerSecond() / 1e6 << std::setprecision(3) << std::setw(12) << result.CyclesPerByte();
+
+			if (counters)
+			{
+				std::vector<std::tuple<const char*, bool, double>> metrics = BenchDetail::CounterMetrics(result.Counters);
+				const int widths[] = { 8, 10, 12, 12 };
+				for (int i = 0; i < 4; ++i)
+				{
+					out << std::setw(widths[i]);
+					if (std::get<1>(metrics[i])) out << std::get<2>(metrics[i]);
+					else out << '-';
+				}
+			}
+			out << '\n';
+		}
+
+		out << std::defaultfloat;
+	}
+
+	// Writes one row per operation, type and mode, with a header row. Costs are in cycles per vector
+	inline void WriteCSV(std::ostream& out, const std::vector<OperationResult>& results)
+	{
+		out << "operation,type,mode,latency,throughput,scalar_latency,scalar_throughput,speedup\n" << std::setprecision(6);
+
+		for (const OperationResult& result : results)
+			out << result.Operation << ',' << result.Type << ',' << (result.Mode == OperationMode::Memory ? "memory" : "register") << ',' << result.Latency << ',' << result.Throughput << ','
+				<< result.ScalarLatency << ',' << result.ScalarThroughput << ',' << result.Speedup() << '\n';
+	}
+
+	// Writes the options of the run and an array of operation results. Costs are in cycles per vector
+	inline void WriteJSON(std::ostream& out, const BenchmarkOptions& options, const std::vector<OperationResult>& results)
+	{
+		out << "{\n  \"warmup\": " << options.Warmup << ",\n  \"repetitions\": " << options.Repetitions << ",\n  \"operations\": [" << std::setprecision(6);
+
+		for (uint64_t i = 0; i < results.size(); ++i)
+		{
+			const OperationResult& result = results[i];
+			out << (i == 0 ? "\n" : ",\n") << "    { \"operation\": \"" << BenchDetail::EscapeJSON(result.Operation) << "\", \"type\": \"" << result.Type << "\", \"mode\": \""
+				<< (result.Mode == OperationMode::Memory ? "memory" : "register") << "\", \"latency\": " << result.Latency << ", \"throughput\": " << result.Throughput
+				<< ", \"scalar_latency\": " << result.ScalarLatency << ", \"scalar_throughput\": " << result.ScalarThroughput << ", \"speedup\": " << result.Speedup() << " }";
+		}
+
+		out << "\n  ]\n}\n";
+	}
+
+	// Writes a Markdown table of the operation results, marking the operations that are slower than their scalar equivalent. Costs are in cycles per vector
+	inline void WriteTable(std::ostream& out, const std::vector<OperationResult>& results)
+	{
+		out << "| Operation | Type | Mode | Latency | Throughput | Scalar latency | Scalar throughput | Speedup |\n|---|---|---|--:|--:|--:|--:|--:|\n" << std::fixed;
+
+		for (const OperationResult& result : results)
+			out << "| " << result.Operation << " | " << result.Type << " | " << (result.Mode == OperationMode::Memory ? "Memory" : "Register") << " | " << std::setprecision(2)
+				<< result.Latency << " | " << result.Throughput << " | " << result.ScalarLatency << " | " << result.ScalarThroughput << " | " << result.Speedup() << 'x'
+				<< (result.Speedup() < 1 ? " (slower than scalar)" : "") << " |\n";
+
+		out << std::defaultfloat;
+	}
+};
+
+#endif
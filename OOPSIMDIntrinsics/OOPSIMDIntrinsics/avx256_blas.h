@@ -0,0 +1,412 @@
+#ifndef AVX256_BLAS_H
+#define AVX256_BLAS_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	namespace BlasDetail
+	{
+		template <typename T> struct VectorOf;
+		template <> struct VectorOf<float> { using Type = __m256; };
+		template <> struct VectorOf<double> { using Type = __m256d; };
+
+		template <typename T>
+		using Vector = typename VectorOf<T>::Type;
+
+		template <typename T>
+		constexpr int WIDTH = 32 / sizeof(T);
+
+		template <typename T>
+		Vector<T> Load(const T* data)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_loadu_ps(data);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_loadu_pd(data);
+		}
+
+		template <typename T>
+		void Store(T* data, Vector<T> v)
+		{
+			if constexpr (std::is_same_v<T, float>) _mm256_storeu_ps(data, v);
+			else if constexpr (std::is_same_v<T, double>) _mm256_storeu_pd(data, v);
+		}
+
+		template <typename T>
+		Vector<T> Broadcast(T value)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_set1_ps(value);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_set1_pd(value);
+		}
+
+		template <typename T>
+		Vector<T> Zero()
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_setzero_ps();
+			else if constexpr (std::is_same_v<T, double>) return _mm256_setzero_pd();
+		}
+
+		template <typename T>
+		Vector<T> Add(Vector<T> a, Vector<T> b)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_add_ps(a, b);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_add_pd(a, b);
+		}
+
+		template <typename T>
+		Vector<T> Mul(Vector<T> a, Vector<T> b)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_mul_ps(a, b);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_mul_pd(a, b);
+		}
+
+		// Returns a * b + c
+		template <typename T>
+		Vector<T> FMA(Vector<T> a, Vector<T> b, Vector<T> c)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_fmadd_ps(a, b, c);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_fmadd_pd(a, b, c);
+		}
+
+		template <typename T>
+		T HorizontalSum(Vector<T> v)
+		{
+			if constexpr (std::is_same_v<T, float>)
+			{
+				__m128 sums = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+				sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+				return _mm_cvtss_f32(_mm_add_ss(sums, _mm_movehdup_ps(sums)));
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				__m128d sums = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+				return _mm_cvtsd_f64(_mm_add_sd(sums, _mm_unpackhi_pd(sums, sums)));
+			}
+		}
+
+		template <typename T>
+		void CheckType() { static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "AVX256: BLAS kernels are only available for float and double"); }
+
+		// GEMM blocking: an MR x NR block of C is held in 12 registers by the micro-kernel, a KC x NR panel of B stays in L1, an MC x KC block of A in L2, and a KC x NC block of B in L3
+		inline constexpr int64_t MR = 6, KC = 256, MC = 120, NC = 3072;
+
+		template <typename T>
+		constexpr int64_t NR = 2 * WIDTH<T>;
+
+		// Packs the mc x kc block of A at 'a' into panels of MR rows, each stored column by column (i.e. MR consecutive elements per k). Rows beyond mc are zero-padded
+		template <typename T>
+		void PackA(const T* a, int64_t lda, int64_t mc, int64_t kc, T* packed)
+		{
+			for (int64_t i = 0; i < mc; i += MR)
+			{
+				int64_t rows = std::min(MR, mc - i);
+
+				for (int64_t k = 0; k < kc; ++k, packed += MR)
+				{
+					for (int64_t r = 0; r < rows; ++r) packed[r] = a[(i + r) * lda + k];
+					for (int64_t r = rows; r < MR; ++r) packed[r] = 0;
+				}
+			}
+		}
+
+		// Packs the kc x nc block of B at 'b' into panels of NR columns, each stored row by row (i.e. NR consecutive elements per k). Columns beyond nc are zero-padded
+		template <typename T>
+		void PackB(const T* b, int64_t ldb, int64_t kc, int64_t nc, T* packed)
+		{
+			for (int64_t j = 0; j < nc; j += NR<T>)
+			{
+				int64_t columns = std::min(NR<T>, nc - j);
+
+				for (int64_t k = 0; k < kc; ++k, packed += NR<T>)
+				{
+					const T* row = b + k * ldb + j;
+
+					if (columns == NR<T>) Store<T>(packed, Load<T>(row)), Store<T>(packed + WIDTH<T>, Load<T>(row + WIDTH<T>));
+					else
+					{
+						for (int64_t c = 0; c < columns; ++c) packed[c] = row[c];
+						for (int64_t c = columns; c < NR<T>; ++c) packed[c] = 0;
+					}
+				}
+			}
+		}
+
+		// Computes the MR x NR block c = alpha * (packedA * packedB) + beta * c, accumulating in 12 registers with one FMA per register per k. C is not read if beta is 0
+		template <typename T>
+		void MicroKernel(int64_t kc, const T* packedA, const T* packedB, T* c, int64_t ldc, T alpha, T beta)
+		{
+			constexpr int W = WIDTH<T>;
+			Vector<T> c00 = Zero<T>(), c01 = Zero<T>(), c10 = Zero<T>(), c11 = Zero<T>(), c20 = Zero<T>(), c21 = Zero<T>();
+			Vector<T> c30 = Zero<T>(), c31 = Zero<T>(), c40 = Zero<T>(), c41 = Zero<T>(), c50 = Zero<T>(), c51 = Zero<T>();
+
+			for (int64_t k = 0; k < kc; ++k, packedA += MR, packedB += 2 * W)
+			{
+				Vector<T> b0 = Load<T>(packedB), b1 = Load<T>(packedB + W), a;
+
+				a = Broadcast<T>(packedA[0]), c00 = FMA<T>(a, b0, c00), c01 = FMA<T>(a, b1, c01);
+				a = Broadcast<T>(packedA[1]), c10 = FMA<T>(a, b0, c10), c11 = FMA<T>(a, b1, c11);
+				a = Broadcast<T>(packedA[2]), c20 = FMA<T>(a, b0, c20), c21 = FMA<T>(a, b1, c21);
+				a = Broadcast<T>(packedA[3]), c30 = FMA<T>(a, b0, c30), c31 = FMA<T>(a, b1, c31);
+				a = Broadcast<T>(packedA[4]), c40 = FMA<T>(a, b0, c40), c41 = FMA<T>(a, b1, c41);
+				a = Broadcast<T>(packedA[5]), c50 = FMA<T>(a, b0, c50), c51 = FMA<T>(a, b1, c51);
+			}
+
+			Vector<T> accumulators[MR][2] = { { c00, c01 }, { c10, c11 }, { c20, c21 }, { c30, c31 }, { c40, c41 }, { c50, c51 } };
+			Vector<T> alphas = Broadcast<T>(alpha), betas = Broadcast<T>(beta);
+
+			for (int64_t r = 0; r < MR; ++r, c += ldc)
+			{
+				for (int h = 0; h < 2; ++h)
+				{
+					Vector<T> result = Mul<T>(alphas, accumulators[r][h]);
+					if (beta != 0) result = FMA<T>(betas, Load<T>(c + h * W), result);
+					Store<T>(c + h * W, result);
+				}
+			}
+		}
+
+		// Serial packed GEMM: C = alpha * A * B + beta * C for row-major m x k A, k x n B, and m x n C
+		template <typename T>
+		void Gemm(int64_t m, int64_t n, int64_t k, T alpha, const T* a, int64_t lda, const T* b, int64_t ldb, T beta, T* c, int64_t ldc)
+		{
+			std::vector<T> packedA(MC * KC), packedB(KC * ((std::min(NC, n) + NR<T> - 1) / NR<T>) * NR<T>);
+			T edge[MR * NR<T>];
+
+			for (int64_t jc = 0; jc < n; jc += NC)
+			{
+				int64_t nc = std::min(NC, n - jc);
+
+				for (int64_t pc = 0; pc < k; pc += KC)
+				{
+					int64_t kc = std::min(KC, k - pc);
+					T blockBeta = pc == 0 ? beta : 1; // Later K blocks accumulate into C
+
+					PackB(b + pc * ldb + jc, ldb, kc, nc, packedB.data());
+
+					for (int64_t ic = 0; ic < m; ic += MC)
+					{
+						int64_t mc = std::min(MC, m - ic);
+						PackA(a + ic * lda + pc, lda, mc, kc, packedA.data());
+
+						for (int64_t jr = 0; jr < nc; jr += NR<T>)
+						{
+							for (int64_t ir = 0; ir < mc; ir += MR)
+							{
+								int64_t rows = std::min(MR, mc - ir), columns = std::min(NR<T>, nc - jr);
+								T* block = c + (ic + ir) * ldc + jc + jr;
+
+								if (rows == MR && columns == NR<T>) MicroKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc, block, ldc, alpha, blockBeta);
+								else // Partial blocks are computed into a temporary block, then only their valid elements are written to C
+								{
+									MicroKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc, edge, NR<T>, static_cast<T>(1), static_cast<T>(0));
+
+									for (int64_t r = 0; r < rows; ++r)
+										for (int64_t col = 0; col < columns; ++col)
+											block[r * ldc + col] = alpha * edge[r * NR<T> + col] + (blockBeta == 0 ? 0 : blockBeta * block[r * ldc + col]);
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+	};
+
+	// Returns the dot product of the first 'count' elements of x and y, accumulated in 4 independent registers with FMA. Available for float and double only
+	template <typename T>
+	T Dot(const T* x, const T* y, uint64_t count)
+	{
+		using namespace BlasDetail;
+		CheckType<T>();
+		constexpr int W = WIDTH<T>;
+
+		Vector<T> sums0 = Zero<T>(), sums1 = Zero<T>(), sums2 = Zero<T>(), sums3 = Zero<T>();
+		uint64_t i = 0;
+
+		for (; i + 4 * W <= count; i += 4 * W)
+		{
+			sums0 = FMA<T>(Load<T>(x + i), Load<T>(y + i), sums0);
+			sums1 = FMA<T>(Load<T>(x + i + W), Load<T>(y + i + W), sums1);
+			sums2 = FMA<T>(Load<T>(x + i + 2 * W), Load<T>(y + i + 2 * W), sums2);
+			sums3 = FMA<T>(Load<T>(x + i + 3 * W), Load<T>(y + i + 3 * W), sums3);
+		}
+
+		for (; i + W <= count; i += W)
+			sums0 = FMA<T>(Load<T>(x + i), Load<T>(y + i), sums0);
+
+		T result = HorizontalSum<T>(Add<T>(Add<T>(sums0, sums1), Add<T>(sums2, sums3)));
+
+		for (; i < count; ++i)
+			result += x[i] * y[i];
+
+		return result;
+	}
+
+	// Computes y = alpha * x + y for the first 'count' elements of x and y. Available for float and double only
+	template <typename T>
+	void Axpy(uint64_t count, T alpha, const T* x, T* y)
+	{
+		using namespace BlasDetail;
+		CheckType<T>();
+		constexpr int W = WIDTH<T>;
+
+		Vector<T> alphas = Broadcast<T>(alpha);
+		uint64_t i = 0;
+
+		for (; i + 2 * W <= count; i += 2 * W)
+		{
+			Store<T>(y + i, FMA<T>(alphas, Load<T>(x + i), Load<T>(y + i)));
+			Store<T>(y + i + W, FMA<T>(alphas, Load<T>(x + i + W), Load<T>(y + i + W)));
+		}
+
+		for (; i + W <= count; i += W)
+			Store<T>(y + i, FMA<T>(alphas, Load<T>(x + i), Load<T>(y + i)));
+
+		for (; i < count; ++i)
+			y[i] += alpha * x[i];
+	}
+
+	// Returns the Euclidean norm of the first 'count' elements of x. Floats are squared and accumulated in double precision, so cannot overflow.
+	// Doubles are accumulated directly, and only re-accumulated after scaling by the largest magnitude if the sum overflows or underflows
+	template <typename T>
+	T Nrm2(const T* x, uint64_t count)
+	{
+		using namespace BlasDetail;
+		CheckType<T>();
+		uint64_t i = 0;
+
+		if constexpr (std::is_same_v<T, float>)
+		{
+			__m256d sums0 = _mm256_setzero_pd(), sums1 = _mm256_setzero_pd();
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 values = _mm256_loadu_ps(x + i);
+				__m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(values)), high = _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1));
+				sums0 = _mm256_fmadd_pd(low, low, sums0);
+				sums1 = _mm256_fmadd_pd(high, high, sums1);
+			}
+
+			double sum = HorizontalSum<double>(_mm256_add_pd(sums0, sums1));
+			for (; i < count; ++i) sum += static_cast<double>(x[i]) * x[i];
+
+			return static_cast<float>(std::sqrt(sum));
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			double sum = Dot(x, x, count);
+			if (sum > std::numeric_limits<double>::min() && sum < std::numeric_limits<double>::infinity()) return std::sqrt(sum);
+
+			// _mm256_max_pd returns its second operand if either is NaN, so NaNs are ORed in to keep them in the maxima
+			__m256d maxima = _mm256_setzero_pd(), absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256d values = _mm256_loadu_pd(x + i);
+				maxima = _mm256_or_pd(_mm256_max_pd(_mm256_and_pd(values, absMask), maxima), _mm256_cmp_pd(values, values, _CMP_UNORD_Q));
+			}
+
+			double maximums[4], maximum = 0;
+			bool isNaN = false;
+			_mm256_storeu_pd(maximums, maxima);
+			for (double value : maximums) maximum = std::max(maximum, value), isNaN |= std::isnan(value);
+			for (; i < count; ++i) maximum = std::max(maximum, std::abs(x[i])), isNaN |= std::isnan(x[i]);
+
+			if (isNaN) return std::numeric_limits<double>::quiet_NaN();
+			if (maximum == 0 || std::isinf(maximum)) return maximum;
+
+			__m256d scale = _mm256_set1_pd(1 / maximum), sums = _mm256_setzero_pd();
+			for (i = 0; i + 4 <= count; i += 4)
+			{
+				__m256d scaled = _mm256_mul_pd(_mm256_loadu_pd(x + i), scale);
+				sums = _mm256_fmadd_pd(scaled, scaled, sums);
+			}
+
+			double scaledSum = HorizontalSum<double>(sums);
+			for (; i < count; ++i) scaledSum += (x[i] / maximum) * (x[i] / maximum);
+
+			return maximum * std::sqrt(scaledSum);
+		}
+	}
+
+	// Computes y = alpha * A * x + beta * y for the row-major rows x columns matrix A (with a stride of lda elements between rows). y is not read if beta is 0.
+	// Four rows are processed at a time so that each load of x is shared by four FMAs
+	template <typename T>
+	void Gemv(uint64_t rows, uint64_t columns, T alpha, const T* a, uint64_t lda, const T* x, T beta, T* y)
+	{
+		using namespace BlasDetail;
+		CheckType<T>();
+		constexpr int W = WIDTH<T>;
+		uint64_t r = 0;
+
+		for (; r + 4 <= rows; r += 4)
+		{
+			const T* row0 = a + r * lda, * row1 = row0 + lda, * row2 = row1 + lda, * row3 = row2 + lda;
+			Vector<T> sums0 = Zero<T>(), sums1 = Zero<T>(), sums2 = Zero<T>(), sums3 = Zero<T>();
+			uint64_t j = 0;
+
+			for (; j + W <= columns; j += W)
+			{
+				Vector<T> xs = Load<T>(x + j);
+				sums0 = FMA<T>(Load<T>(row0 + j), xs, sums0);
+				sums1 = FMA<T>(Load<T>(row1 + j), xs, sums1);
+				sums2 = FMA<T>(Load<T>(row2 + j), xs, sums2);
+				sums3 = FMA<T>(Load<T>(row3 + j), xs, sums3);
+			}
+
+			T dots[4] = { HorizontalSum<T>(sums0), HorizontalSum<T>(sums1), HorizontalSum<T>(sums2), HorizontalSum<T>(sums3) };
+
+			for (; j < columns; ++j)
+				dots[0] += row0[j] * x[j], dots[1] += row1[j] * x[j], dots[2] += row2[j] * x[j], dots[3] += row3[j] * x[j];
+
+			for (int i = 0; i < 4; ++i)
+				y[r + i] = alpha * dots[i] + (beta == 0 ? 0 : beta * y[r + i]);
+		}
+
+		for (; r < rows; ++r)
+			y[r] = alpha * Dot(a + r * lda, x, columns) + (beta == 0 ? 0 : beta * y[r]);
+	}
+
+	// Computes C = alpha * A * B + beta * C for the row-major m x k matrix A, k x n matrix B, and m x n matrix C (with strides of lda, ldb, and ldc elements between rows). C is not read if beta is 0.
+	// A and B are packed into cache-sized blocks and multiplied with a 6 x 16 (float) or 6 x 8 (double) FMA register-blocked micro-kernel.
+	// If threads > 1, the rows of C are split between that many threads (threads < 1 runs on the calling thread)
+	template <typename T>
+	void Gemm(uint64_t m, uint64_t n, uint64_t k, T alpha, const T* a, uint64_t lda, const T* b, uint64_t ldb, T beta, T* c, uint64_t ldc, int threads = 1)
+	{
+		using namespace BlasDetail;
+		CheckType<T>();
+
+		if (m == 0 || n == 0) return;
+
+		if (k == 0 || alpha == 0)
+		{
+			for (uint64_t i = 0; i < m; ++i)
+				for (uint64_t j = 0; j < n; ++j)
+					c[i * ldc + j] = beta == 0 ? 0 : beta * c[i * ldc + j];
+			return;
+		}
+
+		threads = std::max(threads, 1);
+		uint64_t rowsPerThread = ((m + threads - 1) / threads + MR - 1) / MR * MR; // Whole micro-kernel blocks per thread
+
+		if (rowsPerThread >= m)
+		{
+			BlasDetail::Gemm<T>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+			return;
+		}
+
+		std::vector<std::thread> workers;
+		for (uint64_t row = 0; row < m; row += rowsPerThread)
+			workers.emplace_back(BlasDetail::Gemm<T>, std::min(rowsPerThread, m - row), n, k, alpha, a + row * lda, lda, b, ldb, beta, c + row * ldc, ldc);
+
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+};
+
+#endif
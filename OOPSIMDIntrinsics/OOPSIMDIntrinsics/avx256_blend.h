@@ -0,0 +1,256 @@
+#ifndef AVX256_BLEND_H
+#define AVX256_BLEND_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	namespace BlendDetail
+	{
+		template <typename T>
+		void CheckType() { static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>, "AVX256: Blending is only available for uint8_t and uint16_t"); }
+
+		// The number of fractional bits of per-call blend weights: 8.8 fixed point for uint8_t, and 1.15 fixed point for uint16_t (so that pixel * weight fits in 32 bits)
+		template <typename T>
+		constexpr int WEIGHT_BITS = std::is_same_v<T, uint8_t> ? 8 : 15;
+
+		// Returns alpha (clamped to [0, 1]) in fixed point with WEIGHT_BITS fractional bits
+		template <typename T>
+		int32_t Weight(float alpha) { return static_cast<int32_t>(std::lround(std::clamp(alpha, 0.0f, 1.0f) * (1 << WEIGHT_BITS<T>))); }
+
+		// Returns round(a * weight + b * (one - weight)) for the fixed-point weight
+		template <typename T>
+		T Blend(T a, T b, int32_t weight) { return static_cast<T>((a * weight + b * ((1 << WEIGHT_BITS<T>) - weight) + (1 << (WEIGHT_BITS<T> - 1))) >> WEIGHT_BITS<T>); }
+
+		// Returns round(a * alpha + b * (max - alpha)) / max), where max is the largest value of T
+		template <typename T>
+		T BlendAlpha(T a, T b, T alpha)
+		{
+			constexpr uint64_t MAX = std::numeric_limits<T>::max();
+			return static_cast<T>((a * static_cast<uint64_t>(alpha) + b * (MAX - alpha) + MAX / 2) / MAX);
+		}
+
+		// Returns round(x / 255) for the 16-bit unsigned integers x in [0, 255 * 255]
+		inline __m256i Divide255(__m256i x)
+		{
+			x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+			return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+		}
+
+		// Returns round(x / 65535) for the 32-bit unsigned integers x in [0, 65535 * 65535]
+		inline __m256i Divide65535(__m256i x)
+		{
+			x = _mm256_add_epi32(x, _mm256_set1_epi32(32768));
+			return _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(x, 16)), 16);
+		}
+
+		// Shuffle masks that expand the alphas of consecutive pixels (loaded into both lanes) into the alpha of each element of a vector of interleaved channels,
+		// for each possible channel offset of the vector's first element
+		template <typename T>
+		std::vector<std::array<int8_t, 32>> AlphaMasks(int channels)
+		{
+			constexpr int ELEMENTS = 32 / sizeof(T);
+			std::vector<std::array<int8_t, 32>> masks(channels);
+
+			for (int offset = 0; offset < channels; ++offset)
+				for (int i = 0; i < ELEMENTS; ++i)
+					for (int byte = 0; byte < static_cast<int>(sizeof(T)); ++byte)
+						masks[offset][i * sizeof(T) + byte] = static_cast<int8_t>((offset + i) / channels * sizeof(T) + byte);
+
+			return masks;
+		}
+	};
+
+	// Blends a and b into 'out' as out = alpha * a + (1 - alpha) * b, rounded to the nearest integer. 'out' may be a or b.
+	// uint8_t: alpha is converted to 8.8 fixed point, and b + (a - b) * alpha is computed with _mm256_mulhrs_epi16, which rounds exactly like the scalar (a * alpha + b * (256 - alpha) + 128) >> 8.
+	// uint16_t: alpha is converted to 1.15 fixed point, and the interleaved pixel pairs are multiplied by (alpha, 1 - alpha) with _mm256_madd_epi16
+	template <typename T>
+	void Blend(const T* a, const T* b, T* out, uint64_t count, float alpha)
+	{
+		using namespace BlendDetail;
+		CheckType<T>();
+
+		int32_t weight = Weight<T>(alpha);
+		constexpr uint64_t ELEMENTS = 32 / sizeof(T);
+		uint64_t i = 0;
+
+		if constexpr (std::is_same_v<T, uint8_t>)
+		{
+			__m256i weights = _mm256_set1_epi16(static_cast<int16_t>(weight)), zero = _mm256_setzero_si256();
+
+			for (; i + ELEMENTS <= count; i += ELEMENTS)
+			{
+				__m256i pixelsA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), pixelsB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+				__m256i lowB = _mm256_unpacklo_epi8(pixelsB, zero), highB = _mm256_unpackhi_epi8(pixelsB, zero);
+
+				// ((a - b) * 128 * weight + 2^14) >> 15 == ((a - b) * weight + 128) >> 8, and (a - b) * 128 fits in an int16
+				__m256i low = _mm256_add_epi16(lowB, _mm256_mulhrs_epi16(_mm256_slli_epi16(_mm256_sub_epi16(_mm256_unpacklo_epi8(pixelsA, zero), lowB), 7), weights));
+				__m256i high = _mm256_add_epi16(highB, _mm256_mulhrs_epi16(_mm256_slli_epi16(_mm256_sub_epi16(_mm256_unpackhi_epi8(pixelsA, zero), highB), 7), weights));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_packus_epi16(low, high));
+			}
+		}
+		else if constexpr (std::is_same_v<T, uint16_t>)
+		{
+			if (weight == 0 || weight == 1 << WEIGHT_BITS<T>) // The complementary weight would not fit in an int16
+			{
+				std::copy(weight == 0 ? b : a, (weight == 0 ? b : a) + count, out);
+				return;
+			}
+
+			// Pixels are offset by -32768 to fit in an int16, which offsets each weighted sum by -32768 * 32768
+			__m256i weights = _mm256_set1_epi32(static_cast<int32_t>((((1 << WEIGHT_BITS<T>) - weight) << 16) | weight)), signBit = _mm256_set1_epi16(static_cast<int16_t>(0x8000));
+			__m256i rounding = _mm256_set1_epi32(1 << (WEIGHT_BITS<T> - 1)), offset = _mm256_set1_epi32(32768);
+
+			for (; i + ELEMENTS <= count; i += ELEMENTS)
+			{
+				__m256i pixelsA = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), signBit);
+				__m256i pixelsB = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), signBit);
+
+				__m256i low = _mm256_madd_epi16(_mm256_unpacklo_epi16(pixelsA, pixelsB), weights), high = _mm256_madd_epi16(_mm256_unpackhi_epi16(pixelsA, pixelsB), weights);
+				low = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(low, rounding), WEIGHT_BITS<T>), offset);
+				high = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(high, rounding), WEIGHT_BITS<T>), offset);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_packus_epi32(low, high));
+			}
+		}
+
+		for (; i < count; ++i)
+			out[i] = BlendDetail::Blend<T>(a[i], b[i], weight);
+	}
+
+	// Blends a and b into 'out' using a per-pixel alpha plane, as out = (a * alpha + b * (max - alpha)) / max rounded to the nearest integer, where max is 255 (uint8_t) or 65535 (uint16_t).
+	// The images have 'channels' interleaved channels per pixel, each of which is weighted by its pixel's alpha (alpha vectors are expanded to channels with a shuffle). 'out' may be a or b.
+	// uint8_t: the interleaved weights (alpha, 255 - alpha) and pixel pairs are multiplied with _mm256_maddubs_epi16. uint16_t: the pixels are weighted with _mm256_mullo_epi32
+	template <typename T>
+	void BlendAlpha(const T* a, const T* b, const T* alpha, T* out, uint64_t pixels, int channels = 1)
+	{
+		using namespace BlendDetail;
+		CheckType<T>();
+
+		constexpr uint64_t ELEMENTS = 32 / sizeof(T);
+		std::vector<std::array<int8_t, 32>> masks = channels > 1 ? AlphaMasks<T>(channels) : std::vector<std::array<int8_t, 32>>{};
+		uint64_t count = pixels * channels, i = 0;
+
+		for (; i + ELEMENTS <= count; i += ELEMENTS)
+		{
+			__m256i alphas;
+
+			if (channels == 1) alphas = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(alpha + i));
+			else
+			{
+				if (i / channels + 16 / sizeof(T) > pixels) break; // The 16 bytes of alphas loaded would extend past the alpha plane
+				alphas = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + i / channels))), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks[i % channels].data())));
+			}
+
+			__m256i pixelsA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), pixelsB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+
+			if constexpr (std::is_same_v<T, uint8_t>)
+			{
+				// Pixels are offset by -128 to be used as maddubs' signed operand, which offsets each weighted sum by -128 * 255 (fitting in an int16).
+				// Adding 32768 instead of 128 * 255 also adds the 128 that Divide255() would round with, so the sum is divided directly
+				__m256i signBit = _mm256_set1_epi8(static_cast<char>(0x80)), complements = _mm256_xor_si256(alphas, _mm256_set1_epi8(static_cast<char>(0xFF)));
+				pixelsA = _mm256_xor_si256(pixelsA, signBit), pixelsB = _mm256_xor_si256(pixelsB, signBit);
+
+				__m256i low = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(alphas, complements), _mm256_unpacklo_epi8(pixelsA, pixelsB));
+				__m256i high = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(alphas, complements), _mm256_unpackhi_epi8(pixelsA, pixelsB));
+
+				low = _mm256_xor_si256(low, _mm256_set1_epi16(static_cast<int16_t>(0x8000)));
+				high = _mm256_xor_si256(high, _mm256_set1_epi16(static_cast<int16_t>(0x8000)));
+				low = _mm256_srli_epi16(_mm256_add_epi16(low, _mm256_srli_epi16(low, 8)), 8);
+				high = _mm256_srli_epi16(_mm256_add_epi16(high, _mm256_srli_epi16(high, 8)), 8);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_packus_epi16(low, high));
+			}
+			else if constexpr (std::is_same_v<T, uint16_t>)
+			{
+				__m256i complements = _mm256_xor_si256(alphas, _mm256_set1_epi16(static_cast<int16_t>(0xFFFF))), result[2];
+
+				for (int half = 0; half < 2; ++half) // a * alpha + b * (65535 - alpha) fits in a uint32
+				{
+					auto widen = [half](__m256i v) { return _mm256_cvtepu16_epi32(half == 0 ? _mm256_castsi256_si128(v) : _mm256_extracti128_si256(v, 1)); };
+					result[half] = Divide65535(_mm256_add_epi32(_mm256_mullo_epi32(widen(pixelsA), widen(alphas)), _mm256_mullo_epi32(widen(pixelsB), widen(complements))));
+				}
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(_mm256_packus_epi32(result[0], result[1]), 0b11011000));
+			}
+		}
+
+		for (; i < count; ++i)
+			out[i] = BlendDetail::BlendAlpha<T>(a[i], b[i], alpha[i / channels]);
+	}
+
+	// Composites the premultiplied RGBA pixels of 'src' over those of 'dst' in place, as dst = src + dst * (255 - srcAlpha) / 255 rounded to the nearest integer (for all four channels).
+	// 8 pixels are composited at a time, with each source alpha broadcast to its pixel's channels by a shuffle
+	inline void CompositeOver(const uint8_t* src, uint8_t* dst, uint64_t pixels)
+	{
+		const __m256i broadcastAlpha = _mm256_setr_epi8(
+			3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+			3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15
+		);
+		__m256i zero = _mm256_setzero_si256(), ones = _mm256_set1_epi8(static_cast<char>(0xFF));
+		uint64_t i = 0;
+
+		for (; i + 8 <= pixels; i += 8)
+		{
+			__m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4)), destination = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i * 4));
+			__m256i transparency = _mm256_xor_si256(_mm256_shuffle_epi8(source, broadcastAlpha), ones);
+
+			__m256i low = BlendDetail::Divide255(_mm256_mullo_epi16(_mm256_unpacklo_epi8(destination, zero), _mm256_unpacklo_epi8(transparency, zero)));
+			__m256i high = BlendDetail::Divide255(_mm256_mullo_epi16(_mm256_unpackhi_epi8(destination, zero), _mm256_unpackhi_epi8(transparency, zero)));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_adds_epu8(source, _mm256_packus_epi16(low, high)));
+		}
+
+		for (; i < pixels; ++i)
+			for (int c = 0; c < 4; ++c)
+			{
+				int x = dst[i * 4 + c] * (255 - src[i * 4 + 3]) + 128;
+				dst[i * 4 + c] = static_cast<uint8_t>(std::min(src[i * 4 + c] + ((x + (x >> 8)) >> 8), 255));
+			}
+	}
+
+	// Premultiplies the colour channels of the RGBA pixels by their alpha, as out = colour * alpha / 255 rounded to the nearest integer (alpha is unchanged). 'out' may be 'rgba'
+	inline void Premultiply(const uint8_t* rgba, uint8_t* out, uint64_t pixels)
+	{
+		const __m256i broadcastAlpha = _mm256_setr_epi8(
+			3, 3, 3, -1, 7, 7, 7, -1, 11, 11, 11, -1, 15, 15, 15, -1,
+			3, 3, 3, -1, 7, 7, 7, -1, 11, 11, 11, -1, 15, 15, 15, -1
+		);
+		__m256i zero = _mm256_setzero_si256(), alphaChannels = _mm256_set1_epi32(static_cast<int32_t>(0xFF000000));
+		uint64_t i = 0;
+
+		for (; i + 8 <= pixels; i += 8)
+		{
+			__m256i pixelsIn = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + i * 4));
+			__m256i alphas = _mm256_or_si256(_mm256_shuffle_epi8(pixelsIn, broadcastAlpha), alphaChannels); // Alpha is multiplied by 255, i.e. unchanged
+
+			__m256i low = BlendDetail::Divide255(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixelsIn, zero), _mm256_unpacklo_epi8(alphas, zero)));
+			__m256i high = BlendDetail::Divide255(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixelsIn, zero), _mm256_unpackhi_epi8(alphas, zero)));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), _mm256_packus_epi16(low, high));
+		}
+
+		for (; i < pixels; ++i)
+		{
+			uint8_t alpha = rgba[i * 4 + 3];
+
+			for (int c = 0; c < 3; ++c)
+			{
+				int x = rgba[i * 4 + c] * alpha + 128;
+				out[i * 4 + c] = static_cast<uint8_t>((x + (x >> 8)) >> 8);
+			}
+
+			out[i * 4 + 3] = alpha;
+		}
+	}
+};
+
+#endif
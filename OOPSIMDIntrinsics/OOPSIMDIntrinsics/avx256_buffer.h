@@ -0,0 +1,141 @@
+#ifndef AVX256_BUFFER_H
+#define AVX256_BUFFER_H
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	// Returns the OR of the XOR of four consecutive 32-byte blocks of a and b, i.e. a vector that is zero only if all 128 bytes are equal
+	inline __m256i Difference128(const uint8_t* a, const uint8_t* b)
+	{
+		return _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b))),
+				_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 32)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 32)))
+			),
+			_mm256_or_si256(
+				_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 64)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 64))),
+				_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 96)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 96)))
+			)
+		);
+	}
+
+	// Returns the index of the first differing byte within the 32 bytes at a and b, or 32 if they are equal
+	inline uint32_t FirstDifference32(const uint8_t* a, const uint8_t* b)
+	{
+		uint32_t equalMask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)))));
+		return equalMask == UINT32_MAX ? 32 : _tzcnt_u32(~equalMask);
+	}
+
+	// Returns true if the first 'count' elements of a and b are bitwise identical (floating-point elements are not compared by value, e.g. 0.0 != -0.0).
+	// 128 bytes are compared per iteration with a single test, returning as soon as a 128-byte block containing a difference is found
+	template <typename T>
+	bool BuffersEqual(const T* a, const T* b, uint64_t count)
+	{
+		const uint8_t* bytesA = reinterpret_cast<const uint8_t*>(a);
+		const uint8_t* bytesB = reinterpret_cast<const uint8_t*>(b);
+		uint64_t size = count * sizeof(T), i = 0;
+
+		for (; i + 128 <= size; i += 128)
+		{
+			__m256i difference = Difference128(bytesA + i, bytesB + i);
+			if (!_mm256_testz_si256(difference, difference)) return false;
+		}
+
+		for (; i + 32 <= size; i += 32)
+		{
+			__m256i difference = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytesA + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytesB + i)));
+			if (!_mm256_testz_si256(difference, difference)) return false;
+		}
+
+		if (i == size) return true;
+
+		if (size >= 32) // Re-compare the last 32 bytes (overlapping already compared bytes) instead of falling back to scalar comparisons
+		{
+			__m256i difference = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytesA + size - 32)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytesB + size - 32)));
+			return static_cast<bool>(_mm256_testz_si256(difference, difference));
+		}
+
+		return std::memcmp(bytesA + i, bytesB + i, size - i) == 0;
+	}
+
+	// Returns true if all bits of the first 'count' elements of data are 0 (e.g. -0.0 is not considered zero).
+	// 128 bytes are tested per iteration with a single test, returning as soon as a 128-byte block containing a set bit is found
+	template <typename T>
+	bool IsAllZero(const T* data, uint64_t count)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		uint64_t size = count * sizeof(T), i = 0;
+
+		for (; i + 128 <= size; i += 128)
+		{
+			__m256i bits = _mm256_or_si256(
+				_mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i + 32))),
+				_mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i + 64)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i + 96)))
+			);
+			if (!_mm256_testz_si256(bits, bits)) return false;
+		}
+
+		for (; i + 32 <= size; i += 32)
+		{
+			__m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+			if (!_mm256_testz_si256(bits, bits)) return false;
+		}
+
+		if (i == size) return true;
+
+		if (size >= 32) // Re-test the last 32 bytes (overlapping already tested bytes) instead of falling back to scalar tests
+		{
+			__m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + size - 32));
+			return static_cast<bool>(_mm256_testz_si256(bits, bits));
+		}
+
+		for (; i < size; ++i)
+			if (bytes[i] != 0) return false;
+
+		return true;
+	}
+
+	// Returns the index of the first element of a that is not bitwise identical to the corresponding element of b, or 'count' if the first 'count' elements are identical.
+	// 128 bytes are compared per iteration with a single test, the differing element is only located once a 128-byte block containing a difference is found
+	template <typename T>
+	uint64_t FirstDifference(const T* a, const T* b, uint64_t count)
+	{
+		const uint8_t* bytesA = reinterpret_cast<const uint8_t*>(a);
+		const uint8_t* bytesB = reinterpret_cast<const uint8_t*>(b);
+		uint64_t size = count * sizeof(T), i = 0;
+
+		for (; i + 128 <= size; i += 128)
+		{
+			__m256i difference = Difference128(bytesA + i, bytesB + i);
+			if (_mm256_testz_si256(difference, difference)) continue;
+
+			for (uint64_t j = i; j < i + 128; j += 32)
+			{
+				uint32_t index = FirstDifference32(bytesA + j, bytesB + j);
+				if (index != 32) return (j + index) / sizeof(T);
+			}
+		}
+
+		for (; i + 32 <= size; i += 32)
+		{
+			uint32_t index = FirstDifference32(bytesA + i, bytesB + i);
+			if (index != 32) return (i + index) / sizeof(T);
+		}
+
+		if (i != size && size >= 32) // Re-compare the last 32 bytes (overlapping already compared bytes) instead of falling back to scalar comparisons
+		{
+			uint32_t index = FirstDifference32(bytesA + size - 32, bytesB + size - 32);
+			return index == 32 ? count : (size - 32 + index) / sizeof(T);
+		}
+
+		for (; i < size; ++i)
+			if (bytesA[i] != bytesB[i]) return i / sizeof(T);
+
+		return count;
+	}
+};
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef AVX256_CHECKSUM_H
+#define AVX256_CHECKSUM_H
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	namespace ChecksumDetail
+	{
+		// Returns the sum of the 8 32-bit elements of v
+		inline uint32_t HorizontalSum32(__m256i v)
+		{
+			__m128i sums = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+			sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+			sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+			return static_cast<uint32_t>(_mm_cvtsi128_si32(sums));
+		}
+
+		// Computes the running byte sum (sum1) and the sum of running sums (sum2) used by Adler-32 and Fletcher-16, reducing both modulo 'modulus' every 'blockSize' bytes.
+		// For each 32-byte chunk, _mm256_sad_epu8 adds the bytes to sum1, while _mm256_maddubs_epi16 weighs each byte by its number of remaining additions to sum2 (32 to 1) within the chunk
+		inline void ByteSums(const uint8_t* data, uint64_t size, uint32_t& sum1, uint32_t& sum2, uint32_t modulus, uint64_t blockSize)
+		{
+			const __m256i weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+
+			while (size >= 32)
+			{
+				uint64_t blockLength = (size < blockSize ? size : blockSize) & ~static_cast<uint64_t>(31);
+
+				// sum1 is seeded into the running sums so that it is added to sum2 once for every byte of the block
+				__m256i sums1 = _mm256_setr_epi32(static_cast<int32_t>(sum1), 0, 0, 0, 0, 0, 0, 0);
+				__m256i sums2 = _mm256_setr_epi32(static_cast<int32_t>(sum2), 0, 0, 0, 0, 0, 0, 0);
+				__m256i previousSums1 = _mm256_setzero_si256(); // Sum of sums1 before each chunk, each of which is added to sum2 32 times
+
+				for (uint64_t i = 0; i < blockLength; i += 32)
+				{
+					__m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+					previousSums1 = _mm256_add_epi32(previousSums1, sums1);
+					sums1 = _mm256_add_epi32(sums1, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+					sums2 = _mm256_add_epi32(sums2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), _mm256_set1_epi16(1)));
+				}
+
+				sums2 = _mm256_add_epi32(sums2, _mm256_slli_epi32(previousSums1, 5));
+				sum1 = HorizontalSum32(sums1) % modulus;
+				sum2 = HorizontalSum32(sums2) % modulus;
+
+				data += blockLength;
+				size -= blockLength;
+			}
+
+			for (uint64_t i = 0; i < size; ++i)
+				sum1 += data[i], sum2 += sum1;
+
+			sum1 %= modulus;
+			sum2 %= modulus;
+		}
+
+		// Returns the CRC32C polynomial (reflected) applied to vec, where matrix[i] is the result for bit i
+		inline uint32_t MatrixTimes(const uint32_t* matrix, uint32_t vec)
+		{
+			uint32_t result = 0;
+			for (int i = 0; vec; ++i, vec >>= 1)
+				if (vec & 1) result ^= matrix[i];
+			return result;
+		}
+
+		// Returns a table that advances a (non-inverted) CRC32C register over 'length' zero bytes: shift(crc) = table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24]
+		inline std::array<std::array<uint32_t, 256>, 4> CreateCRC32CShiftTable(uint64_t length)
+		{
+			uint32_t op[32], square[32], result[32];
+
+			op[0] = 0x82F63B78; // Operator for one zero bit
+			for (int i = 1; i < 32; ++i) op[i] = 1u << (i - 1);
+
+			for (int i = 0; i < 32; ++i) result[i] = 1u << i; // Identity
+
+			for (int bit = 0; bit < 3; ++bit) // Square up to the operator for one zero byte
+			{
+				for (int i = 0; i < 32; ++i) square[i] = MatrixTimes(op, op[i]);
+				std::memcpy(op, square, sizeof(op));
+			}
+
+			for (; length; length >>= 1) // Combine the operators for 2^k zero bytes for each set bit k of length
+			{
+				if (length & 1)
+				{
+					for (int i = 0; i < 32; ++i) square[i] = MatrixTimes(op, result[i]);
+					std::memcpy(result, square, sizeof(result));
+				}
+
+				for (int i = 0; i < 32; ++i) square[i] = MatrixTimes(op, op[i]);
+				std::memcpy(op, square, sizeof(op));
+			}
+
+			std::array<std::array<uint32_t, 256>, 4> table{};
+			for (int byte = 0; byte < 4; ++byte)
+				for (uint32_t value = 0; value < 256; ++value)
+					table[byte][value] = MatrixTimes(result, value << (8 * byte));
+
+			return table;
+		}
+
+		inline uint32_t Shift(const std::array<std::array<uint32_t, 256>, 4>& table, uint32_t crc)
+		{
+			return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^ table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+		}
+
+		// CRC32C of three adjacent streams of 'length' bytes each, computed in parallel to hide the latency of the crc32 instruction, then combined by shifting
+		inline uint32_t CRC32CInterleaved(const uint8_t* data, uint64_t length, uint32_t crc, const std::array<std::array<uint32_t, 256>, 4>& shiftTable)
+		{
+			uint64_t crc0 = crc, crc1 = 0, crc2 = 0;
+
+			for (uint64_t i = 0; i < length; i += 8)
+			{
+				uint64_t word0, word1, word2;
+				std::memcpy(&word0, data + i, 8);
+				std::memcpy(&word1, data + length + i, 8);
+				std::memcpy(&word2, data + 2 * length + i, 8);
+
+				crc0 = _mm_crc32_u64(crc0, word0);
+				crc1 = _mm_crc32_u64(crc1, word1);
+				crc2 = _mm_crc32_u64(crc2, word2);
+			}
+
+			return Shift(shiftTable, Shift(shiftTable, static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1)) ^ static_cast<uint32_t>(crc2);
+		}
+
+		inline constexpr uint64_t CRC32C_LONG = 8192, CRC32C_SHORT = 256;
+
+		// Returns the 64-bit XOR-folded 128-bit product of a and b
+		inline uint64_t MultiplyFold(uint64_t a, uint64_t b)
+		{
+			uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32, bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+			uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+			uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+
+			uint64_t low = (lowLow & 0xFFFFFFFF) | (middle << 32);
+			uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+			return low ^ high;
+		}
+
+		inline uint64_t Avalanche(uint64_t hash)
+		{
+			hash ^= hash >> 37;
+			hash *= 0x165667919E3779F9;
+			return hash ^ (hash >> 32);
+		}
+
+		inline uint64_t Read64(const uint8_t* data, uint64_t available)
+		{
+			uint64_t word = 0;
+			std::memcpy(&word, data, available < 8 ? available : 8);
+			return word;
+		}
+
+		inline constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87, PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+		inline constexpr uint32_t PRIME32_1 = 0x9E3779B1;
+		inline constexpr uint64_t HASH_KEYS[8] = { 0x243F6A8885A308D3, 0x13198A2E03707344, 0xA4093822299F31D0, 0x082EFA98EC4E6C89, 0x452821E638D01377, 0xBE5466CF34E90C6C, 0xC0AC29B7C97C50DD, 0x3F84D5B5B5470917 };
+		inline constexpr uint64_t HASH_STRIPES_PER_BLOCK = 16;
+
+		// Adds a 64-byte stripe into the 8 64-bit accumulators: each accumulator receives the product of the low and high 32 bits of its keyed data, plus the unkeyed data of its neighbour
+		inline void HashStripe(const uint8_t* data, __m256i* accumulators, const __m256i* keys)
+		{
+			for (int i = 0; i < 2; ++i)
+			{
+				__m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32 * i));
+				__m256i keyed = _mm256_xor_si256(words, keys[i]);
+				__m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+				accumulators[i] = _mm256_add_epi64(accumulators[i], _mm256_add_epi64(product, _mm256_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2))));
+			}
+		}
+
+		// Mixes the high bits of each accumulator into its low bits and multiplies by a 32-bit prime (64 x 32-bit multiplication via two _mm256_mul_epu32)
+		inline void ScrambleAccumulators(__m256i* accumulators, const __m256i* keys)
+		{
+			for (int i = 0; i < 2; ++i)
+			{
+				__m256i mixed = _mm256_xor_si256(_mm256_xor_si256(accumulators[i], _mm256_srli_epi64(accumulators[i], 47)), keys[i]);
+				__m256i low = _mm256_mul_epu32(mixed, _mm256_set1_epi64x(PRIME32_1));
+				__m256i high = _mm256_mul_epu32(_mm256_srli_epi64(mixed, 32), _mm256_set1_epi64x(PRIME32_1));
+				accumulators[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+			}
+		}
+	};
+
+	// Returns the Adler-32 checksum of the first 'size' bytes of data. Pass the result of a previous call as 'adler' to continue a checksum over multiple buffers
+	inline uint32_t Adler32(const uint8_t* data, uint64_t size, uint32_t adler = 1)
+	{
+		uint32_t sum1 = adler & 0xFFFF, sum2 = adler >> 16;
+		ChecksumDetail::ByteSums(data, size, sum1, sum2, 65521, 5536); // 5536 is the largest multiple of 32 for which sum2 cannot overflow 32 bits before being reduced (5552 bytes)
+		return (sum2 << 16) | sum1;
+	}
+
+	// Returns the Fletcher-16 checksum of the first 'size' bytes of data. Pass the result of a previous call as 'fletcher' to continue a checksum over multiple buffers
+	inline uint16_t Fletcher16(const uint8_t* data, uint64_t size, uint16_t fletcher = 0)
+	{
+		uint32_t sum1 = fletcher & 0xFF, sum2 = fletcher >> 8;
+		ChecksumDetail::ByteSums(data, size, sum1, sum2, 255, 5536);
+		return static_cast<uint16_t>((sum2 << 8) | sum1);
+	}
+
+	// Returns the Fletcher-32 checksum of the first 'count' 16-bit words of data. Pass the result of a previous call as 'fletcher' to continue a checksum over multiple buffers.
+	// Words are widened to 32 bits, so each 32-byte chunk adds 16 words to sum1 and their weights (16 to 1) times the words to sum2
+	inline uint32_t Fletcher32(const uint16_t* data, uint64_t count, uint32_t fletcher = 0)
+	{
+		const __m256i weightsLow = _mm256_setr_epi32(16, 15, 14, 13, 8, 7, 6, 5), weightsHigh = _mm256_setr_epi32(12, 11, 10, 9, 4, 3, 2, 1); // Weights of the words unpacked into each 128-bit lane
+		uint32_t sum1 = fletcher & 0xFFFF, sum2 = fletcher >> 16;
+
+		while (count >= 16)
+		{
+			uint64_t blockLength = (count < 352 ? count : 352) & ~static_cast<uint64_t>(15); // sum2 cannot overflow 32 bits within 359 words
+
+			__m256i sums1 = _mm256_setr_epi32(static_cast<int32_t>(sum1), 0, 0, 0, 0, 0, 0, 0);
+			__m256i sums2 = _mm256_setr_epi32(static_cast<int32_t>(sum2), 0, 0, 0, 0, 0, 0, 0);
+			__m256i previousSums1 = _mm256_setzero_si256();
+
+			for (uint64_t i = 0; i < blockLength; i += 16)
+			{
+				__m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+				__m256i low = _mm256_unpacklo_epi16(words, _mm256_setzero_si256()), high = _mm256_unpackhi_epi16(words, _mm256_setzero_si256());
+
+				previousSums1 = _mm256_add_epi32(previousSums1, sums1);
+				sums1 = _mm256_add_epi32(sums1, _mm256_add_epi32(low, high));
+				sums2 = _mm256_add_epi32(sums2, _mm256_add_epi32(_mm256_mullo_epi32(low, weightsLow), _mm256_mullo_epi32(high, weightsHigh)));
+			}
+
+			sums2 = _mm256_add_epi32(sums2, _mm256_slli_epi32(previousSums1, 4));
+			sum1 = ChecksumDetail::HorizontalSum32(sums1) % 65535;
+			sum2 = ChecksumDetail::HorizontalSum32(sums2) % 65535;
+
+			data += blockLength;
+			count -= blockLength;
+		}
+
+		for (uint64_t i = 0; i < count; ++i)
+			sum1 += data[i], sum2 += sum1;
+
+		return ((sum2 % 65535) << 16) | (sum1 % 65535);
+	}
+
+	// Returns the CRC32C (Castagnoli) of the first 'size' bytes of data. Pass the result of a previous call as 'crc' to continue a CRC over multiple buffers.
+	// Large buffers are split into three streams processed with interleaved _mm_crc32_u64 instructions and combined with precomputed shift tables
+	inline uint32_t CRC32C(const uint8_t* data, uint64_t size, uint32_t crc = 0)
+	{
+		static const std::array<std::array<uint32_t, 256>, 4> longShiftTable = ChecksumDetail::CreateCRC32CShiftTable(ChecksumDetail::CRC32C_LONG);
+		static const std::array<std::array<uint32_t, 256>, 4> shortShiftTable = ChecksumDetail::CreateCRC32CShiftTable(ChecksumDetail::CRC32C_SHORT);
+
+		crc = ~crc;
+
+		for (; size >= 3 * ChecksumDetail::CRC32C_LONG; data += 3 * ChecksumDetail::CRC32C_LONG, size -= 3 * ChecksumDetail::CRC32C_LONG)
+			crc = ChecksumDetail::CRC32CInterleaved(data, ChecksumDetail::CRC32C_LONG, crc, longShiftTable);
+
+		for (; size >= 3 * ChecksumDetail::CRC32C_SHORT; data += 3 * ChecksumDetail::CRC32C_SHORT, size -= 3 * ChecksumDetail::CRC32C_SHORT)
+			crc = ChecksumDetail::CRC32CInterleaved(data, ChecksumDetail::CRC32C_SHORT, crc, shortShiftTable);
+
+		uint64_t crc64 = crc;
+		for (; size >= 8; data += 8, size -= 8)
+		{
+			uint64_t word;
+			std::memcpy(&word, data, 8);
+			crc64 = _mm_crc32_u64(crc64, word);
+		}
+
+		crc = static_cast<uint32_t>(crc64);
+		for (; size > 0; ++data, --size)
+			crc = _mm_crc32_u8(crc, *data);
+
+		return ~crc;
+	}
+
+	// Returns a fast, non-cryptographic 64-bit hash of the first 'size' bytes of data, in the style of XXH3 (but not compatible with it).
+	// 64-byte stripes are accumulated into eight 64-bit lanes with _mm256_mul_epu32, with per-stripe keys and a scramble every 1KB, inputs of up to 64 bytes are hashed with scalar 128-bit multiplications
+	inline uint64_t Hash64(const uint8_t* data, uint64_t size, uint64_t seed = 0)
+	{
+		using namespace ChecksumDetail;
+
+		// The seed is mixed in with a multiplication, otherwise changing it would be equivalent to flipping the same bits of the input
+		uint64_t seedKey = MultiplyFold(seed ^ PRIME64_1, size ^ PRIME64_2);
+
+		if (size <= 64)
+		{
+			uint64_t hash = seedKey;
+
+			for (uint64_t i = 0; i < size; i += 16)
+				hash = MultiplyFold(Read64(data + i, size - i) ^ HASH_KEYS[(i / 8) % 8] ^ hash, (i + 8 < size ? Read64(data + i + 8, size - i - 8) : 0) ^ HASH_KEYS[(i / 8 + 1) % 8]);
+
+			return Avalanche(hash ^ MultiplyFold(hash, PRIME64_2));
+		}
+
+		__m256i keys[2] = {
+			_mm256_xor_si256(_mm256_setr_epi64x(HASH_KEYS[0], HASH_KEYS[1], HASH_KEYS[2], HASH_KEYS[3]), _mm256_set1_epi64x(static_cast<int64_t>(seedKey))),
+			_mm256_xor_si256(_mm256_setr_epi64x(HASH_KEYS[4], HASH_KEYS[5], HASH_KEYS[6], HASH_KEYS[7]), _mm256_set1_epi64x(static_cast<int64_t>(seedKey)))
+		};
+		__m256i scrambleKeys[2] = { keys[1], keys[0] };
+		__m256i accumulators[2] = { _mm256_setr_epi64x(PRIME32_1, PRIME64_1, PRIME64_2, seedKey), _mm256_setr_epi64x(PRIME64_2, seedKey, PRIME32_1, PRIME64_1) };
+		const __m256i keyStep = _mm256_set1_epi64x(static_cast<int64_t>(PRIME64_1)); // Keys change with every stripe so that re-ordered stripes hash differently
+
+		uint64_t stripes = (size - 1) / 64; // The last (possibly partial) stripe is hashed separately
+
+		for (uint64_t stripe = 0; stripe < stripes; ++stripe)
+		{
+			HashStripe(data + 64 * stripe, accumulators, keys);
+			keys[0] = _mm256_add_epi64(keys[0], keyStep), keys[1] = _mm256_add_epi64(keys[1], keyStep);
+
+			if (stripe % HASH_STRIPES_PER_BLOCK == HASH_STRIPES_PER_BLOCK - 1) ScrambleAccumulators(accumulators, scrambleKeys);
+		}
+
+		HashStripe(data + size - 64, accumulators, scrambleKeys); // Overlaps the previous stripe unless size is a multiple of 64
+
+		uint64_t lanes[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), accumulators[0]);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 4), accumulators[1]);
+
+		uint64_t hash = size * PRIME64_1 ^ seedKey;
+		for (int i = 0; i < 8; i += 2)
+			hash += MultiplyFold(lanes[i] ^ HASH_KEYS[i], lanes[i + 1] ^ HASH_KEYS[i + 1]);
+
+		return Avalanche(hash);
+	}
+};
+
+#endif
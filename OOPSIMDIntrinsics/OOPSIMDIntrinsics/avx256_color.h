@@ -0,0 +1,144 @@
+#ifndef AVX256_COLOR_H
+#define AVX256_COLOR_H
+
+#include <cstdint>
+#include <array>
+#include <utility>
+#include <immintrin.h>
+
+#include "avx256.h"
+
+namespace AVX256Utils
+{
+	namespace ColorDetail
+	{
+		// BT.601 luma weights (0.114, 0.587, 0.299) in 7-bit fixed point, the largest precision at which _mm256_maddubs_epi16 cannot saturate. They sum to 128 so white stays white
+		inline constexpr int GRAY_SHIFT = 7, GRAY_WEIGHT_B = 15, GRAY_WEIGHT_G = 75, GRAY_WEIGHT_R = 38;
+
+		inline uint8_t Gray(const uint8_t* bgr) { return static_cast<uint8_t>((GRAY_WEIGHT_B * bgr[0] + GRAY_WEIGHT_G * bgr[1] + GRAY_WEIGHT_R * bgr[2] + (1 << (GRAY_SHIFT - 1))) >> GRAY_SHIFT); }
+
+		// Returns the 8 weighted pixel sums of 8 BGR pixels, as pairs of int16s (15B + 75G, 38R). The pixels are the 12 bytes at 'offset' dwords into
+		// 'block' (low lane) and the 12 bytes 3 dwords later (high lane), which are spread into one pixel per dword before the multiply
+		template <int OFFSET>
+		__m256i WeightedPixels(__m256i block)
+		{
+			const __m256i spread = _mm256_setr_epi8(
+				0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+				0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+			);
+			const __m256i weights = _mm256_setr_epi8(
+				GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0, GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0, GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0, GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0,
+				GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0, GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0, GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0, GRAY_WEIGHT_B, GRAY_WEIGHT_G, GRAY_WEIGHT_R, 0
+			);
+
+			__m256i pixels = _mm256_permutevar8x32_epi32(block, _mm256_setr_epi32(OFFSET, OFFSET + 1, OFFSET + 2, OFFSET + 3, OFFSET + 3, OFFSET + 4, OFFSET + 5, OFFSET + 6 > 7 ? 7 : OFFSET + 6));
+			return _mm256_maddubs_epi16(_mm256_shuffle_epi8(pixels, spread), weights);
+		}
+
+		// Returns the grey values of the 32 BGR pixels (96 bytes) at 'bgr'. Each quarter of 8 pixels (24 bytes) is loaded within the 96 bytes, so nothing beyond them is read
+		inline __m256i Gray32(const uint8_t* bgr)
+		{
+			__m256i pixels0 = WeightedPixels<0>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgr))); // Bytes 0 - 23
+			__m256i pixels1 = WeightedPixels<2>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgr + 16))); // Bytes 24 - 47
+			__m256i pixels2 = WeightedPixels<0>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgr + 48))); // Bytes 48 - 71
+			__m256i pixels3 = WeightedPixels<2>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgr + 64))); // Bytes 72 - 95
+
+			__m256i rounding = _mm256_set1_epi16(1 << (GRAY_SHIFT - 1));
+			__m256i gray01 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_hadd_epi16(pixels0, pixels1), rounding), GRAY_SHIFT);
+			__m256i gray23 = _mm256_srli_epi16(_mm256_add_epi16(_mm256_hadd_epi16(pixels2, pixels3), rounding), GRAY_SHIFT);
+
+			// Each lane now holds 4 pixels from each quarter, i.e. pixels [0-3, 8-11, 16-19, 24-27 | 4-7, 12-15, 20-23, 28-31]
+			return _mm256_permutevar8x32_epi32(_mm256_packus_epi16(gray01, gray23), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+		}
+
+		// Calls block(gray, i) with the grey values of each 32 pixels from pixel i, and pixel(gray, i) for each pixel if there are fewer than 32.
+		// If the pixel count is not a multiple of 32, the last 32 pixels are processed again (overlapping already processed pixels), so outputs must not overlap inputs
+		template <typename Block, typename Pixel>
+		void ForEachGray(const uint8_t* bgr, uint64_t pixels, Block block, Pixel pixel)
+		{
+			if (pixels < 32)
+			{
+				for (uint64_t i = 0; i < pixels; ++i) pixel(Gray(bgr + 3 * i), i);
+				return;
+			}
+
+			for (uint64_t i = 0; i < pixels; i += 32)
+			{
+				if (i + 32 > pixels) i = pixels - 32;
+				block(Gray32(bgr + 3 * i), i);
+			}
+		}
+	};
+
+	// Swaps the B and R channels of the BGR pixels in place, 32 pixels (three vectors) at a time. Each vector is permuted within its 128-bit lanes, and the pixels straddling
+	// the lanes and vectors (in brackets) are swapped individually:
+	//                  order1                               order2                                   order3
+	// bgrbgrbgrbgrbgr(b|gr)bgrbgrbgrbgr(bg  ||  r)bgrbgrbgrbgrbgr|bgrbgrbgrbgrbgr(b  ||  gr)bgrbgrbgrbgr(bg|r)bgrbgrbgrbgrbgr  || ...
+	inline void BGRToRGB(uint8_t* bgr, uint64_t pixels)
+	{
+		static constexpr std::array<uint8_t, 32>
+			order1{ { 2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15, 0, 1, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, 14, 15 } },
+			order2{ { 0, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13, 2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15 } },
+			order3{ { 0, 1, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, 14, 15, 0, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13 } };
+
+		AVX256<uint8_t> image{ bgr };
+		uint64_t size = 3 * pixels, i = 0;
+
+		for (; i + 32 * 3 <= size; i += 32 * 3, image.Next())
+		{
+			image.Permute8(order1);
+			std::swap(image.Data[15], image.Data[17]);
+			std::swap(image.Data[30], image.Data[32]);
+			image.Next();
+			image.Permute8(order2);
+			std::swap(image.Data[31], image.Data[33]);
+			image.Next();
+			image.Permute8(order3);
+			std::swap(image.Data[14], image.Data[16]);
+		}
+
+		for (; i < size; i += 3) std::swap(bgr[i], bgr[i + 2]);
+	}
+
+	// Converts the BGR pixels to grey (0.114B + 0.587G + 0.299R, with 7-bit fixed-point weights applied by _mm256_maddubs_epi16). 'gray' must not overlap 'bgr'
+	inline void BGRToGray(const uint8_t* bgr, uint8_t* gray, uint64_t pixels)
+	{
+		ColorDetail::ForEachGray(bgr, pixels,
+			[gray](__m256i values, uint64_t i) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(gray + i), values); },
+			[gray](uint8_t value, uint64_t i) { gray[i] = value; }
+		);
+	}
+
+	// Converts the BGR pixels to grey (see BGRToGray()) and thresholds them in the same pass, setting each mask element to 255 if its grey value is greater than the boundary, and 0 otherwise.
+	// 'mask' must not overlap 'bgr'
+	inline void BGRToGrayThreshold(const uint8_t* bgr, uint8_t* mask, uint64_t pixels, uint8_t boundary)
+	{
+		__m256i signBit = _mm256_set1_epi8(static_cast<char>(0x80)), boundaries = _mm256_xor_si256(_mm256_set1_epi8(static_cast<char>(boundary)), signBit);
+
+		ColorDetail::ForEachGray(bgr, pixels,
+			[=](__m256i values, uint64_t i) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i), _mm256_cmpgt_epi8(_mm256_xor_si256(values, signBit), boundaries)); },
+			[=](uint8_t value, uint64_t i) { mask[i] = (value > boundary) * UINT8_MAX; }
+		);
+	}
+
+	// Converts the BGR pixels to grey (see BGRToGray()) and computes their absolute difference to 'previousGray' in the same pass. If 'gray' is not nullptr, the grey values are also stored in it.
+	// 'gray' and 'difference' must not overlap 'bgr' or 'previousGray'
+	inline void BGRToGrayAbsDiff(const uint8_t* bgr, const uint8_t* previousGray, uint8_t* gray, uint8_t* difference, uint64_t pixels)
+	{
+		ColorDetail::ForEachGray(bgr, pixels,
+			[=](__m256i values, uint64_t i)
+			{
+				__m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previousGray + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(difference + i), _mm256_or_si256(_mm256_subs_epu8(values, previous), _mm256_subs_epu8(previous, values)));
+				if (gray != nullptr) _mm256_storeu_si256(reinterpret_cast<__m256i*>(gray + i), values);
+			},
+			[=](uint8_t value, uint64_t i)
+			{
+				difference[i] = value > previousGray[i] ? value - previousGray[i] : previousGray[i] - value;
+				if (gray != nullptr) gray[i] = value;
+			}
+		);
+	}
+};
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef AVX256_CPU_H
+#define AVX256_CPU_H
+
+#include <cstdint>
+#include <array>
+#include <ostream>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace AVX256Utils
+{
+	namespace CPUDetail
+	{
+		// Returns EAX, EBX, ECX and EDX after executing CPUID function 'leaf' (sub-function 'subleaf')
+		inline std::array<uint32_t, 4> CPUID(uint32_t leaf, uint32_t subleaf = 0)
+		{
+			std::array<uint32_t, 4> registers{};
+#ifdef _MSC_VER
+			__cpuidex(reinterpret_cast<int*>(registers.data()), static_cast<int>(leaf), static_cast<int>(subleaf));
+#else
+			__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+			return registers;
+		}
+
+		// Returns the extended control register XCR0, whose bits are set for the register states the OS saves on context switches (bit 1 XMM, bit 2 YMM, bits 5-7 the AVX-512
+		// opmask and ZMM registers). Must only be called if CPUID reports OSXSAVE
+		inline uint64_t XCR0()
+		{
+#ifdef _MSC_VER
+			return _xgetbv(0);
+#else
+			uint32_t eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+		}
+
+		// Returns bit 'bit' of 'value'
+		inline bool Bit(uint32_t value, uint32_t bit) { return (value >> bit) & 1; }
+	};
+
+	// Returns true if the CPU supports the CPUID instruction (by whether the ID flag of EFLAGS can be toggled). Always true on x86-64
+	inline bool HasCPUIDSupport()
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		return true;
+#elif defined(_MSC_VER)
+		unsigned flags = __readeflags();
+		__writeeflags(flags ^ (1 << 21));
+		bool toggled = ((__readeflags() ^ flags) & (1 << 21)) != 0;
+		__writeeflags(flags);
+		return toggled;
+#else
+		return __get_cpuid_max(0, nullptr) != 0;
+#endif
+	}
+
+	// The instruction set extensions the CPU supports and the OS has enabled the registers of. The AVX family (AVX, AVX2, FMA, F16C, AVX-VNNI) requires the OS to save the YMM
+	// registers, and the AVX-512 family additionally the opmask and ZMM registers, so each is false if the CPU supports it but the OS doesn't
+	struct CPUFeatures
+	{
+		bool SSE41 = false, SSE42 = false, POPCNT = false, AVX = false, AVX2 = false, FMA = false, F16C = false, BMI1 = false, BMI2 = false, LZCNT = false;
+		bool AVX512F = false, AVX512DQ = false, AVX512BW = false, AVX512VL = false, AVX512VNNI = false, AVXVNNI = false;
+
+		// True if the CPU has every extension the avx256 CMake target compiles for (AVX2, FMA, BMI1, LZCNT, POPCNT and SSE4.2)
+		bool HasRequired() const { return AVX2 && FMA && BMI1 && LZCNT && POPCNT && SSE42; }
+	};
+
+	// Returns the features of the CPU executing the call, from CPUID functions 1, 7 (sub-functions 0 and 1) and 0x80000001, and XCR0
+	inline CPUFeatures DetectCPUFeatures()
+	{
+		using CPUDetail::Bit;
+
+		CPUFeatures features;
+		if (!HasCPUIDSupport()) return features;
+
+		uint32_t maxLeaf = CPUDetail::CPUID(0)[0], maxExtendedLeaf = CPUDetail::CPUID(0x80000000)[0];
+		if (maxLeaf < 1) return features;
+
+		std::array<uint32_t, 4> leaf1 = CPUDetail::CPUID(1), leaf7 = maxLeaf >= 7 ? CPUDetail::CPUID(7) : std::array<uint32_t, 4>{};
+		std::array<uint32_t, 4> leaf7Sub1 = maxLeaf >= 7 && leaf7[0] >= 1 ? CPUDetail::CPUID(7, 1) : std::array<uint32_t, 4>{};
+		std::array<uint32_t, 4> extended = maxExtendedLeaf >= 0x80000001 ? CPUDetail::CPUID(0x80000001) : std::array<uint32_t, 4>{};
+
+		uint64_t xcr0 = Bit(leaf1[2], 27) ? CPUDetail::XCR0() : 0; // OSXSAVE
+		bool ymm = (xcr0 & 0b110) == 0b110, zmm = ymm && (xcr0 & 0b11100000) == 0b11100000;
+
+		features.SSE41 = Bit(leaf1[2], 19), features.SSE42 = Bit(leaf1[2], 20), features.POPCNT = Bit(leaf1[2], 23);
+		features.BMI1 = Bit(leaf7[1], 3), features.BMI2 = Bit(leaf7[1], 8), features.LZCNT = Bit(extended[2], 5);
+
+		features.AVX = ymm && Bit(leaf1[2], 28);
+		features.FMA = features.AVX && Bit(leaf1[2], 12), features.F16C = features.AVX && Bit(leaf1[2], 29);
+		features.AVX2 = features.AVX && Bit(leaf7[1], 5), features.AVXVNNI = features.AVX2 && Bit(leaf7Sub1[0], 4);
+
+		features.AVX512F = zmm && Bit(leaf7[1], 16);
+		features.AVX512DQ = features.AVX512F && Bit(leaf7[1], 17), features.AVX512BW = features.AVX512F && Bit(leaf7[1], 30);
+		features.AVX512VL = features.AVX512F && Bit(leaf7[1], 31), features.AVX512VNNI = features.AVX512F && Bit(leaf7[2], 11);
+
+		return features;
+	}
+
+	// Returns the features of the CPU, detected once on first use
+	inline const CPUFeatures& GetCPUFeatures()
+	{
+		static const CPUFeatures features = DetectCPUFeatures();
+		return features;
+	}
+
+	// Returns true if the CPU supports the AVX2 instruction set (CPUID function 7, EBX bit 5) and the OS has enabled the AVX registers (OSXSAVE and XCR0)
+	inline bool HasAVX2Support() { return GetCPUFeatures().AVX2; }
+
+	// Writes the names of the supported features separated by spaces, e.g. "SSE4.1 SSE4.2 POPCNT AVX AVX2 FMA"
+	inline std::ostream& operator<<(std::ostream& out, const CPUFeatures& features)
+	{
+		std::array<std::pair<bool, const char*>, 16> names{ {
+			{ features.SSE41, "SSE4.1" }, { features.SSE42, "SSE4.2" }, { features.POPCNT, "POPCNT" }, { features.AVX, "AVX" }, { features.AVX2, "AVX2" }, { features.FMA, "FMA" },
+			{ features.F16C, "F16C" }, { features.BMI1, "BMI1" }, { features.BMI2, "BMI2" }, { features.LZCNT, "LZCNT" }, { features.AVX512F, "AVX512F" },
+			{ features.AVX512DQ, "AVX512DQ" }, { features.AVX512BW, "AVX512BW" }, { features.AVX512VL, "AVX512VL" }, { features.AVX512VNNI, "AVX512VNNI" }, { features.AVXVNNI, "AVX-VNNI" }
+		} };
+
+		bool first = true;
+		for (const auto& [supported, name] : names)
+			if (supported) out << (first ? "" : " ") << name, first = false;
+
+		return out;
+	}
+};
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef AVX256_DISPATCH_H
+#define AVX256_DISPATCH_H
+
+#include <cstdint>
+#include <immintrin.h>
+
+#include "avx256_cpu.h"
+
+// Compiles a function for the given instruction set extensions regardless of the flags of the translation unit, so that kernels for several instruction sets can live in one
+// binary (MSVC always accepts intrinsics of any instruction set)
+#ifdef _MSC_VER
+#define AVX256_TARGET(extensions)
+#else
+#define AVX256_TARGET(extensions) __attribute__((target(extensions)))
+#endif
+
+namespace AVX256Utils
+{
+	// The instruction set levels the dispatched kernels are compiled for, from the lowest to the highest
+	enum class InstructionSet { Scalar, SSE41, AVX2, AVX512 };
+
+	// Returns the name of the instruction set, e.g. "AVX512"
+	inline const char* InstructionSetName(InstructionSet set)
+	{
+		switch (set)
+		{
+		case InstructionSet::SSE41: return "SSE4.1";
+		case InstructionSet::AVX2: return "AVX2";
+		case InstructionSet::AVX512: return "AVX512";
+		default: return "Scalar";
+		}
+	}
+
+	// Returns true if the CPU with 'features' can execute the kernels compiled for 'set'
+	inline bool IsSupported(InstructionSet set, const CPUFeatures& features = GetCPUFeatures())
+	{
+		switch (set)
+		{
+		case InstructionSet::SSE41: return features.SSE41;
+		case InstructionSet::AVX2: return features.AVX2;
+		case InstructionSet::AVX512: return features.AVX512F && features.AVX512BW;
+		default: return true;
+		}
+	}
+
+	// Returns the highest instruction set the CPU with 'features' supports
+	inline InstructionSet BestInstructionSet(const CPUFeatures& features = GetCPUFeatures())
+	{
+		for (InstructionSet set : { InstructionSet::AVX512, InstructionSet::AVX2, InstructionSet::SSE41 })
+			if (IsSupported(set, features)) return set;
+
+		return InstructionSet::Scalar;
+	}
+
+	namespace DispatchDetail
+	{
+		inline void ThresholdScalar(const uint8_t* source, uint8_t* destination, uint64_t count, uint8_t threshold)
+		{
+			for (uint64_t i = 0; i < count; ++i) destination[i] = (source[i] > threshold) * UINT8_MAX;
+		}
+
+		inline void AbsoluteDifferenceScalar(const uint8_t* a, const uint8_t* b, uint8_t* destination, uint64_t count)
+		{
+			for (uint64_t i = 0; i < count; ++i) destination[i] = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+		}
+
+		inline uint64_t SumScalar(const uint8_t* data, uint64_t count)
+		{
+			uint64_t sum = 0;
+			for (uint64_t i = 0; i < count; ++i) sum += data[i];
+			return sum;
+		}
+
+		// x > threshold (unsigned) is x == max(x, threshold + 1), and never true if the threshold is 255
+		AVX256_TARGET("sse4.1") inline void ThresholdSSE41(const uint8_t* source, uint8_t* destination, uint64_t count, uint8_t threshold)
+		{
+			if (threshold == UINT8_MAX) { ThresholdScalar(source, destination, count, threshold); return; }
+
+			__m128i bound = _mm_set1_epi8(static_cast<char>(threshold + 1));
+			uint64_t i = 0;
+
+			for (; i + 16 <= count; i += 16)
+			{
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_cmpeq_epi8(_mm_max_epu8(x, bound), x));
+			}
+
+			ThresholdScalar(source + i, destination + i, count - i, threshold);
+		}
+
+		AVX256_TARGET("sse4.1") inline void AbsoluteDifferenceSSE41(const uint8_t* a, const uint8_t* b, uint8_t* destination, uint64_t count)
+		{
+			uint64_t i = 0;
+
+			for (; i + 16 <= count; i += 16)
+			{
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_or_si128(_mm_subs_epu8(x, y), _mm_subs_epu8(y, x)));
+			}
+
+			AbsoluteDifferenceScalar(a + i, b + i, destination + i, count - i);
+		}
+
+		// Each PSADBW sums 8 bytes into a 64-bit lane
+		AVX256_TARGET("sse4.1") inline uint64_t SumSSE41(const uint8_t* data, uint64_t count)
+		{
+			__m128i sums = _mm_setzero_si128();
+			uint64_t i = 0;
+
+			for (; i + 16 <= count; i += 16)
+				sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), _mm_setzero_si128()));
+
+			return static_cast<uint64_t>(_mm_cvtsi128_si64(sums)) + static_cast<uint64_t>(_mm_extract_epi64(sums, 1)) + SumScalar(data + i, count - i);
+		}
+
+		AVX256_TARGET("avx2") inline void ThresholdAVX2(const uint8_t* source, uint8_t* destination, uint64_t count, uint8_t threshold)
+		{
+			if (threshold == UINT8_MAX) { ThresholdScalar(source, destination, count, threshold); return; }
+
+			__m256i bound = _mm256_set1_epi8(static_cast<char>(threshold + 1));
+			uint64_t i = 0;
+
+			for (; i + 32 <= count; i += 32)
+			{
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_cmpeq_epi8(_mm256_max_epu8(x, bound), x));
+			}
+
+			ThresholdScalar(source + i, destination + i, count - i, threshold);
+		}
+
+		AVX256_TARGET("avx2") inline void AbsoluteDifferenceAVX2(const uint8_t* a, const uint8_t* b, uint8_t* destination, uint64_t count)
+		{
+			uint64_t i = 0;
+
+			for (; i + 32 <= count; i += 32)
+			{
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_or_si256(_mm256_subs_epu8(x, y), _mm256_subs_epu8(y, x)));
+			}
+
+			AbsoluteDifferenceScalar(a + i, b + i, destination + i, count - i);
+		}
+
+		AVX256_TARGET("avx2") inline uint64_t SumAVX2(const uint8_t* data, uint64_t count)
+		{
+			__m256i sums = _mm256_setzero_si256();
+			uint64_t i = 0;
+
+			for (; i + 32 <= count; i += 32)
+				sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), _mm256_setzero_si256()));
+
+			__m128i halves = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+			return static_cast<uint64_t>(_mm_cvtsi128_si64(halves)) + static_cast<uint64_t>(_mm_extract_epi64(halves, 1)) + SumScalar(data + i, count - i);
+		}
+
+		// Returns the mask of the first 'count' (< 64) bytes of a 64-byte vector
+		inline __mmask64 TailMask(uint64_t count) { return count == 0 ? 0 : ~0ull >> (64 - count); }
+
+		// The comparison writes a mask register, which is expanded to bytes. The last partial vector is loaded and stored under a mask instead of falling back to scalar code
+		AVX256_TARGET("avx512f,avx512bw") inline void ThresholdAVX512(const uint8_t* source, uint8_t* destination, uint64_t count, uint8_t threshold)
+		{
+			__m512i bound = _mm512_set1_epi8(static_cast<char>(threshold));
+			uint64_t i = 0;
+
+			for (; i + 64 <= count; i += 64)
+				_mm512_storeu_si512(destination + i, _mm512_movm_epi8(_mm512_cmpgt_epu8_mask(_mm512_loadu_si512(source + i), bound)));
+
+			if (i != count)
+			{
+				__mmask64 tail = TailMask(count - i);
+				_mm512_mask_storeu_epi8(destination + i, tail, _mm512_movm_epi8(_mm512_cmpgt_epu8_mask(_mm512_maskz_loadu_epi8(tail, source + i), bound)));
+			}
+		}
+
+		AVX256_TARGET("avx512f,avx512bw") inline void AbsoluteDifferenceAVX512(const uint8_t* a, const uint8_t* b, uint8_t* destination, uint64_t count)
+		{
+			uint64_t i = 0;
+
+			for (; i + 64 <= count; i += 64)
+			{
+				__m512i x = _mm512_loadu_si512(a + i), y = _mm512_loadu_si512(b + i);
+				_mm512_storeu_si512(destination + i, _mm512_or_si512(_mm512_subs_epu8(x, y), _mm512_subs_epu8(y, x)));
+			}
+
+			if (i != count)
+			{
+				__mmask64 tail = TailMask(count - i);
+				__m512i x = _mm512_maskz_loadu_epi8(tail, a + i), y = _mm512_maskz_loadu_epi8(tail, b + i);
+				_mm512_mask_storeu_epi8(destination + i, tail, _mm512_or_si512(_mm512_subs_epu8(x, y), _mm512_subs_epu8(y, x)));
+			}
+		}
+
+		// The bytes past the end of the last partial vector are loaded as 0, so they don't change the sum
+		AVX256_TARGET("avx512f,avx512bw") inline uint64_t SumAVX512(const uint8_t* data, uint64_t count)
+		{
+			__m512i sums = _mm512_setzero_si512();
+			uint64_t i = 0;
+
+			for (; i + 64 <= count; i += 64) sums = _mm512_add_epi64(sums, _mm512_sad_epu8(_mm512_loadu_si512(data + i), _mm512_setzero_si512()));
+			if (i != count) sums = _mm512_add_epi64(sums, _mm512_sad_epu8(_mm512_maskz_loadu_epi8(TailMask(count - i), data + i), _mm512_setzero_si512()));
+
+			uint64_t lanes[8], sum = 0;
+			_mm512_storeu_si512(lanes, sums);
+			for (uint64_t lane : lanes) sum += lane;
+			return sum;
+		}
+	};
+
+	// A table of buffer-level kernels compiled for one instruction set. Every table computes identical results
+	struct BufferKernels
+	{
+		InstructionSet Set;
+
+		// Sets each of the 'count' bytes of 'destination' to 255 if the byte of 'source' is greater than 'threshold', and 0 otherwise
+		void (*Threshold)(const uint8_t* source, uint8_t* destination, uint64_t count, uint8_t threshold);
+
+		// Sets each of the 'count' bytes of 'destination' to |a - b|
+		void (*AbsoluteDifference)(const uint8_t* a, const uint8_t* b, uint8_t* destination, uint64_t count);
+
+		// Returns the sum of the 'count' bytes of 'data'
+		uint64_t (*Sum)(const uint8_t* data, uint64_t count);
+	};
+
+	// Returns the kernels compiled for 'set'. Calling them on a CPU that doesn't support 'set' (see IsSupported()) raises an illegal instruction exception
+	inline const BufferKernels& KernelsFor(InstructionSet set)
+	{
+		using namespace DispatchDetail;
+
+		static const BufferKernels kernels[] = {
+			{ InstructionSet::Scalar, ThresholdScalar, AbsoluteDifferenceScalar, SumScalar },
+			{ InstructionSet::SSE41, ThresholdSSE41, AbsoluteDifferenceSSE41, SumSSE41 },
+			{ InstructionSet::AVX2, ThresholdAVX2, AbsoluteDifferenceAVX2, SumAVX2 },
+			{ InstructionSet::AVX512, ThresholdAVX512, AbsoluteDifferenceAVX512, SumAVX512 }
+		};
+
+		return kernels[static_cast<int>(set)];
+	}
+
+	// Returns the kernels for the highest instruction set the CPU supports, selected once on first use. Only this header and avx256_cpu.h need to be compiled for the lowest
+	// instruction set the binary must run on, so one binary takes the fastest path on every CPU
+	inline const BufferKernels& Kernels()
+	{
+		static const BufferKernels& kernels = KernelsFor(BestInstructionSet());
+		return kernels;
+	}
+};
+
+#endif
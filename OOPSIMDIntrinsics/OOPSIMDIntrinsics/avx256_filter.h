@@ -0,0 +1,268 @@
+#ifndef AVX256_FILTER_H
+#define AVX256_FILTER_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	// How pixels outside the image are treated by the filters
+	enum class BorderMode
+	{
+		Replicate, // aaa|abcd|ddd
+		Reflect, // cb|abcd|cb
+		Constant // 000|abcd|000
+	};
+
+	namespace FilterDetail
+	{
+		template <typename T>
+		void CheckType() { static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, float>, "AVX256: Filters are only available for uint8_t and float"); }
+
+		// Returns the index within [0, size) that the (possibly out of range) index is mapped to, or -1 if it maps to the constant border
+		inline int64_t BorderIndex(int64_t index, int64_t size, BorderMode border)
+		{
+			if (index >= 0 && index < size) return index;
+			if (border == BorderMode::Constant) return -1;
+			if (border == BorderMode::Replicate || size == 1) return index < 0 ? 0 : size - 1;
+
+			while (index < 0 || index >= size) // Reflect repeatedly, in case the kernel is larger than the image
+				index = index < 0 ? -index : 2 * (size - 1) - index;
+
+			return index;
+		}
+
+		// 1D kernel weights prepared for the type being filtered. uint8_t weights are converted to 16-bit fixed point with 'Shift' (at most 14) fractional bits, using as many
+		// bits as possible such that each weight fits in an int16_t and accumulating 255 * weight in 32 bits never overflows
+		template <typename T>
+		struct Kernel
+		{
+			int Taps, Anchor, Shift = 0;
+			std::vector<float> Weights;
+			std::vector<int16_t> FixedWeights;
+
+			Kernel(const float* weights, int taps) : Taps{ taps }, Anchor{ taps / 2 }, Weights{ weights, weights + taps }
+			{
+				if constexpr (std::is_same_v<T, uint8_t>)
+				{
+					double sum = 0;
+					for (float weight : Weights) sum += weight;
+
+					for (Shift = 14; ; --Shift)
+					{
+						std::vector<int64_t> fixed(taps);
+						int64_t fixedSum = 0, fixedAbsoluteSum = 0;
+						bool fits = true;
+
+						for (int i = 0; i < taps; ++i)
+							fixedSum += fixed[i] = std::llround(static_cast<double>(Weights[i]) * (1 << Shift));
+
+						fixed[Anchor] += std::llround(sum * (1 << Shift)) - fixedSum; // Keep the kernel's gain exact, so that flat regions stay flat
+
+						for (int64_t weight : fixed)
+							fixedAbsoluteSum += std::abs(weight), fits = fits && std::abs(weight) <= INT16_MAX;
+
+						if ((fits && fixedAbsoluteSum * 255 < (int64_t{ 1 } << 30)) || Shift == 0)
+						{
+							FixedWeights.assign(fixed.begin(), fixed.end());
+							break;
+						}
+					}
+				}
+			}
+		};
+
+		// Computes out[x] = sum(weights[k] * inputs[k][x]) for x in [0, count), 32 elements at a time. The inputs are taken in pairs, whose pixels are interleaved and widened to
+		// 16 bits, so that _mm256_madd_epi16 multiplies each pair by its fixed-point weights and sums them into 32 bits. The sums are rounded back to 8 bits (saturated to [0, 255]).
+		// 'out' must not overlap any input
+		inline void ConvolveRow(const uint8_t* const* inputs, const Kernel<uint8_t>& kernel, uint8_t* out, uint64_t count)
+		{
+			__m256i weights[32], rounding = _mm256_set1_epi32(kernel.Shift == 0 ? 0 : 1 << (kernel.Shift - 1)), zero = _mm256_setzero_si256();
+			__m128i shift = _mm_cvtsi32_si128(kernel.Shift);
+			int taps = kernel.Taps, pairs = (taps + 1) / 2;
+
+			if (count >= 32 && taps <= 64)
+			{
+				for (int p = 0; p < pairs; ++p) // The weight of an odd kernel's last input is paired with 0
+					weights[p] = _mm256_set1_epi32(static_cast<uint16_t>(kernel.FixedWeights[2 * p]) | (2 * p + 1 < taps ? static_cast<uint16_t>(kernel.FixedWeights[2 * p + 1]) << 16 : 0));
+
+				for (uint64_t x = 0; x < count; x += 32)
+				{
+					if (x + 32 > count) x = count - 32; // Recompute the last 32 elements (overlapping already computed elements) instead of falling back to scalar operations
+
+					__m256i sums[4] = { zero, zero, zero, zero }; // Elements 0-3, 4-7, 8-11 and 12-15 of each 128-bit lane
+
+					for (int p = 0; p < pairs; ++p)
+					{
+						__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[2 * p] + x));
+						__m256i second = 2 * p + 1 < taps ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[2 * p + 1] + x)) : zero;
+						__m256i low = _mm256_unpacklo_epi8(first, second), high = _mm256_unpackhi_epi8(first, second);
+
+						sums[0] = _mm256_add_epi32(sums[0], _mm256_madd_epi16(_mm256_unpacklo_epi8(low, zero), weights[p]));
+						sums[1] = _mm256_add_epi32(sums[1], _mm256_madd_epi16(_mm256_unpackhi_epi8(low, zero), weights[p]));
+						sums[2] = _mm256_add_epi32(sums[2], _mm256_madd_epi16(_mm256_unpacklo_epi8(high, zero), weights[p]));
+						sums[3] = _mm256_add_epi32(sums[3], _mm256_madd_epi16(_mm256_unpackhi_epi8(high, zero), weights[p]));
+					}
+
+					for (__m256i& sum : sums) sum = _mm256_sra_epi32(_mm256_add_epi32(sum, rounding), shift);
+
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), _mm256_packus_epi16(_mm256_packs_epi32(sums[0], sums[1]), _mm256_packs_epi32(sums[2], sums[3])));
+				}
+			}
+			else
+			{
+				for (uint64_t x = 0; x < count; ++x)
+				{
+					int sum = kernel.Shift == 0 ? 0 : 1 << (kernel.Shift - 1);
+					for (int k = 0; k < taps; ++k) sum += kernel.FixedWeights[k] * inputs[k][x];
+					out[x] = static_cast<uint8_t>(std::clamp(sum >> kernel.Shift, 0, 255));
+				}
+			}
+		}
+
+		// Computes out[x] = sum(weights[k] * inputs[k][x]) for x in [0, count), 16 elements at a time with FMA. 'out' must not overlap any input
+		inline void ConvolveRow(const float* const* inputs, const Kernel<float>& kernel, float* out, uint64_t count)
+		{
+			int taps = kernel.Taps;
+			uint64_t x = 0;
+
+			for (; x + 16 <= count; x += 16)
+			{
+				__m256 sums0 = _mm256_setzero_ps(), sums1 = _mm256_setzero_ps();
+
+				for (int k = 0; k < taps; ++k)
+				{
+					__m256 weight = _mm256_set1_ps(kernel.Weights[k]);
+					sums0 = _mm256_fmadd_ps(_mm256_loadu_ps(inputs[k] + x), weight, sums0);
+					sums1 = _mm256_fmadd_ps(_mm256_loadu_ps(inputs[k] + x + 8), weight, sums1);
+				}
+
+				_mm256_storeu_ps(out + x, sums0);
+				_mm256_storeu_ps(out + x + 8, sums1);
+			}
+
+			if (count >= 8) // Compute the remaining elements 8 at a time, recomputing the last 8 (overlapping already computed elements) instead of falling back to scalar operations
+			{
+				for (; x < count; x += 8)
+				{
+					if (x + 8 > count) x = count - 8;
+
+					__m256 sums = _mm256_setzero_ps();
+					for (int k = 0; k < taps; ++k) sums = _mm256_fmadd_ps(_mm256_loadu_ps(inputs[k] + x), _mm256_set1_ps(kernel.Weights[k]), sums);
+					_mm256_storeu_ps(out + x, sums);
+				}
+			}
+
+			for (; x < count; ++x)
+			{
+				float sum = 0;
+				for (int k = 0; k < taps; ++k) sum += kernel.Weights[k] * inputs[k][x];
+				out[x] = sum;
+			}
+		}
+
+		// Copies the row into 'padded', extending it by the kernel's radius (in pixels) on each side according to the border mode
+		template <typename T>
+		void PadRow(const T* row, uint64_t width, int channels, const Kernel<T>& kernel, BorderMode border, T* padded)
+		{
+			int64_t left = kernel.Anchor, right = kernel.Taps - 1 - kernel.Anchor;
+			std::memcpy(padded + left * channels, row, width * channels * sizeof(T));
+
+			auto padPixel = [&](int64_t x)
+			{
+				int64_t source = BorderIndex(x, width, border);
+				for (int c = 0; c < channels; ++c) padded[(x + left) * channels + c] = source < 0 ? 0 : row[source * channels + c];
+			};
+
+			for (int64_t x = -left; x < 0; ++x) padPixel(x);
+			for (int64_t x = width; x < static_cast<int64_t>(width) + right; ++x) padPixel(x);
+		}
+	};
+
+	// Filters the width x height image 'src' (with 'channels' interleaved channels per pixel) with the separable kernel kernelX (applied along rows) and kernelY
+	// (applied along columns), writing the result to 'dst'. Strides are the number of elements between rows. 'src' and 'dst' may be the same image.
+	// Each source row is read once and filtered horizontally into a ring of tapsY rows (which stays in cache), from which each output row is filtered vertically.
+	// The kernel anchors are at taps / 2. Available for uint8_t (14-bit fixed-point weights, accumulated in 32 bits) and float (FMA accumulation)
+	template <typename T>
+	void SeparableFilter(const T* src, uint64_t srcStride, T* dst, uint64_t dstStride, uint64_t width, uint64_t height, int channels,
+		const float* kernelX, int tapsX, const float* kernelY, int tapsY, BorderMode border = BorderMode::Reflect)
+	{
+		using namespace FilterDetail;
+		CheckType<T>();
+
+		if (width == 0 || height == 0) return;
+
+		Kernel<T> horizontal{ kernelX, tapsX }, vertical{ kernelY, tapsY };
+		uint64_t rowSize = width * channels;
+
+		std::vector<T> padded((width + tapsX - 1) * channels), ring(tapsY * rowSize), zeros(rowSize, 0);
+		std::vector<const T*> columns(tapsX), rows(tapsY);
+		std::vector<int64_t> sourceRows(tapsY);
+
+		for (int k = 0; k < tapsX; ++k) columns[k] = padded.data() + k * channels;
+
+		int64_t filtered = 0; // Source rows [0, filtered) have been filtered horizontally into ring[row % tapsY]
+
+		for (int64_t y = 0; y < static_cast<int64_t>(height); ++y)
+		{
+			int64_t lastRow = -1;
+
+			for (int k = 0; k < tapsY; ++k)
+				lastRow = std::max(lastRow, sourceRows[k] = BorderIndex(y - vertical.Anchor + k, height, border));
+
+			for (; filtered <= lastRow; ++filtered)
+			{
+				PadRow(src + filtered * srcStride, width, channels, horizontal, border, padded.data());
+				ConvolveRow(columns.data(), horizontal, ring.data() + (filtered % tapsY) * rowSize, rowSize);
+			}
+
+			for (int k = 0; k < tapsY; ++k)
+				rows[k] = sourceRows[k] < 0 ? zeros.data() : ring.data() + (sourceRows[k] % tapsY) * rowSize;
+
+			ConvolveRow(rows.data(), vertical, dst + y * dstStride, rowSize);
+		}
+	}
+
+	// Replaces each pixel with the mean of the size x size pixels around it. See SeparableFilter()
+	template <typename T>
+	void BoxBlur(const T* src, uint64_t srcStride, T* dst, uint64_t dstStride, uint64_t width, uint64_t height, int channels, int size, BorderMode border = BorderMode::Reflect)
+	{
+		std::vector<float> kernel(size, 1.0f / size);
+		SeparableFilter(src, srcStride, dst, dstStride, width, height, channels, kernel.data(), size, kernel.data(), size, border);
+	}
+
+	// Returns the normalised size-tap Gaussian kernel with the specified standard deviation. If sigma <= 0, it is derived from the size as 0.3 * ((size - 1) * 0.5 - 1) + 0.8
+	inline std::vector<float> GaussianKernel(int size, double sigma = 0)
+	{
+		if (sigma <= 0) sigma = 0.3 * ((size - 1) * 0.5 - 1) + 0.8;
+
+		std::vector<double> weights(size);
+		double sum = 0;
+
+		for (int i = 0; i < size; ++i)
+		{
+			double x = i - (size - 1) * 0.5;
+			sum += weights[i] = std::exp(-x * x / (2 * sigma * sigma));
+		}
+
+		std::vector<float> kernel(size);
+		for (int i = 0; i < size; ++i) kernel[i] = static_cast<float>(weights[i] / sum);
+
+		return kernel;
+	}
+
+	// Blurs the image with a size x size Gaussian kernel with the specified standard deviation (see GaussianKernel()). See SeparableFilter()
+	template <typename T>
+	void GaussianBlur(const T* src, uint64_t srcStride, T* dst, uint64_t dstStride, uint64_t width, uint64_t height, int channels, int size, double sigma = 0, BorderMode border = BorderMode::Reflect)
+	{
+		std::vector<float> kernel = GaussianKernel(size, sigma);
+		SeparableFilter(src, srcStride, dst, dstStride, width, height, channels, kernel.data(), size, kernel.data(), size, border);
+	}
+};
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef AVX256_FRAMEPOOL_H
+#define AVX256_FRAMEPOOL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace AVX256Utils
+{
+	class FrameBufferPool;
+
+	namespace FramePoolDetail
+	{
+		constexpr uint64_t ALIGNMENT = 64; // A cache line, so buffers are also 32-byte (AVX) aligned
+		constexpr uint64_t HUGE_PAGE = uint64_t{ 2 } << 20;
+
+		// A buffer of the pool, with the number of FrameBuffers referencing it
+		struct Slot
+		{
+			uint8_t* Data = nullptr;
+			uint64_t Bytes = 0; // Allocated, rounded up to whole cache lines (or huge pages)
+			bool IsMapped = false; // Allocated with huge pages by the OS rather than the heap
+			std::atomic<uint32_t> References{ 0 };
+			FrameBufferPool* Pool = nullptr;
+		};
+
+		// Allocates at least 'bytes' bytes aligned to a cache line. With 'hugePages', tries to back them with huge pages (2 MB pages, which need far fewer TLB entries for whole frames),
+		// falling back to 2 MB-aligned heap memory, which Linux can back with transparent huge pages
+		inline void Allocate(Slot& slot, uint64_t bytes, bool hugePages)
+		{
+			uint64_t alignment = hugePages ? HUGE_PAGE : ALIGNMENT;
+			slot.Bytes = (std::max<uint64_t>(bytes, 1) + alignment - 1) / alignment * alignment;
+
+#ifdef _WIN32
+			if (hugePages)
+			{
+				uint64_t largePage = GetLargePageMinimum();
+				uint64_t largeBytes = largePage == 0 ? 0 : (slot.Bytes + largePage - 1) / largePage * largePage;
+				void* data = largeBytes == 0 ? nullptr : VirtualAlloc(nullptr, largeBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE); // Needs SeLockMemoryPrivilege
+				if (data != nullptr) { slot.Data = static_cast<uint8_t*>(data), slot.Bytes = largeBytes, slot.IsMapped = true; return; }
+			}
+
+			slot.Data = static_cast<uint8_t*>(_aligned_malloc(slot.Bytes, alignment));
+#else
+			if (hugePages)
+			{
+				void* data = mmap(nullptr, slot.Bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0); // Needs reserved huge pages
+				if (data != MAP_FAILED) { slot.Data = static_cast<uint8_t*>(data), slot.IsMapped = true; return; }
+			}
+
+			slot.Data = static_cast<uint8_t*>(std::aligned_alloc(alignment, slot.Bytes));
+			if (hugePages && slot.Data != nullptr) madvise(slot.Data, slot.Bytes, MADV_HUGEPAGE);
+#endif
+		}
+
+		inline void Free(Slot& slot)
+		{
+#ifdef _WIN32
+			if (slot.IsMapped) VirtualFree(slot.Data, 0, MEM_RELEASE);
+			else _aligned_free(slot.Data);
+#else
+			if (slot.IsMapped) munmap(slot.Data, slot.Bytes);
+			else std::free(slot.Data);
+#endif
+		}
+	};
+
+	// A reference-counted handle to a buffer of a FrameBufferPool. Copies share the buffer, and the buffer returns to the pool when the last handle is destroyed (or reset).
+	// The pool must outlive its buffers
+	class FrameBuffer
+	{
+	public:
+		FrameBuffer() = default;
+		FrameBuffer(const FrameBuffer& buffer) : Buffer{ buffer.Buffer } { if (Buffer != nullptr) Buffer->References.fetch_add(1, std::memory_order_relaxed); }
+		FrameBuffer(FrameBuffer&& buffer) noexcept : Buffer{ std::exchange(buffer.Buffer, nullptr) } {}
+		~FrameBuffer() { Reset(); }
+
+		FrameBuffer& operator=(FrameBuffer buffer) noexcept
+		{
+			std::swap(Buffer, buffer.Buffer);
+			return *this;
+		}
+
+		// Returns the buffer, aligned to a cache line, or nullptr for an empty handle
+		uint8_t* Data() const { return Buffer == nullptr ? nullptr : Buffer->Data; }
+
+		// Returns the number of handles sharing the buffer
+		uint32_t References() const { return Buffer == nullptr ? 0 : Buffer->References.load(std::memory_order_relaxed); }
+
+		explicit operator bool() const { return Buffer != nullptr; }
+
+		// Releases this handle's reference to the buffer
+		inline void Reset();
+
+	private:
+		friend class FrameBufferPool;
+
+		FramePoolDetail::Slot* Buffer = nullptr;
+
+		explicit FrameBuffer(FramePoolDetail::Slot* buffer) : Buffer{ buffer } { Buffer->References.store(1, std::memory_order_relaxed); }
+	};
+
+	// A pool of preallocated, cache-line aligned buffers of 'bufferSize' bytes for frames. Acquire() hands out a free buffer, which is recycled once no FrameBuffer references it,
+	// so a loop that acquires and releases buffers only allocates until it has as many buffers as it ever holds at once. Buffers can be backed by huge pages
+	class FrameBufferPool
+	{
+	public:
+		// Allocates 'buffers' buffers up front. If 'hugePages', buffers are backed by huge pages where the OS allows it
+		FrameBufferPool(uint64_t bufferSize, uint32_t buffers = 0, bool hugePages = false) : BufferSize{ bufferSize }, HugePages{ hugePages }
+		{
+			std::lock_guard<std::mutex> lock{ Mutex };
+			for (uint32_t i = 0; i < buffers; ++i) Free.push_back(Grow());
+		}
+
+		// Frees the buffers. Every FrameBuffer must have been released
+		~FrameBufferPool() { for (std::unique_ptr<FramePoolDetail::Slot>& slot : Slots) FramePoolDetail::Free(*slot); }
+
+		FrameBufferPool(const FrameBufferPool&) = delete;
+		FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+		// Returns a free buffer, allocating a new one only if every buffer is in use. Its contents are those left by its last user
+		FrameBuffer Acquire()
+		{
+			std::lock_guard<std::mutex> lock{ Mutex };
+			if (Free.empty()) return FrameBuffer{ Grow() };
+
+			FramePoolDetail::Slot* slot = Free.back();
+			Free.pop_back();
+			return FrameBuffer{ slot };
+		}
+
+		uint64_t Size() const { return BufferSize; }
+
+		// Returns the number of buffers allocated by the pool, which stays constant once a loop has reached its steady state
+		uint64_t Allocations() const
+		{
+			std::lock_guard<std::mutex> lock{ Mutex };
+			return Slots.size();
+		}
+
+		// Returns the number of free buffers
+		uint64_t Available() const
+		{
+			std::lock_guard<std::mutex> lock{ Mutex };
+			return Free.size();
+		}
+
+	private:
+		friend class FrameBuffer;
+
+		uint64_t BufferSize;
+		bool HugePages;
+		mutable std::mutex Mutex;
+		std::vector<std::unique_ptr<FramePoolDetail::Slot>> Slots;
+		std::vector<FramePoolDetail::Slot*> Free; // Has room for every buffer, so releasing a buffer never allocates
+
+		FramePoolDetail::Slot* Grow()
+		{
+			Slots.push_back(std::make_unique<FramePoolDetail::Slot>());
+			Free.reserve(Slots.size());
+
+			FramePoolDetail::Slot* slot = Slots.back().get();
+			FramePoolDetail::Allocate(*slot, BufferSize, HugePages);
+			slot->Pool = this;
+			return slot;
+		}
+
+		void Release(FramePoolDetail::Slot* slot)
+		{
+			std::lock_guard<std::mutex> lock{ Mutex };
+			Free.push_back(slot);
+		}
+	};
+
+	inline void FrameBuffer::Reset()
+	{
+		if (Buffer != nullptr && Buffer->References.fetch_sub(1, std::memory_order_acq_rel) == 1) Buffer->Pool->Release(Buffer);
+		Buffer = nullptr;
+	}
+
+	// A current and a previous frame buffer for loops that compare each frame with the one before it. Swap() makes the current frame the previous one, and the next frame is written
+	// over the old previous frame, instead of copying the current frame every iteration
+	class DoubleBuffer
+	{
+	public:
+		explicit DoubleBuffer(FrameBufferPool& pool) : Buffers{ pool.Acquire(), pool.Acquire() } {}
+
+		uint8_t* Current() const { return Buffers[Index].Data(); }
+		uint8_t* Previous() const { return Buffers[Index ^ 1].Data(); }
+
+		void Swap() { Index ^= 1; }
+
+	private:
+		FrameBuffer Buffers[2];
+		int Index = 0;
+	};
+};
+
+#endif
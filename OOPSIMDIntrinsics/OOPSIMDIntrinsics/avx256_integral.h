@@ -0,0 +1,109 @@
+#ifndef AVX256_INTEGRAL_H
+#define AVX256_INTEGRAL_H
+
+#include <type_traits>
+#include <cstdint>
+#include <algorithm>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	namespace IntegralDetail
+	{
+		template <typename T>
+		void CheckType() { static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, float> || std::is_same_v<T, double>, "AVX256: Integral images are only available for uint32_t, float, and double"); }
+
+		// Returns the inclusive prefix sums of the 8 uint32s, computed in-register: within each lane with two shifted adds, then carrying the low lane's total into the high lane
+		inline __m256i PrefixSum8(__m256i values)
+		{
+			values = _mm256_add_epi32(values, _mm256_slli_si256(values, 4));
+			values = _mm256_add_epi32(values, _mm256_slli_si256(values, 8));
+			return _mm256_add_epi32(values, _mm256_permute2x128_si256(_mm256_shuffle_epi32(values, 0xFF), _mm256_shuffle_epi32(values, 0xFF), 0x08));
+		}
+
+		// The row sum up to the previous vector, broadcast across a register of the output type
+		template <typename T> struct Carry;
+		template <> struct Carry<uint32_t> { __m256i Sums = _mm256_setzero_si256(); };
+		template <> struct Carry<float> { __m256 Sums = _mm256_setzero_ps(); };
+		template <> struct Carry<double> { __m256d Sums = _mm256_setzero_pd(); };
+
+		// Computes 8 elements of an output row, out[x] = above[x] + carry + prefix[x], then carries the row sum to the next vector
+		template <typename T>
+		void Row(__m256i prefix, T* out, const T* above, Carry<T>& carry)
+		{
+			if constexpr (std::is_same_v<T, uint32_t>)
+			{
+				carry.Sums = _mm256_add_epi32(prefix, carry.Sums);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi32(carry.Sums, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above))));
+				carry.Sums = _mm256_permutevar8x32_epi32(carry.Sums, _mm256_set1_epi32(7));
+			}
+			else if constexpr (std::is_same_v<T, float>)
+			{
+				carry.Sums = _mm256_add_ps(_mm256_cvtepi32_ps(prefix), carry.Sums);
+				_mm256_storeu_ps(out, _mm256_add_ps(carry.Sums, _mm256_loadu_ps(above)));
+				carry.Sums = _mm256_permutevar8x32_ps(carry.Sums, _mm256_set1_epi32(7));
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				__m256d low = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(prefix)), carry.Sums), high = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(prefix, 1)), carry.Sums);
+				_mm256_storeu_pd(out, _mm256_add_pd(low, _mm256_loadu_pd(above)));
+				_mm256_storeu_pd(out + 4, _mm256_add_pd(high, _mm256_loadu_pd(above + 4)));
+				carry.Sums = _mm256_permute4x64_pd(high, 0xFF);
+			}
+		}
+
+		// Computes row y of an integral image (of the squared pixels if SQUARED) from the row above it
+		template <typename T, bool SQUARED>
+		void IntegralRow(const uint8_t* row, T* integral, uint64_t stride, uint64_t width, uint64_t y)
+		{
+			T* out = integral + (y + 1) * stride + 1;
+			const T* above = out - stride;
+			Carry<T> carry;
+			uint64_t x = 0;
+			out[-1] = 0;
+
+			for (; x + 8 <= width; x += 8)
+			{
+				__m256i pixels = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + x)));
+				if constexpr (SQUARED) pixels = _mm256_madd_epi16(pixels, pixels); // Each dword is (pixel, 0) as int16s, so this is pixel * pixel
+				Row<T>(PrefixSum8(pixels), out + x, above + x, carry);
+			}
+
+			T rowSum = x == 0 ? 0 : out[x - 1] - above[x - 1]; // The remaining pixels continue from the last row sum
+
+			for (; x < width; ++x)
+				out[x] = above[x] + (rowSum += static_cast<T>(SQUARED ? row[x] * row[x] : row[x]));
+		}
+	};
+
+	// Computes the integral image (summed-area table) of the width x height uint8_t image 'src', and optionally the integral image of its squared pixels (if 'squaredSum' is not nullptr).
+	// Like OpenCV, integral images are (width + 1) x (height + 1), with a zero first row and column, so that sum[y][x] is the sum of all pixels above and to the left of (x, y).
+	// Strides are the number of elements between rows. Each row is prefix-summed 8 pixels at a time in registers, and added to the previous output row a whole vector at a time.
+	// uint32_t sums wrap around for large images, but the box sums computed from them (see BoxSum()) are still exact as long as they fit in a uint32_t.
+	// float sums are only exact up to 2^24. Available for uint32_t, float, and double
+	template <typename T>
+	void IntegralImage(const uint8_t* src, uint64_t srcStride, T* sum, uint64_t sumStride, uint64_t width, uint64_t height, T* squaredSum = nullptr, uint64_t squaredStride = 0)
+	{
+		using namespace IntegralDetail;
+		CheckType<T>();
+
+		std::fill(sum, sum + width + 1, T{ 0 });
+		if (squaredSum != nullptr) std::fill(squaredSum, squaredSum + width + 1, T{ 0 });
+
+		for (uint64_t y = 0; y < height; ++y)
+		{
+			IntegralRow<T, false>(src + y * srcStride, sum, sumStride, width, y);
+			if (squaredSum != nullptr) IntegralRow<T, true>(src + y * srcStride, squaredSum, squaredStride, width, y);
+		}
+	}
+
+	// Returns the sum of the width x height box with top-left corner (x, y) from its integral image (see IntegralImage()), with 3 additions
+	template <typename T>
+	T BoxSum(const T* integral, uint64_t stride, uint64_t x, uint64_t y, uint64_t width, uint64_t height)
+	{
+		const T* top = integral + y * stride + x, * bottom = top + height * stride;
+		return bottom[width] - bottom[0] - top[width] + top[0];
+	}
+};
+
+#endif
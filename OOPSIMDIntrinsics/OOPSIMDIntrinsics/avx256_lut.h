@@ -0,0 +1,129 @@
+#ifndef AVX256_LUT_H
+#define AVX256_LUT_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <immintrin.h>
+
+#include "avx256.h"
+
+namespace AVX256Utils
+{
+	namespace LUTDetail
+	{
+		// The 16 rows of 16 entries of a 256-entry table (one row per high nibble), each broadcast to both lanes. They are loaded once per call, as stores to the output could alias the table
+		struct Table
+		{
+			__m256i Rows[16];
+
+			explicit Table(const uint8_t* table)
+			{
+				for (int i = 0; i < 16; ++i) Rows[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * i)));
+			}
+		};
+
+		// Returns the 32 bytes looked up in the 256-entry table. Every row is looked up with the low nibbles using _mm256_shuffle_epi8 (as in Permute8()), and the rows are then
+		// blended in pairs on each bit of the high nibble, from bit 4 (8 blends) to bit 7 (1 blend). _mm256_blendv_epi8 selects on each byte's MSB, so each bit is shifted up to it first
+		inline __m256i Lookup256(__m256i values, const Table& table)
+		{
+			__m256i lowNibbles = _mm256_and_si256(values, _mm256_set1_epi8(0x0F)), rows[8];
+
+			for (int i = 0; i < 8; ++i) rows[i] = _mm256_blendv_epi8(_mm256_shuffle_epi8(table.Rows[2 * i], lowNibbles), _mm256_shuffle_epi8(table.Rows[2 * i + 1], lowNibbles), _mm256_slli_epi16(values, 3));
+			for (int i = 0; i < 4; ++i) rows[i] = _mm256_blendv_epi8(rows[2 * i], rows[2 * i + 1], _mm256_slli_epi16(values, 2));
+			for (int i = 0; i < 2; ++i) rows[i] = _mm256_blendv_epi8(rows[2 * i], rows[2 * i + 1], _mm256_slli_epi16(values, 1));
+
+			return _mm256_blendv_epi8(rows[0], rows[1], values);
+		}
+
+		// Returns the 32 bytes looked up in the 16-entry table with a single shuffle. Only the low nibble of each value is used
+		inline __m256i Lookup16(__m256i values, const uint8_t* table)
+		{
+			return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table))), _mm256_and_si256(values, _mm256_set1_epi8(0x0F)));
+		}
+
+		// Calls lookup(values, i) for each 32 bytes from byte i, and stores the results to 'dst'. The last partial vector is copied out first so that nothing past
+		// the end of the buffers is accessed, and every byte is looked up exactly once, so 'dst' may be 'src'
+		template <typename Lookup>
+		void ForEachVector(const uint8_t* src, uint8_t* dst, uint64_t count, Lookup lookup)
+		{
+			uint64_t i = 0;
+
+			for (; i + 32 <= count; i += 32)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), lookup(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), i));
+
+			if (i != count)
+			{
+				std::array<uint8_t, 32> tail{};
+				std::memcpy(tail.data(), src + i, count - i);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(tail.data()), lookup(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail.data())), i));
+				std::memcpy(dst + i, tail.data(), count - i);
+			}
+		}
+	};
+
+	// Maps each of the 'count' bytes of 'src' through the 256-entry table (dst[i] = table[src[i]]), 32 bytes at a time with 16 in-register lookups blended on the high nibble. 'dst' may be 'src'
+	inline void ApplyLUT256(const uint8_t* src, uint8_t* dst, uint64_t count, const uint8_t* table)
+	{
+		LUTDetail::Table rows{ table };
+		LUTDetail::ForEachVector(src, dst, count, [&rows](__m256i values, uint64_t) { return LUTDetail::Lookup256(values, rows); });
+	}
+
+	// Maps the 32 elements of 'values' through the 256-entry table in place
+	inline AVX256<uint8_t>& ApplyLUT256(AVX256<uint8_t>& values, const uint8_t* table)
+	{
+		ApplyLUT256(values.Data, values.Data, 32, table);
+		return values;
+	}
+
+	// Maps each of the 'count' bytes of 'src' through the 16-entry table (dst[i] = table[src[i] & 15]) with a single in-register lookup per 32 bytes. 'dst' may be 'src'
+	inline void ApplyLUT16(const uint8_t* src, uint8_t* dst, uint64_t count, const uint8_t* table)
+	{
+		LUTDetail::ForEachVector(src, dst, count, [table](__m256i values, uint64_t) { return LUTDetail::Lookup16(values, table); });
+	}
+
+	// Maps the 32 elements of 'values' through the 16-entry table in place (see ApplyLUT16())
+	inline AVX256<uint8_t>& ApplyLUT16(AVX256<uint8_t>& values, const uint8_t* table)
+	{
+		ApplyLUT16(values.Data, values.Data, 32, table);
+		return values;
+	}
+
+	// Maps each channel of the pixels (with 'channels' interleaved channels) through its own 256-entry table, where channel c's table is the 256 bytes from tables + 256 * c. 'dst' may be 'src'.
+	// As a shuffle can only look up the same table for every byte, each byte is instead looked up with _mm256_i32gather_epi32, 8 bytes per gather, at its value plus its channel's table
+	// offset (the offsets of each byte in a vector repeat every 'channels' vectors). If every channel has the same table, the single-table ApplyLUT256() is used instead
+	inline void ApplyLUT256(const uint8_t* src, uint8_t* dst, uint64_t pixels, int channels, const uint8_t* tables)
+	{
+		bool sameTables = true;
+		for (int c = 1; c < channels; ++c) sameTables = sameTables && std::memcmp(tables, tables + 256 * c, 256) == 0;
+		if (sameTables) return ApplyLUT256(src, dst, pixels * channels, tables);
+
+		std::vector<uint8_t> paddedTables(256 * channels + 3); // Each gather reads 4 bytes from the looked up byte
+		std::memcpy(paddedTables.data(), tables, 256 * channels);
+
+		std::vector<std::array<int32_t, 32>> offsets(channels); // offsets[phase] are the table offsets of the bytes of a vector starting at a byte offset of 'phase' channels
+		for (int phase = 0; phase < channels; ++phase)
+			for (int b = 0; b < 32; ++b) offsets[phase][b] = 256 * ((phase + b) % channels);
+
+		LUTDetail::ForEachVector(src, dst, pixels * channels, [&](__m256i values, uint64_t i)
+			{
+				const int32_t* phaseOffsets = offsets[i % channels].data();
+				__m128i low = _mm256_castsi256_si128(values), high = _mm256_extracti128_si256(values, 1), quarters[4] = { low, _mm_srli_si128(low, 8), high, _mm_srli_si128(high, 8) };
+				__m256i bytes[4];
+
+				for (int q = 0; q < 4; ++q)
+				{
+					__m256i indices = _mm256_add_epi32(_mm256_cvtepu8_epi32(quarters[q]), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(phaseOffsets + 8 * q)));
+					bytes[q] = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(paddedTables.data()), indices, 1), _mm256_set1_epi32(0xFF));
+				}
+
+				// Each lane now holds 4 bytes from each gather, i.e. bytes [0-3, 8-11, 16-19, 24-27 | 4-7, 12-15, 20-23, 28-31]
+				__m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(bytes[0], bytes[1]), _mm256_packus_epi32(bytes[2], bytes[3]));
+				return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+			}
+		);
+	}
+};
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef AVX256_MOTION_H
+#define AVX256_MOTION_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <immintrin.h>
+
+#include "avx256.h"
+
+namespace AVX256Utils
+{
+	// The 3x3 morphology applied to the thresholded motion mask. Opening (erode, then dilate) removes isolated changed pixels, closing (dilate, then erode) fills small holes
+	enum class Morphology { None, Erode, Dilate, Open, Close };
+
+	// The result of MotionDetector::Detect(). The bounding box of the changed pixels is inclusive, and is only valid if ChangedPixels > 0
+	struct MotionResult
+	{
+		uint64_t ChangedPixels = 0;
+		int64_t Left = -1, Top = -1, Right = -1, Bottom = -1;
+	};
+
+	// Detects the pixels that changed between two grey frames in a single pass: each row's AbsoluteDifference is compared against the threshold (IsGreaterThan), and the
+	// resulting mask rows are streamed through 3x3 erode/dilate stages (Min/Max of the rows above and below, then of the left and right neighbours), which each lag one row behind
+	// their input, so only a few rows are ever live. The changed-pixel count and bounding box are accumulated from each finished mask row.
+	// Each frame byte is read exactly once, and the row buffers are allocated once per detector rather than per frame. Pixels outside the frame do not affect the morphology
+	class MotionDetector
+	{
+	public:
+		MotionDetector(uint64_t width, uint64_t height, uint8_t threshold, Morphology morphology = Morphology::Open) : Width{ width }, Height{ height }, Pitch{ (width + 31) / 32 * 32 + 2 * PADDING }
+		{
+			Thresholds = threshold;
+
+			if (morphology == Morphology::Erode || morphology == Morphology::Open) Stages.push_back(Stage{ true, {}, {}, {} });
+			if (morphology == Morphology::Dilate || morphology == Morphology::Open || morphology == Morphology::Close) Stages.push_back(Stage{ false, {}, {}, {} });
+			if (morphology == Morphology::Close) Stages.push_back(Stage{ true, {}, {}, {} });
+
+			for (Stage& stage : Stages)
+				stage.Rows.assign(3 * Pitch, 0), stage.Vertical.assign(Pitch, stage.Erode ? UINT8_MAX : 0), stage.Neutral.assign(Pitch, stage.Erode ? UINT8_MAX : 0);
+
+			Output.assign(Pitch, 0);
+		}
+
+		// Detects the pixels that changed between the previous and current frames, writing 255 for changed pixels and 0 otherwise to 'mask' (which is skipped if nullptr).
+		// Strides are the number of bytes between rows. 'mask' must not overlap either frame
+		MotionResult Detect(const uint8_t* previous, const uint8_t* current, uint8_t* mask, uint64_t previousStride, uint64_t currentStride, uint64_t maskStride)
+		{
+			Result = MotionResult{}, Mask = mask, MaskStride = maskStride;
+			if (Width == 0 || Height == 0) return Result;
+
+			for (int64_t y = 0; y < static_cast<int64_t>(Height); ++y)
+			{
+				uint8_t* row = Stages.empty() ? Output.data() : Slot(Stages[0], y);
+				Threshold(previous + y * previousStride, current + y * currentStride, row + PADDING);
+				Emit(0, y);
+			}
+
+			for (size_t s = 0; s < Stages.size(); ++s) // Each stage's last row has no row below it
+				Filter(s, Height - 1);
+
+			return Result;
+		}
+
+		// Detects the pixels that changed between two frames with rows of 'width' bytes. See Detect()
+		MotionResult Detect(const uint8_t* previous, const uint8_t* current, uint8_t* mask) { return Detect(previous, current, mask, Width, Width, Width); }
+
+	private:
+		// Row buffers have 32 bytes before the first pixel and at least 32 after the last, so whole vectors past the last pixel (and the horizontal neighbours of every pixel) can be accessed
+		static constexpr uint64_t PADDING = 32;
+
+		struct Stage
+		{
+			bool Erode;
+			std::vector<uint8_t> Rows, Vertical, Neutral; // The last 3 input rows (row y in slot y % 3), the vertical min/max of the 3 rows, and the row used outside the frame
+		};
+
+		uint64_t Width, Height, Pitch;
+		AVX256<uint8_t> Thresholds{};
+		std::vector<Stage> Stages;
+		std::vector<uint8_t> Output;
+		uint8_t* Mask = nullptr;
+		uint64_t MaskStride = 0;
+		MotionResult Result;
+
+		uint8_t* Slot(Stage& stage, int64_t y) { return stage.Rows.data() + (y % 3) * Pitch; }
+
+		// Writes the threshold mask of |current - previous| (255 where the difference is greater than the threshold) to 'out'. The frames' last partial vector is copied out first
+		// so that nothing past the end of their rows is read. Whole vectors are written, so up to 31 bytes past the end of 'out' are overwritten
+		void Threshold(const uint8_t* previous, const uint8_t* current, uint8_t* out)
+		{
+			AVX256<uint8_t> difference{ out };
+			uint64_t x = 0;
+
+			for (; x + 32 <= Width; x += 32, difference.Next())
+			{
+				difference.Set(current + x).AbsoluteDifference(previous + x);
+				difference = difference > Thresholds;
+			}
+
+			if (x != Width)
+			{
+				std::array<uint8_t, 32> previousTail{}, currentTail{};
+				std::memcpy(previousTail.data(), previous + x, Width - x), std::memcpy(currentTail.data(), current + x, Width - x);
+				difference.Set(currentTail).AbsoluteDifference(previousTail);
+				difference = difference > Thresholds;
+			}
+		}
+
+		// Computes the 3x3 min (erode) or max (dilate) of row y of stage s's input into the next stage's input (or the output row), then passes it on
+		void Filter(size_t s, int64_t y)
+		{
+			Stage& stage = Stages[s];
+			const uint8_t* above = y == 0 ? stage.Neutral.data() : Slot(stage, y - 1);
+			const uint8_t* below = y + 1 == static_cast<int64_t>(Height) ? stage.Neutral.data() : Slot(stage, y + 1);
+			uint8_t* out = s + 1 == Stages.size() ? Output.data() : Slot(Stages[s + 1], y);
+
+			AVX256<uint8_t> vertical{ stage.Vertical.data() + PADDING }, result{ out + PADDING };
+
+			for (uint64_t x = 0; x < Width; x += 32, vertical.Next())
+			{
+				vertical.Set(above + PADDING + x);
+				if (stage.Erode) vertical.Min(Slot(stage, y) + PADDING + x).Min(below + PADDING + x);
+				else vertical.Max(Slot(stage, y) + PADDING + x).Max(below + PADDING + x);
+			}
+
+			stage.Vertical[PADDING + Width] = stage.Erode ? UINT8_MAX : 0; // Restore the padding past the last pixel (the padding before the first pixel is never written)
+
+			for (uint64_t x = 0; x < Width; x += 32, result.Next())
+			{
+				const uint8_t* centre = stage.Vertical.data() + PADDING + x;
+				result.Set(centre - 1);
+				if (stage.Erode) result.Min(centre).Min(centre + 1);
+				else result.Max(centre).Max(centre + 1);
+			}
+
+			Emit(s + 1, y);
+		}
+
+		// Called once row y of stage s's input is ready. Once a stage has the row below row y - 1, row y - 1 can be filtered. Rows past the last stage are finished
+		void Emit(size_t s, int64_t y)
+		{
+			if (s == Stages.size()) Accumulate(y);
+			else if (y > 0) Filter(s, y - 1);
+		}
+
+		// Adds the changed pixels of the finished output row y to the count and bounding box, and copies it to the mask
+		void Accumulate(int64_t y)
+		{
+			const uint8_t* row = Output.data() + PADDING;
+			uint64_t changed = 0;
+			int64_t left = -1, right = -1;
+
+			for (uint64_t x = 0; x < Width; x += 32)
+			{
+				uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x))));
+				if (x + 32 > Width) bits &= (1u << (Width - x)) - 1; // Ignore the bytes past the end of the row
+				if (bits == 0) continue;
+
+				changed += _mm_popcnt_u32(bits);
+				if (left < 0) left = x + _tzcnt_u32(bits);
+				right = x + 31 - _lzcnt_u32(bits);
+			}
+
+			if (changed != 0)
+			{
+				Result.Left = Result.ChangedPixels == 0 ? left : std::min(Result.Left, left);
+				Result.Right = std::max(Result.Right, right);
+				Result.Top = Result.ChangedPixels == 0 ? y : Result.Top;
+				Result.Bottom = y;
+				Result.ChangedPixels += changed;
+			}
+
+			if (Mask != nullptr) std::memcpy(Mask + y * MaskStride, row, Width);
+		}
+	};
+};
+
+#endif
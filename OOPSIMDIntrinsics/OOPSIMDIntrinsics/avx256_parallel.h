@@ -0,0 +1,269 @@
+#ifndef AVX256_PARALLEL_H
+#define AVX256_PARALLEL_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "avx256.h"
+
+namespace AVX256Utils
+{
+	// A persistent pool of worker threads. Run() hands the worker threads (and the calling thread) the tasks of a job, which they take one at a time until there are none left,
+	// so no threads are created or destroyed per job and idle workers sleep on a condition variable. Calling Run() from within one of the pool's tasks runs the nested tasks
+	// on the calling thread, and jobs from different threads are run one after the other
+	class ThreadPool
+	{
+	public:
+		// Creates a pool of 'threads' threads in total, including the thread calling Run(). 0 uses one thread per hardware thread
+		explicit ThreadPool(unsigned threads = 0)
+		{
+			if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+			for (unsigned thread = 1; thread < threads; ++thread) Workers.emplace_back(&ThreadPool::Work, this, thread);
+		}
+
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ Mutex };
+				Stopping = true;
+			}
+
+			WorkAvailable.notify_all();
+			for (std::thread& worker : Workers) worker.join();
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Returns the number of threads that run tasks, including the thread calling Run()
+		unsigned Threads() const { return static_cast<unsigned>(Workers.size()) + 1; }
+
+		// Calls task(index, thread) for each index in [0, tasks) and returns once all have finished. 'thread' is the index (below Threads()) of the thread running the task,
+		// so tasks can keep per-thread state without locking. The calling thread is thread 0
+		template <typename Task>
+		void Run(uint64_t tasks, const Task& task)
+		{
+			if (CurrentPool == this || Workers.empty() || tasks <= 1)
+			{
+				for (uint64_t i = 0; i < tasks; ++i) task(i, CurrentPool == this ? CurrentThread : 0);
+				return;
+			}
+
+			std::lock_guard<std::mutex> runLock{ RunMutex };
+			{
+				std::lock_guard<std::mutex> lock{ Mutex };
+				CurrentJob = Job{ &task, [](const void* context, uint64_t i, unsigned thread) { (*static_cast<const Task*>(context))(i, thread); }, tasks };
+				NextTask = 0;
+				++Generation;
+			}
+
+			WorkAvailable.notify_all();
+			RunTasks(CurrentJob, 0);
+
+			std::unique_lock<std::mutex> lock{ Mutex };
+			CurrentJob.Invoke = nullptr; // Workers that wake up from now on don't join the job
+			WorkDone.wait(lock, [this] { return ActiveWorkers == 0; });
+		}
+
+		// Returns a pool shared by the whole program, with one thread per hardware thread
+		static ThreadPool& Default()
+		{
+			static ThreadPool pool;
+			return pool;
+		}
+
+	private:
+		struct Job
+		{
+			const void* Context = nullptr;
+			void (*Invoke)(const void*, uint64_t, unsigned) = nullptr;
+			uint64_t Tasks = 0;
+		};
+
+		std::vector<std::thread> Workers;
+		std::mutex Mutex, RunMutex;
+		std::condition_variable WorkAvailable, WorkDone;
+		Job CurrentJob;
+		std::atomic<uint64_t> NextTask{ 0 };
+		uint64_t Generation = 0;
+		unsigned ActiveWorkers = 0;
+		bool Stopping = false;
+
+		static inline thread_local const ThreadPool* CurrentPool = nullptr;
+		static inline thread_local unsigned CurrentThread = 0;
+
+		void RunTasks(const Job& job, unsigned thread)
+		{
+			const ThreadPool* previousPool = CurrentPool;
+			unsigned previousThread = CurrentThread;
+			CurrentPool = this, CurrentThread = thread;
+
+			for (uint64_t i = NextTask.fetch_add(1, std::memory_order_relaxed); i < job.Tasks; i = NextTask.fetch_add(1, std::memory_order_relaxed)) job.Invoke(job.Context, i, thread);
+
+			CurrentPool = previousPool, CurrentThread = previousThread;
+		}
+
+		void Work(unsigned thread)
+		{
+			uint64_t seenGeneration = 0;
+			std::unique_lock<std::mutex> lock{ Mutex };
+
+			while (true)
+			{
+				WorkAvailable.wait(lock, [&] { return Stopping || Generation != seenGeneration; });
+				if (Stopping) return;
+
+				seenGeneration = Generation;
+				if (CurrentJob.Invoke == nullptr) continue; // The job has already finished
+
+				Job job = CurrentJob;
+				++ActiveWorkers;
+				lock.unlock();
+
+				RunTasks(job, thread);
+
+				lock.lock();
+				if (--ActiveWorkers == 0) WorkDone.notify_all();
+			}
+		}
+	};
+
+	namespace ParallelDetail
+	{
+		// Returns the number of elements per chunk: 'grain' rounded up to a whole number of cache lines (and so of vectors), so that chunks of a cache-line aligned buffer
+		// never share a cache line. A 'grain' of 0 picks about 4 chunks per thread (for load balancing), of at least 4 KB each
+		template <typename T>
+		uint64_t ChunkSize(uint64_t count, uint64_t grain, unsigned threads)
+		{
+			constexpr uint64_t LINE = 64 / sizeof(T);
+			if (grain == 0) grain = std::max<uint64_t>(4096 / sizeof(T), (count + 4 * threads - 1) / (4 * threads));
+			return (grain + LINE - 1) / LINE * LINE;
+		}
+
+		// The per-thread partial result of a reduction, on its own cache lines
+		template <typename R>
+		struct alignas(64) Partial
+		{
+			R Value;
+		};
+	};
+
+	// Splits the 'count' elements of 'buffer' into chunks of about 'grain' elements (see ParallelDetail::ChunkSize()), and calls kernel(chunk, chunkCount, begin) for each chunk on the pool,
+	// where chunk = buffer + begin. Every chunk but the last is a whole number of vectors (and cache lines), so only the last chunk has a tail, which the kernel must handle
+	template <typename T, typename Kernel>
+	void ParallelFor(T* buffer, uint64_t count, uint64_t grain, const Kernel& kernel, ThreadPool& pool = ThreadPool::Default())
+	{
+		uint64_t chunkSize = ParallelDetail::ChunkSize<T>(count, grain, pool.Threads()), chunks = (count + chunkSize - 1) / chunkSize;
+
+		pool.Run(chunks, [&](uint64_t chunk, unsigned)
+			{
+				uint64_t begin = chunk * chunkSize;
+				kernel(buffer + begin, std::min(chunkSize, count - begin), begin);
+			}
+		);
+	}
+
+	// Calls kernel(values, index) for each 32 bytes of 'buffer' in parallel (see ParallelFor()), where 'values' is an AVX256<T> over the elements from 'index'. The last partial vector is
+	// copied out to a zero-padded vector and back, so the kernel can run whole-vector AVX256 operations on it without accessing past the end of 'buffer', as long as it only accesses 'values'
+	template <typename T, typename Kernel>
+	void ParallelForEachVector(T* buffer, uint64_t count, uint64_t grain, const Kernel& kernel, ThreadPool& pool = ThreadPool::Default())
+	{
+		constexpr uint64_t LANES = 32 / sizeof(T);
+
+		ParallelFor(buffer, count, grain, [&kernel](T* chunk, uint64_t chunkCount, uint64_t begin)
+			{
+				AVX256<T> values{ chunk };
+				uint64_t i = 0;
+
+				for (; i + LANES <= chunkCount; i += LANES, values.Next()) kernel(values, begin + i);
+
+				if (i != chunkCount)
+				{
+					std::array<T, LANES> tail{};
+					std::memcpy(tail.data(), chunk + i, (chunkCount - i) * sizeof(T));
+					AVX256<T> tailValues{ tail.data() };
+					kernel(tailValues, begin + i);
+					std::memcpy(chunk + i, tail.data(), (chunkCount - i) * sizeof(T));
+				}
+			}, pool
+		);
+	}
+
+	// Reduces the 'count' elements of 'buffer' in parallel: each thread folds partial = merge(partial, kernel(chunk, chunkCount, begin)) over the chunks it runs (see ParallelFor())
+	// into its own partial result starting from 'identity', and the partial results are merged at the end. Chunks are taken in no particular order, so 'merge' must be associative and commutative
+	template <typename R, typename T, typename Kernel, typename Merge>
+	R ParallelReduce(const T* buffer, uint64_t count, uint64_t grain, const R& identity, const Kernel& kernel, const Merge& merge, ThreadPool& pool = ThreadPool::Default())
+	{
+		std::vector<ParallelDetail::Partial<R>> partials(pool.Threads(), ParallelDetail::Partial<R>{ identity });
+		uint64_t chunkSize = ParallelDetail::ChunkSize<T>(count, grain, pool.Threads()), chunks = (count + chunkSize - 1) / chunkSize;
+
+		pool.Run(chunks, [&](uint64_t chunk, unsigned thread)
+			{
+				uint64_t begin = chunk * chunkSize;
+				partials[thread].Value = merge(partials[thread].Value, kernel(buffer + begin, std::min(chunkSize, count - begin), begin));
+			}
+		);
+
+		R result = identity;
+		for (const ParallelDetail::Partial<R>& partial : partials) result = merge(result, partial.Value);
+		return result;
+	}
+
+	// Returns the sum of the 'count' elements of 'buffer', summing each vector with AVX256<T>::Sum() (so 32-bit integer vectors have the same overflow) into per-thread 64-bit integer or double
+	// partial sums. Not available for 64-bit integers
+	template <typename T>
+	auto ParallelSum(const T* buffer, uint64_t count, uint64_t grain = 0, ThreadPool& pool = ThreadPool::Default())
+	{
+		using Sum = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+		constexpr uint64_t LANES = 32 / sizeof(T);
+
+		return ParallelReduce(buffer, count, grain, Sum{ 0 }, [](const T* chunk, uint64_t chunkCount, uint64_t)
+			{
+				AVX256<T> values{ const_cast<T*>(chunk) }; // Sum() only reads the elements
+				Sum sum = 0;
+				uint64_t i = 0;
+
+				for (; i + LANES <= chunkCount; i += LANES, values.Next()) sum += static_cast<Sum>(values.Sum());
+				for (; i < chunkCount; ++i) sum += static_cast<Sum>(chunk[i]);
+				return sum;
+			}, [](Sum a, Sum b) { return a + b; }, pool
+		);
+	}
+
+	// Counts the occurrences of each byte value of the 'count' bytes of 'buffer' into histogram[0..255]. Each thread counts into its own partial histogram, which are added together at the end.
+	// Within a chunk, consecutive bytes are counted into 4 separate tables, so runs of equal bytes don't wait on the previous increment of the same counter
+	inline void ParallelHistogram(const uint8_t* buffer, uint64_t count, uint64_t* histogram, uint64_t grain = 0, ThreadPool& pool = ThreadPool::Default())
+	{
+		using Histogram = std::array<uint64_t, 256>;
+
+		Histogram result = ParallelReduce(buffer, count, grain, Histogram{}, [](const uint8_t* chunk, uint64_t chunkCount, uint64_t)
+			{
+				std::array<std::array<uint64_t, 256>, 4> tables{};
+				uint64_t i = 0;
+
+				for (; i + 4 <= chunkCount; i += 4) ++tables[0][chunk[i]], ++tables[1][chunk[i + 1]], ++tables[2][chunk[i + 2]], ++tables[3][chunk[i + 3]];
+				for (; i < chunkCount; ++i) ++tables[0][chunk[i]];
+
+				Histogram counts;
+				for (int value = 0; value < 256; ++value) counts[value] = tables[0][value] + tables[1][value] + tables[2][value] + tables[3][value];
+				return counts;
+			}, [](Histogram a, const Histogram& b)
+			{
+				for (int value = 0; value < 256; ++value) a[value] += b[value];
+				return a;
+			}, pool
+		);
+
+		std::copy(result.begin(), result.end(), histogram);
+	}
+};
+
+#endif
@@ -0,0 +1,233 @@
+#ifndef AVX256_PERF_H
+#define AVX256_PERF_H
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <iterator>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <cpuid.h>
+#endif
+
+namespace AVX256Utils
+{
+	// The hardware events counted by a PerfProbe. Level1License and Level2License count the cycles a core ran at the reduced frequency of its AVX2 (heavy) or AVX-512 licence,
+	// and Throttle the cycles it was halted while changing licence. These are only counted on Intel server cores from Skylake-SP to Ice Lake-SP
+	enum class PerfEvent { Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, Level1License, Level2License, Throttle, Count };
+
+	// The counts of the events during a measured region, and the bytes it accessed. Events that couldn't be counted (e.g. without a PMU, in a VM, or with perf_event_paranoid
+	// too high) are not available and read 0, as does every metric derived from them
+	struct PerfCounters
+	{
+		std::array<uint64_t, static_cast<int>(PerfEvent::Count)> Values{};
+		std::array<bool, static_cast<int>(PerfEvent::Count)> Available{};
+		uint64_t Bytes = 0;
+		uint64_t Regions = 0; // The number of measured regions the counts add up
+
+		uint64_t operator[](PerfEvent event) const { return Values[static_cast<int>(event)]; }
+		bool IsAvailable(PerfEvent event) const { return Available[static_cast<int>(event)]; }
+
+		// Returns instructions per cycle
+		double IPC() const { return Ratio(PerfEvent::Instructions, 1, PerfEvent::Cycles); }
+
+		double BytesPerCycle() const { return IsAvailable(PerfEvent::Cycles) && (*this)[PerfEvent::Cycles] != 0 ? static_cast<double>(Bytes) / (*this)[PerfEvent::Cycles] : 0; }
+
+		// Returns the count of 'event' (e.g. L1DMisses) per KB accessed
+		double PerKB(PerfEvent event) const { return IsAvailable(event) && Bytes != 0 ? (*this)[event] * 1024.0 / Bytes : 0; }
+
+		// Returns the fraction of cycles counted by 'event' (Level1License, Level2License or Throttle)
+		double CycleFraction(PerfEvent event) const { return Ratio(event, 1, PerfEvent::Cycles); }
+
+		// Adds the counts of 'counters', e.g. of each run of a kernel. An event stays available only if it was counted in every region
+		PerfCounters& operator+=(const PerfCounters& counters)
+		{
+			for (int i = 0; i < static_cast<int>(PerfEvent::Count); ++i) Values[i] += counters.Values[i], Available[i] = (Regions == 0 || Available[i]) && counters.Available[i];
+			Bytes += counters.Bytes, Regions += counters.Regions;
+			return *this;
+		}
+
+	private:
+		double Ratio(PerfEvent numerator, double scale, PerfEvent denominator) const
+		{
+			return IsAvailable(numerator) && IsAvailable(denominator) && (*this)[denominator] != 0 ? scale * (*this)[numerator] / (*this)[denominator] : 0;
+		}
+	};
+
+	namespace PerfDetail
+	{
+		constexpr int EVENTS = static_cast<int>(PerfEvent::Count);
+
+		// The events counted in each group, after the group's own Cycles counter which leads it. A group is scheduled onto the PMU as a whole, so its events are counted over
+		// the same time even when the PMU multiplexes, and ratios between them (e.g. IPC) don't mix measurements. The licence events are a second group, as all the events
+		// together need more counters than a core has
+		constexpr int GROUPS = 2;
+		constexpr PerfEvent CORE_EVENTS[] = { PerfEvent::Instructions, PerfEvent::L1DMisses, PerfEvent::LLCMisses, PerfEvent::BranchMisses };
+		constexpr PerfEvent LICENSE_EVENTS[] = { PerfEvent::Level1License, PerfEvent::Level2License, PerfEvent::Throttle };
+
+#ifdef __linux__
+		// Returns true on the Intel cores whose CORE_POWER event (0x28) counts licence cycles: Skylake-SP, Cascade Lake-SP, Cooper Lake and Ice Lake-SP
+		inline bool HasLicenseEvents()
+		{
+			unsigned eax, ebx, ecx, edx;
+			if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx) || ebx != 0x756e6547 || edx != 0x49656e69 || ecx != 0x6c65746e) return false; // "GenuineIntel"
+
+			__get_cpuid(1, &eax, &ebx, &ecx, &edx);
+			unsigned family = (eax >> 8) & 0xF, model = ((eax >> 4) & 0xF) | ((eax >> 12) & 0xF0);
+			return family == 6 && (model == 0x55 || model == 0x6A || model == 0x6C);
+		}
+
+		// Opens a counter of the calling thread's user-space execution, returning -1 if it can't be counted. With a 'leader' of -1 it leads a new group, initially disabled,
+		// and otherwise it joins the leader's group, and is started and stopped with it
+		inline int Open(uint32_t type, uint64_t config, int leader)
+		{
+			perf_event_attr attribute{};
+			attribute.size = sizeof(attribute), attribute.type = type, attribute.config = config;
+			attribute.disabled = leader < 0, attribute.exclude_kernel = 1, attribute.exclude_hv = 1;
+			attribute.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING; // For scaling when groups are multiplexed
+
+			return static_cast<int>(syscall(SYS_perf_event_open, &attribute, 0, -1, leader, 0));
+		}
+
+		inline int Open(PerfEvent event, int leader)
+		{
+			constexpr uint64_t L1D_READ_MISS = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+			switch (event)
+			{
+			case PerfEvent::Cycles: return Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, leader);
+			case PerfEvent::Instructions: return Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, leader);
+			case PerfEvent::L1DMisses: return Open(PERF_TYPE_HW_CACHE, L1D_READ_MISS, leader);
+			case PerfEvent::LLCMisses: return Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, leader);
+			case PerfEvent::BranchMisses: return Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, leader);
+			case PerfEvent::Level1License: return HasLicenseEvents() ? Open(PERF_TYPE_RAW, 0x1828, leader) : -1; // CORE_POWER.LVL1_TURBO_LICENSE
+			case PerfEvent::Level2License: return HasLicenseEvents() ? Open(PERF_TYPE_RAW, 0x2028, leader) : -1; // CORE_POWER.LVL2_TURBO_LICENSE
+			case PerfEvent::Throttle: return HasLicenseEvents() ? Open(PERF_TYPE_RAW, 0x4028, leader) : -1; // CORE_POWER.THROTTLE
+			default: return -1;
+			}
+		}
+#endif
+	};
+
+	// The hardware event counters of the calling thread, opened once (which takes a system call per event) and then started and stopped around each measured region.
+	// Counts only user-space execution, so it works with the default perf_event_paranoid of 2. Without perf_event_open (outside Linux) no events are available.
+	// Events are counted in groups led by a Cycles counter (see PerfDetail::CORE_EVENTS), so an event is only available if its group's Cycles counter is
+	class PerfEvents
+	{
+	public:
+		// Opens a counter for each event that can be counted on this machine
+		PerfEvents()
+		{
+			Descriptors.fill(-1), Leaders.fill(-1);
+#ifdef __linux__
+			auto openGroup = [this](int group, const PerfEvent* events, int count)
+			{
+				Leaders[group] = PerfDetail::Open(PerfEvent::Cycles, -1);
+				if (Leaders[group] < 0) return;
+
+				for (int i = 0; i < count; ++i)
+				{
+					Descriptors[static_cast<int>(events[i])] = PerfDetail::Open(events[i], Leaders[group]);
+					if (Descriptors[static_cast<int>(events[i])] >= 0) Members[group].push_back(events[i]);
+				}
+			};
+
+			openGroup(0, PerfDetail::CORE_EVENTS, static_cast<int>(std::size(PerfDetail::CORE_EVENTS)));
+			Descriptors[static_cast<int>(PerfEvent::Cycles)] = Leaders[0];
+			if (PerfDetail::HasLicenseEvents()) openGroup(1, PerfDetail::LICENSE_EVENTS, static_cast<int>(std::size(PerfDetail::LICENSE_EVENTS)));
+#endif
+		}
+
+		~PerfEvents()
+		{
+#ifdef __linux__
+			for (int i = 0; i < PerfDetail::EVENTS; ++i) if (Descriptors[i] >= 0 && i != static_cast<int>(PerfEvent::Cycles)) close(Descriptors[i]);
+			for (int leader : Leaders) if (leader >= 0) close(leader);
+#endif
+		}
+
+		PerfEvents(const PerfEvents&) = delete;
+		PerfEvents& operator=(const PerfEvents&) = delete;
+
+		bool IsAvailable(PerfEvent event) const { return Descriptors[static_cast<int>(event)] >= 0; }
+
+		// Resets and starts the counters
+		void Start()
+		{
+#ifdef __linux__
+			for (int leader : Leaders) if (leader >= 0) ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP), ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+		}
+
+		// Stops the counters and returns their counts since Start(), scaled up by the time each group was enabled over the time it was counting if the PMU had to multiplex them.
+		// The licence events are scaled by the first group's cycles over their own group's, so that CycleFraction() is a ratio of counts from the same time. An event whose group
+		// was never scheduled onto the PMU is not available
+		PerfCounters Stop()
+		{
+			PerfCounters counters;
+			counters.Regions = 1;
+#ifdef __linux__
+			for (int leader : Leaders) if (leader >= 0) ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+			double coreCycles = 0;
+			for (int group = 0; group < PerfDetail::GROUPS; ++group)
+			{
+				uint64_t values[4 + PerfDetail::EVENTS]; // Number of counters, time enabled, time running, then the leader's count and each member's
+				ssize_t bytes = static_cast<ssize_t>((4 + Members[group].size()) * sizeof(uint64_t));
+				if (Leaders[group] < 0 || read(Leaders[group], values, bytes) != bytes || values[2] == 0) continue;
+
+				double scale = static_cast<double>(values[1]) / values[2], cycles = values[3] * scale;
+				if (group == 0) coreCycles = cycles, counters.Values[static_cast<int>(PerfEvent::Cycles)] = static_cast<uint64_t>(cycles);
+				else if (coreCycles != 0 && values[3] != 0) scale = coreCycles / values[3];
+
+				for (uint64_t i = 0; i < Members[group].size(); ++i)
+					counters.Values[static_cast<int>(Members[group][i])] = static_cast<uint64_t>(values[4 + i] * scale), counters.Available[static_cast<int>(Members[group][i])] = true;
+
+				if (group == 0) counters.Available[static_cast<int>(PerfEvent::Cycles)] = true;
+			}
+#endif
+			return counters;
+		}
+
+		// Returns the calling thread's counters, opened on first use
+		static PerfEvents& ForThread()
+		{
+			thread_local PerfEvents events;
+			return events;
+		}
+
+	private:
+		std::array<int, PerfDetail::EVENTS> Descriptors; // The counter of each event, or -1 if it isn't counted. Cycles is the first group's leader
+		std::array<int, PerfDetail::GROUPS> Leaders; // The Cycles counter leading each group
+		std::array<std::vector<PerfEvent>, PerfDetail::GROUPS> Members; // The other events of each group, in the order they are read
+	};
+
+	// Counts the calling thread's hardware events from its construction to its destruction, e.g. around a kernel call, and adds them (with 'bytes', the bytes the region accesses)
+	// to 'counters'. Probes using the same PerfEvents can't be nested
+	class PerfProbe
+	{
+	public:
+		explicit PerfProbe(PerfCounters& counters, uint64_t bytes = 0, PerfEvents& events = PerfEvents::ForThread()) : Counters{ counters }, Events{ events }, Bytes{ bytes } { Events.Start(); }
+
+		~PerfProbe()
+		{
+			PerfCounters counters = Events.Stop();
+			counters.Bytes = Bytes;
+			Counters += counters;
+		}
+
+		PerfProbe(const PerfProbe&) = delete;
+		PerfProbe& operator=(const PerfProbe&) = delete;
+
+	private:
+		PerfCounters& Counters;
+		PerfEvents& Events;
+		uint64_t Bytes;
+	};
+};
+
+#endif
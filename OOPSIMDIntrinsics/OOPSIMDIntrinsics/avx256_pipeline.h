@@ -0,0 +1,203 @@
+#ifndef AVX256_PIPELINE_H
+#define AVX256_PIPELINE_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	// A bounded lock-free single-producer single-consumer ring buffer. One thread pushes and one thread pops, and each only writes its own index (on its own cache line),
+	// keeping a cached copy of the other's index which it only reloads when the ring looks full (or empty)
+	template <typename T>
+	class SPSCRing
+	{
+	public:
+		// Creates a ring of at least 'capacity' elements (rounded up to a power of 2)
+		explicit SPSCRing(uint64_t capacity)
+		{
+			uint64_t size = 1;
+			while (size < capacity) size *= 2;
+			Slots.resize(size), Mask = size - 1;
+		}
+
+		// Pushes 'value', returning false if the ring is full. Only called by the producer
+		bool TryPush(const T& value)
+		{
+			uint64_t tail = Tail.load(std::memory_order_relaxed);
+
+			if (tail - CachedHead > Mask)
+			{
+				CachedHead = Head.load(std::memory_order_acquire);
+				if (tail - CachedHead > Mask) return false;
+			}
+
+			Slots[tail & Mask] = value;
+			Tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Pops the oldest element into 'value', returning false if the ring is empty. Only called by the consumer
+		bool TryPop(T& value)
+		{
+			uint64_t head = Head.load(std::memory_order_relaxed);
+
+			if (head == CachedTail)
+			{
+				CachedTail = Tail.load(std::memory_order_acquire);
+				if (head == CachedTail) return false;
+			}
+
+			value = Slots[head & Mask];
+			Head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		uint64_t Capacity() const { return Mask + 1; }
+
+	private:
+		std::vector<T> Slots;
+		uint64_t Mask;
+		alignas(64) std::atomic<uint64_t> Head{ 0 }; // The next element to pop, written by the consumer
+		uint64_t CachedTail = 0;
+		alignas(64) std::atomic<uint64_t> Tail{ 0 }; // The next element to push, written by the producer
+		uint64_t CachedHead = 0;
+	};
+
+	// The time a pipeline stage spent in its function (busy) and waiting for a frame from its neighbours (back-pressure or starvation)
+	struct StageStatistics
+	{
+		uint64_t Frames = 0;
+		double BusySeconds = 0, MaxSeconds = 0, WaitSeconds = 0;
+
+		double MeanSeconds() const { return Frames == 0 ? 0 : BusySeconds / Frames; }
+	};
+
+	// The statistics of each stage of a FramePipeline run, and the latency of each displayed frame from the start of its capture to the end of its sink
+	struct PipelineStatistics
+	{
+		StageStatistics Capture, Compute, Sink;
+		double MeanLatencySeconds = 0, MaxLatencySeconds = 0;
+	};
+
+	namespace PipelineDetail
+	{
+		using Clock = std::chrono::steady_clock;
+
+		constexpr uint32_t END = UINT32_MAX; // Sent in place of a frame index once capture has stopped
+
+		inline double Seconds(Clock::time_point start, Clock::time_point end) { return std::chrono::duration<double>(end - start).count(); }
+
+		// Pops an element of 'ring', waiting for one by spinning on _mm_pause(), then yielding, then sleeping, and adds the time waited to 'stats'. Gives up when 'stop' returns true
+		template <typename T, typename Stop>
+		bool Pop(SPSCRing<T>& ring, T& value, StageStatistics& stats, const Stop& stop)
+		{
+			Clock::time_point start = Clock::now();
+			bool popped = true;
+
+			for (unsigned step = 0; !ring.TryPop(value); ++step)
+			{
+				if (stop()) { popped = false; break; }
+
+				if (step < 64) _mm_pause();
+				else if (step < 1024) std::this_thread::yield();
+				else std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+			}
+
+			stats.WaitSeconds += Seconds(start, Clock::now());
+			return popped;
+		}
+
+		// Calls function(), adding its duration to 'stats', and returns its start time
+		template <typename Function>
+		Clock::time_point Time(StageStatistics& stats, const Function& function)
+		{
+			Clock::time_point start = Clock::now();
+			function();
+			double seconds = Seconds(start, Clock::now());
+
+			++stats.Frames, stats.BusySeconds += seconds, stats.MaxSeconds = std::max(stats.MaxSeconds, seconds);
+			return start;
+		}
+	};
+
+	// Runs a capture, a compute, and a sink stage on a stream of frames concurrently, so that e.g. decoding the next frame overlaps processing and displaying the current one.
+	// A fixed set of 'depth' preallocated frames circulates between the stages through SPSC rings (capture -> compute -> sink -> capture), so no frames are allocated or copied
+	// while running, and a stage that runs ahead waits for the next stage to hand back a frame (back-pressure), which bounds the latency to 'depth' frames
+	template <typename Frame>
+	class FramePipeline
+	{
+	public:
+		// Creates 'depth' (at least 2) frames as copies of 'prototype'
+		explicit FramePipeline(uint32_t depth, const Frame& prototype = Frame{}) : Frames(std::max(depth, 2u), prototype) {}
+
+		// Runs capture(frame) and compute(frame) on their own threads and sink(frame) on the calling thread (which may need to be the UI thread), in that order for each frame,
+		// until capture() or sink() returns false, and returns the statistics of the run. Frames are filled by capture() and keep their contents between uses
+		template <typename Capture, typename Compute, typename Sink>
+		PipelineStatistics Run(const Capture& capture, const Compute& compute, const Sink& sink)
+		{
+			using namespace PipelineDetail;
+
+			uint32_t depth = static_cast<uint32_t>(Frames.size());
+			SPSCRing<uint32_t> free{ depth + 1 }, captured{ depth + 1 }, computed{ depth + 1 }; // Room for every frame and END, so pushes never fail
+			std::vector<Clock::time_point> starts(depth);
+			std::atomic<bool> stopping{ false };
+			PipelineStatistics stats;
+
+			for (uint32_t i = 0; i < depth; ++i) free.TryPush(i);
+
+			std::thread captureThread{ [&]
+				{
+					uint32_t i = 0;
+					bool more = true;
+
+					while (more && !stopping.load(std::memory_order_relaxed) && Pop(free, i, stats.Capture, [&] { return stopping.load(std::memory_order_relaxed); }))
+					{
+						starts[i] = Time(stats.Capture, [&] { more = capture(Frames[i]); });
+						if (more) captured.TryPush(i);
+					}
+
+					captured.TryPush(END);
+				}
+			};
+
+			std::thread computeThread{ [&]
+				{
+					uint32_t i = 0;
+
+					do
+					{
+						Pop(captured, i, stats.Compute, [] { return false; });
+						if (i != END) Time(stats.Compute, [&] { compute(Frames[i]); });
+						computed.TryPush(i);
+					} while (i != END);
+				}
+			};
+
+			for (uint32_t i = 0; Pop(computed, i, stats.Sink, [] { return false; }) && i != END; free.TryPush(i))
+			{
+				if (stopping.load(std::memory_order_relaxed)) continue; // Frames still in flight are handed back unseen
+
+				bool more = true;
+				Time(stats.Sink, [&] { more = sink(Frames[i]); });
+				if (!more) stopping.store(true, std::memory_order_relaxed);
+
+				double latency = Seconds(starts[i], Clock::now());
+				stats.MeanLatencySeconds += latency, stats.MaxLatencySeconds = std::max(stats.MaxLatencySeconds, latency);
+			}
+
+			captureThread.join(), computeThread.join();
+			if (stats.Sink.Frames != 0) stats.MeanLatencySeconds /= stats.Sink.Frames;
+			return stats;
+		}
+
+	private:
+		std::vector<Frame> Frames;
+	};
+};
+
+#endif
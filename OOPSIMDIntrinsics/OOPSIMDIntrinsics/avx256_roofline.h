@@ -0,0 +1,318 @@
+#ifndef AVX256_ROOFLINE_H
+#define AVX256_ROOFLINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <iomanip>
+#include <immintrin.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "avx256.h"
+#include "avx256_bench.h"
+#include "avx256_dispatch.h"
+#include "avx256_framepool.h"
+
+namespace AVX256Utils
+{
+	// The level of the memory hierarchy a working set fits in
+	enum class MemoryLevel { L1, L2, L3, DRAM };
+
+	// The per-core L1 data and L2 cache sizes, and the shared L3 size, in bytes
+	struct CacheSizes
+	{
+		uint64_t L1 = 32 << 10, L2 = 1 << 20, L3 = 8 << 20;
+	};
+
+	// The attainable bandwidth of a level, measured by the STREAM kernels over three arrays of doubles: Copy (c = a), Scale (b = s * c), Add (c = a + b) and Triad
+	// (a = b + s * c). Each kernel loads and stores whole vectors (512-bit where the CPU supports AVX-512) with intrinsics, keeping the values in registers in between, so only the
+	// loads and stores reach memory. Bandwidths are in GB/s, of each kernel's fastest run, counting the bytes each kernel reads and writes as STREAM does (i.e. not the reads that write-allocate caches add for stores)
+	struct StreamResult
+	{
+		MemoryLevel Level = MemoryLevel::L1;
+		uint64_t WorkingSet = 0; // Bytes of all three arrays
+		double Copy = 0, Scale = 0, Add = 0, Triad = 0;
+
+		double Attainable() const { return std::max({ Copy, Scale, Add, Triad }); }
+	};
+
+	// Where a kernel variant sits on the roofline of a level. The roofline is the lower of the compute ceiling (see MeasureComputePeak()), which is the same for every kernel and
+	// variant, and the level's attainable bandwidth times the variant's arithmetic intensity. Intensity is in elements processed per byte accessed, so that kernels on bytes,
+	// pixels and floats are all measured by the work they do rather than by an estimate of their instructions
+	struct RooflineResult
+	{
+		std::string Kernel, Variant;
+		MemoryLevel Level = MemoryLevel::L1;
+		uint64_t WorkingSet = 0; // Bytes accessed per run
+		double GBPerSecond = 0, AttainableGBPerSecond = 0;
+		double Intensity = 0; // Elements per byte
+		double ElementsPerSecond = 0, PeakElementsPerSecond = 0;
+
+		// Returns true if the level's bandwidth, rather than the compute ceiling, bounds it
+		bool MemoryBound() const { return Intensity * AttainableGBPerSecond * 1e9 < PeakElementsPerSecond; }
+
+		double RooflineElementsPerSecond() const { return std::min(PeakElementsPerSecond, Intensity * AttainableGBPerSecond * 1e9); }
+
+		// Returns the achieved fraction of the roofline. Memory-bound variants near 1 are saturating the level, and gain nothing from fewer instructions
+		double Fraction() const { return RooflineElementsPerSecond() == 0 ? 0 : ElementsPerSecond / RooflineElementsPerSecond(); }
+
+		double BandwidthFraction() const { return AttainableGBPerSecond == 0 ? 0 : GBPerSecond / AttainableGBPerSecond; }
+	};
+
+	namespace RooflineDetail
+	{
+		inline const char* Name(MemoryLevel level)
+		{
+			const char* names[] = { "L1", "L2", "L3", "DRAM" };
+			return names[static_cast<int>(level)];
+		}
+
+		// The STREAM kernels, each applied to one vector of the three arrays
+		enum class StreamKernel { Copy, Scale, Add, Triad };
+
+		constexpr double STREAM_SCALAR = 3.0;
+		constexpr uint64_t STREAM_UNROLL = 4; // Vectors per iteration of the STREAM loops, so that the loop overhead doesn't limit the L1 bandwidth
+
+		template <StreamKernel KERNEL>
+		AVX256_TARGET("avx2") inline void StreamVector256(double* a, double* b, double* c, __m256d scalar)
+		{
+			if constexpr (KERNEL == StreamKernel::Copy) _mm256_storeu_pd(c, _mm256_loadu_pd(a));
+			else if constexpr (KERNEL == StreamKernel::Scale) _mm256_storeu_pd(b, _mm256_mul_pd(scalar, _mm256_loadu_pd(c)));
+			else if constexpr (KERNEL == StreamKernel::Add) _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+			else _mm256_storeu_pd(a, _mm256_add_pd(_mm256_loadu_pd(b), _mm256_mul_pd(scalar, _mm256_loadu_pd(c))));
+		}
+
+		template <StreamKernel KERNEL>
+		AVX256_TARGET("avx512f") inline void StreamVector512(double* a, double* b, double* c, __m512d scalar)
+		{
+			if constexpr (KERNEL == StreamKernel::Copy) _mm512_storeu_pd(c, _mm512_loadu_pd(a));
+			else if constexpr (KERNEL == StreamKernel::Scale) _mm512_storeu_pd(b, _mm512_mul_pd(scalar, _mm512_loadu_pd(c)));
+			else if constexpr (KERNEL == StreamKernel::Add) _mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(a), _mm512_loadu_pd(b)));
+			else _mm512_storeu_pd(a, _mm512_add_pd(_mm512_loadu_pd(b), _mm512_mul_pd(scalar, _mm512_loadu_pd(c))));
+		}
+
+		// Applies the kernel to the three arrays of 'elements' doubles (a multiple of 8 * STREAM_UNROLL), STREAM_UNROLL vectors per iteration
+		template <StreamKernel KERNEL>
+		AVX256_TARGET("avx2") inline void Stream256(double* a, double* b, double* c, uint64_t elements)
+		{
+			__m256d scalar = _mm256_set1_pd(STREAM_SCALAR);
+			for (uint64_t i = 0; i < elements; i += 4 * STREAM_UNROLL)
+			{
+				StreamVector256<KERNEL>(a + i, b + i, c + i, scalar), StreamVector256<KERNEL>(a + i + 4, b + i + 4, c + i + 4, scalar);
+				StreamVector256<KERNEL>(a + i + 8, b + i + 8, c + i + 8, scalar), StreamVector256<KERNEL>(a + i + 12, b + i + 12, c + i + 12, scalar);
+			}
+		}
+
+		template <StreamKernel KERNEL>
+		AVX256_TARGET("avx512f") inline void Stream512(double* a, double* b, double* c, uint64_t elements)
+		{
+			__m512d scalar = _mm512_set1_pd(STREAM_SCALAR);
+			for (uint64_t i = 0; i < elements; i += 8 * STREAM_UNROLL)
+			{
+				StreamVector512<KERNEL>(a + i, b + i, c + i, scalar), StreamVector512<KERNEL>(a + i + 8, b + i + 8, c + i + 8, scalar);
+				StreamVector512<KERNEL>(a + i + 16, b + i + 16, c + i + 16, scalar), StreamVector512<KERNEL>(a + i + 24, b + i + 24, c + i + 24, scalar);
+			}
+		}
+
+		// Returns the bandwidth of the fastest run, as STREAM reports, so that the ceiling isn't lowered by runs that were interrupted
+		inline double BestGBPerSecond(const BenchmarkResult& result) { return result.MinSeconds == 0 ? 0 : result.Bytes / result.MinSeconds / 1e9; }
+
+		// Applies the kernel with the widest vectors the CPU supports, as the dispatched kernels (see avx256_dispatch.h) do, so that no kernel can outrun the bandwidth measured
+		template <StreamKernel KERNEL>
+		void Stream(double* a, double* b, double* c, uint64_t elements, bool avx512)
+		{
+			if (avx512) Stream512<KERNEL>(a, b, c, elements);
+			else Stream256<KERNEL>(a, b, c, elements);
+
+			BenchDetail::ClobberMemory();
+		}
+	};
+
+	// Returns the cache sizes of this machine, or the defaults of CacheSizes where the OS doesn't report one
+	inline CacheSizes DetectCacheSizes()
+	{
+		CacheSizes caches;
+
+#ifdef _WIN32
+		DWORD length = 0;
+		GetLogicalProcessorInformation(nullptr, &length);
+		std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> processors(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+		if (!processors.empty() && GetLogicalProcessorInformation(processors.data(), &length))
+			for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& processor : processors)
+				if (processor.Relationship == RelationCache && processor.Cache.Type != CacheInstruction)
+				{
+					if (processor.Cache.Level == 1) caches.L1 = processor.Cache.Size;
+					else if (processor.Cache.Level == 2) caches.L2 = processor.Cache.Size;
+					else if (processor.Cache.Level == 3) caches.L3 = processor.Cache.Size;
+				}
+#elif defined(_SC_LEVEL1_DCACHE_SIZE)
+		long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE), l2 = sysconf(_SC_LEVEL2_CACHE_SIZE), l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+		if (l1 > 0) caches.L1 = l1;
+		if (l2 > 0) caches.L2 = l2;
+		if (l3 > 0) caches.L3 = l3;
+#endif
+
+		return caches;
+	}
+
+	// Returns the bytes a kernel should access per run to measure 'level': half of each cache, leaving room for the stack and code, and four times the L3 for DRAM (as STREAM requires)
+	inline uint64_t WorkingSetSize(MemoryLevel level, const CacheSizes& caches)
+	{
+		switch (level)
+		{
+		case MemoryLevel::L1: return caches.L1 / 2;
+		case MemoryLevel::L2: return caches.L2 / 2;
+		case MemoryLevel::L3: return caches.L3 / 2;
+		default: return caches.L3 * 4;
+		}
+	}
+
+	// Measures the attainable bandwidth of 'level' with each STREAM kernel over three arrays totalling 'workingSet' bytes, timed by Benchmark() with 'options'
+	inline StreamResult MeasureStream(MemoryLevel level, uint64_t workingSet, const BenchmarkOptions& options)
+	{
+		using RooflineDetail::StreamKernel;
+
+		constexpr uint64_t BLOCK = 8 * RooflineDetail::STREAM_UNROLL;
+		uint64_t elements = std::max<uint64_t>(workingSet / 3 / sizeof(double) / BLOCK * BLOCK, BLOCK);
+		bool avx512 = IsSupported(InstructionSet::AVX512);
+
+		// Cache-line aligned like the kernels' buffers, so that no vector is split across cache lines
+		FrameBufferPool pool{ elements * sizeof(double), 3 };
+		FrameBuffer bufferA = pool.Acquire(), bufferB = pool.Acquire(), bufferC = pool.Acquire();
+		double *a = reinterpret_cast<double*>(bufferA.Data()), *b = reinterpret_cast<double*>(bufferB.Data()), *c = reinterpret_cast<double*>(bufferC.Data());
+		std::fill(a, a + elements, 1.0), std::fill(b, b + elements, 2.0), std::fill(c, c + elements, 0.0);
+		auto none = [] {};
+
+		StreamResult result;
+		result.Level = level, result.WorkingSet = 3 * elements * sizeof(double);
+
+		result.Copy = RooflineDetail::BestGBPerSecond(Benchmark("copy", "STREAM", 2 * elements * sizeof(double), elements, options, none,
+			[&] { RooflineDetail::Stream<StreamKernel::Copy>(a, b, c, elements, avx512); }));
+		result.Scale = RooflineDetail::BestGBPerSecond(Benchmark("scale", "STREAM", 2 * elements * sizeof(double), elements, options, none,
+			[&] { RooflineDetail::Stream<StreamKernel::Scale>(a, b, c, elements, avx512); }));
+		result.Add = RooflineDetail::BestGBPerSecond(Benchmark("add", "STREAM", 3 * elements * sizeof(double), elements, options, none,
+			[&] { RooflineDetail::Stream<StreamKernel::Add>(a, b, c, elements, avx512); }));
+		result.Triad = RooflineDetail::BestGBPerSecond(Benchmark("triad", "STREAM", 3 * elements * sizeof(double), elements, options, none,
+			[&] { RooflineDetail::Stream<StreamKernel::Triad>(a, b, c, elements, avx512); }));
+
+		return result;
+	}
+
+	// Returns the compute ceiling in elements per second: the rate at which the core applies AVX256<uint8_t>::Add() to vectors kept in registers (the register-mode throughput
+	// of the operations suite, see MeasureOperation()), counting each of the 32 lanes as an element. It bounds any kernel that needs at least one vector operation per 32 elements,
+	// and is lower for kernels with wider elements or more operations per element
+	inline double MeasureComputePeak(const BenchmarkOptions& options)
+	{
+		std::vector<uint8_t> initial(32, 1), operands(BenchDetail::OPERANDS * 32, 3);
+		std::vector<double> samples;
+
+		BenchDetail::MeasureChains<OperationMode::Register>([](uint8_t* vector, const uint8_t* operand) { AVX256<uint8_t>{ vector }.Add(operand); }, initial.data(), operands.data(),
+			options, &samples);
+
+		std::sort(samples.begin(), samples.end());
+		double seconds = BenchDetail::Percentile(samples, 0.5);
+		return seconds == 0 ? 0 : 32 / seconds;
+	}
+
+	// Places each kernel result on the roofline of the level it was measured at, given by the stream result of the same level and the compute ceiling 'peakElementsPerSecond'
+	// (see MeasureComputePeak()). A ceiling that a kernel exceeded was measured too low, so it is raised to that kernel's throughput, and no kernel is ever beyond 100% of a ceiling
+	inline std::vector<RooflineResult> Roofline(const std::vector<std::pair<MemoryLevel, BenchmarkResult>>& results, const std::vector<StreamResult>& streams,
+		double peakElementsPerSecond)
+	{
+		std::vector<RooflineResult> roofline;
+		for (const std::pair<MemoryLevel, BenchmarkResult>& result : results) peakElementsPerSecond = std::max(peakElementsPerSecond, result.second.ElementsPerSecond());
+
+		for (const std::pair<MemoryLevel, BenchmarkResult>& result : results)
+		{
+			RooflineResult point;
+			point.Kernel = result.second.Kernel, point.Variant = result.second.Variant, point.Level = result.first, point.WorkingSet = result.second.Bytes;
+			point.GBPerSecond = result.second.GBPerSecond(), point.ElementsPerSecond = result.second.ElementsPerSecond();
+			point.Intensity = result.second.Bytes == 0 ? 0 : static_cast<double>(result.second.Elements) / result.second.Bytes, point.PeakElementsPerSecond = peakElementsPerSecond;
+
+			for (const StreamResult& stream : streams) if (stream.Level == result.first) point.AttainableGBPerSecond = stream.Attainable();
+			for (const std::pair<MemoryLevel, BenchmarkResult>& other : results)
+				if (other.first == result.first) point.AttainableGBPerSecond = std::max(point.AttainableGBPerSecond, other.second.GBPerSecond());
+
+			roofline.push_back(point);
+		}
+
+		return roofline;
+	}
+
+	// The stream results of each level and the roofline of each kernel variant at each level
+	struct RooflineReport
+	{
+		std::vector<StreamResult> Streams;
+		std::vector<RooflineResult> Kernels;
+	};
+
+	// Writes one row per kernel variant and level, with a header row. The stream results are given by the attainable bandwidth of each row
+	inline void WriteCSV(std::ostream& out, const RooflineReport& report)
+	{
+		out << "kernel,variant,level,working_set,gb_per_s,attainable_gb_per_s,bandwidth_fraction,intensity,elements_per_s,peak_elements_per_s,roofline_elements_per_s,roofline_fraction,bound\n"
+			<< std::setprecision(6);
+
+		for (const RooflineResult& result : report.Kernels)
+			out << result.Kernel << ',' << result.Variant << ',' << RooflineDetail::Name(result.Level) << ',' << result.WorkingSet << ',' << result.GBPerSecond << ','
+				<< result.AttainableGBPerSecond << ',' << result.BandwidthFraction() << ',' << result.Intensity << ',' << result.ElementsPerSecond << ',' << result.PeakElementsPerSecond << ','
+				<< result.RooflineElementsPerSecond() << ',' << result.Fraction() << ',' << (result.MemoryBound() ? "memory" : "compute") << '\n';
+	}
+
+	// Writes the stream results of each level and the roofline of each kernel variant at each level
+	inline void WriteJSON(std::ostream& out, const BenchmarkOptions& options, const RooflineReport& report)
+	{
+		out << "{\n  \"warmup\": " << options.Warmup << ",\n  \"repetitions\": " << options.Repetitions << ",\n  \"streams\": [" << std::setprecision(6);
+
+		for (uint64_t i = 0; i < report.Streams.size(); ++i)
+		{
+			const StreamResult& stream = report.Streams[i];
+			out << (i == 0 ? "\n" : ",\n") << "    { \"level\": \"" << RooflineDetail::Name(stream.Level) << "\", \"working_set\": " << stream.WorkingSet << ", \"copy\": " << stream.Copy
+				<< ", \"scale\": " << stream.Scale << ", \"add\": " << stream.Add << ", \"triad\": " << stream.Triad << " }";
+		}
+
+		out << "\n  ],\n  \"kernels\": [";
+
+		for (uint64_t i = 0; i < report.Kernels.size(); ++i)
+		{
+			const RooflineResult& result = report.Kernels[i];
+			out << (i == 0 ? "\n" : ",\n") << "    { \"kernel\": \"" << BenchDetail::EscapeJSON(result.Kernel) << "\", \"variant\": \"" << BenchDetail::EscapeJSON(result.Variant)
+				<< "\", \"level\": \"" << RooflineDetail::Name(result.Level) << "\", \"working_set\": " << result.WorkingSet << ", \"gb_per_s\": " << result.GBPerSecond
+				<< ", \"attainable_gb_per_s\": " << result.AttainableGBPerSecond << ", \"intensity\": " << result.Intensity << ", \"elements_per_s\": " << result.ElementsPerSecond
+				<< ", \"peak_elements_per_s\": " << result.PeakElementsPerSecond << ", \"roofline_fraction\": " << result.Fraction() << ", \"bound\": \""
+				<< (result.MemoryBound() ? "memory" : "compute") << "\" }";
+		}
+
+		out << "\n  ]\n}\n";
+	}
+
+	// Writes Markdown tables of the stream results and of the kernel rooflines. Bandwidths are in GB/s and throughputs in Melements/s
+	inline void WriteTable(std::ostream& out, const RooflineReport& report)
+	{
+		out << "| Level | Working set KB | Copy | Scale | Add | Triad |\n|---|--:|--:|--:|--:|--:|\n" << std::fixed << std::setprecision(2);
+
+		for (const StreamResult& stream : report.Streams)
+			out << "| " << RooflineDetail::Name(stream.Level) << " | " << stream.WorkingSet / 1024 << " | " << stream.Copy << " | " << stream.Scale << " | " << stream.Add << " | "
+				<< stream.Triad << " |\n";
+
+		out << "\n| Kernel | Variant | Level | GB/s | Of attainable | Elements/B | Melements/s | Of roofline | Bound |\n|---|---|---|--:|--:|--:|--:|--:|---|\n";
+
+		for (const RooflineResult& result : report.Kernels)
+			out << "| " << result.Kernel << " | " << result.Variant << " | " << RooflineDetail::Name(result.Level) << " | " << result.GBPerSecond << " | "
+				<< result.BandwidthFraction() * 100 << "% | " << result.Intensity << " | " << result.ElementsPerSecond / 1e6 << " | " << result.Fraction() * 100 << "% | "
+				<< (result.MemoryBound() ? "Memory" : "Compute") << " |\n";
+
+		out << std::defaultfloat;
+	}
+};
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef AVX256_SCHEDULER_H
+#define AVX256_SCHEDULER_H
+
+#include <type_traits>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <immintrin.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "avx256_parallel.h"
+
+namespace AVX256Utils
+{
+	// A Chase-Lev work-stealing deque (in the C11 formulation of Le et al.) of up to CAPACITY (a power of 2) lock-free, trivially copyable elements. Its owner thread pushes and pops
+	// at the bottom (LIFO), and any other thread can steal from the top (FIFO). Only a pop of the last element and steals synchronise with a compare-and-swap
+	template <typename T, uint64_t CAPACITY>
+	class ChaseLevDeque
+	{
+		static_assert(CAPACITY != 0 && (CAPACITY & (CAPACITY - 1)) == 0, "AVX256: ChaseLevDeque's capacity must be a power of 2");
+		static_assert(std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free, "AVX256: ChaseLevDeque is only available for lock-free element types");
+
+	public:
+		// Pushes 'value' to the bottom, returning false if the deque is full. Only called by the owner
+		bool Push(T value)
+		{
+			int64_t bottom = Bottom.load(std::memory_order_relaxed), top = Top.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<int64_t>(CAPACITY)) return false;
+
+			Elements[bottom & (CAPACITY - 1)].store(value, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Pops the bottom (newest) element into 'value', returning false if the deque is empty (or its last element was stolen). Only called by the owner
+		bool Pop(T& value)
+		{
+			int64_t bottom = Bottom.load(std::memory_order_relaxed) - 1;
+			Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t top = Top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			value = Elements[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+			if (top != bottom) return true;
+
+			bool won = Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed); // The last element, which thieves race for
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		// Steals the top (oldest) element into 'value', returning false if the deque is empty or another thread took the element first. Called by any thread
+		bool Steal(T& value)
+		{
+			int64_t top = Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t bottom = Bottom.load(std::memory_order_acquire);
+			if (top >= bottom) return false;
+
+			value = Elements[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+			return Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+		// Returns the number of elements, which may be out of date as soon as it is returned if other threads are using the deque
+		uint64_t Size() const { return static_cast<uint64_t>(std::max<int64_t>(0, Bottom.load(std::memory_order_relaxed) - Top.load(std::memory_order_relaxed))); }
+
+	private:
+		alignas(64) std::atomic<int64_t> Top{ 0 }; // Top and Bottom are on separate cache lines, as thieves only write Top and the owner mostly writes Bottom
+		alignas(64) std::atomic<int64_t> Bottom{ 0 };
+		alignas(64) std::atomic<T> Elements[CAPACITY];
+	};
+
+	// Runs range kernels over [0, count) on a pool of threads that balance uneven work by stealing. Each thread starts with its own contiguous slice of the range in its deque, so repeated runs
+	// over the same buffer tend to give each thread the same slice (and its cache contents). A thread splits the ranges it takes in half, pushing the upper half to its deque, until they are
+	// a single chunk, which it runs. Idle threads steal the oldest (and so largest) ranges of random other threads, backing off from spinning to yielding to sleeping while there are none,
+	// and sleep on a condition variable between runs. Calling Run() from within a kernel runs the nested range on the calling thread, and runs from different threads are run one after the other
+	class WorkStealingScheduler
+	{
+	public:
+		// Creates a scheduler of 'threads' threads in total, including the thread calling Run(). 0 uses one thread per hardware thread. If 'pinThreads', worker i is pinned to logical processor i
+		explicit WorkStealingScheduler(unsigned threads = 0, bool pinThreads = false)
+		{
+			if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+			for (unsigned thread = 0; thread < threads; ++thread) Deques.emplace_back(std::make_unique<Deque>());
+			for (unsigned thread = 1; thread < threads; ++thread)
+			{
+				Workers.emplace_back(&WorkStealingScheduler::Work, this, thread);
+				if (pinThreads) Pin(Workers.back(), thread % std::max(1u, std::thread::hardware_concurrency()));
+			}
+		}
+
+		~WorkStealingScheduler()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ Mutex };
+				Stopping = true;
+			}
+
+			WorkAvailable.notify_all();
+			for (std::thread& worker : Workers) worker.join();
+		}
+
+		WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+		WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+		// Returns the number of threads that run kernels, including the thread calling Run()
+		unsigned Threads() const { return static_cast<unsigned>(Deques.size()); }
+
+		// Calls kernel(begin, end, thread) for ranges [begin, end) of up to 'chunkSize' elements covering [0, count), and returns once all have finished. Ranges start at multiples of
+		// 'chunkSize'. 'thread' is the index (below Threads()) of the thread running the kernel, and the calling thread is thread 0
+		template <typename Kernel>
+		void Run(uint64_t count, uint64_t chunkSize, const Kernel& kernel)
+		{
+			chunkSize = std::max({ chunkSize, uint64_t{ 1 }, count >> 31 }); // Ranges of chunks are packed into 32-bit halves
+			uint64_t chunks = (count + chunkSize - 1) / chunkSize;
+
+			if (CurrentScheduler == this || Workers.empty() || chunks <= 1)
+			{
+				for (uint64_t begin = 0; begin < count; begin += chunkSize) kernel(begin, std::min(begin + chunkSize, count), CurrentScheduler == this ? CurrentThread : 0);
+				return;
+			}
+
+			std::lock_guard<std::mutex> runLock{ RunMutex };
+			{
+				std::lock_guard<std::mutex> lock{ Mutex }; // No worker is running, so the deques can be seeded from this thread
+				CurrentJob = Job{ &kernel, [](const void* context, uint64_t begin, uint64_t end, unsigned thread) { (*static_cast<const Kernel*>(context))(begin, end, thread); }, count, chunkSize };
+				RemainingChunks.store(chunks, std::memory_order_relaxed);
+
+				for (uint64_t thread = 0, threads = std::min<uint64_t>(Threads(), chunks); thread < threads; ++thread)
+					Deques[thread]->Push(Pack(chunks * thread / threads, chunks * (thread + 1) / threads));
+
+				++Generation;
+			}
+
+			WorkAvailable.notify_all();
+			RunRanges(CurrentJob, 0);
+
+			std::unique_lock<std::mutex> lock{ Mutex };
+			CurrentJob.Invoke = nullptr; // Workers that wake up from now on don't join the job
+			WorkDone.wait(lock, [this] { return ActiveWorkers == 0; });
+		}
+
+		// Returns a scheduler shared by the whole program, with one thread per hardware thread
+		static WorkStealingScheduler& Default()
+		{
+			static WorkStealingScheduler scheduler;
+			return scheduler;
+		}
+
+	private:
+		// Ranges of chunks are packed as begin << 32 | end. Each deque holds at most its seed range and one half of each split of it
+		using Deque = ChaseLevDeque<uint64_t, 64>;
+
+		struct Job
+		{
+			const void* Context = nullptr;
+			void (*Invoke)(const void*, uint64_t, uint64_t, unsigned) = nullptr;
+			uint64_t Count = 0, ChunkSize = 0;
+		};
+
+		// Waits a little longer each time there is no work to steal: spinning on _mm_pause() for up to 64 iterations, then yielding, then sleeping
+		struct Backoff
+		{
+			unsigned Step = 0;
+
+			void Wait()
+			{
+				if (Step < 7) for (unsigned i = 0; i < 1u << Step; ++i) _mm_pause();
+				else if (Step < 23) std::this_thread::yield();
+				else std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+
+				Step = std::min(Step + 1, 23u);
+			}
+		};
+
+		std::vector<std::unique_ptr<Deque>> Deques; // Deques[thread], aligned to cache lines
+		std::vector<std::thread> Workers;
+		std::mutex Mutex, RunMutex;
+		std::condition_variable WorkAvailable, WorkDone;
+		Job CurrentJob;
+		std::atomic<uint64_t> RemainingChunks{ 0 };
+		uint64_t Generation = 0;
+		unsigned ActiveWorkers = 0;
+		bool Stopping = false;
+
+		static inline thread_local const WorkStealingScheduler* CurrentScheduler = nullptr;
+		static inline thread_local unsigned CurrentThread = 0;
+
+		static uint64_t Pack(uint64_t begin, uint64_t end) { return begin << 32 | end; }
+
+		static void Pin(std::thread& thread, unsigned processor)
+		{
+#ifdef _WIN32
+			SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{ 1 } << (processor % (8 * sizeof(DWORD_PTR))));
+#else
+			cpu_set_t processors;
+			CPU_ZERO(&processors);
+			CPU_SET(processor, &processors);
+			pthread_setaffinity_np(thread.native_handle(), sizeof(processors), &processors);
+#endif
+		}
+
+		// Runs a range of chunks, splitting off and pushing its upper half until it is a single chunk
+		void RunRange(const Job& job, uint64_t range, unsigned thread)
+		{
+			uint64_t begin = range >> 32, end = range & UINT32_MAX;
+
+			while (end - begin > 1)
+			{
+				uint64_t middle = begin + (end - begin) / 2;
+				if (!Deques[thread]->Push(Pack(middle, end))) break; // Full, so the rest of the range is run here
+				end = middle;
+			}
+
+			for (uint64_t chunk = begin; chunk < end; ++chunk) job.Invoke(job.Context, chunk * job.ChunkSize, std::min((chunk + 1) * job.ChunkSize, job.Count), thread);
+			RemainingChunks.fetch_sub(end - begin, std::memory_order_acq_rel);
+		}
+
+		// Runs ranges from this thread's deque, and steals from the others when it is empty, until every chunk has been run
+		void RunRanges(const Job& job, unsigned thread)
+		{
+			const WorkStealingScheduler* previousScheduler = CurrentScheduler;
+			unsigned previousThread = CurrentThread;
+			CurrentScheduler = this, CurrentThread = thread;
+
+			uint64_t random = 0x9E3779B97F4A7C15ull * (thread + 1), range;
+			Backoff backoff;
+
+			while (RemainingChunks.load(std::memory_order_acquire) != 0)
+			{
+				bool found = Deques[thread]->Pop(range);
+
+				for (unsigned attempt = 0; !found && attempt < Threads(); ++attempt)
+				{
+					random ^= random << 13, random ^= random >> 7, random ^= random << 17; // xorshift64
+					unsigned victim = static_cast<unsigned>(random % Threads());
+					found = victim != thread && Deques[victim]->Steal(range);
+				}
+
+				if (found) RunRange(job, range, thread), backoff = Backoff{};
+				else backoff.Wait();
+			}
+
+			CurrentScheduler = previousScheduler, CurrentThread = previousThread;
+		}
+
+		void Work(unsigned thread)
+		{
+			uint64_t seenGeneration = 0;
+			std::unique_lock<std::mutex> lock{ Mutex };
+
+			while (true)
+			{
+				WorkAvailable.wait(lock, [&] { return Stopping || Generation != seenGeneration; });
+				if (Stopping) return;
+
+				seenGeneration = Generation;
+				if (CurrentJob.Invoke == nullptr) continue; // The job has already finished
+
+				Job job = CurrentJob;
+				++ActiveWorkers;
+				lock.unlock();
+
+				RunRanges(job, thread);
+
+				lock.lock();
+				if (--ActiveWorkers == 0) WorkDone.notify_all();
+			}
+		}
+	};
+
+	// Splits the 'count' elements of 'buffer' into chunks of about 'grain' elements (rounded up to whole cache lines, see ParallelFor()), and calls kernel(chunk, chunkCount, begin) for each
+	// chunk on the work-stealing scheduler, where chunk = buffer + begin. For kernels whose work per chunk varies, e.g. sparse or data-dependent kernels. A 'grain' of 0 picks about 16 chunks
+	// per thread, of at least 4 KB each
+	template <typename T, typename Kernel>
+	void ParallelForStealing(T* buffer, uint64_t count, uint64_t grain, const Kernel& kernel, WorkStealingScheduler& scheduler = WorkStealingScheduler::Default())
+	{
+		if (grain == 0) grain = std::max<uint64_t>(4096 / sizeof(T), count / (16 * uint64_t{ scheduler.Threads() }));
+
+		scheduler.Run(count, ParallelDetail::ChunkSize<T>(count, grain, scheduler.Threads()), [&](uint64_t begin, uint64_t end, unsigned)
+			{
+				kernel(buffer + begin, end - begin, begin);
+			}
+		);
+	}
+};
+
+#endif
@@ -0,0 +1,693 @@
+#ifndef AVX256_SIMD_H
+#define AVX256_SIMD_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+// The instructions of each vector width, from which SIMD<T, Bits> (avx256.h) composes its operations. SIMD<T, 512> is only available when compiling for AVX-512F, BW and DQ (e.g. -mavx512f -mavx512bw -mavx512dq, /arch:AVX512, or the AVX256_AVX512 CMake option). Kernels for several
+// widths are built in separate translation units and selected at run-time as in avx256_dispatch.h
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__)
+#define AVX256_HAS_AVX512 1
+#else
+#define AVX256_HAS_AVX512 0
+#endif
+
+namespace AVX256Utils
+{
+	namespace SIMDDetail
+	{
+		// The instructions of one vector width for elements of type T. Every register is held as an integer vector, and cast for floating-point instructions (casts are free).
+		// SIMD<T, Bits> composes its operations from these, so each operation has the same semantics at every width
+		template <int Bits, typename T>
+		struct Backend;
+
+		template <typename T>
+		struct Backend<128, T>
+		{
+			using Register = __m128i;
+
+			static Register Load(const void* data) { return _mm_loadu_si128(static_cast<const __m128i*>(data)); }
+			static void Store(void* data, Register value) { _mm_storeu_si128(static_cast<__m128i*>(data), value); }
+
+			// Loads the first 'bytes' bytes (the rest are 0) or stores them, through a copy so that nothing past them is accessed
+			static Register LoadPartial(const void* data, uint64_t bytes) { alignas(16) uint8_t copy[16]{}; std::memcpy(copy, data, bytes); return Load(copy); }
+			static void StorePartial(void* data, Register value, uint64_t bytes) { alignas(16) uint8_t copy[16]; Store(copy, value); std::memcpy(data, copy, bytes); }
+
+			static Register Zero() { return _mm_setzero_si128(); }
+			static Register Ones() { return _mm_set1_epi32(-1); }
+
+			static Register Set1(T value)
+			{
+				if constexpr (std::is_same_v<T, double>) return _mm_castpd_si128(_mm_set1_pd(value));
+				else if constexpr (std::is_same_v<T, float>) return _mm_castps_si128(_mm_set1_ps(value));
+				else if constexpr (sizeof(T) == 8) return _mm_set1_epi64x(static_cast<int64_t>(value));
+				else if constexpr (sizeof(T) == 4) return _mm_set1_epi32(static_cast<int32_t>(value));
+				else if constexpr (sizeof(T) == 2) return _mm_set1_epi16(static_cast<int16_t>(value));
+				else return _mm_set1_epi8(static_cast<char>(value));
+			}
+
+			static Register Add(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_add_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_add_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return _mm_add_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm_add_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_add_epi16(a, b);
+				else return _mm_add_epi8(a, b);
+			}
+
+			static Register Sub(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_sub_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_sub_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return _mm_sub_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm_sub_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_sub_epi16(a, b);
+				else return _mm_sub_epi8(a, b);
+			}
+
+			// 16 and 8-bit integers only
+			static Register AddSaturate(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm_adds_epi16(a, b) : _mm_adds_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm_adds_epi8(a, b) : _mm_adds_epu8(a, b);
+			}
+
+			// 16 and 8-bit integers only
+			static Register SubSaturate(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm_subs_epi16(a, b) : _mm_subs_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm_subs_epi8(a, b) : _mm_subs_epu8(a, b);
+			}
+
+			// Floating-point, and 64 (the low 32 bits), 32 and 16-bit (the low half of the product) integers
+			static Register Mul(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_mul_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_mul_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return std::is_signed_v<T> ? _mm_mul_epi32(a, b) : _mm_mul_epu32(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm_mullo_epi32(a, b);
+				else return _mm_mullo_epi16(a, b);
+			}
+
+			static Register Div(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_div_pd(PD(a), PD(b)));
+				else return I(_mm_div_ps(PS(a), PS(b)));
+			}
+
+			static Register And(Register a, Register b) { return _mm_and_si128(a, b); }
+			static Register Or(Register a, Register b) { return _mm_or_si128(a, b); }
+			static Register Xor(Register a, Register b) { return _mm_xor_si128(a, b); }
+
+			// 64, 32 and 16-bit integers only
+			static Register ShiftLeft(Register a, int shift)
+			{
+				if constexpr (sizeof(T) == 8) return _mm_slli_epi64(a, shift);
+				else if constexpr (sizeof(T) == 4) return _mm_slli_epi32(a, shift);
+				else return _mm_slli_epi16(a, shift);
+			}
+
+			// Arithmetic for signed, logical for unsigned integers. 64-bit (unsigned), 32 and 16-bit integers only
+			static Register ShiftRight(Register a, int shift)
+			{
+				if constexpr (sizeof(T) == 8) return _mm_srli_epi64(a, shift);
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm_srai_epi32(a, shift) : _mm_srli_epi32(a, shift);
+				else return std::is_signed_v<T> ? _mm_srai_epi16(a, shift) : _mm_srli_epi16(a, shift);
+			}
+
+			// There are no variable shifts (shifting each element by its own count), which were added to 128-bit vectors by AVX2
+
+			// Floating-point, and 32, 16 and 8-bit integers only
+			static Register Min(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_min_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_min_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm_min_epi32(a, b) : _mm_min_epu32(a, b);
+				else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm_min_epi16(a, b) : _mm_min_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm_min_epi8(a, b) : _mm_min_epu8(a, b);
+			}
+
+			// Floating-point, and 32, 16 and 8-bit integers only
+			static Register Max(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_max_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_max_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm_max_epi32(a, b) : _mm_max_epu32(a, b);
+				else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm_max_epi16(a, b) : _mm_max_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm_max_epi8(a, b) : _mm_max_epu8(a, b);
+			}
+
+			// 32, 16 and 8-bit signed integers only
+			static Register Abs(Register a)
+			{
+				if constexpr (sizeof(T) == 4) return _mm_abs_epi32(a);
+				else if constexpr (sizeof(T) == 2) return _mm_abs_epi16(a);
+				else return _mm_abs_epi8(a);
+			}
+
+			// The rounded-up mean of 16 and 8-bit unsigned integers
+			static Register Average(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return _mm_avg_epu16(a, b);
+				else return _mm_avg_epu8(a, b);
+			}
+
+			// All 1's where a == b. Floating-point comparisons are unordered (true if either is NaN)
+			static Register Equal(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_or_pd(_mm_cmpeq_pd(PD(a), PD(b)), _mm_cmpunord_pd(PD(a), PD(b))));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_or_ps(_mm_cmpeq_ps(PS(a), PS(b)), _mm_cmpunord_ps(PS(a), PS(b))));
+				else if constexpr (sizeof(T) == 8) return _mm_cmpeq_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm_cmpeq_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(a, b);
+				else return _mm_cmpeq_epi8(a, b);
+			}
+
+			// All 1's where a > b. Floating-point comparisons are ordered (false if either is NaN). Unsigned integers are compared as signed after flipping their sign bits
+			static Register Greater(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_cmpgt_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm_cmpgt_ps(PS(a), PS(b)));
+				else if constexpr (!std::is_signed_v<T>)
+				{
+					using Signed = std::make_signed_t<T>;
+					Register sign = Set1(static_cast<T>(T{ 1 } << (8 * sizeof(T) - 1)));
+					return Backend<128, Signed>::Greater(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+				}
+				else if constexpr (sizeof(T) == 8) return _mm_cmpgt_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm_cmpgt_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_cmpgt_epi16(a, b);
+				else return _mm_cmpgt_epi8(a, b);
+			}
+
+			static bool IsZero(Register a) { return _mm_testz_si128(a, a) != 0; }
+
+			static Register Sqrt(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_sqrt_pd(PD(a)));
+				else return I(_mm_sqrt_ps(PS(a)));
+			}
+
+			static Register Floor(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_floor_pd(PD(a)));
+				else return I(_mm_floor_ps(PS(a)));
+			}
+
+			static Register Ceil(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm_ceil_pd(PD(a)));
+				else return I(_mm_ceil_ps(PS(a)));
+			}
+
+			// Approximations with a relative error < 1.5*2^-12, for floats only
+			static Register Inverse(Register a) { return I(_mm_rcp_ps(PS(a))); }
+			static Register InverseSqrt(Register a) { return I(_mm_rsqrt_ps(PS(a))); }
+
+			// Interleave the low or high 8 bytes of each 16-byte lane of a and b, and pack the 16-bit integers of each lane of a then b into 8-bit integers with saturation
+			static Register UnpackLow8(Register a, Register b) { return _mm_unpacklo_epi8(a, b); }
+			static Register UnpackHigh8(Register a, Register b) { return _mm_unpackhi_epi8(a, b); }
+			static Register PackUnsigned16(Register a, Register b) { return _mm_packus_epi16(a, b); }
+			static Register PackSigned16(Register a, Register b) { return _mm_packs_epi16(a, b); }
+
+			// Sums each 8 bytes into a 64-bit integer, and multiplies 16-bit integers and sums each pair of products into a 32-bit integer
+			static Register SumBytes(Register a) { return _mm_sad_epu8(a, _mm_setzero_si128()); }
+			static Register MulAdd16(Register a, Register b) { return _mm_madd_epi16(a, b); }
+
+			// Horizontal sums of 64-bit integers, 32-bit integers (with wraparound) and floating-point elements
+			static uint64_t ReduceAdd64(Register a) { return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_add_epi64(a, _mm_unpackhi_epi64(a, a)))); }
+
+			static uint32_t ReduceAdd32(Register a)
+			{
+				a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0b01001110));
+				return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_add_epi32(a, _mm_shuffle_epi32(a, 0b10110001))));
+			}
+
+			static T ReduceAdd(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return _mm_cvtsd_f64(_mm_add_sd(PD(a), _mm_unpackhi_pd(PD(a), PD(a))));
+				else
+				{
+					__m128 sums = _mm_add_ps(PS(a), _mm_movehl_ps(PS(a), PS(a)));
+					return _mm_cvtss_f32(_mm_add_ss(sums, _mm_shuffle_ps(sums, sums, 0b01)));
+				}
+			}
+
+		private:
+			static __m128d PD(Register a) { return _mm_castsi128_pd(a); }
+			static __m128 PS(Register a) { return _mm_castsi128_ps(a); }
+			static Register I(__m128d a) { return _mm_castpd_si128(a); }
+			static Register I(__m128 a) { return _mm_castps_si128(a); }
+		};
+
+		template <typename T>
+		struct Backend<256, T>
+		{
+			using Register = __m256i;
+
+			// Unaligned loads and stores of integer vectors. These only need AVX, unlike _mm256_loadu_epi8/16/32/64 and _mm256_storeu_epi8/16/32/64, which outside MSVC are AVX-512VL masked moves
+			static Register Load(const void* data) { return _mm256_loadu_si256(static_cast<const __m256i*>(data)); }
+			static void Store(void* data, Register value) { _mm256_storeu_si256(static_cast<__m256i*>(data), value); }
+
+			static Register LoadPartial(const void* data, uint64_t bytes) { alignas(32) uint8_t copy[32]{}; std::memcpy(copy, data, bytes); return Load(copy); }
+			static void StorePartial(void* data, Register value, uint64_t bytes) { alignas(32) uint8_t copy[32]; Store(copy, value); std::memcpy(data, copy, bytes); }
+
+			static Register Zero() { return _mm256_setzero_si256(); }
+			static Register Ones() { return _mm256_set1_epi32(-1); }
+
+			static Register Set1(T value)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_set1_pd(value));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_set1_ps(value));
+				else if constexpr (sizeof(T) == 8) return _mm256_set1_epi64x(static_cast<int64_t>(value));
+				else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int32_t>(value));
+				else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(static_cast<int16_t>(value));
+				else return _mm256_set1_epi8(static_cast<char>(value));
+			}
+
+			static Register Add(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_add_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_add_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return _mm256_add_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_add_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_add_epi16(a, b);
+				else return _mm256_add_epi8(a, b);
+			}
+
+			static Register Sub(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_sub_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_sub_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return _mm256_sub_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_sub_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_sub_epi16(a, b);
+				else return _mm256_sub_epi8(a, b);
+			}
+
+			static Register AddSaturate(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_adds_epi16(a, b) : _mm256_adds_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm256_adds_epi8(a, b) : _mm256_adds_epu8(a, b);
+			}
+
+			static Register SubSaturate(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_subs_epi16(a, b) : _mm256_subs_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm256_subs_epi8(a, b) : _mm256_subs_epu8(a, b);
+			}
+
+			static Register Mul(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_mul_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_mul_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return std::is_signed_v<T> ? _mm256_mul_epi32(a, b) : _mm256_mul_epu32(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_mullo_epi32(a, b);
+				else return _mm256_mullo_epi16(a, b);
+			}
+
+			static Register Div(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_div_pd(PD(a), PD(b)));
+				else return I(_mm256_div_ps(PS(a), PS(b)));
+			}
+
+			static Register And(Register a, Register b) { return _mm256_and_si256(a, b); }
+			static Register Or(Register a, Register b) { return _mm256_or_si256(a, b); }
+			static Register Xor(Register a, Register b) { return _mm256_xor_si256(a, b); }
+
+			static Register ShiftLeft(Register a, int shift)
+			{
+				if constexpr (sizeof(T) == 8) return _mm256_slli_epi64(a, shift);
+				else if constexpr (sizeof(T) == 4) return _mm256_slli_epi32(a, shift);
+				else return _mm256_slli_epi16(a, shift);
+			}
+
+			static Register ShiftRight(Register a, int shift)
+			{
+				if constexpr (sizeof(T) == 8) return _mm256_srli_epi64(a, shift);
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm256_srai_epi32(a, shift) : _mm256_srli_epi32(a, shift);
+				else return std::is_signed_v<T> ? _mm256_srai_epi16(a, shift) : _mm256_srli_epi16(a, shift);
+			}
+
+			// Shift each element by the matching element of 'shifts'. 64 and 32-bit integers only (64-bit unsigned only to the right)
+			static Register ShiftLeft(Register a, Register shifts)
+			{
+				if constexpr (sizeof(T) == 8) return _mm256_sllv_epi64(a, shifts);
+				else return _mm256_sllv_epi32(a, shifts);
+			}
+
+			static Register ShiftRight(Register a, Register shifts)
+			{
+				if constexpr (sizeof(T) == 8) return _mm256_srlv_epi64(a, shifts);
+				else return std::is_signed_v<T> ? _mm256_srav_epi32(a, shifts) : _mm256_srlv_epi32(a, shifts);
+			}
+
+			static Register Min(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_min_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_min_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm256_min_epi32(a, b) : _mm256_min_epu32(a, b);
+				else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_min_epi16(a, b) : _mm256_min_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm256_min_epi8(a, b) : _mm256_min_epu8(a, b);
+			}
+
+			static Register Max(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_max_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_max_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm256_max_epi32(a, b) : _mm256_max_epu32(a, b);
+				else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm256_max_epi16(a, b) : _mm256_max_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm256_max_epi8(a, b) : _mm256_max_epu8(a, b);
+			}
+
+			static Register Abs(Register a)
+			{
+				if constexpr (sizeof(T) == 4) return _mm256_abs_epi32(a);
+				else if constexpr (sizeof(T) == 2) return _mm256_abs_epi16(a);
+				else return _mm256_abs_epi8(a);
+			}
+
+			static Register Average(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return _mm256_avg_epu16(a, b);
+				else return _mm256_avg_epu8(a, b);
+			}
+
+			static Register Equal(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_cmp_pd(PD(a), PD(b), _CMP_EQ_UQ));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_cmp_ps(PS(a), PS(b), _CMP_EQ_UQ));
+				else if constexpr (sizeof(T) == 8) return _mm256_cmpeq_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+				else return _mm256_cmpeq_epi8(a, b);
+			}
+
+			// Unsigned integers are compared as signed after flipping their sign bits
+			static Register Greater(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_cmp_pd(PD(a), PD(b), _CMP_GT_OQ));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm256_cmp_ps(PS(a), PS(b), _CMP_GT_OQ));
+				else if constexpr (!std::is_signed_v<T>)
+				{
+					using Signed = std::make_signed_t<T>;
+					Register sign = Set1(static_cast<T>(T{ 1 } << (8 * sizeof(T) - 1)));
+					return Backend<256, Signed>::Greater(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+				}
+				else if constexpr (sizeof(T) == 8) return _mm256_cmpgt_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm256_cmpgt_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_cmpgt_epi16(a, b);
+				else return _mm256_cmpgt_epi8(a, b);
+			}
+
+			static bool IsZero(Register a) { return _mm256_testz_si256(a, a) != 0; }
+
+			static Register Sqrt(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_sqrt_pd(PD(a)));
+				else return I(_mm256_sqrt_ps(PS(a)));
+			}
+
+			static Register Floor(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_floor_pd(PD(a)));
+				else return I(_mm256_floor_ps(PS(a)));
+			}
+
+			static Register Ceil(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm256_ceil_pd(PD(a)));
+				else return I(_mm256_ceil_ps(PS(a)));
+			}
+
+			static Register Inverse(Register a) { return I(_mm256_rcp_ps(PS(a))); }
+			static Register InverseSqrt(Register a) { return I(_mm256_rsqrt_ps(PS(a))); }
+
+			static Register UnpackLow8(Register a, Register b) { return _mm256_unpacklo_epi8(a, b); }
+			static Register UnpackHigh8(Register a, Register b) { return _mm256_unpackhi_epi8(a, b); }
+			static Register PackUnsigned16(Register a, Register b) { return _mm256_packus_epi16(a, b); }
+			static Register PackSigned16(Register a, Register b) { return _mm256_packs_epi16(a, b); }
+
+			static Register SumBytes(Register a) { return _mm256_sad_epu8(a, _mm256_setzero_si256()); }
+			static Register MulAdd16(Register a, Register b) { return _mm256_madd_epi16(a, b); }
+
+			// The two 128-bit lanes are added, and summed by the 128-bit backend
+			static uint64_t ReduceAdd64(Register a) { return Backend<128, T>::ReduceAdd64(_mm_add_epi64(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1))); }
+			static uint32_t ReduceAdd32(Register a) { return Backend<128, T>::ReduceAdd32(_mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1))); }
+
+			static T ReduceAdd(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return Backend<128, T>::ReduceAdd(_mm_castpd_si128(_mm_add_pd(_mm256_castpd256_pd128(PD(a)), _mm256_extractf128_pd(PD(a), 1))));
+				else return Backend<128, T>::ReduceAdd(_mm_castps_si128(_mm_add_ps(_mm256_castps256_ps128(PS(a)), _mm256_extractf128_ps(PS(a), 1))));
+			}
+
+		private:
+			static __m256d PD(Register a) { return _mm256_castsi256_pd(a); }
+			static __m256 PS(Register a) { return _mm256_castsi256_ps(a); }
+			static Register I(__m256d a) { return _mm256_castpd_si256(a); }
+			static Register I(__m256 a) { return _mm256_castps_si256(a); }
+		};
+
+#if AVX256_HAS_AVX512
+		// Comparisons write mask registers, which are expanded to all 1's elements, and partial loads and stores are masked rather than copied
+		template <typename T>
+		struct Backend<512, T>
+		{
+			using Register = __m512i;
+
+			static Register Load(const void* data) { return _mm512_loadu_si512(data); }
+			static void Store(void* data, Register value) { _mm512_storeu_si512(data, value); }
+
+			static Register LoadPartial(const void* data, uint64_t bytes) { return _mm512_maskz_loadu_epi8(BytesMask(bytes), data); }
+			static void StorePartial(void* data, Register value, uint64_t bytes) { _mm512_mask_storeu_epi8(data, BytesMask(bytes), value); }
+
+			static Register Zero() { return _mm512_setzero_si512(); }
+			static Register Ones() { return _mm512_set1_epi32(-1); }
+
+			static Register Set1(T value)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_set1_pd(value));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm512_set1_ps(value));
+				else if constexpr (sizeof(T) == 8) return _mm512_set1_epi64(static_cast<int64_t>(value));
+				else if constexpr (sizeof(T) == 4) return _mm512_set1_epi32(static_cast<int32_t>(value));
+				else if constexpr (sizeof(T) == 2) return _mm512_set1_epi16(static_cast<int16_t>(value));
+				else return _mm512_set1_epi8(static_cast<char>(value));
+			}
+
+			static Register Add(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_add_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm512_add_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return _mm512_add_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_add_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm512_add_epi16(a, b);
+				else return _mm512_add_epi8(a, b);
+			}
+
+			static Register Sub(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_sub_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm512_sub_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return _mm512_sub_epi64(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_sub_epi32(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm512_sub_epi16(a, b);
+				else return _mm512_sub_epi8(a, b);
+			}
+
+			static Register AddSaturate(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm512_adds_epi16(a, b) : _mm512_adds_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm512_adds_epi8(a, b) : _mm512_adds_epu8(a, b);
+			}
+
+			static Register SubSaturate(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm512_subs_epi16(a, b) : _mm512_subs_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm512_subs_epi8(a, b) : _mm512_subs_epu8(a, b);
+			}
+
+			static Register Mul(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_mul_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm512_mul_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 8) return std::is_signed_v<T> ? _mm512_mul_epi32(a, b) : _mm512_mul_epu32(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_mullo_epi32(a, b);
+				else return _mm512_mullo_epi16(a, b);
+			}
+
+			static Register Div(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_div_pd(PD(a), PD(b)));
+				else return I(_mm512_div_ps(PS(a), PS(b)));
+			}
+
+			static Register And(Register a, Register b) { return _mm512_and_si512(a, b); }
+			static Register Or(Register a, Register b) { return _mm512_or_si512(a, b); }
+			static Register Xor(Register a, Register b) { return _mm512_xor_si512(a, b); }
+
+			static Register ShiftLeft(Register a, int shift)
+			{
+				if constexpr (sizeof(T) == 8) return _mm512_sll_epi64(a, _mm_cvtsi32_si128(shift));
+				else if constexpr (sizeof(T) == 4) return _mm512_sll_epi32(a, _mm_cvtsi32_si128(shift));
+				else return _mm512_sll_epi16(a, _mm_cvtsi32_si128(shift));
+			}
+
+			static Register ShiftRight(Register a, int shift)
+			{
+				if constexpr (sizeof(T) == 8) return _mm512_srl_epi64(a, _mm_cvtsi32_si128(shift));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm512_sra_epi32(a, _mm_cvtsi32_si128(shift)) : _mm512_srl_epi32(a, _mm_cvtsi32_si128(shift));
+				else return std::is_signed_v<T> ? _mm512_sra_epi16(a, _mm_cvtsi32_si128(shift)) : _mm512_srl_epi16(a, _mm_cvtsi32_si128(shift));
+			}
+
+			// 64, 32 and 16-bit integers (64-bit unsigned only to the right)
+			static Register ShiftLeft(Register a, Register shifts)
+			{
+				if constexpr (sizeof(T) == 8) return _mm512_sllv_epi64(a, shifts);
+				else if constexpr (sizeof(T) == 4) return _mm512_sllv_epi32(a, shifts);
+				else return _mm512_sllv_epi16(a, shifts);
+			}
+
+			static Register ShiftRight(Register a, Register shifts)
+			{
+				if constexpr (sizeof(T) == 8) return _mm512_srlv_epi64(a, shifts);
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm512_srav_epi32(a, shifts) : _mm512_srlv_epi32(a, shifts);
+				else return std::is_signed_v<T> ? _mm512_srav_epi16(a, shifts) : _mm512_srlv_epi16(a, shifts);
+			}
+
+			static Register Min(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_min_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm512_min_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm512_min_epi32(a, b) : _mm512_min_epu32(a, b);
+				else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm512_min_epi16(a, b) : _mm512_min_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm512_min_epi8(a, b) : _mm512_min_epu8(a, b);
+			}
+
+			static Register Max(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_max_pd(PD(a), PD(b)));
+				else if constexpr (std::is_same_v<T, float>) return I(_mm512_max_ps(PS(a), PS(b)));
+				else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? _mm512_max_epi32(a, b) : _mm512_max_epu32(a, b);
+				else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? _mm512_max_epi16(a, b) : _mm512_max_epu16(a, b);
+				else return std::is_signed_v<T> ? _mm512_max_epi8(a, b) : _mm512_max_epu8(a, b);
+			}
+
+			static Register Abs(Register a)
+			{
+				if constexpr (sizeof(T) == 4) return _mm512_abs_epi32(a);
+				else if constexpr (sizeof(T) == 2) return _mm512_abs_epi16(a);
+				else return _mm512_abs_epi8(a);
+			}
+
+			static Register Average(Register a, Register b)
+			{
+				if constexpr (sizeof(T) == 2) return _mm512_avg_epu16(a, b);
+				else return _mm512_avg_epu8(a, b);
+			}
+
+			static Register Equal(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return Expand(_mm512_cmp_pd_mask(PD(a), PD(b), _CMP_EQ_UQ));
+				else if constexpr (std::is_same_v<T, float>) return Expand(_mm512_cmp_ps_mask(PS(a), PS(b), _CMP_EQ_UQ));
+				else if constexpr (sizeof(T) == 8) return Expand(_mm512_cmpeq_epi64_mask(a, b));
+				else if constexpr (sizeof(T) == 4) return Expand(_mm512_cmpeq_epi32_mask(a, b));
+				else if constexpr (sizeof(T) == 2) return Expand(_mm512_cmpeq_epi16_mask(a, b));
+				else return Expand(_mm512_cmpeq_epi8_mask(a, b));
+			}
+
+			// Unsigned integers are compared natively
+			static Register Greater(Register a, Register b)
+			{
+				if constexpr (std::is_same_v<T, double>) return Expand(_mm512_cmp_pd_mask(PD(a), PD(b), _CMP_GT_OQ));
+				else if constexpr (std::is_same_v<T, float>) return Expand(_mm512_cmp_ps_mask(PS(a), PS(b), _CMP_GT_OQ));
+				else if constexpr (sizeof(T) == 8) return Expand(std::is_signed_v<T> ? _mm512_cmpgt_epi64_mask(a, b) : _mm512_cmpgt_epu64_mask(a, b));
+				else if constexpr (sizeof(T) == 4) return Expand(std::is_signed_v<T> ? _mm512_cmpgt_epi32_mask(a, b) : _mm512_cmpgt_epu32_mask(a, b));
+				else if constexpr (sizeof(T) == 2) return Expand(std::is_signed_v<T> ? _mm512_cmpgt_epi16_mask(a, b) : _mm512_cmpgt_epu16_mask(a, b));
+				else return Expand(std::is_signed_v<T> ? _mm512_cmpgt_epi8_mask(a, b) : _mm512_cmpgt_epu8_mask(a, b));
+			}
+
+			static bool IsZero(Register a) { return _mm512_test_epi64_mask(a, a) == 0; }
+
+			static Register Sqrt(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_sqrt_pd(PD(a)));
+				else return I(_mm512_sqrt_ps(PS(a)));
+			}
+
+			static Register Floor(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_roundscale_pd(PD(a), _MM_FROUND_FLOOR));
+				else return I(_mm512_roundscale_ps(PS(a), _MM_FROUND_FLOOR));
+			}
+
+			static Register Ceil(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>) return I(_mm512_roundscale_pd(PD(a), _MM_FROUND_CEIL));
+				else return I(_mm512_roundscale_ps(PS(a), _MM_FROUND_CEIL));
+			}
+
+			// Relative error < 2^-14
+			static Register Inverse(Register a) { return I(_mm512_rcp14_ps(PS(a))); }
+			static Register InverseSqrt(Register a) { return I(_mm512_rsqrt14_ps(PS(a))); }
+
+			static Register UnpackLow8(Register a, Register b) { return _mm512_unpacklo_epi8(a, b); }
+			static Register UnpackHigh8(Register a, Register b) { return _mm512_unpackhi_epi8(a, b); }
+			static Register PackUnsigned16(Register a, Register b) { return _mm512_packus_epi16(a, b); }
+			static Register PackSigned16(Register a, Register b) { return _mm512_packs_epi16(a, b); }
+
+			static Register SumBytes(Register a) { return _mm512_sad_epu8(a, _mm512_setzero_si512()); }
+			static Register MulAdd16(Register a, Register b) { return _mm512_madd_epi16(a, b); }
+
+			// The four 128-bit lanes are folded into one, which is summed by the 128-bit backend
+			static uint64_t ReduceAdd64(Register a)
+			{
+				a = _mm512_add_epi64(a, _mm512_shuffle_i64x2(a, a, 0b01001110));
+				return Backend<128, T>::ReduceAdd64(_mm512_castsi512_si128(_mm512_add_epi64(a, _mm512_shuffle_i64x2(a, a, 0b10110001))));
+			}
+
+			static uint32_t ReduceAdd32(Register a)
+			{
+				a = _mm512_add_epi32(a, _mm512_shuffle_i64x2(a, a, 0b01001110));
+				return Backend<128, T>::ReduceAdd32(_mm512_castsi512_si128(_mm512_add_epi32(a, _mm512_shuffle_i64x2(a, a, 0b10110001))));
+			}
+
+			static T ReduceAdd(Register a)
+			{
+				if constexpr (std::is_same_v<T, double>)
+				{
+					__m512d sums = _mm512_add_pd(PD(a), _mm512_shuffle_f64x2(PD(a), PD(a), 0b01001110));
+					sums = _mm512_add_pd(sums, _mm512_shuffle_f64x2(sums, sums, 0b10110001));
+					return Backend<128, T>::ReduceAdd(_mm512_castsi512_si128(I(sums)));
+				}
+				else
+				{
+					__m512 sums = _mm512_add_ps(PS(a), _mm512_shuffle_f32x4(PS(a), PS(a), 0b01001110));
+					sums = _mm512_add_ps(sums, _mm512_shuffle_f32x4(sums, sums, 0b10110001));
+					return Backend<128, T>::ReduceAdd(_mm512_castsi512_si128(I(sums)));
+				}
+			}
+
+		private:
+			static __m512d PD(Register a) { return _mm512_castsi512_pd(a); }
+			static __m512 PS(Register a) { return _mm512_castsi512_ps(a); }
+			static Register I(__m512d a) { return _mm512_castpd_si512(a); }
+			static Register I(__m512 a) { return _mm512_castps_si512(a); }
+
+			// The mask of the first 'bytes' (at most 64) bytes
+			static __mmask64 BytesMask(uint64_t bytes) { return bytes >= 64 ? ~0ull : (1ull << bytes) - 1; }
+
+			// Sets the elements whose mask bit is set to all 1's, and the rest to 0
+			static Register Expand(__mmask64 mask) { return _mm512_movm_epi8(mask); }
+			static Register Expand(__mmask32 mask) { return _mm512_movm_epi16(mask); }
+			static Register Expand(__mmask16 mask) { return _mm512_movm_epi32(mask); }
+			static Register Expand(__mmask8 mask) { return _mm512_movm_epi64(mask); }
+		};
+#endif
+	};
+};
+
+#endif
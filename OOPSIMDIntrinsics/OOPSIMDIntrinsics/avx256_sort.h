@@ -0,0 +1,465 @@
+#ifndef AVX256_SORT_H
+#define AVX256_SORT_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	namespace SortDetail
+	{
+		// 8 keys and (if HasValues) their 8 corresponding values. Every operation applied to the keys is applied to the values too
+		struct Lanes
+		{
+			__m256i Keys;
+			__m256i Values;
+		};
+
+		// For each partition mask (bit i set if element i belongs to the right partition), the packed 4-bit source indices that move left elements to the front and right elements to the back of a vector
+		constexpr std::array<uint32_t, 256> CreatePartitionTable()
+		{
+			std::array<uint32_t, 256> table{};
+
+			for (uint32_t mask = 0; mask < 256; ++mask)
+			{
+				uint32_t packed = 0, destination = 0;
+
+				for (uint32_t i = 0; i < 8; ++i)
+					if (!(mask & (1 << i))) packed |= i << (4 * destination++);
+
+				for (uint32_t i = 0; i < 8; ++i)
+					if (mask & (1 << i)) packed |= i << (4 * destination++);
+
+				table[mask] = packed;
+			}
+
+			return table;
+		}
+
+		inline constexpr std::array<uint32_t, 256> PARTITION_TABLE = CreatePartitionTable();
+
+		template <typename K>
+		K MaxKey()
+		{
+			if constexpr (std::is_same_v<K, float>) return std::numeric_limits<float>::infinity();
+			else if constexpr (true) return std::numeric_limits<K>::max();
+		}
+
+		// Returns a mask where each 32-bit element is all 1's if a > b, otherwise all 0's
+		template <typename K>
+		__m256i Greater(__m256i a, __m256i b)
+		{
+			if constexpr (std::is_same_v<K, int32_t>) return _mm256_cmpgt_epi32(a, b);
+			else if constexpr (std::is_same_v<K, uint32_t>) return _mm256_cmpgt_epi32(_mm256_xor_si256(a, _mm256_set1_epi32(INT32_MIN)), _mm256_xor_si256(b, _mm256_set1_epi32(INT32_MIN))); // Flip sign bits to compare as signed integers
+			else if constexpr (std::is_same_v<K, float>) return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_GT_OQ));
+		}
+
+		template <typename K>
+		__m256i Min(__m256i a, __m256i b)
+		{
+			if constexpr (std::is_same_v<K, int32_t>) return _mm256_min_epi32(a, b);
+			else if constexpr (std::is_same_v<K, uint32_t>) return _mm256_min_epu32(a, b);
+		}
+
+		template <typename K>
+		__m256i Max(__m256i a, __m256i b)
+		{
+			if constexpr (std::is_same_v<K, int32_t>) return _mm256_max_epi32(a, b);
+			else if constexpr (std::is_same_v<K, uint32_t>) return _mm256_max_epu32(a, b);
+		}
+
+		// min/max are used for integer keys. Float keys (and all key/value pairs) are swapped via a comparison mask instead, which preserves the exact bits (e.g. -0.0 and 0.0) and values of equal keys
+		template <typename K, bool HasValues>
+		constexpr bool USE_MIN_MAX = !HasValues && !std::is_same_v<K, float>;
+
+		template <bool HasValues, typename K, typename V>
+		Lanes Load(const K* keys, const V* values, int64_t index)
+		{
+			Lanes lanes;
+			lanes.Keys = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + index));
+			if constexpr (HasValues) lanes.Values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + index));
+			return lanes;
+		}
+
+		template <bool HasValues, typename K, typename V>
+		void Store(K* keys, V* values, int64_t index, const Lanes& lanes)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(keys + index), lanes.Keys);
+			if constexpr (HasValues) _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + index), lanes.Values);
+		}
+
+		template <bool HasValues>
+		Lanes Permute(const Lanes& lanes, __m256i order)
+		{
+			Lanes result;
+			result.Keys = _mm256_permutevar8x32_epi32(lanes.Keys, order);
+			if constexpr (HasValues) result.Values = _mm256_permutevar8x32_epi32(lanes.Values, order);
+			return result;
+		}
+
+		template <bool HasValues>
+		Lanes Reverse(const Lanes& lanes) { return Permute<HasValues>(lanes, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+
+		template <bool HasValues>
+		Lanes SwapHalves(const Lanes& lanes)
+		{
+			Lanes result;
+			result.Keys = _mm256_permute4x64_epi64(lanes.Keys, 0b01001110);
+			if constexpr (HasValues) result.Values = _mm256_permute4x64_epi64(lanes.Values, 0b01001110);
+			return result;
+		}
+
+		template <int ORDER, bool HasValues>
+		Lanes Shuffle(const Lanes& lanes)
+		{
+			Lanes result;
+			result.Keys = _mm256_shuffle_epi32(lanes.Keys, ORDER);
+			if constexpr (HasValues) result.Values = _mm256_shuffle_epi32(lanes.Values, ORDER);
+			return result;
+		}
+
+		// Compare-exchange between two vectors: each element of a receives the smaller, and each element of b the larger, of their corresponding keys
+		template <typename K, bool HasValues>
+		void CompareExchange(Lanes& a, Lanes& b)
+		{
+			if constexpr (USE_MIN_MAX<K, HasValues>)
+			{
+				__m256i min = Min<K>(a.Keys, b.Keys);
+				b.Keys = Max<K>(a.Keys, b.Keys);
+				a.Keys = min;
+			}
+			else if constexpr (true)
+			{
+				__m256i swap = Greater<K>(a.Keys, b.Keys);
+				__m256i keys = _mm256_blendv_epi8(a.Keys, b.Keys, swap);
+				b.Keys = _mm256_blendv_epi8(b.Keys, a.Keys, swap);
+				a.Keys = keys;
+
+				if constexpr (HasValues)
+				{
+					__m256i values = _mm256_blendv_epi8(a.Values, b.Values, swap);
+					b.Values = _mm256_blendv_epi8(b.Values, a.Values, swap);
+					a.Values = values;
+				}
+			}
+		}
+
+		// Compare-exchange within a vector: 'partners' holds each element's partner, elements whose bit is set in MAX_LANES receive the larger key of the pair, others the smaller
+		template <int MAX_LANES, typename K, bool HasValues>
+		Lanes Exchange(const Lanes& lanes, const Lanes& partners)
+		{
+			Lanes result;
+
+			if constexpr (USE_MIN_MAX<K, HasValues>) result.Keys = _mm256_blend_epi32(Min<K>(lanes.Keys, partners.Keys), Max<K>(lanes.Keys, partners.Keys), MAX_LANES);
+			else if constexpr (true)
+			{
+				// Lower elements of a pair take their partner if it is smaller, upper elements if it is larger. Equal keys are never swapped so no value is lost
+				__m256i swap = _mm256_blend_epi32(Greater<K>(lanes.Keys, partners.Keys), Greater<K>(partners.Keys, lanes.Keys), MAX_LANES);
+				result.Keys = _mm256_blendv_epi8(lanes.Keys, partners.Keys, swap);
+				if constexpr (HasValues) result.Values = _mm256_blendv_epi8(lanes.Values, partners.Values, swap);
+			}
+
+			return result;
+		}
+
+		// Bitonic sort of the 8 elements of a vector
+		template <typename K, bool HasValues>
+		Lanes Sort8(Lanes lanes)
+		{
+			lanes = Exchange<0b10101010, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(2, 3, 0, 1), HasValues>(lanes));
+			lanes = Exchange<0b11001100, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(0, 1, 2, 3), HasValues>(lanes));
+			lanes = Exchange<0b10101010, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(2, 3, 0, 1), HasValues>(lanes));
+			lanes = Exchange<0b11110000, K, HasValues>(lanes, Reverse<HasValues>(lanes));
+			lanes = Exchange<0b11001100, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(1, 0, 3, 2), HasValues>(lanes));
+			lanes = Exchange<0b10101010, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(2, 3, 0, 1), HasValues>(lanes));
+			return lanes;
+		}
+
+		// Sorts the 8 elements of a vector whose halves, quarters, and pairs are already ordered relative to each other (i.e. the last 3 half-cleaner stages of a bitonic merge)
+		template <typename K, bool HasValues>
+		Lanes Clean8(Lanes lanes)
+		{
+			lanes = Exchange<0b11110000, K, HasValues>(lanes, SwapHalves<HasValues>(lanes));
+			lanes = Exchange<0b11001100, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(1, 0, 3, 2), HasValues>(lanes));
+			lanes = Exchange<0b10101010, K, HasValues>(lanes, Shuffle<_MM_SHUFFLE(2, 3, 0, 1), HasValues>(lanes));
+			return lanes;
+		}
+
+		// Merges the two sorted runs lanes[0, count) and lanes[count, 2 * count) (count vectors each) into one sorted run of 2 * count vectors
+		template <typename K, bool HasValues>
+		void Merge(Lanes* lanes, int count)
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				Lanes mirror = Reverse<HasValues>(lanes[2 * count - 1 - i]);
+				CompareExchange<K, HasValues>(lanes[i], mirror);
+				lanes[2 * count - 1 - i] = Reverse<HasValues>(mirror);
+			}
+
+			for (int distance = count / 2; distance >= 1; distance /= 2)
+				for (int i = 0; i < 2 * count; ++i)
+					if (!(i & distance)) CompareExchange<K, HasValues>(lanes[i], lanes[i + distance]);
+
+			for (int i = 0; i < 2 * count; ++i)
+				lanes[i] = Clean8<K, HasValues>(lanes[i]);
+		}
+
+		// Sorts count (1, 2, 4, or 8) vectors in registers
+		template <typename K, bool HasValues>
+		void SortNetwork(Lanes* lanes, int count)
+		{
+			for (int i = 0; i < count; ++i)
+				lanes[i] = Sort8<K, HasValues>(lanes[i]);
+
+			for (int runLength = 1; runLength < count; runLength *= 2)
+				for (int i = 0; i < count; i += 2 * runLength)
+					Merge<K, HasValues>(lanes + i, runLength);
+		}
+
+		// Sorts keys[left, right) (up to 64 elements) with an in-register bitonic network, padding the last vector with the largest key
+		template <typename K, bool HasValues, typename V>
+		void SortSmall(K* keys, V* values, int64_t left, int64_t right)
+		{
+			if constexpr (HasValues) // Move elements that compare equal to the padding to the end so their values cannot be confused with the padding's
+			{
+				for (int64_t i = left; i < right;)
+				{
+					if (keys[i] == MaxKey<K>()) --right, std::swap(keys[i], keys[right]), std::swap(values[i], values[right]);
+					else ++i;
+				}
+			}
+
+			int64_t count = right - left;
+			if (count <= 1) return;
+
+			int vectorCount = count <= 8 ? 1 : count <= 16 ? 2 : count <= 32 ? 4 : 8;
+			K keyBuffer[64];
+			V valueBuffer[64];
+
+			std::memcpy(keyBuffer, keys + left, count * sizeof(K));
+			std::fill(keyBuffer + count, keyBuffer + vectorCount * 8, MaxKey<K>());
+			if constexpr (HasValues) std::memcpy(valueBuffer, values + left, count * sizeof(V));
+
+			Lanes lanes[8];
+			for (int i = 0; i < vectorCount; ++i) lanes[i] = Load<HasValues>(keyBuffer, valueBuffer, i * 8);
+
+			SortNetwork<K, HasValues>(lanes, vectorCount);
+
+			for (int i = 0; i < vectorCount; ++i) Store<HasValues>(keyBuffer, valueBuffer, i * 8, lanes[i]);
+
+			std::memcpy(keys + left, keyBuffer, count * sizeof(K));
+			if constexpr (HasValues) std::memcpy(values + left, valueBuffer, count * sizeof(V));
+		}
+
+		// Returns a mask with bit i set if element i belongs to the right partition, i.e. is greater than the pivot (PIVOT_LEFT) or not less than the pivot (!PIVOT_LEFT)
+		template <typename K, bool PIVOT_LEFT>
+		uint32_t RightMask(__m256i keys, __m256i pivot)
+		{
+			if constexpr (PIVOT_LEFT) return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(Greater<K>(keys, pivot))));
+			else if constexpr (true) return ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(Greater<K>(pivot, keys)))) & 0xFF;
+		}
+
+		// Writes the left elements of a vector to keys[left] onwards and its right elements to the elements preceding keys[right], updating left and right
+		template <typename K, bool HasValues, bool PIVOT_LEFT, typename V>
+		void PartitionVector(K* keys, V* values, const Lanes& lanes, __m256i pivot, int64_t& left, int64_t& right)
+		{
+			uint32_t rightMask = RightMask<K, PIVOT_LEFT>(lanes.Keys, pivot);
+			int rightCount = static_cast<int>(_mm_popcnt_u32(rightMask));
+
+			__m256i order = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(PARTITION_TABLE[rightMask]), _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28)), _mm256_set1_epi32(7));
+			Lanes partitioned = Permute<HasValues>(lanes, order);
+
+			Store<HasValues>(keys, values, left, partitioned);
+			right -= rightCount;
+			Store<HasValues>(keys, values, right + rightCount - 8, partitioned);
+			left += 8 - rightCount;
+		}
+
+		// Partitions keys[left, right) (at least 16 elements) in place around pivot and returns the index of the first element of the right partition.
+		// The first and last vectors are held in registers so that there is always at least a vector's worth of free space on the side a vector is written to
+		template <typename K, bool HasValues, bool PIVOT_LEFT, typename V>
+		int64_t Partition(K* keys, V* values, int64_t left, int64_t right, K pivotKey)
+		{
+			__m256i pivot;
+			if constexpr (std::is_same_v<K, float>) pivot = _mm256_castps_si256(_mm256_set1_ps(pivotKey));
+			else if constexpr (true) pivot = _mm256_set1_epi32(static_cast<int32_t>(pivotKey));
+
+			Lanes first = Load<HasValues>(keys, values, left), last = Load<HasValues>(keys, values, right - 8);
+			int64_t readLeft = left + 8, readRight = right - 8, writeLeft = left, writeRight = right;
+
+			while (readRight - readLeft >= 8)
+			{
+				Lanes lanes;
+
+				if (readLeft - writeLeft <= writeRight - readRight) lanes = Load<HasValues>(keys, values, readLeft), readLeft += 8;
+				else readRight -= 8, lanes = Load<HasValues>(keys, values, readRight);
+
+				PartitionVector<K, HasValues, PIVOT_LEFT>(keys, values, lanes, pivot, writeLeft, writeRight);
+			}
+
+			// The free space is now contiguous: partition the remaining (< 8) unread elements, then the two held vectors
+			K remainingKeys[8];
+			V remainingValues[8];
+			int64_t remainingCount = readRight - readLeft;
+
+			std::memcpy(remainingKeys, keys + readLeft, remainingCount * sizeof(K));
+			if constexpr (HasValues) std::memcpy(remainingValues, values + readLeft, remainingCount * sizeof(V));
+
+			for (int64_t i = 0; i < remainingCount; ++i)
+			{
+				bool isRight = PIVOT_LEFT ? remainingKeys[i] > pivotKey : !(remainingKeys[i] < pivotKey);
+				int64_t destination = isRight ? --writeRight : writeLeft++;
+
+				keys[destination] = remainingKeys[i];
+				if constexpr (HasValues) values[destination] = remainingValues[i];
+			}
+
+			PartitionVector<K, HasValues, PIVOT_LEFT>(keys, values, first, pivot, writeLeft, writeRight);
+			PartitionVector<K, HasValues, PIVOT_LEFT>(keys, values, last, pivot, writeLeft, writeRight);
+
+			return writeLeft;
+		}
+
+		template <typename K>
+		K MedianOfThree(K a, K b, K c) { return std::max(std::min(a, b), std::min(std::max(a, b), c)); }
+
+		// Fallback for adversarial inputs that exceed the quicksort recursion depth
+		template <typename K, bool HasValues, typename V>
+		void FallbackSort(K* keys, V* values, int64_t left, int64_t right)
+		{
+			if constexpr (!HasValues) std::sort(keys + left, keys + right);
+			else if constexpr (true)
+			{
+				std::vector<std::pair<K, V>> pairs(right - left);
+				for (int64_t i = left; i < right; ++i) pairs[i - left] = { keys[i], values[i] };
+
+				std::sort(pairs.begin(), pairs.end(), [](const std::pair<K, V>& a, const std::pair<K, V>& b) { return a.first < b.first; });
+
+				for (int64_t i = left; i < right; ++i) keys[i] = pairs[i - left].first, values[i] = pairs[i - left].second;
+			}
+		}
+
+		template <typename K, bool HasValues, typename V>
+		void QuickSort(K* keys, V* values, int64_t left, int64_t right, int depth)
+		{
+			while (right - left > 64)
+			{
+				if (depth-- == 0) { FallbackSort<K, HasValues>(keys, values, left, right); return; }
+
+				K pivot = MedianOfThree(keys[left], keys[left + (right - left) / 2], keys[right - 1]);
+				int64_t boundary = Partition<K, HasValues, true>(keys, values, left, right, pivot);
+
+				if (boundary == right) // Every element is <= pivot: split off the elements equal to the pivot, which are already in their final place
+				{
+					right = Partition<K, HasValues, false>(keys, values, left, right, pivot);
+					continue;
+				}
+
+				if (boundary - left < right - boundary) QuickSort<K, HasValues>(keys, values, left, boundary, depth), left = boundary;
+				else QuickSort<K, HasValues>(keys, values, boundary, right, depth), right = boundary;
+			}
+
+			SortSmall<K, HasValues>(keys, values, left, right);
+		}
+
+		template <typename K, bool HasValues, typename V>
+		void Sort(K* keys, V* values, uint64_t count)
+		{
+			static_assert(std::is_same_v<K, int32_t> || std::is_same_v<K, uint32_t> || std::is_same_v<K, float>, "AVX256: Sort() is only available for int32_t, uint32_t, and float keys");
+			static_assert(sizeof(V) == 4, "AVX256: SortPairs() is only available for 32-bit values");
+
+			int depth = 0;
+			for (uint64_t i = count; i > 1; i >>= 1) depth += 2;
+
+			QuickSort<K, HasValues>(keys, values, 0, static_cast<int64_t>(count), depth);
+		}
+
+		// Merges two sorted arrays 8 elements at a time: the next vector is taken from the input with the smaller head and merged with the 8 largest elements seen so far,
+		// whose lower half is then stored
+		template <typename K, bool HasValues, typename V>
+		void MergeSorted(const K* keysA, const V* valuesA, uint64_t countA, const K* keysB, const V* valuesB, uint64_t countB, K* keysOut, V* valuesOut)
+		{
+			static_assert(std::is_same_v<K, int32_t> || std::is_same_v<K, uint32_t> || std::is_same_v<K, float>, "AVX256: MergeSorted() is only available for int32_t, uint32_t, and float keys");
+			static_assert(sizeof(V) == 4, "AVX256: MergeSorted() is only available for 32-bit values");
+
+			uint64_t a = 0, b = 0, out = 0;
+			K pendingKeys[8];
+			V pendingValues[8];
+			uint64_t pending = 0, pendingCount = 0;
+
+			if (countA >= 8 && countB >= 8)
+			{
+				Lanes lanes[2] = { Load<HasValues>(keysA, valuesA, 0), Load<HasValues>(keysB, valuesB, 0) };
+				a = 8, b = 8;
+
+				while (true)
+				{
+					Merge<K, HasValues>(lanes, 1);
+					Store<HasValues>(keysOut, valuesOut, out, lanes[0]);
+					out += 8;
+
+					// Stop once the input with the smaller head has fewer than 8 elements left, as they may belong before elements of the other input's next vector
+					bool takeA = a < countA && b < countB ? !(keysB[b] < keysA[a]) : a < countA;
+
+					if (takeA && a + 8 <= countA) lanes[0] = Load<HasValues>(keysA, valuesA, a), a += 8;
+					else if (!takeA && b + 8 <= countB) lanes[0] = Load<HasValues>(keysB, valuesB, b), b += 8;
+					else break;
+				}
+
+				Store<HasValues>(pendingKeys, pendingValues, 0, lanes[1]);
+				pendingCount = 8;
+			}
+
+			// Scalar three-way merge of the pending vector and the remaining (possibly fewer than 8) elements of each input
+			while (pending < pendingCount || a < countA || b < countB)
+			{
+				int source = 0;
+				K key{};
+
+				if (pending < pendingCount) source = 1, key = pendingKeys[pending];
+				if (a < countA && (source == 0 || keysA[a] < key)) source = 2, key = keysA[a];
+				if (b < countB && (source == 0 || keysB[b] < key)) source = 3, key = keysB[b];
+
+				keysOut[out] = key;
+				if constexpr (HasValues) valuesOut[out] = source == 1 ? pendingValues[pending] : source == 2 ? valuesA[a] : valuesB[b];
+
+				++out;
+				if (source == 1) ++pending;
+				else if (source == 2) ++a;
+				else ++b;
+			}
+		}
+	};
+
+	// Sorts the first 'count' elements of data in ascending order. Available for int32_t, uint32_t, and float only (NaNs are not supported).
+	// Uses quicksort with a vectorised in-place partition, and in-register bitonic sorting networks for partitions of up to 64 elements
+	template <typename T>
+	void Sort(T* data, uint64_t count) { SortDetail::Sort<T, false>(data, static_cast<uint32_t*>(nullptr), count); }
+
+	// Sorts the first 'count' keys in ascending order, applying the same re-ordering to values. Keys can be int32_t, uint32_t, or float (NaNs are not supported), values can be any 32-bit type.
+	// The sort is not stable
+	template <typename K, typename V>
+	void SortPairs(K* keys, V* values, uint64_t count) { SortDetail::Sort<K, true>(keys, values, count); }
+
+	// Merges the sorted arrays a and b into out, which must have space for countA + countB elements and must not overlap a or b
+	template <typename T>
+	void MergeSorted(const T* a, uint64_t countA, const T* b, uint64_t countB, T* out)
+	{
+		SortDetail::MergeSorted<T, false>(a, static_cast<const uint32_t*>(nullptr), countA, b, static_cast<const uint32_t*>(nullptr), countB, out, static_cast<uint32_t*>(nullptr));
+	}
+
+	// Merges the sorted key arrays keysA and keysB into keysOut, moving their values from valuesA and valuesB into valuesOut along with them
+	template <typename K, typename V>
+	void MergeSortedPairs(const K* keysA, const V* valuesA, uint64_t countA, const K* keysB, const V* valuesB, uint64_t countB, K* keysOut, V* valuesOut)
+	{
+		SortDetail::MergeSorted<K, true>(keysA, valuesA, countA, keysB, valuesB, countB, keysOut, valuesOut);
+	}
+};
+
+#endif
@@ -0,0 +1,354 @@
+#ifndef AVX256_STATS_H
+#define AVX256_STATS_H
+
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	// The result of Stats(). MinIndex and MaxIndex are the indices of the first occurrences of Min and Max (row-major within the region for 2D regions).
+	// StandardDeviation is the population standard deviation. All members are 0 for an empty buffer, and Min and Max are NaN if every element is NaN
+	template <typename T>
+	struct Statistics
+	{
+		uint64_t Count = 0;
+		double Sum = 0, SumOfSquares = 0, Mean = 0, StandardDeviation = 0;
+		T Min{}, Max{};
+		uint64_t MinIndex = 0, MaxIndex = 0;
+	};
+
+	namespace StatsDetail
+	{
+		template <typename T>
+		void CheckType() { static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && (sizeof(T) <= 4 || std::is_same_v<T, double>), "AVX256: Stats() is not available for 64-bit integers"); }
+
+		template <typename T> struct VectorOf { using Type = __m256i; };
+		template <> struct VectorOf<float> { using Type = __m256; };
+		template <> struct VectorOf<double> { using Type = __m256d; };
+
+		// Integer sums are exact in 64-bit integers. Floating-point sums, and the squares of 32-bit integers (which could overflow a uint64_t), are accumulated in doubles
+		template <typename T>
+		using SumType = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+		template <typename T>
+		using SquaresType = std::conditional_t<std::is_integral_v<T> && sizeof(T) <= 2, uint64_t, double>;
+
+		// The number of vectors in a block, after which the per-lane iteration counters (and 32-bit partial sums) are reduced, before either could overflow
+		template <typename T>
+		constexpr uint64_t BLOCK = sizeof(T) == 1 ? 255 : sizeof(T) == 2 ? 16384 : uint64_t{ 1 } << 24;
+
+		// Integers are compared with signed comparisons, so unsigned integers are kept with their sign bit flipped
+		template <typename T>
+		__m256i Bias(__m256i values)
+		{
+			if constexpr (std::is_signed_v<T>) return values;
+			else if constexpr (sizeof(T) == 4) return _mm256_xor_si256(values, _mm256_set1_epi32(INT32_MIN));
+			else if constexpr (sizeof(T) == 2) return _mm256_xor_si256(values, _mm256_set1_epi16(INT16_MIN));
+			else return _mm256_xor_si256(values, _mm256_set1_epi8(INT8_MIN));
+		}
+
+		template <typename T>
+		T Unbias(T value)
+		{
+			if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) return static_cast<T>(value ^ (T{ 1 } << (8 * sizeof(T) - 1)));
+			else return value;
+		}
+
+		template <typename T, typename V>
+		V Load(const T* data)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_loadu_ps(data);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_loadu_pd(data);
+			else return Bias<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+		}
+
+		template <typename T, typename V>
+		V Broadcast(T value)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_set1_ps(value);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_set1_pd(value);
+			else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int32_t>(Unbias(value)));
+			else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(static_cast<int16_t>(Unbias(value)));
+			else return _mm256_set1_epi8(static_cast<int8_t>(Unbias(value)));
+		}
+
+		// Returns a mask of the lanes where a < b. Comparisons with NaN are false, so NaNs are never a min or max
+		template <typename T, typename V>
+		V IsLess(V a, V b)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+			else if constexpr (sizeof(T) == 4) return _mm256_cmpgt_epi32(b, a);
+			else if constexpr (sizeof(T) == 2) return _mm256_cmpgt_epi16(b, a);
+			else return _mm256_cmpgt_epi8(b, a);
+		}
+
+		// Returns a mask of the lanes where 'values' is a number (not NaN) and 'found' is not yet set, and sets 'found' in the lanes where 'values' is a number
+		template <typename T, typename V>
+		V FirstNumbers(V values, V& found)
+		{
+			if constexpr (std::is_same_v<T, float>)
+			{
+				__m256 numbers = _mm256_cmp_ps(values, values, _CMP_ORD_Q), first = _mm256_andnot_ps(found, numbers);
+				found = _mm256_or_ps(found, numbers);
+				return first;
+			}
+			else
+			{
+				__m256d numbers = _mm256_cmp_pd(values, values, _CMP_ORD_Q), first = _mm256_andnot_pd(found, numbers);
+				found = _mm256_or_pd(found, numbers);
+				return first;
+			}
+		}
+
+		template <typename T, typename V>
+		V Or(V a, V b)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_or_ps(a, b);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_or_pd(a, b);
+			else return _mm256_or_si256(a, b);
+		}
+
+		template <typename T, typename V>
+		V Select(V a, V b, V mask)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_blendv_ps(a, b, mask);
+			else if constexpr (std::is_same_v<T, double>) return _mm256_blendv_pd(a, b, mask);
+			else return _mm256_blendv_epi8(a, b, mask);
+		}
+
+		// Returns 'iteration' in every lane, as an integer of the element's width in a register of the element's type
+		template <typename T, typename V>
+		V Iteration(uint64_t iteration)
+		{
+			if constexpr (std::is_same_v<T, float>) return _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int32_t>(iteration)));
+			else if constexpr (std::is_same_v<T, double>) return _mm256_castsi256_pd(_mm256_set1_epi64x(static_cast<int64_t>(iteration)));
+			else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int32_t>(iteration));
+			else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(static_cast<int16_t>(iteration));
+			else return _mm256_set1_epi8(static_cast<int8_t>(iteration));
+		}
+
+		inline void Store(__m256i vector, void* lanes) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), vector); }
+		inline void Store(__m256 vector, void* lanes) { _mm256_storeu_ps(reinterpret_cast<float*>(lanes), vector); }
+		inline void Store(__m256d vector, void* lanes) { _mm256_storeu_pd(reinterpret_cast<double*>(lanes), vector); }
+
+		// The running statistics, with exact integer sums
+		template <typename T>
+		struct Accumulator
+		{
+			Statistics<T> Stats;
+			SumType<T> Sum = 0;
+			SquaresType<T> Squares = 0;
+			bool IsEmpty = true;
+
+			// Adds a min and a max candidate. Ties go to the lower index, as the lanes of a block interleave their indices
+			void Candidates(T min, uint64_t minIndex, T max, uint64_t maxIndex)
+			{
+				bool isFirst = IsEmpty;
+				IsEmpty = false;
+				if (isFirst || min < Stats.Min || (min == Stats.Min && minIndex < Stats.MinIndex)) Stats.Min = min, Stats.MinIndex = minIndex;
+				if (isFirst || max > Stats.Max || (max == Stats.Max && maxIndex < Stats.MaxIndex)) Stats.Max = max, Stats.MaxIndex = maxIndex;
+			}
+		};
+
+		// The per-lane state of a block of vectors: the min and max of each lane and the iterations they were found at, and the partial sums
+		template <typename T>
+		struct Block
+		{
+			using V = typename VectorOf<T>::Type;
+			V Mins, Maxs, MinIterations, MaxIterations;
+			V Found; // The lanes that have seen a number, for floating-point types, where a lane of NaNs has no min or max
+			__m256i Sums = _mm256_setzero_si256(), Squares = _mm256_setzero_si256(); // Integer sums, in 64-bit lanes or as 32-bit partial sums
+			__m256d DoubleSums = _mm256_setzero_pd(), DoubleSquares = _mm256_setzero_pd();
+
+			// Lanes start at the extremes of the type at iteration 0, so if no element is ever strictly less (greater), the lane's first element is its min (max)
+			Block() : Mins{ Broadcast<T, V>(std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::max() : std::numeric_limits<T>::infinity()) },
+				Maxs{ Broadcast<T, V>(std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::lowest() : -std::numeric_limits<T>::infinity()) },
+				MinIterations{ Iteration<T, V>(0) }, MaxIterations{ MinIterations }, Found{ MinIterations } {}
+
+			void Add(const T* data, uint64_t iteration)
+			{
+				V values = Load<T, V>(data), iterations = Iteration<T, V>(iteration);
+				V isLess = IsLess<T>(values, Mins), isGreater = IsLess<T>(Maxs, values); // Strict, so each lane keeps its first occurrence
+
+				// A lane's first number is always taken, as lanes that start with NaNs would otherwise keep an infinity (at iteration 0) that ties with no later element
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					V first = FirstNumbers<T>(values, Found);
+					isLess = Or<T>(isLess, first), isGreater = Or<T>(isGreater, first);
+				}
+
+				Mins = Select<T>(Mins, values, isLess), MinIterations = Select<T>(MinIterations, iterations, isLess);
+				Maxs = Select<T>(Maxs, values, isGreater), MaxIterations = Select<T>(MaxIterations, iterations, isGreater);
+
+				if constexpr (std::is_same_v<T, double>) DoubleSums = _mm256_add_pd(DoubleSums, values), DoubleSquares = _mm256_fmadd_pd(values, values, DoubleSquares);
+				else if constexpr (std::is_same_v<T, float>)
+				{
+					__m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(values)), high = _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1));
+					DoubleSums = _mm256_add_pd(DoubleSums, _mm256_add_pd(low, high)), DoubleSquares = _mm256_fmadd_pd(low, low, _mm256_fmadd_pd(high, high, DoubleSquares));
+				}
+				else if constexpr (sizeof(T) == 1)
+				{
+					// _mm256_sad_epu8 sums groups of 8 bytes into 64-bit lanes. int8s are summed biased by 128, which is subtracted again when the block is reduced
+					__m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), low, high;
+					Sums = _mm256_add_epi64(Sums, _mm256_sad_epu8(std::is_signed_v<T> ? _mm256_xor_si256(raw, _mm256_set1_epi8(INT8_MIN)) : raw, _mm256_setzero_si256()));
+
+					if constexpr (std::is_signed_v<T>) low = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(raw)), high = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(raw, 1));
+					else low = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(raw)), high = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(raw, 1));
+					Squares = _mm256_add_epi32(Squares, _mm256_add_epi32(_mm256_madd_epi16(low, low), _mm256_madd_epi16(high, high))); // At most 4 * 255^2 per lane per vector
+				}
+				else if constexpr (sizeof(T) == 2 && std::is_signed_v<T>)
+				{
+					__m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), squares = _mm256_madd_epi16(raw, raw); // At most 2 * 32768^2 = 2^31, which fits as a uint32
+					Sums = _mm256_add_epi32(Sums, _mm256_madd_epi16(raw, _mm256_set1_epi16(1)));
+					Squares = _mm256_add_epi64(Squares, _mm256_add_epi64(_mm256_and_si256(squares, _mm256_set1_epi64x(UINT32_MAX)), _mm256_srli_epi64(squares, 32)));
+				}
+				else if constexpr (sizeof(T) == 2)
+				{
+					__m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+					__m256i low = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(raw)), high = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(raw, 1));
+					__m256i oddLow = _mm256_srli_epi64(low, 32), oddHigh = _mm256_srli_epi64(high, 32);
+
+					Sums = _mm256_add_epi32(Sums, _mm256_add_epi32(low, high)); // At most 2 * 65535 per lane per vector, read as uint32s
+					Squares = _mm256_add_epi64(Squares, _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(low, low), _mm256_mul_epu32(high, high)), _mm256_add_epi64(_mm256_mul_epu32(oddLow, oddLow), _mm256_mul_epu32(oddHigh, oddHigh))));
+				}
+				else
+				{
+					__m128i low = _mm256_castsi256_si128(values), high = _mm256_extracti128_si256(values, 1); // Biased for uint32s, so they convert directly as int32s
+					__m256d lowDoubles = _mm256_cvtepi32_pd(low), highDoubles = _mm256_cvtepi32_pd(high);
+
+					if constexpr (std::is_signed_v<T>) Sums = _mm256_add_epi64(Sums, _mm256_add_epi64(_mm256_cvtepi32_epi64(low), _mm256_cvtepi32_epi64(high)));
+					else
+					{
+						__m256i raw = Bias<T>(values);
+						Sums = _mm256_add_epi64(Sums, _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(raw)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(raw, 1))));
+						lowDoubles = _mm256_add_pd(lowDoubles, _mm256_set1_pd(2147483648.0)), highDoubles = _mm256_add_pd(highDoubles, _mm256_set1_pd(2147483648.0));
+					}
+
+					DoubleSquares = _mm256_fmadd_pd(lowDoubles, lowDoubles, _mm256_fmadd_pd(highDoubles, highDoubles, DoubleSquares));
+				}
+			}
+
+			// Adds the block of 'iterations' vectors, whose first element is at index 'start', to the running statistics
+			void Reduce(uint64_t iterations, uint64_t start, Accumulator<T>& accumulator) const
+			{
+				constexpr int LANES = 32 / sizeof(T);
+				using Index = std::conditional_t<sizeof(T) == 8, uint64_t, std::conditional_t<sizeof(T) == 4, uint32_t, std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+				T mins[LANES], maxs[LANES];
+				Index minIterations[LANES], maxIterations[LANES];
+
+				Store(Mins, mins), Store(Maxs, maxs), Store(MinIterations, minIterations), Store(MaxIterations, maxIterations);
+
+				uint64_t found = ~uint64_t{ 0 };
+				if constexpr (std::is_same_v<T, float>) found = static_cast<uint64_t>(_mm256_movemask_ps(Found));
+				else if constexpr (std::is_same_v<T, double>) found = static_cast<uint64_t>(_mm256_movemask_pd(Found));
+
+				for (int lane = 0; lane < LANES; ++lane, ++accumulator.Stats.Count)
+					if (found >> lane & 1) accumulator.Candidates(Unbias(mins[lane]), start + minIterations[lane] * LANES + lane, Unbias(maxs[lane]), start + maxIterations[lane] * LANES + lane);
+
+				accumulator.Stats.Count += (iterations - 1) * LANES;
+
+				if constexpr (std::is_integral_v<T>)
+				{
+					alignas(32) uint64_t sums[4], squares[4];
+					_mm256_store_si256(reinterpret_cast<__m256i*>(sums), Sums), _mm256_store_si256(reinterpret_cast<__m256i*>(squares), Squares);
+					const uint32_t* partialSums = reinterpret_cast<const uint32_t*>(sums), * partialSquares = reinterpret_cast<const uint32_t*>(squares);
+
+					if constexpr (sizeof(T) == 1)
+					{
+						accumulator.Sum += static_cast<SumType<T>>(sums[0] + sums[1] + sums[2] + sums[3]);
+						if constexpr (std::is_signed_v<T>) accumulator.Sum -= static_cast<int64_t>(128 * LANES * iterations);
+						for (int i = 0; i < 8; ++i) accumulator.Squares += partialSquares[i];
+					}
+					else if constexpr (sizeof(T) == 2)
+					{
+						for (int i = 0; i < 8; ++i) accumulator.Sum += std::is_signed_v<T> ? static_cast<SumType<T>>(static_cast<int32_t>(partialSums[i])) : static_cast<SumType<T>>(partialSums[i]);
+						accumulator.Squares += squares[0] + squares[1] + squares[2] + squares[3];
+					}
+					else
+					{
+						double doubleSquares[4];
+						_mm256_storeu_pd(doubleSquares, DoubleSquares);
+						accumulator.Sum += static_cast<SumType<T>>(sums[0] + sums[1] + sums[2] + sums[3]);
+						accumulator.Squares += (doubleSquares[0] + doubleSquares[1]) + (doubleSquares[2] + doubleSquares[3]);
+					}
+				}
+				else
+				{
+					double sums[4], squares[4];
+					_mm256_storeu_pd(sums, DoubleSums), _mm256_storeu_pd(squares, DoubleSquares);
+					accumulator.Sum += (sums[0] + sums[1]) + (sums[2] + sums[3]), accumulator.Squares += (squares[0] + squares[1]) + (squares[2] + squares[3]);
+				}
+			}
+		};
+
+		// Adds the 'count' elements of 'data', the first at index 'start', to the running statistics: in blocks of whole vectors, then the remaining elements one at a time
+		template <typename T>
+		void AddRange(const T* data, uint64_t count, uint64_t start, Accumulator<T>& accumulator)
+		{
+			constexpr uint64_t LANES = 32 / sizeof(T);
+			uint64_t i = 0;
+
+			while (i + LANES <= count)
+			{
+				uint64_t iterations = std::min(BLOCK<T>, (count - i) / LANES);
+				Block<T> block;
+
+				for (uint64_t iteration = 0; iteration < iterations; ++iteration) block.Add(data + i + iteration * LANES, iteration);
+
+				block.Reduce(iterations, start + i, accumulator);
+				i += iterations * LANES;
+			}
+
+			for (; i < count; ++i, ++accumulator.Stats.Count)
+			{
+				if (data[i] == data[i]) accumulator.Candidates(data[i], start + i, data[i], start + i); // Skips NaNs
+				accumulator.Sum += static_cast<SumType<T>>(data[i]), accumulator.Squares += static_cast<SquaresType<T>>(data[i]) * static_cast<SquaresType<T>>(data[i]);
+			}
+		}
+
+		template <typename T>
+		Statistics<T> Finish(Accumulator<T>& accumulator)
+		{
+			Statistics<T>& stats = accumulator.Stats;
+			if (stats.Count == 0) return Statistics<T>{};
+
+			if (accumulator.IsEmpty) stats.Min = stats.Max = std::numeric_limits<T>::quiet_NaN(); // Only NaNs, as other types always have candidates
+
+			stats.Sum = static_cast<double>(accumulator.Sum), stats.SumOfSquares = static_cast<double>(accumulator.Squares);
+			stats.Mean = stats.Sum / stats.Count;
+			stats.StandardDeviation = std::sqrt(std::max(0.0, stats.SumOfSquares / stats.Count - stats.Mean * stats.Mean));
+			return stats;
+		}
+	};
+
+	// Computes the count, sum, sum of squares, mean, standard deviation, min, max, and the indices of the first min and max of the 'count' elements of 'data' in a single pass.
+	// Each lane keeps its own min and max, and the iteration it was found at, in registers of the element's width (so each vector is compared and blended without widening).
+	// Every 255 (8-bit) or 16384 (16-bit) vectors, before the iteration counters could overflow, the lanes are reduced and their sums flushed to 64-bit integers (doubles for
+	// floating-point types, and for the squares of 32-bit integers), so integer sums are exact. NaNs are ignored by min and max, which are NaN if every element is NaN. Not available for 64-bit integers
+	template <typename T>
+	Statistics<T> Stats(const T* data, uint64_t count)
+	{
+		StatsDetail::CheckType<T>();
+
+		StatsDetail::Accumulator<T> accumulator;
+		StatsDetail::AddRange(data, count, 0, accumulator);
+		return StatsDetail::Finish(accumulator);
+	}
+
+	// Computes the statistics (see above) of the width x height region of 'data' with 'stride' elements between rows. Indices are row-major within the region (y * width + x)
+	template <typename T>
+	Statistics<T> Stats(const T* data, uint64_t stride, uint64_t width, uint64_t height)
+	{
+		StatsDetail::CheckType<T>();
+
+		StatsDetail::Accumulator<T> accumulator;
+		for (uint64_t y = 0; y < height; ++y) StatsDetail::AddRange(data + y * stride, width, y * width, accumulator);
+		return StatsDetail::Finish(accumulator);
+	}
+};
+
+#endif
@@ -0,0 +1,441 @@
+#ifndef AVX256_YUV_H
+#define AVX256_YUV_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <immintrin.h>
+
+namespace AVX256Utils
+{
+	// The byte order of RGB pixels. The alpha of BGRA pixels is ignored when converting to YUV, and set to 255 when converting from it
+	enum class RGBFormat { BGR, RGB, BGRA };
+
+	// The luma coefficients used by the YUV conversions: BT.601 (SD video, JPEG) or BT.709 (HD video)
+	enum class YUVStandard { BT601, BT709 };
+
+	// The range of YUV values: limited (Y in [16, 235], U and V in [16, 240], used by most video) or full (all in [0, 255])
+	enum class YUVRange { Limited, Full };
+
+	namespace YUVDetail
+	{
+		// Fixed-point conversion coefficients. YUV to RGB: (Y - YOffset) << 6 and (C - 128) << 7 are multiplied (_mm256_mulhi_epi16) by YScale (2^14 fractional bits) and the chroma
+		// coefficients (2^13 fractional bits), which gives terms with 4 fractional bits. RGB to YUV: the channels are multiplied (_mm256_madd_epi16) by the Y*, U* and V* weights (2^15 fractional bits)
+		struct Coefficients
+		{
+			int16_t YOffset, YScale, RV, GU, GV, BU;
+			int16_t YR, YG, YB, UR, UG, UB, VR, VG, VB;
+
+			Coefficients(YUVStandard standard, YUVRange range)
+			{
+				double kr = standard == YUVStandard::BT601 ? 0.299 : 0.2126, kb = standard == YUVStandard::BT601 ? 0.114 : 0.0722, kg = 1 - kr - kb;
+				double yRange = range == YUVRange::Limited ? 219.0 / 255 : 1, cRange = range == YUVRange::Limited ? 224.0 / 255 : 1;
+				auto fixed = [](double value, int bits) { return static_cast<int16_t>(std::lround(value * (1 << bits))); };
+
+				YOffset = range == YUVRange::Limited ? 16 : 0;
+				YScale = fixed(1 / yRange, 14);
+				RV = fixed((2 - 2 * kr) / cRange, 13), BU = fixed((2 - 2 * kb) / cRange, 13);
+				GU = fixed(-(2 - 2 * kb) * kb / kg / cRange, 13), GV = fixed(-(2 - 2 * kr) * kr / kg / cRange, 13);
+
+				YR = fixed(kr * yRange, 15), YG = fixed(kg * yRange, 15), YB = fixed(kb * yRange, 15);
+				UR = fixed(-0.5 * kr / (1 - kb) * cRange, 15), UG = fixed(-0.5 * kg / (1 - kb) * cRange, 15), UB = fixed(0.5 * cRange, 15);
+				VR = fixed(0.5 * cRange, 15), VG = fixed(-0.5 * kg / (1 - kr) * cRange, 15), VB = fixed(-0.5 * kb / (1 - kr) * cRange, 15);
+			}
+		};
+
+		inline int BytesPerPixel(RGBFormat format) { return format == RGBFormat::BGRA ? 4 : 3; }
+
+		inline uint8_t Clamp(int value) { return static_cast<uint8_t>(std::min(std::max(value, 0), 255)); }
+
+		// The scalar equivalent of _mm256_mulhi_epi16()
+		inline int MulHigh(int a, int b) { return (a * b) >> 16; }
+
+		// Converts one YUV pixel to RGB, exactly as Decode32() does
+		inline void DecodePixel(int y, int u, int v, const Coefficients& k, uint8_t* out, RGBFormat format)
+		{
+			int luma = MulHigh((y - k.YOffset) * 64, k.YScale), cu = (u - 128) * 128, cv = (v - 128) * 128;
+			uint8_t r = Clamp((luma + MulHigh(cv, k.RV) + 8) >> 4), g = Clamp((luma + MulHigh(cu, k.GU) + MulHigh(cv, k.GV) + 8) >> 4), b = Clamp((luma + MulHigh(cu, k.BU) + 8) >> 4);
+
+			out[0] = format == RGBFormat::RGB ? r : b, out[1] = g, out[2] = format == RGBFormat::RGB ? b : r;
+			if (format == RGBFormat::BGRA) out[3] = UINT8_MAX;
+		}
+
+		// Returns the luma of one RGB pixel, exactly as Luma32() does
+		inline uint8_t LumaPixel(const uint8_t* pixel, const Coefficients& k, RGBFormat format)
+		{
+			int r = pixel[format == RGBFormat::RGB ? 0 : 2], g = pixel[1], b = pixel[format == RGBFormat::RGB ? 2 : 0];
+			return Clamp(((k.YR * r + k.YG * g + k.YB * b + (1 << 14)) >> 15) + k.YOffset);
+		}
+
+		// Returns the U and V of the sums of 4 RGB pixels (r, g, b), exactly as Chroma16() does
+		inline void ChromaPixel(int r, int g, int b, const Coefficients& k, uint8_t& u, uint8_t& v)
+		{
+			u = Clamp(((k.UR * r + k.UG * g + k.UB * b + (1 << 16)) >> 17) + 128);
+			v = Clamp(((k.VR * r + k.VG * g + k.VB * b + (1 << 16)) >> 17) + 128);
+		}
+
+		// Returns the 8 BGR pixels (24 bytes) at 'offset' dwords into 'block' (low lane) and 3 dwords later (high lane) as dwords (b, g, r, 0). See ColorDetail::WeightedPixels()
+		template <int OFFSET>
+		__m256i Spread(__m256i block)
+		{
+			const __m256i spread = _mm256_setr_epi8(
+				0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+				0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+			);
+
+			return _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(block, _mm256_setr_epi32(OFFSET, OFFSET + 1, OFFSET + 2, OFFSET + 3, OFFSET + 3, OFFSET + 4, OFFSET + 5, OFFSET + 6 > 7 ? 7 : OFFSET + 6)), spread);
+		}
+
+		// Loads 32 RGB pixels as 4 vectors of 8 pixels (in order), one pixel per dword. 3-byte pixels are loaded as in ColorDetail::Gray32(), so nothing beyond the 96 bytes is read
+		inline void LoadPixels(const uint8_t* src, RGBFormat format, __m256i pixels[4])
+		{
+			if (format == RGBFormat::BGRA)
+			{
+				for (int i = 0; i < 4; ++i) pixels[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32 * i));
+				return;
+			}
+
+			pixels[0] = Spread<0>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src))); // Bytes 0 - 23
+			pixels[1] = Spread<2>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 16))); // Bytes 24 - 47
+			pixels[2] = Spread<0>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 48))); // Bytes 48 - 71
+			pixels[3] = Spread<2>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64))); // Bytes 72 - 95
+		}
+
+		// Stores 32 pixels from the 32 bytes of each channel. 'first' and 'third' are the channels stored at bytes 0 and 2 of each pixel
+		inline void StorePixels(uint8_t* dst, __m256i first, __m256i second, __m256i third, RGBFormat format)
+		{
+			// Interleaving within lanes gives pixels [0-3 | 16-19], [4-7 | 20-23], [8-11 | 24-27] and [12-15 | 28-31]
+			__m256i firstSecondLow = _mm256_unpacklo_epi8(first, second), firstSecondHigh = _mm256_unpackhi_epi8(first, second);
+			__m256i thirdAlphaLow = _mm256_unpacklo_epi8(third, _mm256_set1_epi8(-1)), thirdAlphaHigh = _mm256_unpackhi_epi8(third, _mm256_set1_epi8(-1));
+			__m256i quarters[4] = { _mm256_unpacklo_epi16(firstSecondLow, thirdAlphaLow), _mm256_unpackhi_epi16(firstSecondLow, thirdAlphaLow), _mm256_unpacklo_epi16(firstSecondHigh, thirdAlphaHigh), _mm256_unpackhi_epi16(firstSecondHigh, thirdAlphaHigh) };
+			__m256i pixels[4] = {
+				_mm256_permute2x128_si256(quarters[0], quarters[1], 0x20), _mm256_permute2x128_si256(quarters[2], quarters[3], 0x20),
+				_mm256_permute2x128_si256(quarters[0], quarters[1], 0x31), _mm256_permute2x128_si256(quarters[2], quarters[3], 0x31)
+			};
+
+			if (format == RGBFormat::BGRA)
+			{
+				for (int i = 0; i < 4; ++i) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32 * i), pixels[i]);
+				return;
+			}
+
+			// Drop every 4th byte, so each group of 4 pixels is 12 bytes. Groups are stored in order as 16 bytes, so the extra 4 bytes are overwritten by the next group, except for the last one
+			const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+			for (int i = 0; i < 4; ++i)
+			{
+				__m256i packed = _mm256_shuffle_epi8(pixels[i], pack);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 24 * i), _mm256_castsi256_si128(packed));
+
+				if (i < 3) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 24 * i + 12), _mm256_extracti128_si256(packed, 1));
+				else
+				{
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 84), _mm256_extracti128_si256(packed, 1));
+					_mm_storeu_si32(dst + 92, _mm_srli_si128(_mm256_extracti128_si256(packed, 1), 8));
+				}
+			}
+		}
+
+		// Converts 32 pixels to RGB from their 32 Y values and 16 U and V values (each shared by 2 horizontally adjacent pixels)
+		inline void Decode32(__m256i y, __m128i u, __m128i v, const Coefficients& k, uint8_t* out, RGBFormat format)
+		{
+			__m256i cu = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(u), _mm256_set1_epi16(128)), 7), cv = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(v), _mm256_set1_epi16(128)), 7);
+			__m256i chroma[3] = { // The R, G and B chroma terms of chroma samples 0 - 15
+				_mm256_mulhi_epi16(cv, _mm256_set1_epi16(k.RV)),
+				_mm256_add_epi16(_mm256_mulhi_epi16(cu, _mm256_set1_epi16(k.GU)), _mm256_mulhi_epi16(cv, _mm256_set1_epi16(k.GV))),
+				_mm256_mulhi_epi16(cu, _mm256_set1_epi16(k.BU))
+			};
+
+			// Unpacking within lanes gives pixels [0-7 | 16-23] (low) and [8-15 | 24-31] (high) for both the luma and the upsampled (duplicated) chroma terms
+			__m256i offset = _mm256_set1_epi16(k.YOffset), scale = _mm256_set1_epi16(k.YScale), rounding = _mm256_set1_epi16(8);
+			__m256i lumaLow = _mm256_mulhi_epi16(_mm256_slli_epi16(_mm256_sub_epi16(_mm256_unpacklo_epi8(y, _mm256_setzero_si256()), offset), 6), scale);
+			__m256i lumaHigh = _mm256_mulhi_epi16(_mm256_slli_epi16(_mm256_sub_epi16(_mm256_unpackhi_epi8(y, _mm256_setzero_si256()), offset), 6), scale);
+			__m256i channels[3];
+
+			for (int c = 0; c < 3; ++c)
+			{
+				__m256i low = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(lumaLow, _mm256_unpacklo_epi16(chroma[c], chroma[c])), rounding), 4);
+				__m256i high = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(lumaHigh, _mm256_unpackhi_epi16(chroma[c], chroma[c])), rounding), 4);
+				channels[c] = _mm256_packus_epi16(low, high);
+			}
+
+			if (format == RGBFormat::RGB) StorePixels(out, channels[0], channels[1], channels[2], format);
+			else StorePixels(out, channels[2], channels[1], channels[0], format);
+		}
+
+		// Returns the (first, third) and (second, 0) weight pairs of a Y, U or V weight triple (r, g, b), for pixels whose first byte is 'format''s
+		inline void Weights(int16_t r, int16_t g, int16_t b, RGBFormat format, __m256i& firstThird, __m256i& second)
+		{
+			firstThird = format == RGBFormat::RGB ? _mm256_set1_epi32((static_cast<uint16_t>(b) << 16) | static_cast<uint16_t>(r)) : _mm256_set1_epi32((static_cast<uint16_t>(r) << 16) | static_cast<uint16_t>(b));
+			second = _mm256_set1_epi32(static_cast<uint16_t>(g));
+		}
+
+		// Returns the Y values of 32 pixels (4 vectors of 8 pixel dwords)
+		inline __m256i Luma32(const __m256i pixels[4], const Coefficients& k, RGBFormat format)
+		{
+			__m256i firstThird, second, luma[4];
+			Weights(k.YR, k.YG, k.YB, format, firstThird, second);
+
+			for (int i = 0; i < 4; ++i)
+			{
+				__m256i sum = _mm256_add_epi32(_mm256_madd_epi16(_mm256_and_si256(pixels[i], _mm256_set1_epi32(0x00FF00FF)), firstThird), _mm256_madd_epi16(_mm256_srli_epi16(pixels[i], 8), second));
+				luma[i] = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(1 << 14)), 15), _mm256_set1_epi32(k.YOffset));
+			}
+
+			// Each lane now holds 4 pixels from each vector, i.e. pixels [0-3, 8-11, 16-19, 24-27 | 4-7, 12-15, 20-23, 28-31]
+			return _mm256_permutevar8x32_epi32(_mm256_packus_epi16(_mm256_packs_epi32(luma[0], luma[1]), _mm256_packs_epi32(luma[2], luma[3])), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+		}
+
+		// Returns the 16 U or V values (as int16s, in order) of 32 pixels on two rows, each from the sum of 2 x 2 pixels
+		inline __m256i Chroma16(const __m256i sumsFirstThird[4], const __m256i sumsSecond[4], int16_t r, int16_t g, int16_t b, RGBFormat format)
+		{
+			__m256i firstThird, second, pixelChroma[4];
+			Weights(r, g, b, format, firstThird, second);
+
+			for (int i = 0; i < 4; ++i) pixelChroma[i] = _mm256_add_epi32(_mm256_madd_epi16(sumsFirstThird[i], firstThird), _mm256_madd_epi16(sumsSecond[i], second));
+
+			// Adding horizontal pairs gives chroma [0, 1, 4, 5 | 2, 3, 6, 7] and [8, 9, 12, 13 | 10, 11, 14, 15]
+			__m256i rounding = _mm256_set1_epi32(1 << 16), order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7), center = _mm256_set1_epi32(128);
+			__m256i low = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_permutevar8x32_epi32(_mm256_hadd_epi32(pixelChroma[0], pixelChroma[1]), order), rounding), 17), center);
+			__m256i high = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_permutevar8x32_epi32(_mm256_hadd_epi32(pixelChroma[2], pixelChroma[3]), order), rounding), 17), center);
+
+			__m256i chroma = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8); // [0-3, 8-11 | 4-7, 12-15] -> [0-15]
+			return _mm256_min_epi16(_mm256_max_epi16(chroma, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+		}
+
+		// Computes the U and V values (as int16s, in order) of 32 pixels from the sums of each pixel on 'above' and 'below' (which may be the same row)
+		inline void ChromaFromRows(const __m256i above[4], const __m256i below[4], const Coefficients& k, RGBFormat format, __m256i& u, __m256i& v)
+		{
+			__m256i sumsFirstThird[4], sumsSecond[4], mask = _mm256_set1_epi32(0x00FF00FF);
+
+			for (int i = 0; i < 4; ++i)
+			{
+				sumsFirstThird[i] = _mm256_add_epi16(_mm256_and_si256(above[i], mask), _mm256_and_si256(below[i], mask));
+				sumsSecond[i] = _mm256_add_epi16(_mm256_srli_epi16(above[i], 8), _mm256_srli_epi16(below[i], 8));
+			}
+
+			u = Chroma16(sumsFirstThird, sumsSecond, k.UR, k.UG, k.UB, format);
+			v = Chroma16(sumsFirstThird, sumsSecond, k.VR, k.VG, k.VB, format);
+		}
+
+		// Computes the chroma of the 2 x 2 pixels (or fewer, which are repeated) at column x of the two rows, as ChromaFromRows() does
+		inline void ChromaPixels(const uint8_t* above, const uint8_t* below, uint64_t x, uint64_t width, const Coefficients& k, RGBFormat format, uint8_t& u, uint8_t& v)
+		{
+			int pixelSize = BytesPerPixel(format), red = format == RGBFormat::RGB ? 0 : 2, blue = 2 - red;
+			uint64_t right = x + 1 < width ? x + 1 : x;
+			const uint8_t* pixels[4] = { above + x * pixelSize, above + right * pixelSize, below + x * pixelSize, below + right * pixelSize };
+			int r = 0, g = 0, b = 0;
+
+			for (const uint8_t* pixel : pixels) r += pixel[red], g += pixel[1], b += pixel[blue];
+			ChromaPixel(r, g, b, k, u, v);
+		}
+
+		// Converts a row of YUV pixels to RGB. load(x, y, u, v) loads the 32 Y and 16 U and V values of the pixels from x, and loadPixel(x, y, u, v) those of pixel x
+		template <typename Load, typename LoadPixel>
+		void DecodeRow(uint8_t* out, uint64_t width, const Coefficients& k, RGBFormat format, Load load, LoadPixel loadPixel)
+		{
+			uint64_t x = 0;
+			int pixelSize = BytesPerPixel(format);
+
+			for (; x + 32 <= width; x += 32)
+			{
+				__m256i y;
+				__m128i u, v;
+				load(x, y, u, v);
+				Decode32(y, u, v, k, out + x * pixelSize, format);
+			}
+
+			for (; x < width; ++x)
+			{
+				int y, u, v;
+				loadPixel(x, y, u, v);
+				DecodePixel(y, u, v, k, out + x * pixelSize, format);
+			}
+		}
+
+		// Converts a row pair (or a single row, if 'below' is 'above') of RGB pixels to Y for each row and chroma for every 2 pixels. store(x, u, v) stores the 16 U and V values (int16s)
+		// of the pixels from x, and storePixel(x, u, v) those of pixels x and x + 1
+		template <typename Store, typename StorePixel>
+		void EncodeRows(const uint8_t* above, const uint8_t* below, uint8_t* yAbove, uint8_t* yBelow, uint64_t width, const Coefficients& k, RGBFormat format, Store store, StorePixel storePixel)
+		{
+			uint64_t x = 0;
+			int pixelSize = BytesPerPixel(format);
+
+			for (; x + 32 <= width; x += 32)
+			{
+				__m256i pixelsAbove[4], pixelsBelow[4], u, v;
+				LoadPixels(above + x * pixelSize, format, pixelsAbove), LoadPixels(below + x * pixelSize, format, pixelsBelow);
+
+				if (yAbove != nullptr) _mm256_storeu_si256(reinterpret_cast<__m256i*>(yAbove + x), Luma32(pixelsAbove, k, format));
+				if (yBelow != nullptr && yBelow != yAbove) _mm256_storeu_si256(reinterpret_cast<__m256i*>(yBelow + x), Luma32(pixelsBelow, k, format));
+
+				ChromaFromRows(pixelsAbove, pixelsBelow, k, format, u, v);
+				store(x, u, v);
+			}
+
+			for (; x < width; x += 2)
+			{
+				uint8_t u, v;
+
+				for (uint64_t i = x; i < x + 2 && i < width; ++i)
+				{
+					if (yAbove != nullptr) yAbove[i] = LumaPixel(above + i * pixelSize, k, format);
+					if (yBelow != nullptr && yBelow != yAbove) yBelow[i] = LumaPixel(below + i * pixelSize, k, format);
+				}
+
+				ChromaPixels(above, below, x, width, k, format, u, v);
+				storePixel(x, u, v);
+			}
+		}
+
+		// Splits 32 interleaved UV bytes (NV12's chroma plane) into 16 U and 16 V values
+		inline void SplitUV(__m256i uv, __m128i& u, __m128i& v)
+		{
+			const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+			__m256i separated = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(uv, split), 0xD8); // [U0-7, V0-7 | U8-15, V8-15] -> [U0-15 | V0-15]
+			u = _mm256_castsi256_si128(separated), v = _mm256_extracti128_si256(separated, 1);
+		}
+
+		// Returns the 16 U and V values (int16s) as 32 interleaved UV bytes
+		inline __m256i InterleaveUV(__m256i u, __m256i v) { return _mm256_or_si256(u, _mm256_slli_epi16(v, 8)); }
+	};
+
+	// Converts an NV12 image (a Y plane, then a plane of interleaved U and V values for each 2 x 2 pixels) to RGB. Strides are the number of bytes between rows.
+	// Chroma is upsampled by repeating each U and V value for its 2 x 2 pixels. Odd widths and heights are supported, the last chroma column/row then covers 1 pixel
+	inline void NV12ToRGB(const uint8_t* y, uint64_t yStride, const uint8_t* uv, uint64_t uvStride, uint8_t* dst, uint64_t dstStride, uint64_t width, uint64_t height,
+		RGBFormat format = RGBFormat::BGR, YUVStandard standard = YUVStandard::BT601, YUVRange range = YUVRange::Limited)
+	{
+		YUVDetail::Coefficients k{ standard, range };
+
+		for (uint64_t row = 0; row < height; ++row)
+		{
+			const uint8_t* yRow = y + row * yStride, * uvRow = uv + (row / 2) * uvStride;
+
+			YUVDetail::DecodeRow(dst + row * dstStride, width, k, format,
+				[=](uint64_t x, __m256i& yValues, __m128i& u, __m128i& v)
+				{
+					yValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yRow + x));
+					YUVDetail::SplitUV(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(uvRow + x)), u, v);
+				},
+				[=](uint64_t x, int& yValue, int& u, int& v) { yValue = yRow[x], u = uvRow[x / 2 * 2], v = uvRow[x / 2 * 2 + 1]; }
+			);
+		}
+	}
+
+	// Converts an I420 image (a Y plane, then U and V planes with a value for each 2 x 2 pixels) to RGB. See NV12ToRGB()
+	inline void I420ToRGB(const uint8_t* y, uint64_t yStride, const uint8_t* u, uint64_t uStride, const uint8_t* v, uint64_t vStride, uint8_t* dst, uint64_t dstStride, uint64_t width, uint64_t height,
+		RGBFormat format = RGBFormat::BGR, YUVStandard standard = YUVStandard::BT601, YUVRange range = YUVRange::Limited)
+	{
+		YUVDetail::Coefficients k{ standard, range };
+
+		for (uint64_t row = 0; row < height; ++row)
+		{
+			const uint8_t* yRow = y + row * yStride, * uRow = u + (row / 2) * uStride, * vRow = v + (row / 2) * vStride;
+
+			YUVDetail::DecodeRow(dst + row * dstStride, width, k, format,
+				[=](uint64_t x, __m256i& yValues, __m128i& uValues, __m128i& vValues)
+				{
+					yValues = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yRow + x));
+					uValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(uRow + x / 2)), vValues = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vRow + x / 2));
+				},
+				[=](uint64_t x, int& yValue, int& uValue, int& vValue) { yValue = yRow[x], uValue = uRow[x / 2], vValue = vRow[x / 2]; }
+			);
+		}
+	}
+
+	// Converts a YUYV (YUY2) image (Y0 U Y1 V for each 2 horizontally adjacent pixels) to RGB. See NV12ToRGB(). The width must be even
+	inline void YUYVToRGB(const uint8_t* yuyv, uint64_t yuyvStride, uint8_t* dst, uint64_t dstStride, uint64_t width, uint64_t height,
+		RGBFormat format = RGBFormat::BGR, YUVStandard standard = YUVStandard::BT601, YUVRange range = YUVRange::Limited)
+	{
+		YUVDetail::Coefficients k{ standard, range };
+		const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15, 0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15); // [Y0-7, U0-3, V0-3] per lane
+
+		for (uint64_t row = 0; row < height; ++row)
+		{
+			const uint8_t* yuyvRow = yuyv + row * yuyvStride;
+
+			YUVDetail::DecodeRow(dst + row * dstStride, width, k, format,
+				[=](uint64_t x, __m256i& y, __m128i& u, __m128i& v)
+				{
+					// Each half is [Y0-7, U0-3, V0-3 | Y8-15, U4-7, V4-7], reordered to [Y0-15 | U0-7, V0-7]
+					__m256i first = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(yuyvRow + 2 * x)), split), _mm256_setr_epi32(0, 1, 4, 5, 2, 6, 3, 7));
+					__m256i second = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(yuyvRow + 2 * x + 32)), split), _mm256_setr_epi32(0, 1, 4, 5, 2, 6, 3, 7));
+					__m256i chroma = _mm256_permute4x64_epi64(_mm256_permute2x128_si256(first, second, 0x31), 0xD8); // [U0-7, V0-7 | U8-15, V8-15] -> [U0-15 | V0-15]
+
+					y = _mm256_permute2x128_si256(first, second, 0x20);
+					u = _mm256_castsi256_si128(chroma), v = _mm256_extracti128_si256(chroma, 1);
+				},
+				[=](uint64_t x, int& y, int& u, int& v) { y = yuyvRow[2 * x], u = yuyvRow[x / 2 * 4 + 1], v = yuyvRow[x / 2 * 4 + 3]; }
+			);
+		}
+	}
+
+	// Converts an RGB image to NV12 (see NV12ToRGB()). Each U and V value is computed from the mean of its 2 x 2 pixels
+	inline void RGBToNV12(const uint8_t* src, uint64_t srcStride, uint8_t* y, uint64_t yStride, uint8_t* uv, uint64_t uvStride, uint64_t width, uint64_t height,
+		RGBFormat format = RGBFormat::BGR, YUVStandard standard = YUVStandard::BT601, YUVRange range = YUVRange::Limited)
+	{
+		YUVDetail::Coefficients k{ standard, range };
+
+		for (uint64_t row = 0; row < height; row += 2)
+		{
+			uint64_t below = row + 1 < height ? row + 1 : row; // The last row of an odd height is its own pair
+			uint8_t* uvRow = uv + (row / 2) * uvStride;
+
+			YUVDetail::EncodeRows(src + row * srcStride, src + below * srcStride, y + row * yStride, y + below * yStride, width, k, format,
+				[=](uint64_t x, __m256i u, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(uvRow + x), YUVDetail::InterleaveUV(u, v)); },
+				[=](uint64_t x, uint8_t u, uint8_t v) { uvRow[x] = u, uvRow[x + 1] = v; }
+			);
+		}
+	}
+
+	// Converts an RGB image to I420 (see I420ToRGB()). Each U and V value is computed from the mean of its 2 x 2 pixels
+	inline void RGBToI420(const uint8_t* src, uint64_t srcStride, uint8_t* y, uint64_t yStride, uint8_t* u, uint64_t uStride, uint8_t* v, uint64_t vStride, uint64_t width, uint64_t height,
+		RGBFormat format = RGBFormat::BGR, YUVStandard standard = YUVStandard::BT601, YUVRange range = YUVRange::Limited)
+	{
+		YUVDetail::Coefficients k{ standard, range };
+
+		for (uint64_t row = 0; row < height; row += 2)
+		{
+			uint64_t below = row + 1 < height ? row + 1 : row;
+			uint8_t* uRow = u + (row / 2) * uStride, * vRow = v + (row / 2) * vStride;
+
+			YUVDetail::EncodeRows(src + row * srcStride, src + below * srcStride, y + row * yStride, y + below * yStride, width, k, format,
+				[=](uint64_t x, __m256i uValues, __m256i vValues)
+				{
+					__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(uValues, vValues), 0xD8); // [U0-7, V0-7 | U8-15, V8-15] -> [U0-15 | V0-15]
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(uRow + x / 2), _mm256_castsi256_si128(packed)), _mm_storeu_si128(reinterpret_cast<__m128i*>(vRow + x / 2), _mm256_extracti128_si256(packed, 1));
+				},
+				[=](uint64_t x, uint8_t uValue, uint8_t vValue) { uRow[x / 2] = uValue, vRow[x / 2] = vValue; }
+			);
+		}
+	}
+
+	// Converts an RGB image to YUYV (see YUYVToRGB()). Each U and V value is computed from the mean of its 2 pixels. The width must be even
+	inline void RGBToYUYV(const uint8_t* src, uint64_t srcStride, uint8_t* yuyv, uint64_t yuyvStride, uint64_t width, uint64_t height,
+		RGBFormat format = RGBFormat::BGR, YUVStandard standard = YUVStandard::BT601, YUVRange range = YUVRange::Limited)
+	{
+		YUVDetail::Coefficients k{ standard, range };
+		std::vector<uint8_t> luma(width); // Y values are interleaved with the chroma once the row's are computed
+
+		for (uint64_t row = 0; row < height; ++row)
+		{
+			const uint8_t* srcRow = src + row * srcStride;
+			uint8_t* yuyvRow = yuyv + row * yuyvStride;
+			uint8_t* lumaRow = luma.data();
+
+			YUVDetail::EncodeRows(srcRow, srcRow, lumaRow, lumaRow, width, k, format,
+				[=](uint64_t x, __m256i u, __m256i v)
+				{
+					__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lumaRow + x)), chroma = YUVDetail::InterleaveUV(u, v);
+					__m256i low = _mm256_unpacklo_epi8(y, chroma), high = _mm256_unpackhi_epi8(y, chroma); // Pixels [0-7 | 16-23] and [8-15 | 24-31]
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(yuyvRow + 2 * x), _mm256_permute2x128_si256(low, high, 0x20));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(yuyvRow + 2 * x + 32), _mm256_permute2x128_si256(low, high, 0x31));
+				},
+				[=](uint64_t x, uint8_t u, uint8_t v) { yuyvRow[2 * x] = lumaRow[x], yuyvRow[2 * x + 1] = u, yuyvRow[2 * x + 2] = lumaRow[x + 1], yuyvRow[2 * x + 3] = v; }
+			);
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,367 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include "benchmark.h"
+#include "avx256.h"
+#include "avx256_buffer.h"
+#include "avx256_blend.h"
+#include "avx256_color.h"
+#include "avx256_framepool.h"
+#include "avx256_bench.h"
+#include "avx256_roofline.h"
+#include "avx256_baseline.h"
+#include "avx256_dispatch.h"
+#include "operation_benchmark.h"
+
+#ifdef BENCHMARK_OPENCV // Defined by CMake when it finds and links OpenCV
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#endif
+
+#ifdef BENCHMARK
+
+using AVX256Utils::BenchmarkOptions;
+using AVX256Utils::BenchmarkResult;
+using AVX256Utils::BenchDetail::HideValue;
+
+// The buffers the kernels read from and write to, allocated once from a pool of cache-line aligned buffers
+struct BenchmarkBuffers
+{
+	AVX256Utils::FrameBuffer Input1, Input2, Reference, Output;
+	uint64_t Size;
+};
+
+// Fills the buffers with the bytes of 'path', repeated to fill 'size' bytes (Input2 starts halfway through), or with pseudo-random bytes if 'path' is empty. Returns false if the file can't be read
+bool fillInputs(BenchmarkBuffers& buffers, const std::string& path)
+{
+	std::vector<uint8_t> bytes;
+
+	if (!path.empty())
+	{
+		std::ifstream file{ path, std::ios::binary };
+		bytes.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+		if (bytes.empty()) return false;
+	}
+
+	uint32_t state = 2463534242;
+	for (uint64_t i = 0; i < buffers.Size; ++i)
+	{
+		if (bytes.empty())
+		{
+			state ^= state << 13, state ^= state >> 17, state ^= state << 5;
+			buffers.Input1.Data()[i] = static_cast<uint8_t>(state), buffers.Input2.Data()[i] = static_cast<uint8_t>(state >> 8);
+		}
+		else buffers.Input1.Data()[i] = bytes[i % bytes.size()], buffers.Input2.Data()[i] = bytes[(i + bytes.size() / 2) % bytes.size()];
+	}
+
+	return true;
+}
+
+// Benchmarks a variant that writes 'outputSize' bytes to buffers.Output (see AVX256Utils::Benchmark()), and adds its result to 'results'. The scalar variants hide their loop
+// index from the compiler (HideValue()) so that they aren't auto-vectorised and stay a scalar baseline for the speedups. The scalar variant's output is kept in
+// buffers.Reference, and if 'check', the variant's output must equal it, returning false otherwise
+template <typename Prepare, typename Run>
+bool benchmarkVariant(std::vector<BenchmarkResult>& results, const std::string& kernel, const std::string& variant, uint64_t bytes, uint64_t elements, const BenchmarkOptions& options,
+	BenchmarkBuffers& buffers, uint64_t outputSize, bool check, const Prepare& prepare, const Run& run)
+{
+	results.push_back(AVX256Utils::Benchmark(kernel, variant, bytes, elements, options, prepare, run));
+
+	if (variant == "Scalar") std::memcpy(buffers.Reference.Data(), buffers.Output.Data(), outputSize);
+	else if (check && !AVX256Utils::BuffersEqual(buffers.Reference.Data(), buffers.Output.Data(), outputSize))
+	{
+		std::cerr << "Error: " << kernel << " " << variant << " output differs from the scalar output!\n";
+		return false;
+	}
+
+	return true;
+}
+
+// Sets each byte to 255 if it is greater than the boundary, and 0 otherwise
+bool benchmarkThreshold(std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, BenchmarkBuffers& buffers)
+{
+	uint8_t boundary = 127, *input = buffers.Input1.Data(), *output = buffers.Output.Data();
+	uint64_t size = buffers.Size;
+	auto none = [] {};
+
+	bool passed = benchmarkVariant(results, "threshold", "Scalar", 2 * size, size, options, buffers, size, false, none, [=]
+		{
+			for (uint64_t i = 0; i < size; ++i) output[i] = (input[i] > boundary) * UINT8_MAX, HideValue(i);
+		}
+	);
+
+	passed &= benchmarkVariant(results, "threshold", "AVX256", 2 * size, size, options, buffers, size, true, none, [=]
+		{
+			AVX256<uint8_t> avxInput{ input }, avxOutput{ output }, avxBoundary{};
+			avxBoundary = boundary;
+
+			uint64_t i = 0;
+			for (; i + 32 <= size; i += 32, avxInput.Next(), avxOutput.Next()) avxOutput = avxInput > avxBoundary;
+			for (; i < size; ++i) output[i] = (input[i] > boundary) * UINT8_MAX;
+		}
+	);
+
+	passed &= benchmarkVariant(results, "threshold", "Dispatch", 2 * size, size, options, buffers, size, true, none, [=] { AVX256Utils::Kernels().Threshold(input, output, size, boundary); });
+
+#ifdef BENCHMARK_OPENCV
+	cv::Mat inputMat(1, static_cast<int>(size), CV_8UC1, input), outputMat(1, static_cast<int>(size), CV_8UC1, output);
+	passed &= benchmarkVariant(results, "threshold", "OpenCV", 2 * size, size, options, buffers, size, true, none, [&] { cv::threshold(inputMat, outputMat, boundary, UINT8_MAX, cv::THRESH_BINARY); });
+#endif
+
+	return passed;
+}
+
+// Blends the two inputs, weighting the first by alpha
+bool benchmarkBlend(std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, BenchmarkBuffers& buffers)
+{
+	float alpha = 0.3f;
+	uint8_t *input1 = buffers.Input1.Data(), *input2 = buffers.Input2.Data(), *output = buffers.Output.Data();
+	uint64_t size = buffers.Size;
+	auto none = [] {};
+
+	bool passed = benchmarkVariant(results, "blend", "Scalar", 3 * size, size, options, buffers, size, false, none, [=]
+		{
+			int weight = static_cast<int>(std::lround(alpha * 256));
+			for (uint64_t i = 0; i < size; ++i) output[i] = (input1[i] * weight + input2[i] * (256 - weight) + 128) >> 8, HideValue(i);
+		}
+	);
+
+	passed &= benchmarkVariant(results, "blend", "AVX256", 3 * size, size, options, buffers, size, true, none, [=] { AVX256Utils::Blend(input1, input2, output, size, alpha); });
+
+#ifdef BENCHMARK_OPENCV
+	cv::Mat input1Mat(1, static_cast<int>(size), CV_8UC1, input1), input2Mat(1, static_cast<int>(size), CV_8UC1, input2), outputMat(1, static_cast<int>(size), CV_8UC1, output);
+	passed &= benchmarkVariant(results, "blend", "OpenCV", 3 * size, size, options, buffers, size, false, none, [&] { cv::addWeighted(input1Mat, alpha, input2Mat, 1 - alpha, 0, outputMat); }); // Rounds differently
+#endif
+
+	return passed;
+}
+
+// Computes the absolute difference of the two inputs
+bool benchmarkAbsDiff(std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, BenchmarkBuffers& buffers)
+{
+	uint8_t *input1 = buffers.Input1.Data(), *input2 = buffers.Input2.Data(), *output = buffers.Output.Data();
+	uint64_t size = buffers.Size;
+	auto none = [] {};
+
+	bool passed = benchmarkVariant(results, "abs_diff", "Scalar", 3 * size, size, options, buffers, size, false, none, [=]
+		{
+			for (uint64_t i = 0; i < size; ++i) output[i] = abs(input1[i] - input2[i]), HideValue(i);
+		}
+	);
+
+	passed &= benchmarkVariant(results, "abs_diff", "AVX256", 3 * size, size, options, buffers, size, true, none, [=]
+		{
+			AVX256<uint8_t> avxInput1{ input1 }, avxInput2{ input2 }, avxOutput{ output };
+
+			uint64_t i = 0;
+			for (; i + 32 <= size; i += 32, avxInput1.Next(), avxInput2.Next(), avxOutput.Next()) avxOutput.Set(avxInput1).AbsoluteDifference(avxInput2);
+			for (; i < size; ++i) output[i] = abs(input1[i] - input2[i]);
+		}
+	);
+
+	passed &= benchmarkVariant(results, "abs_diff", "Dispatch", 3 * size, size, options, buffers, size, true, none, [=] { AVX256Utils::Kernels().AbsoluteDifference(input1, input2, output, size); });
+
+#ifdef BENCHMARK_OPENCV
+	cv::Mat input1Mat(1, static_cast<int>(size), CV_8UC1, input1), input2Mat(1, static_cast<int>(size), CV_8UC1, input2), outputMat(1, static_cast<int>(size), CV_8UC1, output);
+	passed &= benchmarkVariant(results, "abs_diff", "OpenCV", 3 * size, size, options, buffers, size, true, none, [&] { cv::absdiff(input1Mat, input2Mat, outputMat); });
+#endif
+
+	return passed;
+}
+
+// Swaps the B and R channels of BGR pixels in place. The output is reset to the input before each run
+bool benchmarkBGRToRGB(std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, BenchmarkBuffers& buffers)
+{
+	uint8_t *input = buffers.Input1.Data(), *output = buffers.Output.Data();
+	uint64_t pixels = buffers.Size / 3, size = 3 * pixels;
+	auto reset = [=] { std::memcpy(output, input, size); };
+
+	bool passed = benchmarkVariant(results, "bgr_to_rgb", "Scalar", 2 * size, pixels, options, buffers, size, false, reset, [=]
+		{
+			for (uint64_t i = 0; i < size; i += 3) std::swap(output[i], output[i + 2]), HideValue(i);
+		}
+	);
+
+	passed &= benchmarkVariant(results, "bgr_to_rgb", "AVX256", 2 * size, pixels, options, buffers, size, true, reset, [=] { AVX256Utils::BGRToRGB(output, pixels); });
+
+#ifdef BENCHMARK_OPENCV
+	cv::Mat inputMat(1, static_cast<int>(pixels), CV_8UC3, input), outputMat(1, static_cast<int>(pixels), CV_8UC3, output);
+	passed &= benchmarkVariant(results, "bgr_to_rgb", "OpenCV", 2 * size, pixels, options, buffers, size, true, [] {}, [&] { cv::cvtColor(inputMat, outputMat, cv::COLOR_BGR2RGB); });
+#endif
+
+	return passed;
+}
+
+// Converts BGR pixels to grey
+bool benchmarkBGRToGray(std::vector<BenchmarkResult>& results, const BenchmarkOptions& options, BenchmarkBuffers& buffers)
+{
+	uint8_t *input = buffers.Input1.Data(), *output = buffers.Output.Data();
+	uint64_t pixels = buffers.Size / 3;
+	auto none = [] {};
+
+	bool passed = benchmarkVariant(results, "bgr_to_gray", "Scalar", 4 * pixels, pixels, options, buffers, pixels, false, none, [=]
+		{
+			for (uint64_t i = 0; i < pixels; ++i) output[i] = AVX256Utils::ColorDetail::Gray(input + 3 * i), HideValue(i);
+		}
+	);
+
+	passed &= benchmarkVariant(results, "bgr_to_gray", "AVX256", 4 * pixels, pixels, options, buffers, pixels, true, none, [=] { AVX256Utils::BGRToGray(input, output, pixels); });
+
+#ifdef BENCHMARK_OPENCV
+	cv::Mat inputMat(1, static_cast<int>(pixels), CV_8UC3, input), outputMat(1, static_cast<int>(pixels), CV_8UC1, output);
+	passed &= benchmarkVariant(results, "bgr_to_gray", "OpenCV", 4 * pixels, pixels, options, buffers, pixels, false, none, [&] { cv::cvtColor(inputMat, outputMat, cv::COLOR_BGR2GRAY); }); // Different weights
+#endif
+
+	return passed;
+}
+
+// Runs each variant of each kernel matching the filter on buffers of options.Size bytes, adding the results to 'results'. Returns false if the input file can't be read or
+// an AVX256 variant's output differs from the scalar output
+bool benchmarkKernels(std::vector<BenchmarkResult>& results, const BenchmarkOptions& options)
+{
+	AVX256Utils::FrameBufferPool pool{ options.Size, 4 };
+	BenchmarkBuffers buffers{ pool.Acquire(), pool.Acquire(), pool.Acquire(), pool.Acquire(), options.Size };
+	if (!fillInputs(buffers, options.Input)) { std::cerr << "Error: Could not read " << options.Input << '\n'; return false; }
+
+	using Kernel = bool (*)(std::vector<BenchmarkResult>&, const BenchmarkOptions&, BenchmarkBuffers&);
+	std::pair<const char*, Kernel> kernels[] = {
+		{ "threshold", benchmarkThreshold }, { "blend", benchmarkBlend }, { "abs_diff", benchmarkAbsDiff }, { "bgr_to_rgb", benchmarkBGRToRGB }, { "bgr_to_gray", benchmarkBGRToGray }
+	};
+
+	bool passed = true;
+	for (const std::pair<const char*, Kernel>& kernel : kernels)
+		if (std::string{ kernel.first }.find(options.Filter) != std::string::npos) passed &= kernel.second(results, options, buffers);
+
+	return passed;
+}
+
+// Measures the STREAM bandwidth of each memory level, then runs the kernels with each level's working set (options.Size is ignored), and places each on its level's roofline
+// under the compute ceiling. Warns if a kernel exceeded a measured ceiling, and returns false if a kernel fails
+bool benchmarkRoofline(AVX256Utils::RooflineReport& report, const BenchmarkOptions& options)
+{
+	using AVX256Utils::MemoryLevel;
+
+	AVX256Utils::CacheSizes caches = AVX256Utils::DetectCacheSizes();
+	std::vector<std::pair<MemoryLevel, BenchmarkResult>> results;
+	bool passed = true;
+
+	for (MemoryLevel level : { MemoryLevel::L1, MemoryLevel::L2, MemoryLevel::L3, MemoryLevel::DRAM })
+	{
+		uint64_t workingSet = AVX256Utils::WorkingSetSize(level, caches);
+		report.Streams.push_back(AVX256Utils::MeasureStream(level, workingSet, options));
+
+		BenchmarkOptions levelOptions = options;
+		levelOptions.Size = std::max<uint64_t>(workingSet / 3 / 96 * 96, 96); // The most any kernel accesses is two inputs and an output, in whole BGR vectors
+		std::vector<BenchmarkResult> levelResults;
+		passed &= benchmarkKernels(levelResults, levelOptions);
+
+		for (BenchmarkResult& result : levelResults) results.emplace_back(level, std::move(result));
+	}
+
+	double peak = AVX256Utils::MeasureComputePeak(options);
+	report.Kernels = AVX256Utils::Roofline(results, report.Streams, peak);
+
+	// Roofline() raises a ceiling a kernel exceeded, which means the ceiling was measured too low (e.g. the machine was busy while measuring it)
+	for (const AVX256Utils::RooflineResult& result : report.Kernels)
+		for (const AVX256Utils::StreamResult& stream : report.Streams)
+			if (stream.Level == result.Level && (result.GBPerSecond > stream.Attainable() || result.ElementsPerSecond > peak))
+				std::cerr << "Warning: " << result.Kernel << " (" << result.Variant << ") exceeded the measured " << (result.GBPerSecond > stream.Attainable() ? "bandwidth" : "compute")
+					<< " ceiling at " << AVX256Utils::RooflineDetail::Name(result.Level) << ", which was raised to its throughput\n";
+
+	return passed;
+}
+
+// Writes the results to the output file (or the standard output) in the chosen format
+template <typename Results>
+void writeResults(const BenchmarkOptions& options, const Results& results)
+{
+	std::ofstream file;
+	if (!options.Output.empty()) file.open(options.Output);
+	std::ostream& out = options.Output.empty() ? std::cout : file;
+
+	if (options.Format == AVX256Utils::BenchmarkFormat::CSV) AVX256Utils::WriteCSV(out, results);
+	else if (options.Format == AVX256Utils::BenchmarkFormat::JSON) AVX256Utils::WriteJSON(out, options, results);
+	else AVX256Utils::WriteTable(out, results);
+}
+
+// Saves the samples of the results as a baseline with --save-baseline, and with --baseline, compares them against that baseline and writes the comparison instead of the results.
+// Returns 1 if a baseline file can't be read or written, 2 if a benchmark regressed, and 0 otherwise
+template <typename Result>
+int reportResults(const BenchmarkOptions& options, const std::vector<Result>& results)
+{
+	AVX256Utils::Baseline current = AVX256Utils::MakeBaseline(results);
+
+	if (!options.SaveBaseline.empty())
+	{
+		std::ofstream file{ options.SaveBaseline };
+		AVX256Utils::WriteBaseline(file, current);
+		if (!file) { std::cerr << "Error: Could not write " << options.SaveBaseline << '\n'; return 1; }
+	}
+
+	if (options.Baseline.empty())
+	{
+		writeResults(options, results);
+		return 0;
+	}
+
+	std::ifstream file{ options.Baseline };
+	AVX256Utils::Baseline baseline;
+	if (!AVX256Utils::ReadBaseline(file, baseline)) { std::cerr << "Error: Could not read the baseline " << options.Baseline << '\n'; return 1; }
+
+	if (baseline.Suite != current.Suite) std::cerr << "Warning: The baseline is of the " << baseline.Suite << " suite, not the " << current.Suite << " suite\n";
+	if (baseline.Machine != current.Machine) std::cerr << "Warning: The baseline was run on " << baseline.Machine << ", not " << current.Machine << '\n';
+
+	std::vector<AVX256Utils::BaselineComparison> comparisons = AVX256Utils::CompareBaseline(baseline, current, options);
+	writeResults(options, comparisons);
+
+	bool regressed = std::any_of(comparisons.begin(), comparisons.end(), [](const AVX256Utils::BaselineComparison& comparison) { return comparison.Regression; });
+	return regressed ? 2 : 0;
+}
+
+// Runs each variant (scalar, AVX256, the dispatched kernel of avx256_dispatch.h where there is one, and OpenCV if available) of each kernel on synthetic or file-backed buffers
+// without a display, or with --suite operations, each AVX256 method (see operationBenchmark()), or with --suite roofline, each kernel at each memory level (see
+// benchmarkRoofline()), and writes the timings as a table, CSV or JSON, or their comparison with a baseline (see reportResults()). Returns 1 if an argument is invalid or an
+// AVX256 variant's output differs from the scalar output, and 2 on a regression from the baseline
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!AVX256Utils::ParseBenchmarkOptions(argc, argv, options, std::cerr)) { AVX256Utils::WriteBenchmarkUsage(std::cerr); return 1; }
+	if (options.Help) { AVX256Utils::WriteBenchmarkUsage(std::cout); return 0; }
+
+	if (!AVX256Utils::GetCPUFeatures().HasRequired())
+	{
+		std::cerr << "Error: The benchmark requires AVX2, FMA, BMI1, LZCNT, POPCNT and SSE4.2, but your CPU only supports: " << AVX256Utils::GetCPUFeatures() << '\n';
+		return 1;
+	}
+
+	if (options.Suite == AVX256Utils::BenchmarkSuite::Operations) return reportResults(options, operationBenchmark(options));
+
+#ifdef BENCHMARK_OPENCV
+	cv::setNumThreads(0); // Every variant runs on a single thread
+#endif
+
+	if (options.Suite == AVX256Utils::BenchmarkSuite::Roofline)
+	{
+		if (!options.Baseline.empty() || !options.SaveBaseline.empty()) { std::cerr << "Error: The roofline suite has no baselines\n"; return 1; }
+
+		AVX256Utils::RooflineReport report;
+		bool passed = benchmarkRoofline(report, options);
+		writeResults(options, report);
+		return passed ? 0 : 1;
+	}
+
+	std::vector<BenchmarkResult> results;
+	bool passed = benchmarkKernels(results, options);
+
+	int status = reportResults(options, results);
+	return passed ? status : 1;
+}
+
+#endif
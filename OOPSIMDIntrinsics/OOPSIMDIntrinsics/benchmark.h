@@ -0,0 +1,2 @@
+// #define BENCHMARK
+// #define BENCHMARK_OPENCV
\ No newline at end of file
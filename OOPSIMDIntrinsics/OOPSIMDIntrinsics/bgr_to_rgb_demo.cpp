@@ -1,5 +1,7 @@
+#include <iostream>
 #include <string>
 #include <chrono>
+#include <array>
 
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/highgui.hpp>
@@ -7,6 +9,9 @@
 
 #include "test.h"
 #include "avx256.h"
+#include "avx256_buffer.h"
+#include "avx256_color.h"
+#include "avx256_pipeline.h"
 #include "demo.h"
 
 #ifndef TEST
@@ -14,65 +19,26 @@
 // Convert a BGR video to RGB using scalar operations, return fps performance metric
 int bgrToRGBScalar(cv::Mat& image)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	uint64_t size = static_cast<uint64_t>(image.rows) * image.cols * image.channels();
 
 	for (int i = 0; i < size; i += 3)
 		std::swap(image.data[i], image.data[i + 2]);
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
 
-// Convert a BGR video to RGB using AVX256, return fps performance metric
+// Convert a BGR video to RGB using AVX256 (see AVX256Utils::BGRToRGB()), return fps performance metric
 int bgrToRGBAVX256(cv::Mat& image)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
-
-	/*
-	*                 order1                               order2                                   order3
-	bgrbgrbgrbgrbgr(b|gr)bgrbgrbgrbgr(bg  ||  r)bgrbgrbgrbgrbgr|bgrbgrbgrbgrbgr(b  ||  gr)bgrbgrbgrbgr(bg|r)bgrbgrbgrbgrbgr  || ...
-	*/
-
-	AVX256<uint8_t> avxImage{ image.data };
-	std::array<uint8_t, 32>
-		order1{ {
-			2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15,
-			0, 1, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, 14, 15
-		} },
-		order2{ {
-			0, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13,
-			2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15
-		} },
-		order3{ {
-			0, 1, 4, 3, 2, 7, 6, 5, 10, 9, 8, 13, 12, 11, 14, 15,
-			0, 3, 2, 1, 6, 5, 4, 9, 8, 7, 12, 11, 10, 15, 14, 13
-			} };
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
+	AVX256Utils::BGRToRGB(image.data, static_cast<uint64_t>(image.rows) * image.cols);
 
-	uint64_t size = static_cast<uint64_t>(image.rows) * image.cols * image.channels();
-	uint64_t count = size / (32 * 3);
-	int residualCount = size % (32 * 3);
-
-	for (int i = 0; i < count; ++i, avxImage.Next())
-	{
-		avxImage.Permute8(order1);
-		std::swap(avxImage.Data[15], avxImage.Data[17]);
-		std::swap(avxImage.Data[30], avxImage.Data[32]);
-		avxImage.Next();
-		avxImage.Permute8(order2);
-		std::swap(avxImage.Data[31], avxImage.Data[33]);
-		avxImage.Next();
-		avxImage.Permute8(order3);
-		std::swap(avxImage.Data[14], avxImage.Data[16]);
-	}
-
-	for (uint64_t i = size - residualCount; i < size; i += 3)
-		std::swap(image.data[i], image.data[i + 2]);
-
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
@@ -80,56 +46,87 @@ int bgrToRGBAVX256(cv::Mat& image)
 // Convert a BGR video to RGB using cv::cvtColor() (with SIMD acceleration), return fps performance metric
 int bgrToRGBOpenCVSIMD(cv::Mat& image)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	cv::cvtColor(image, image, cv::COLOR_BGR2RGB);
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
 
-// Convert a BGR video to RGB using scalar, AVX256, and cv::cvtColor() (with SIMD acceleration)
+// A frame of the demo's pipeline, with preallocated images for each method so that no images are allocated per frame
+struct BGRToRGBFrame
+{
+	cv::Mat Frame, FrameScalar, FrameAVX256, FrameOpenCVSIMD;
+	int FPSs[3] = {};
+	bool IsFirst = false, IsEqual = true;
+};
+
+// Convert a BGR video to RGB using scalar, AVX256, and cv::cvtColor() (with SIMD acceleration). Frames are decoded, converted, and displayed on separate threads, so that decoding
+// the next frames overlaps converting and displaying the current one
 void bgrToRGBDemo(const std::string& videoPath)
 {
-	cv::Mat frame, result;
-	cv::Mat frameScalar, frameAVX256, frameOpenCVSIMD;
+	cv::Mat result;
 	cv::VideoCapture video{ videoPath };
 
 	int xmax = video.get(cv::CAP_PROP_FRAME_COUNT), ymax = 3000, avgRange = 15;
-	cv::Mat plot = createFPSPlot(cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT) / 2.5), std::pair<int, int>{xmax, ymax}, avgRange);
+	cv::Size plotSize(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT) / 2.5); // Read before the pipeline starts, as only the capture stage may use 'video' after
+	cv::Mat plot = createFPSPlot(plotSize, std::pair<int, int>{xmax, ymax}, avgRange);
 
 	std::vector<std::vector<int>> fpss(3, std::vector<int>(xmax));
 	int frameCount = 0;
 
-	while (true)
-	{
-		while (video.read(frame))
+	AVX256Utils::FramePipeline<BGRToRGBFrame> pipeline{ 3 };
+	AVX256Utils::PipelineStatistics stats = pipeline.Run(
+		[&video](BGRToRGBFrame& frame)
 		{
-			frameScalar = frame.clone();
-			fpss[0][frameCount] = bgrToRGBScalar(frameScalar);
+			frame.IsFirst = false;
+			if (video.read(frame.Frame)) return true;
 
-			frameAVX256 = frame.clone();
-			fpss[1][frameCount] = bgrToRGBAVX256(frameAVX256);
+			frame.IsFirst = true, video.set(cv::CAP_PROP_POS_FRAMES, 0); // Loop the video
+			return video.read(frame.Frame);
+		},
+		[](BGRToRGBFrame& frame)
+		{
+			frame.Frame.copyTo(frame.FrameScalar);
+			frame.FPSs[0] = bgrToRGBScalar(frame.FrameScalar);
+
+			frame.Frame.copyTo(frame.FrameAVX256);
+			frame.FPSs[1] = bgrToRGBAVX256(frame.FrameAVX256);
+
+			frame.Frame.copyTo(frame.FrameOpenCVSIMD);
+			frame.FPSs[2] = bgrToRGBOpenCVSIMD(frame.FrameOpenCVSIMD);
+
+			uint64_t size = static_cast<uint64_t>(frame.Frame.rows) * frame.Frame.cols * frame.Frame.channels();
+			frame.IsEqual = AVX256Utils::BuffersEqual(frame.FrameScalar.data, frame.FrameAVX256.data, size) && AVX256Utils::BuffersEqual(frame.FrameScalar.data, frame.FrameOpenCVSIMD.data, size);
+		},
+		[&](BGRToRGBFrame& frame)
+		{
+			if (!frame.IsEqual) return false;
 
-			frameOpenCVSIMD = frame.clone();
-			fpss[2][frameCount] = bgrToRGBOpenCVSIMD(frameOpenCVSIMD);
+			if (frame.IsFirst)
+			{
+				frameCount = 0;
+				plot = createFPSPlot(plotSize, std::pair<int, int>{xmax, ymax}, avgRange);
+			}
 
+			for (int i = 0; i < 3; ++i) fpss[i][frameCount] = frame.FPSs[i];
 			++frameCount;
 
-			if (cv::sum(frameScalar != frameAVX256) != cv::Scalar(0) || cv::sum(frameScalar != frameOpenCVSIMD) != cv::Scalar(0)) return;
 			plotFPS(plot, std::pair<int, int>{xmax, ymax}, frameCount, avgRange, fpss);
-			writeFPS(frameScalar, frameCount, fpss);
+			writeFPS(frame.FrameScalar, frameCount, fpss);
 
-			cv::vconcat(std::array<cv::Mat, 2>{frameScalar, plot}, result);
+			cv::vconcat(std::array<cv::Mat, 2>{frame.FrameScalar, plot}, result);
 			cv::imshow("Output", result);
 
-			if (cv::pollKey() != -1) { cv::destroyAllWindows(); return; }
+			if (cv::pollKey() != -1) { cv::destroyAllWindows(); return false; }
+			return true;
 		}
+	);
 
-		frameCount = 0, video.set(cv::CAP_PROP_POS_FRAMES, 0);
-		plot = createFPSPlot(cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT) / 2.5), std::pair<int, int>{xmax, ymax}, avgRange);
-	}
+	std::cout << "Decode: " << 1000 * stats.Capture.MeanSeconds() << "ms, convert: " << 1000 * stats.Compute.MeanSeconds() << "ms, display: " << 1000 * stats.Sink.MeanSeconds()
+		<< "ms, latency: " << 1000 * stats.MeanLatencySeconds << "ms (max " << 1000 * stats.MaxLatencySeconds << "ms)\n";
 }
 
 #endif
\ No newline at end of file
@@ -8,69 +8,72 @@
 
 #include "test.h"
 #include "avx256.h"
+#include "avx256_buffer.h"
+#include "avx256_framepool.h"
+#include "avx256_blend.h"
 #include "demo.h"
 
 #ifndef TEST
 
-// Blend image2 into image1 using scalar addition, return fps performance metric
-int blendScalar(cv::Mat& image1, cv::Mat& image2)
+// Blend image2 into image1 (weighting image1 by alpha) using scalar 8.8 fixed-point arithmetic, return fps performance metric
+int blendScalar(cv::Mat& image1, cv::Mat& image2, float alpha)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();	
 
 	uint64_t size = static_cast<uint64_t>(image1.rows) * image1.cols * image1.channels();
+	int weight = static_cast<int>(std::lround(alpha * 256));
 
 	for (uint64_t i = 0; i < size; ++i)
-		image1.data[i] = (image1.data[i] + image2.data[i] + 1) >> 1;
+		image1.data[i] = (image1.data[i] * weight + image2.data[i] * (256 - weight) + 128) >> 8;
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
 
-// Blend image2 into image1 using AVX256 Average(), return fps performance metric
-int blendAVX256(cv::Mat& image1, cv::Mat& image2)
+// Blend image2 into image1 (weighting image1 by alpha) using AVX256Utils::Blend(), return fps performance metric
+int blendAVX256(cv::Mat& image1, cv::Mat& image2, float alpha)
 {	
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-	AVX256<uint8_t> avxImage1{ image1.data }, avxImage2{ image2.data };
+	AVX256Utils::Blend(image1.data, image2.data, image1.data, static_cast<uint64_t>(image1.rows) * image1.cols * image1.channels(), alpha);
 
-	uint64_t size = static_cast<uint64_t>(image1.rows) * image1.cols * image1.channels();
-	uint64_t count = size / 32;
-	int residualCount = size % 32;
-
-	for (int i = 0; i < count; ++i, avxImage1.Next(), avxImage2.Next())
-		avxImage1.Average(avxImage2);
-
-	for (uint64_t i = size - residualCount; i < size; ++i)
-		image1.data[i] = (image1.data[i] + image2.data[i] + 1) >> 1;
-
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
 
-// Blend image2 into image1 using cv::addWeighted() (simd), return fps performance metric
-int blendOpenCVSIMD(cv::Mat& image1, cv::Mat& image2)
+// Blend image2 into image1 (weighting image1 by alpha) using cv::addWeighted() (simd), return fps performance metric
+int blendOpenCVSIMD(cv::Mat& image1, cv::Mat& image2, float alpha)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-	cv::addWeighted(image1, 0.5, image2, 0.5, 0, image1);
+	cv::addWeighted(image1, alpha, image2, 1 - alpha, 0, image1);
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
 
-// Blend frames of video2 into video1 using scalar addition, AVX256 addition, and cv::add() (with SIMD acceleration)
+// Blend frames of video2 into video1 using scalar, AVX256, and cv::addWeighted() (with SIMD acceleration). The weight of video1 is configurable by a trackbar element
 void blendDemo(const std::string& video1Path, const std::string& video2Path)
 {
 	cv::Mat frame1, frame2, result;
-	cv::Mat frame1Scalar, frame1AVX256, frame1OpenCVSIMD;
 	cv::VideoCapture video1{ video1Path }, video2{ video2Path };
 
 	int xmax = std::min(video1.get(cv::CAP_PROP_FRAME_COUNT), video2.get(cv::CAP_PROP_FRAME_COUNT)), ymax = 3000, avgRange = 15, size = video1.get(cv::CAP_PROP_FRAME_HEIGHT) * video1.get(cv::CAP_PROP_FRAME_WIDTH) * 3;
+	int width = video1.get(cv::CAP_PROP_FRAME_WIDTH), height = video1.get(cv::CAP_PROP_FRAME_HEIGHT);
+
+	// Each method blends a copy of the frame in its own preallocated, aligned buffer, rather than a clone allocated every frame
+	AVX256Utils::FrameBufferPool pool{ static_cast<uint64_t>(size), 3 };
+	AVX256Utils::FrameBuffer buffers[3] = { pool.Acquire(), pool.Acquire(), pool.Acquire() };
+	cv::Mat frame1Scalar(height, width, CV_8UC3, buffers[0].Data()), frame1AVX256(height, width, CV_8UC3, buffers[1].Data()), frame1OpenCVSIMD(height, width, CV_8UC3, buffers[2].Data());
 	cv::Mat plot = createFPSPlot(cv::Size(video1.get(cv::CAP_PROP_FRAME_WIDTH), video1.get(cv::CAP_PROP_FRAME_HEIGHT) / 2.5), std::pair<int, int>{xmax, ymax}, avgRange);
 
+	int alphaPercent = 50;
+	cv::namedWindow("Output", cv::WINDOW_AUTOSIZE);
+	cv::createTrackbar("Alpha %", "Output", nullptr, 100, [](int barPos, void* alphaPercent) {*static_cast<int*>(alphaPercent) = barPos; }, &alphaPercent);
+
 	std::vector<std::vector<int>> fpss(3, std::vector<int>(xmax));
 	int frameCount = 0;
 
@@ -78,18 +81,20 @@ void blendDemo(const std::string& video1Path, const std::string& video2Path)
 	{
 		while (video1.read(frame1) && video2.read(frame2))
 		{
-			frame1Scalar = frame1.clone();
-			fpss[0][frameCount] = blendScalar(frame1Scalar, frame2);
+			float alpha = alphaPercent / 100.0f;
+
+			frame1.copyTo(frame1Scalar);
+			fpss[0][frameCount] = blendScalar(frame1Scalar, frame2, alpha);
 
-			frame1AVX256 = frame1.clone();
-			fpss[1][frameCount] = blendAVX256(frame1AVX256, frame2);
+			frame1.copyTo(frame1AVX256);
+			fpss[1][frameCount] = blendAVX256(frame1AVX256, frame2, alpha);
 
-			frame1OpenCVSIMD = frame1.clone();
-			fpss[2][frameCount] = blendOpenCVSIMD(frame1OpenCVSIMD, frame2);
+			frame1.copyTo(frame1OpenCVSIMD);
+			fpss[2][frameCount] = blendOpenCVSIMD(frame1OpenCVSIMD, frame2, alpha);
 
 			++frameCount;			
 
-			if (cv::sum(frame1Scalar != frame1AVX256) != cv::Scalar(0, 0, 0) || !std::equal(frame1Scalar.data, frame1Scalar.data + size, frame1OpenCVSIMD.data, [](const int& a, const int& b) {return std::abs(a - b) <= 1; })) return;
+			if (!AVX256Utils::BuffersEqual(frame1Scalar.data, frame1AVX256.data, size) || !std::equal(frame1Scalar.data, frame1Scalar.data + size, frame1OpenCVSIMD.data, [](const int& a, const int& b) {return std::abs(a - b) <= 1; })) return;
 			plotFPS(plot, std::pair<int, int>{xmax, ymax}, frameCount, avgRange, fpss);
 			writeFPS(frame1Scalar, frameCount, fpss);
 
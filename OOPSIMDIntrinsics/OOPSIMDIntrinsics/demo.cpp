@@ -7,13 +7,14 @@
 #include <opencv2/imgproc.hpp>
 
 #include "test.h"
+#include "benchmark.h"
 #include "avx256.h"
 #include "blend_demo.h"
 #include "threshold_demo.h"
 #include "abs_diff_demo.h"
 #include "bgr_to_rgb_demo.h"
 
-#ifndef TEST
+#if !defined(TEST) && !defined(BENCHMARK)
 
 // Create and return a graph for plotting fps moving average points on
 cv::Mat createFPSPlot(const cv::Size& size, const std::pair<int, int>& axisMax, int avgRange)
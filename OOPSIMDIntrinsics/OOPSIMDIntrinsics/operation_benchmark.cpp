@@ -0,0 +1,255 @@
+#include <ostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "benchmark.h"
+#include "avx256.h"
+#include "avx256_bench.h"
+#include "operation_benchmark.h"
+
+#ifdef BENCHMARK
+
+using AVX256Utils::BenchDetail::HideValue;
+
+// The unsigned integer type with the same size as T, for bitwise scalar operations on floating-point elements
+template <typename T>
+using Bits = std::conditional_t<sizeof(T) == 8, uint64_t, std::conditional_t<sizeof(T) == 4, uint32_t, std::conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+
+template <typename T>
+Bits<T> toBits(T value)
+{
+	Bits<T> bits;
+	std::memcpy(&bits, &value, sizeof(T));
+	return bits;
+}
+
+template <typename T>
+T fromBits(Bits<T> bits)
+{
+	T value;
+	std::memcpy(&value, &bits, sizeof(T));
+	return value;
+}
+
+template <typename T>
+T saturate(int64_t value) { return static_cast<T>(std::clamp<int64_t>(value, std::numeric_limits<T>::min(), std::numeric_limits<T>::max())); }
+
+// Sets each element of 'vector' to function(element, operand element), keeping each result in a register so that the loop stays scalar
+template <typename T, typename Function>
+void scalarElementwise(T* vector, const T* operand, const Function& function)
+{
+	for (uint64_t i = 0; i < 32 / sizeof(T); ++i)
+	{
+		T value = static_cast<T>(function(vector[i], operand[i]));
+		HideValue(value);
+		vector[i] = value;
+	}
+}
+
+// Re-orders the G-sized elements of 'vector' so that element i is copied from element sources[i], or cleared if sources[i] is negative
+template <typename G, typename T>
+void scalarPermute(T* vector, const std::array<int, 32 / sizeof(G)>& sources)
+{
+	G elements[32 / sizeof(G)], permuted[32 / sizeof(G)];
+	std::memcpy(elements, vector, 32);
+
+	for (uint64_t i = 0; i < 32 / sizeof(G); ++i)
+	{
+		G value = sources[i] < 0 ? 0 : elements[sources[i]];
+		HideValue(value);
+		permuted[i] = value;
+	}
+
+	std::memcpy(vector, permuted, 32);
+}
+
+constexpr std::array<uint32_t, 8> PERMUTE32_ORDER{ { 1, 2, 3, 4, 5, 6, 7, 0 } }; // Rotate
+constexpr std::array<uint8_t, 32> PERMUTE8_ORDER{ { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 } }; // Reverse each 128-bit lane
+
+// Returns 'count' pseudo-random elements. Floating-point elements are close to 1, so that chains of operations on them neither overflow nor become denormal,
+// and shift counts are small
+template <typename T>
+std::vector<T> operandValues(uint64_t count, bool shiftCounts, uint32_t seed)
+{
+	std::vector<T> values(count);
+
+	for (T& value : values)
+	{
+		seed ^= seed << 13, seed ^= seed >> 17, seed ^= seed << 5;
+		if constexpr (std::is_floating_point_v<T>) value = static_cast<T>(1 + (static_cast<int>(seed % 1000) - 500) * 1e-5);
+		else if (shiftCounts) value = static_cast<T>(seed % 4);
+		else value = static_cast<T>(seed | 1); // Odd, so products don't become 0
+	}
+
+	return values;
+}
+
+// Returns whether 'filter' selects the operation on 'type': "name<type>" selects the operations on exactly that type whose name contains 'name', a type name
+// selects every operation on exactly that type (so "int8_t" doesn't select uint8_t operations), and anything else selects the operations whose name contains it
+bool operationSelected(const std::string& filter, const std::string& operation, const std::string& type)
+{
+	size_t open = filter.find('<');
+	if (open != std::string::npos)
+	{
+		std::string name = filter.substr(0, open), filterType = filter.substr(open + 1);
+		if (!filterType.empty() && filterType.back() == '>') filterType.pop_back();
+		return operation.find(name) != std::string::npos && (filterType.empty() || filterType == type);
+	}
+
+	static const std::array<std::string, 10> TYPES{ { "double", "float", "uint64_t", "int64_t", "uint32_t", "int32_t", "uint16_t", "int16_t", "uint8_t", "int8_t" } };
+	if (std::find(TYPES.begin(), TYPES.end(), filter) != TYPES.end()) return filter == type;
+	return operation.find(filter) != std::string::npos;
+}
+
+// Measure every AVX256<T> method available for T, adding the results to 'results'
+template <typename T>
+void benchmarkType(const std::string& type, const AVX256Utils::BenchmarkOptions& options, std::vector<AVX256Utils::OperationResult>& results)
+{
+	constexpr bool FLOAT = std::is_floating_point_v<T>, INTEGER = !FLOAT, SIGNED = std::is_signed_v<T>;
+	constexpr uint64_t LANES = 32 / sizeof(T);
+	using Wide = std::conditional_t<FLOAT, T, std::conditional_t<SIGNED, int64_t, uint64_t>>;
+
+	std::vector<T> initial = operandValues<T>(LANES, false, 2463534242), operands = operandValues<T>(AVX256Utils::BenchDetail::OPERANDS * LANES, false, 88675123);
+	std::vector<T> shifts = operandValues<T>(AVX256Utils::BenchDetail::OPERANDS * LANES, true, 88675123);
+
+	// Operations whose result doesn't depend on the vector's previous value are only measured in memory mode, as in registers the compiler drops all but the last one of each chain
+	auto measure = [&](const std::string& operation, const auto& kernel, const auto& scalar, const std::vector<T>& values, bool dependent = true)
+	{
+		if (!operationSelected(options.Filter, operation, type)) return;
+
+		std::vector<AVX256Utils::OperationResult> measured = AVX256Utils::MeasureOperation(operation, type, kernel, scalar, initial.data(), values.data(), options);
+		for (const AVX256Utils::OperationResult& result : measured)
+			if (dependent || result.Mode == AVX256Utils::OperationMode::Memory) results.push_back(result);
+	};
+
+	auto elementwise = [&](const std::string& operation, const auto& kernel, const auto& function, bool dependent = true)
+	{
+		measure(operation, kernel, [&function](T* vector, const T* operand) { scalarElementwise(vector, operand, function); }, operands, dependent);
+	};
+
+	auto bitwise = [](const auto& function) { return [function](T a, T b) { return fromBits<T>(static_cast<Bits<T>>(function(toBits(a), toBits(b)))); }; };
+
+	elementwise("Add", [](T* v, const T* o) { AVX256<T>{ v }.Add(o); }, [](T a, T b) { return static_cast<Wide>(a) + b; });
+	elementwise("Sub", [](T* v, const T* o) { AVX256<T>{ v }.Sub(o); }, [](T a, T b) { return static_cast<Wide>(a) - b; });
+
+	if constexpr (INTEGER && sizeof(T) <= 2)
+	{
+		elementwise("AddSaturate", [](T* v, const T* o) { AVX256<T>{ v }.AddSaturate(o); }, [](T a, T b) { return saturate<T>(static_cast<int64_t>(a) + b); });
+		elementwise("SubSaturate", [](T* v, const T* o) { AVX256<T>{ v }.SubSaturate(o); }, [](T a, T b) { return saturate<T>(static_cast<int64_t>(a) - b); });
+		elementwise("Average", [](T* v, const T* o) { AVX256<T>{ v }.Average(o); }, [](T a, T b) { return (static_cast<int64_t>(a) + b + 1) >> 1; });
+	}
+
+	elementwise("Mul", [](T* v, const T* o) { AVX256<T>{ v }.Mul(o); }, [](T a, T b)
+		{
+			if constexpr (FLOAT) return a * b;
+			else if constexpr (sizeof(T) == 8) return static_cast<Wide>(static_cast<std::conditional_t<SIGNED, int32_t, uint32_t>>(a)) * static_cast<std::conditional_t<SIGNED, int32_t, uint32_t>>(b);
+			else if constexpr (sizeof(T) == 1) return saturate<T>(static_cast<int64_t>(a) * b);
+			else return static_cast<Wide>(a) * b;
+		}
+	);
+
+	if constexpr (FLOAT)
+	{
+		elementwise("Div", [](T* v, const T* o) { AVX256<T>{ v }.Div(o); }, [](T a, T b) { return a / b; });
+		elementwise("Floor", [](T* v, const T*) { AVX256<T>{ v }.Floor(); }, [](T a, T) { return std::floor(a); });
+		elementwise("Ceil", [](T* v, const T*) { AVX256<T>{ v }.Ceil(); }, [](T a, T) { return std::ceil(a); });
+		elementwise("Sqrt", [](T* v, const T*) { AVX256<T>{ v }.Sqrt(); }, [](T a, T) { return std::sqrt(a); });
+	}
+
+	if constexpr (std::is_same_v<T, float>)
+	{
+		elementwise("Inverse", [](T* v, const T*) { AVX256<T>{ v }.Inverse(); }, [](T a, T) { return 1 / a; });
+		elementwise("InverseSqrt", [](T* v, const T*) { AVX256<T>{ v }.InverseSqrt(); }, [](T a, T) { return 1 / std::sqrt(a); });
+	}
+
+	elementwise("Set", [](T* v, const T* o) { AVX256<T>{ v }.Set(o); }, [](T, T b) { return b; }, false);
+	elementwise("Clear", [](T* v, const T*) { AVX256<T>{ v }.Clear(); }, [](T, T) { return T{ 0 }; }, false);
+	elementwise("Negate", [](T* v, const T*) { AVX256<T>{ v }.Negate(); }, bitwise([](Bits<T> a, Bits<T>) { return ~a; }));
+	elementwise("And", [](T* v, const T* o) { AVX256<T>{ v }.And(o); }, bitwise([](Bits<T> a, Bits<T> b) { return a & b; }));
+	elementwise("Or", [](T* v, const T* o) { AVX256<T>{ v }.Or(o); }, bitwise([](Bits<T> a, Bits<T> b) { return a | b; }));
+	elementwise("Xor", [](T* v, const T* o) { AVX256<T>{ v }.Xor(o); }, bitwise([](Bits<T> a, Bits<T> b) { return a ^ b; }));
+
+	if constexpr (INTEGER && sizeof(T) >= 2)
+		elementwise("ShiftLeft(shift)", [](T* v, const T*) { AVX256<T>{ v }.ShiftLeft(1); }, [](T a, T) { return static_cast<Bits<T>>(static_cast<Bits<T>>(a) << 1); });
+
+	if constexpr (INTEGER && sizeof(T) >= 2 && !std::is_same_v<T, int64_t>)
+		elementwise("ShiftRight(shift)", [](T* v, const T*) { AVX256<T>{ v }.ShiftRight(1); }, [](T a, T) { return a >> 1; });
+
+	if constexpr (INTEGER && sizeof(T) >= 4)
+		measure("ShiftLeft(shifts)", [](T* v, const T* o) { AVX256<T>{ v }.ShiftLeft(o); }, [](T* v, const T* o)
+			{
+				scalarElementwise(v, o, [](T a, T b) { return static_cast<Bits<T>>(static_cast<Bits<T>>(a) << b); });
+			}, shifts
+		);
+
+	if constexpr (INTEGER && sizeof(T) >= 4 && !std::is_same_v<T, int64_t>)
+		measure("ShiftRight(shifts)", [](T* v, const T* o) { AVX256<T>{ v }.ShiftRight(o); }, [](T* v, const T* o) { scalarElementwise(v, o, [](T a, T b) { return a >> b; }); }, shifts);
+
+	if constexpr (INTEGER && SIGNED && sizeof(T) <= 4)
+		elementwise("Absolute", [](T* v, const T*) { AVX256<T>{ v }.Absolute(); }, [](T a, T) { return a < 0 ? -static_cast<Wide>(a) : a; });
+
+	if constexpr (FLOAT || (!SIGNED && sizeof(T) <= 4))
+		elementwise("AbsoluteDifference", [](T* v, const T* o) { AVX256<T>{ v }.AbsoluteDifference(o); }, [](T a, T b) { return a > b ? a - b : b - a; });
+
+	if constexpr (FLOAT || sizeof(T) <= 4)
+	{
+		elementwise("Min", [](T* v, const T* o) { AVX256<T>{ v }.Min(o); }, [](T a, T b) { return std::min(a, b); });
+		elementwise("Max", [](T* v, const T* o) { AVX256<T>{ v }.Max(o); }, [](T a, T b) { return std::max(a, b); });
+
+		// The sum is written back to the first element, so that each sum depends on the previous one
+		measure("Sum", [](T* v, const T*) { v[0] = static_cast<T>(AVX256<T>{ v }.Sum()); }, [](T* v, const T*)
+			{
+				Wide sum = 0;
+				for (uint64_t i = 0; i < LANES; ++i) sum += v[i], HideValue(sum);
+				v[0] = static_cast<T>(sum);
+			}, operands
+		);
+	}
+
+	// Comparison masks are written back to the vector, so that each comparison depends on the previous one
+	T ones = fromBits<T>(static_cast<Bits<T>>(~Bits<T>{ 0 }));
+	elementwise("IsEqualTo", [](T* v, const T* o) { AVX256<T> vector{ v }; vector.Set(vector.IsEqualTo(o)); }, [ones](T a, T b) { return a == b ? ones : T{ 0 }; });
+	elementwise("IsGreaterThan", [](T* v, const T* o) { AVX256<T> vector{ v }; vector.Set(vector.IsGreaterThan(o)); }, [ones](T a, T b) { return a > b ? ones : T{ 0 }; });
+	elementwise("IsLessThan", [](T* v, const T* o) { AVX256<T> vector{ v }; vector.Set(vector.IsLessThan(o)); }, [ones](T a, T b) { return a < b ? ones : T{ 0 }; });
+
+	measure("IsZero", [](T* v, const T*) { v[0] = static_cast<T>(AVX256<T>{ v }.IsZero()); }, [](T* v, const T*)
+		{
+			Bits<T> bits = 0; // Without returning early, like IsZero()
+			for (uint64_t i = 0; i < LANES; ++i) bits |= toBits(v[i]), HideValue(bits);
+			v[0] = static_cast<T>(bits == 0);
+		}, operands
+	);
+
+	std::array<int, 32> sources8;
+	for (int i = 0; i < 32; ++i) sources8[i] = i / 16 * 16 + PERMUTE8_ORDER[i];
+
+	measure("Permute64", [](T* v, const T*) { AVX256<T>{ v }.template Permute64<3, 2, 1, 0>(); }, [](T* v, const T*) { scalarPermute<uint64_t>(v, { { 3, 2, 1, 0 } }); }, operands);
+	measure("Permute32", [](T* v, const T*) { AVX256<T>{ v }.Permute32(PERMUTE32_ORDER.data()); }, [](T* v, const T*) { scalarPermute<uint32_t>(v, { { 1, 2, 3, 4, 5, 6, 7, 0 } }); }, operands);
+	measure("Permute8", [](T* v, const T*) { AVX256<T>{ v }.Permute8(PERMUTE8_ORDER.data()); }, [&sources8](T* v, const T*) { scalarPermute<uint8_t>(v, sources8); }, operands);
+}
+
+std::vector<AVX256Utils::OperationResult> operationBenchmark(const AVX256Utils::BenchmarkOptions& options)
+{
+	std::vector<AVX256Utils::OperationResult> results;
+
+	benchmarkType<double>("double", options, results);
+	benchmarkType<float>("float", options, results);
+	benchmarkType<uint64_t>("uint64_t", options, results);
+	benchmarkType<int64_t>("int64_t", options, results);
+	benchmarkType<uint32_t>("uint32_t", options, results);
+	benchmarkType<int32_t>("int32_t", options, results);
+	benchmarkType<uint16_t>("uint16_t", options, results);
+	benchmarkType<int16_t>("int16_t", options, results);
+	benchmarkType<uint8_t>("uint8_t", options, results);
+	benchmarkType<int8_t>("int8_t", options, results);
+
+	return results;
+}
+
+#endif
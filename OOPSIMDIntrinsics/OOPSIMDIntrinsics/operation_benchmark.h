@@ -0,0 +1,7 @@
+#ifndef OPERATION_BENCHMARK_H
+#define OPERATION_BENCHMARK_H
+
+// Measure the latency and reciprocal throughput of every AVX256<T> method, for every type it is available for, against the equivalent scalar loop
+std::vector<AVX256Utils::OperationResult> operationBenchmark(const AVX256Utils::BenchmarkOptions& options);
+
+#endif
@@ -5,21 +5,45 @@
 #include <array>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <set>
 
 #include "test.h"
 #include "avx256.h"
+#include "avx256_buffer.h"
+#include "avx256_sort.h"
+#include "avx256_checksum.h"
+#include "avx256_blas.h"
+#include "avx256_filter.h"
+#include "avx256_color.h"
+#include "avx256_motion.h"
+#include "avx256_blend.h"
+#include "avx256_integral.h"
+#include "avx256_background.h"
+#include "avx256_lut.h"
+#include "avx256_yuv.h"
+#include "avx256_stats.h"
+#include "avx256_parallel.h"
+#include "avx256_scheduler.h"
+#include "avx256_pipeline.h"
+#include "avx256_framepool.h"
+#include "avx256_bench.h"
+#include "avx256_perf.h"
+#include "avx256_roofline.h"
+#include "avx256_baseline.h"
+#include "avx256_dispatch.h"
+#include "avx256_simd.h"
 
 #ifdef TEST
 
-namespace
-{
-	extern "C" bool HasCPUIDSupport(void);
-
-}
-
 void testHasCPUIDSupport()
 {
-	assert(HasCPUIDSupport() == true);
+	assert(AVX256Utils::HasCPUIDSupport() == true);
 }
 
 void testHasAVX2Support()
@@ -27,6 +51,26 @@ void testHasAVX2Support()
 	assert(AVX256Utils::HasAVX2Support() == true);
 }
 
+void testCPUFeatures()
+{
+	const AVX256Utils::CPUFeatures& features = AVX256Utils::GetCPUFeatures();
+
+	assert(features.AVX2 == AVX256Utils::HasAVX2Support());
+	assert(features.HasRequired() == true);
+	assert(features.AVX == true && features.SSE41 == true);
+	assert(!features.AVX512BW || features.AVX512F);
+	assert(!features.AVX512F || features.AVX2);
+
+	std::ostringstream names;
+	names << features;
+	assert(names.str().find("AVX2") != std::string::npos && names.str().find("SSE4.1") != std::string::npos);
+	assert(names.str().front() != ' ' && names.str().back() != ' ');
+
+	std::ostringstream none;
+	none << AVX256Utils::CPUFeatures{};
+	assert(none.str().empty());
+}
+
 void testAVX256Constructor()
 {
 	float floats[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
@@ -908,10 +952,1739 @@ void testAVX256Permute()
 	assert(AVX256<uint8_t>{avxUChars.IsEqualTo({ 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16 })}.Negate().IsZero());
 }
 
+void testBuffersEqual()
+{
+	for (int size : { 0, 1, 31, 32, 33, 100, 127, 128, 129, 300, 1000 })
+	{
+		std::vector<uint8_t> a(size), b(size);
+		std::iota(a.begin(), a.end(), 0), std::iota(b.begin(), b.end(), 0);
+		assert(AVX256Utils::BuffersEqual(a.data(), b.data(), size) == true);
+
+		for (int i = 0; i < size; ++i)
+		{
+			b[i] ^= 0x10;
+			assert(AVX256Utils::BuffersEqual(a.data(), b.data(), size) == false);
+			b[i] ^= 0x10;
+		}
+	}
+
+	float floats0[] = { 0.0f, 1.0f, 2.0f }, floats1[] = { -0.0f, 1.0f, 2.0f };
+	assert(AVX256Utils::BuffersEqual(floats0, floats0, 3) == true);
+	assert(AVX256Utils::BuffersEqual(floats0, floats1, 3) == false);
+}
+
+void testIsAllZero()
+{
+	for (int size : { 0, 1, 31, 32, 33, 100, 127, 128, 129, 300, 1000 })
+	{
+		std::vector<uint16_t> data(size);
+		assert(AVX256Utils::IsAllZero(data.data(), size) == true);
+
+		for (int i = 0; i < size; ++i)
+		{
+			data[i] = 0x0100;
+			assert(AVX256Utils::IsAllZero(data.data(), size) == false);
+			data[i] = 0;
+		}
+	}
+
+	double doubles[] = { 0.0, -0.0 };
+	assert(AVX256Utils::IsAllZero(doubles, 1) == true);
+	assert(AVX256Utils::IsAllZero(doubles, 2) == false);
+}
+
+void testFirstDifference()
+{
+	for (int size : { 0, 1, 31, 32, 33, 100, 127, 128, 129, 300, 1000 })
+	{
+		std::vector<uint32_t> a(size), b(size);
+		std::iota(a.begin(), a.end(), 0), std::iota(b.begin(), b.end(), 0);
+		assert(AVX256Utils::FirstDifference(a.data(), b.data(), size) == size);
+
+		for (int i = size - 1; i >= 0; --i)
+		{
+			b[i] = UINT32_MAX;
+			assert(AVX256Utils::FirstDifference(a.data(), b.data(), size) == i);
+		}
+	}
+}
+
+void testSort()
+{
+	for (int size : { 0, 1, 7, 8, 9, 16, 33, 64, 65, 100, 1000, 100000 })
+	{
+		std::vector<int32_t> ints(size), intsSorted;
+		std::vector<uint32_t> uInts(size), uIntsSorted;
+		std::vector<float> floats(size), floatsSorted;
+
+		for (int i = 0; i < size; ++i)
+		{
+			ints[i] = static_cast<int32_t>((i * 2654435761u) % 1000) - 500;
+			uInts[i] = UINT32_MAX - (i * 2654435761u) % 300;
+			floats[i] = static_cast<float>(ints[i]) / 4;
+		}
+
+		intsSorted = ints, uIntsSorted = uInts, floatsSorted = floats;
+		std::sort(intsSorted.begin(), intsSorted.end()), std::sort(uIntsSorted.begin(), uIntsSorted.end()), std::sort(floatsSorted.begin(), floatsSorted.end());
+
+		AVX256Utils::Sort(ints.data(), size);
+		AVX256Utils::Sort(uInts.data(), size);
+		AVX256Utils::Sort(floats.data(), size);
+
+		assert(ints == intsSorted);
+		assert(uInts == uIntsSorted);
+		assert(floats == floatsSorted);
+	}
+
+	std::vector<int32_t> equal(1000, 7), descending(1000);
+	std::iota(descending.rbegin(), descending.rend(), INT32_MIN);
+
+	AVX256Utils::Sort(equal.data(), equal.size());
+	AVX256Utils::Sort(descending.data(), descending.size());
+
+	assert(std::count(equal.begin(), equal.end(), 7) == 1000);
+	assert(std::is_sorted(descending.begin(), descending.end()) && descending[0] == INT32_MIN);
+}
+
+void testSortPairs()
+{
+	for (int size : { 0, 1, 7, 8, 9, 16, 33, 64, 65, 100, 1000, 100000 })
+	{
+		std::vector<float> keys(size), keysOriginal;
+		std::vector<uint32_t> values(size), valuesSeen(size);
+
+		for (int i = 0; i < size; ++i) keys[i] = static_cast<float>((i * 2654435761u) % 50), values[i] = i;
+		if (size > 0) keys[0] = std::numeric_limits<float>::infinity(); // Same key as the padding used for partially filled vectors
+		keysOriginal = keys;
+
+		AVX256Utils::SortPairs(keys.data(), values.data(), size);
+
+		assert(std::is_sorted(keys.begin(), keys.end()));
+		for (int i = 0; i < size; ++i) assert(keysOriginal[values[i]] == keys[i] && valuesSeen[values[i]]++ == 0); // Every value is moved with its key exactly once
+	}
+}
+
+void testMergeSorted()
+{
+	for (int size : { 0, 1, 15, 16, 17, 100, 1000 })
+	{
+		std::vector<int32_t> a(size), b(size / 2 + 3), result(a.size() + b.size()), expected(a.size() + b.size());
+
+		for (int i = 0; i < a.size(); ++i) a[i] = (i * 2654435761u) % 97;
+		for (int i = 0; i < b.size(); ++i) b[i] = (i * 2246822519u) % 97;
+
+		std::sort(a.begin(), a.end()), std::sort(b.begin(), b.end());
+		std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+
+		AVX256Utils::MergeSorted(a.data(), a.size(), b.data(), b.size(), result.data());
+		assert(result == expected);
+
+		std::vector<uint32_t> valuesA(a.size(), 1), valuesB(b.size(), 2), valuesResult(result.size());
+		std::vector<int32_t> keysResult(result.size());
+
+		AVX256Utils::MergeSortedPairs(a.data(), valuesA.data(), a.size(), b.data(), valuesB.data(), b.size(), keysResult.data(), valuesResult.data());
+		assert(keysResult == expected);
+		assert(std::count(valuesResult.begin(), valuesResult.end(), 1) == a.size() && std::count(valuesResult.begin(), valuesResult.end(), 2) == b.size());
+	}
+}
+
+void testAdler32()
+{
+	const uint8_t* wikipedia = reinterpret_cast<const uint8_t*>("Wikipedia");
+	assert(AVX256Utils::Adler32(wikipedia, 9) == 0x11E60398);
+	assert(AVX256Utils::Adler32(wikipedia + 4, 5, AVX256Utils::Adler32(wikipedia, 4)) == 0x11E60398);
+
+	for (int size : { 0, 31, 32, 33, 5536, 5537, 20000 })
+	{
+		std::vector<uint8_t> data(size, UINT8_MAX); // Largest sums
+		uint32_t sum1 = 1, sum2 = 0;
+
+		for (int i = 0; i < size; ++i) sum1 = (sum1 + data[i]) % 65521, sum2 = (sum2 + sum1) % 65521;
+		assert(AVX256Utils::Adler32(data.data(), size) == ((sum2 << 16) | sum1));
+	}
+}
+
+void testFletcher()
+{
+	uint16_t words[] = { 0x6261, 0x6463, 0x0065 }; // "abcde"
+	assert(AVX256Utils::Fletcher16(reinterpret_cast<const uint8_t*>("abcde"), 5) == 0xC8F0);
+	assert(AVX256Utils::Fletcher32(words, 3) == 0xF04FC729);
+
+	for (int size : { 0, 15, 16, 17, 352, 353, 20000 })
+	{
+		std::vector<uint16_t> data(size, UINT16_MAX - 1);
+		uint32_t sum1 = 0, sum2 = 0, byteSum1 = 0, byteSum2 = 0;
+
+		for (int i = 0; i < size; ++i) sum1 = (sum1 + data[i]) % 65535, sum2 = (sum2 + sum1) % 65535;
+		for (int i = 0; i < 2 * size; ++i) byteSum1 = (byteSum1 + reinterpret_cast<uint8_t*>(data.data())[i]) % 255, byteSum2 = (byteSum2 + byteSum1) % 255;
+
+		assert(AVX256Utils::Fletcher32(data.data(), size) == ((sum2 << 16) | sum1));
+		assert(AVX256Utils::Fletcher16(reinterpret_cast<uint8_t*>(data.data()), 2 * size) == ((byteSum2 << 8) | byteSum1));
+	}
+}
+
+void testCRC32C()
+{
+	const uint8_t* digits = reinterpret_cast<const uint8_t*>("123456789");
+	assert(AVX256Utils::CRC32C(digits, 9) == 0xE3069283);
+	assert(AVX256Utils::CRC32C(digits + 3, 6, AVX256Utils::CRC32C(digits, 3)) == 0xE3069283);
+
+	for (int size : { 0, 7, 8, 767, 768, 769, 24575, 24576, 24577, 100000 })
+	{
+		std::vector<uint8_t> data(size);
+		for (int i = 0; i < size; ++i) data[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+		uint32_t crc = UINT32_MAX;
+		for (int i = 0; i < size; ++i)
+		{
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+		}
+
+		assert(AVX256Utils::CRC32C(data.data(), size) == ~crc);
+	}
+}
+
+void testHash64()
+{
+	std::vector<uint8_t> data(300);
+	for (int i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+	std::vector<uint64_t> hashes;
+	for (int size : { 0, 1, 8, 16, 63, 64, 65, 128, 129, 300 })
+	{
+		hashes.push_back(AVX256Utils::Hash64(data.data(), size));
+		hashes.push_back(AVX256Utils::Hash64(data.data(), size, 1));
+
+		for (int i = 0; i < size; ++i) // Flipping any bit changes the hash
+		{
+			data[i] ^= 1;
+			hashes.push_back(AVX256Utils::Hash64(data.data(), size));
+			data[i] ^= 1;
+		}
+
+		assert(AVX256Utils::Hash64(data.data(), size) == hashes[hashes.size() - size - 2]);
+	}
+
+	std::sort(hashes.begin(), hashes.end());
+	assert(std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end());
+}
+
+void testDot()
+{
+	for (int count : { 0, 1, 7, 8, 31, 32, 33, 100 })
+	{
+		std::vector<float> xf(count), yf(count);
+		std::vector<double> xd(count), yd(count);
+		float expectedF = 0;
+		double expectedD = 0;
+
+		for (int i = 0; i < count; ++i)
+		{
+			xf[i] = xd[i] = (i % 7) - 3, yf[i] = yd[i] = (i % 5) + 0.5;
+			expectedF += xf[i] * yf[i], expectedD += xd[i] * yd[i];
+		}
+
+		assert(AVX256Utils::Dot(xf.data(), yf.data(), count) == expectedF);
+		assert(AVX256Utils::Dot(xd.data(), yd.data(), count) == expectedD);
+	}
+}
+
+void testAxpy()
+{
+	for (int count : { 0, 1, 7, 8, 15, 16, 17, 50 })
+	{
+		std::vector<float> xf(count), yf(count);
+		std::vector<double> xd(count), yd(count);
+
+		for (int i = 0; i < count; ++i) xf[i] = xd[i] = i, yf[i] = yd[i] = -i;
+
+		AVX256Utils::Axpy(count, 2.5f, xf.data(), yf.data());
+		AVX256Utils::Axpy(count, -0.5, xd.data(), yd.data());
+
+		for (int i = 0; i < count; ++i) assert(yf[i] == 1.5f * i && yd[i] == -1.5 * i);
+	}
+}
+
+void testNrm2()
+{
+	std::vector<float> xf = { 3, 4, 0, 0, 0, 0, 0, 0, 12 };
+	std::vector<double> xd = { 3, 4, 0, 0, 0, 0, 0, 0, 12 };
+
+	assert(AVX256Utils::Nrm2(xf.data(), xf.size()) == 13.0f);
+	assert(AVX256Utils::Nrm2(xd.data(), xd.size()) == 13.0);
+	assert(AVX256Utils::Nrm2(xd.data(), 0) == 0.0);
+
+	std::fill(xf.begin(), xf.end(), 1e30f); // Squares overflow float
+	assert(std::abs(AVX256Utils::Nrm2(xf.data(), xf.size()) - 3e30f) < 1e24f);
+
+	std::fill(xd.begin(), xd.end(), 1e200); // Squares overflow double
+	assert(std::abs(AVX256Utils::Nrm2(xd.data(), xd.size()) / 3e200 - 1) < 1e-15);
+
+	std::fill(xd.begin(), xd.end(), 1e-200); // Squares underflow double
+	assert(std::abs(AVX256Utils::Nrm2(xd.data(), xd.size()) / 3e-200 - 1) < 1e-15);
+
+	// A NaN propagates, in the vector loop or the tail, even when an infinity would otherwise be the largest magnitude
+	xd[1] = std::numeric_limits<double>::quiet_NaN(), xd[8] = std::numeric_limits<double>::infinity();
+	assert(std::isnan(AVX256Utils::Nrm2(xd.data(), xd.size())));
+	xd[1] = 1e-200, xd[5] = std::numeric_limits<double>::infinity(), xd[8] = std::numeric_limits<double>::quiet_NaN();
+	assert(std::isnan(AVX256Utils::Nrm2(xd.data(), xd.size())));
+}
+
+void testGemv()
+{
+	int rows = 11, columns = 13, lda = 16;
+	std::vector<double> a(rows * lda), x(columns), y(rows, 1), expected(rows);
+
+	for (int i = 0; i < a.size(); ++i) a[i] = (i % 9) - 4;
+	for (int j = 0; j < columns; ++j) x[j] = j % 3;
+
+	for (int r = 0; r < rows; ++r)
+	{
+		double dot = 0;
+		for (int j = 0; j < columns; ++j) dot += a[r * lda + j] * x[j];
+		expected[r] = 2 * dot + 3;
+	}
+
+	AVX256Utils::Gemv(rows, columns, 2.0, a.data(), lda, x.data(), 3.0, y.data());
+	assert(y == expected);
+
+	std::vector<float> af(a.begin(), a.end()), xf(x.begin(), x.end()), yf(rows, std::numeric_limits<float>::quiet_NaN()); // y is not read when beta is 0
+	AVX256Utils::Gemv(rows, columns, 2.0f, af.data(), lda, xf.data(), 0.0f, yf.data());
+	for (int r = 0; r < rows; ++r) assert(yf[r] == static_cast<float>(expected[r] - 3));
+}
+
+template <typename T>
+void testGemm(int m, int n, int k, int threads)
+{
+	int lda = k + 3, ldb = n + 1, ldc = n + 2;
+	std::vector<T> a(m * lda), b(k * ldb), c(m * ldc), expected(m * ldc);
+
+	for (int i = 0; i < a.size(); ++i) a[i] = (i % 7) - 3;
+	for (int i = 0; i < b.size(); ++i) b[i] = (i % 5) - 2;
+	for (int i = 0; i < c.size(); ++i) c[i] = expected[i] = i % 3;
+
+	for (int i = 0; i < m; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			T dot = 0;
+			for (int p = 0; p < k; ++p) dot += a[i * lda + p] * b[p * ldb + j];
+			expected[i * ldc + j] = 2 * dot - expected[i * ldc + j];
+		}
+	}
+
+	AVX256Utils::Gemm<T>(m, n, k, 2, a.data(), lda, b.data(), ldb, -1, c.data(), ldc, threads);
+	assert(c == expected); // Small integer inputs are exact in any summation order
+}
+
+void testGemm()
+{
+	testGemm<float>(1, 1, 1, 1);
+	testGemm<float>(6, 16, 8, 1);
+	testGemm<float>(13, 37, 29, 1);
+	testGemm<float>(130, 50, 300, 1); // Multiple MC and KC blocks
+	testGemm<float>(130, 50, 300, 3);
+	testGemm<double>(7, 9, 5, 1);
+	testGemm<double>(125, 3100, 20, 1); // Multiple NC blocks
+	testGemm<double>(64, 40, 270, 4);
+	testGemm<float>(20, 30, 10, 0); // Runs on the calling thread
+	testGemm<float>(20, 30, 10, -2);
+	testGemm<double>(5, 4, 0, 1); // C = beta * C when k is 0
+}
+
+// Reference separable filter using double accumulation, rounding (uint8_t images) after each pass like the uint8_t kernel. Matches it exactly for kernels that are exact in 14 bits
+template <typename T>
+std::vector<T> referenceSeparableFilter(const std::vector<T>& image, int width, int height, int channels, const std::vector<float>& kernelX, const std::vector<float>& kernelY, AVX256Utils::BorderMode border)
+{
+	auto index = [border](int i, int size) {
+		if (border == AVX256Utils::BorderMode::Constant) return i < 0 || i >= size ? -1 : i;
+		if (border == AVX256Utils::BorderMode::Replicate) return std::clamp(i, 0, size - 1);
+		while (size > 1 && (i < 0 || i >= size)) i = i < 0 ? -i : 2 * (size - 1) - i;
+		return size > 1 ? i : 0;
+	};
+
+	auto round = [](double value) { return std::is_same_v<T, float> ? static_cast<T>(value) : static_cast<T>(std::clamp(static_cast<int>(std::floor(value + 0.5)), 0, 255)); };
+	int taps = kernelX.size();
+	std::vector<T> horizontal(image.size()), result(image.size());
+
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			for (int c = 0; c < channels; ++c)
+			{
+				double sum = 0;
+				for (int k = 0; k < taps; ++k) if (index(x - taps / 2 + k, width) >= 0) sum += kernelX[k] * image[(y * width + index(x - taps / 2 + k, width)) * channels + c];
+				horizontal[(y * width + x) * channels + c] = round(sum);
+			}
+
+	taps = kernelY.size();
+
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			for (int c = 0; c < channels; ++c)
+			{
+				double sum = 0;
+				for (int k = 0; k < taps; ++k) if (index(y - taps / 2 + k, height) >= 0) sum += kernelY[k] * horizontal[(index(y - taps / 2 + k, height) * width + x) * channels + c];
+				result[(y * width + x) * channels + c] = round(sum);
+			}
+
+	return result;
+}
+
+void testSeparableFilter()
+{
+	std::vector<float> kernelX = { 0.25f, 0.5f, 0.25f }, kernelY = { 0.125f, 0.25f, 0.25f, 0.25f, 0.125f }, shift = { 0, 0, 1 };
+
+	for (AVX256Utils::BorderMode border : { AVX256Utils::BorderMode::Replicate, AVX256Utils::BorderMode::Reflect, AVX256Utils::BorderMode::Constant })
+	{
+		for (auto [width, height, channels] : { std::array<int, 3>{ 1, 1, 1 }, { 5, 3, 3 }, { 40, 2, 1 }, { 37, 9, 3 }, { 100, 20, 1 } })
+		{
+			std::vector<uint8_t> image(width * height * channels), result(image.size());
+			for (int i = 0; i < image.size(); ++i) image[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+			std::vector<float> imageF(image.begin(), image.end()), resultF(image.size());
+
+			AVX256Utils::SeparableFilter(image.data(), width * channels, result.data(), width * channels, width, height, channels, kernelX.data(), 3, kernelY.data(), 5, border);
+			assert(result == referenceSeparableFilter(image, width, height, channels, kernelX, kernelY, border));
+
+			AVX256Utils::SeparableFilter(imageF.data(), width * channels, resultF.data(), width * channels, width, height, channels, kernelY.data(), 5, shift.data(), 3, border);
+			assert(resultF == referenceSeparableFilter(imageF, width, height, channels, kernelY, shift, border));
+
+			AVX256Utils::SeparableFilter(image.data(), width * channels, image.data(), width * channels, width, height, channels, kernelX.data(), 3, kernelY.data(), 5, border); // In place
+			assert(image == result);
+		}
+	}
+
+	std::vector<float> sharpen = { -1, 3, -1 }; // Negative weights saturate to [0, 255]
+	std::vector<uint8_t> edge = { 10, 10, 10, 200, 200, 200, 200 }, sharpened(edge.size());
+	AVX256Utils::SeparableFilter(edge.data(), 7, sharpened.data(), 7, 7, 1, 1, sharpen.data(), 3, std::vector<float>{ 1 }.data(), 1);
+	assert((sharpened == std::vector<uint8_t>{ 10, 10, 0, 255, 200, 200, 200 }));
+}
+
+void testBlur()
+{
+	int width = 70, height = 10;
+	std::vector<uint8_t> flat(width * height, 77), result(flat.size());
+	std::vector<float> flatF(width * height, 0.5f), resultF(flat.size());
+
+	for (int size : { 1, 3, 5, 7, 15 }) // Blurring a flat image leaves it unchanged
+	{
+		AVX256Utils::BoxBlur(flat.data(), width, result.data(), width, width, height, 1, size);
+		assert(result == flat);
+		AVX256Utils::GaussianBlur(flat.data(), width, result.data(), width, width, height, 1, size);
+		assert(result == flat);
+		AVX256Utils::GaussianBlur(flatF.data(), width, resultF.data(), width, width, height, 1, size, 2.0);
+		for (float value : resultF) assert(std::abs(value - 0.5f) < 1e-6f);
+	}
+
+	std::vector<float> kernel = AVX256Utils::GaussianKernel(5, 1.0);
+	assert(std::abs(std::accumulate(kernel.begin(), kernel.end(), 0.0f) - 1) < 1e-6f);
+	assert(kernel[0] == kernel[4] && kernel[1] == kernel[3] && kernel[0] < kernel[1] && kernel[1] < kernel[2]);
+
+	std::vector<uint8_t> image(53 * 41), result53(image.size()); // Within 1 of filtering exactly and rounding once, for kernels that aren't exact in fixed point
+	for (int i = 0; i < image.size(); ++i) image[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+	std::vector<float> imageF(image.begin(), image.end());
+
+	for (int size = 5; size <= 15; ++size)
+	{
+		for (bool box : { true, false })
+		{
+			std::vector<float> weights = box ? std::vector<float>(size, 1.0f / size) : AVX256Utils::GaussianKernel(size);
+			if (box) AVX256Utils::BoxBlur(image.data(), 53, result53.data(), 53, 53, 41, 1, size);
+			else AVX256Utils::GaussianBlur(image.data(), 53, result53.data(), 53, 53, 41, 1, size);
+
+			std::vector<float> exact = referenceSeparableFilter(imageF, 53, 41, 1, weights, weights, AVX256Utils::BorderMode::Reflect);
+			for (int i = 0; i < image.size(); ++i) assert(std::abs(result53[i] - std::lround(exact[i])) <= 1);
+		}
+	}
+
+	std::vector<uint8_t> spike(15 * 15, 0); // 255 / 225 = 1.13
+	spike[7 * 15 + 7] = 255;
+	AVX256Utils::BoxBlur(spike.data(), 15, spike.data(), 15, 15, 15, 1, 15, AVX256Utils::BorderMode::Constant);
+	assert(std::all_of(spike.begin(), spike.end(), [](uint8_t value) { return value == 1; }));
+
+	std::vector<uint8_t> impulse(9 * 9, 0); // A box blur spreads an impulse evenly over its neighbourhood
+	impulse[4 * 9 + 4] = 180;
+	AVX256Utils::BoxBlur(impulse.data(), 9, impulse.data(), 9, 9, 9, 1, 3);
+	for (int y = 0; y < 9; ++y)
+		for (int x = 0; x < 9; ++x)
+			assert(std::abs(impulse[y * 9 + x] - (std::abs(x - 4) <= 1 && std::abs(y - 4) <= 1 ? 20 : 0)) <= 1);
+}
+
+void testBGRToRGB()
+{
+	for (int pixels : { 0, 1, 31, 32, 33, 64, 100 })
+	{
+		std::vector<uint8_t> bgr(pixels * 3), rgb(pixels * 3);
+		for (int i = 0; i < bgr.size(); ++i) bgr[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+		rgb = bgr;
+		AVX256Utils::BGRToRGB(rgb.data(), pixels);
+
+		for (int i = 0; i < pixels; ++i)
+			assert(rgb[3 * i] == bgr[3 * i + 2] && rgb[3 * i + 1] == bgr[3 * i + 1] && rgb[3 * i + 2] == bgr[3 * i]);
+	}
+}
+
+void testBGRToGray()
+{
+	for (int pixels : { 0, 1, 31, 32, 33, 64, 100 })
+	{
+		std::vector<uint8_t> bgr(pixels * 3), previous(pixels), gray(pixels), mask(pixels), difference(pixels), fusedGray(pixels);
+		for (int i = 0; i < bgr.size(); ++i) bgr[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+		for (int i = 0; i < pixels; ++i) previous[i] = static_cast<uint8_t>(i * 7);
+
+		AVX256Utils::BGRToGray(bgr.data(), gray.data(), pixels);
+		AVX256Utils::BGRToGrayThreshold(bgr.data(), mask.data(), pixels, 100);
+		AVX256Utils::BGRToGrayAbsDiff(bgr.data(), previous.data(), fusedGray.data(), difference.data(), pixels);
+
+		for (int i = 0; i < pixels; ++i)
+		{
+			assert(std::abs(gray[i] - (0.114 * bgr[i * 3] + 0.587 * bgr[i * 3 + 1] + 0.299 * bgr[i * 3 + 2])) <= 1);
+			assert(mask[i] == (gray[i] > 100 ? 255 : 0));
+			assert(difference[i] == std::abs(gray[i] - previous[i]));
+		}
+
+		assert(fusedGray == gray);
+	}
+
+	std::vector<uint8_t> bgr(40 * 3, 255), gray(40); // White stays white
+	AVX256Utils::BGRToGray(bgr.data(), gray.data(), 40);
+	assert(std::all_of(gray.begin(), gray.end(), [](uint8_t value) { return value == 255; }));
+}
+
+void testMotionDetector()
+{
+	using AVX256Utils::Morphology;
+
+	for (auto [width, height] : { std::pair<int, int>{ 1, 1 }, { 5, 3 }, { 31, 2 }, { 32, 7 }, { 33, 9 }, { 70, 12 } })
+	{
+		std::vector<uint8_t> previous(width * height), current(width * height), mask(width * height), expected(width * height);
+
+		for (int i = 0; i < width * height; ++i)
+		{
+			previous[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+			current[i] = static_cast<uint8_t>(previous[i] + ((i * 40503u >> 8) % 5 == 0 ? 40 : 3)); // About 1 in 5 pixels change by more than the threshold
+		}
+
+		for (Morphology morphology : { Morphology::None, Morphology::Erode, Morphology::Dilate, Morphology::Open, Morphology::Close })
+		{
+			for (int i = 0; i < width * height; ++i)
+				expected[i] = std::abs(current[i] - previous[i]) > 20 ? 255 : 0;
+
+			auto morph = [&](bool erode) {
+				std::vector<uint8_t> input = expected;
+				for (int y = 0; y < height; ++y)
+					for (int x = 0; x < width; ++x)
+						for (int dy = -1; dy <= 1; ++dy)
+							for (int dx = -1; dx <= 1; ++dx)
+								if (y + dy >= 0 && y + dy < height && x + dx >= 0 && x + dx < width)
+									expected[y * width + x] = erode ? std::min(expected[y * width + x], input[(y + dy) * width + x + dx]) : std::max(expected[y * width + x], input[(y + dy) * width + x + dx]);
+			};
+
+			if (morphology == Morphology::Erode || morphology == Morphology::Open) morph(true);
+			if (morphology == Morphology::Dilate || morphology == Morphology::Open || morphology == Morphology::Close) morph(false);
+			if (morphology == Morphology::Close) morph(true);
+
+			AVX256Utils::MotionResult expectedResult;
+			for (int y = 0; y < height; ++y)
+				for (int x = 0; x < width; ++x)
+					if (expected[y * width + x] != 0)
+					{
+						expectedResult.Left = expectedResult.ChangedPixels == 0 ? x : std::min<int64_t>(expectedResult.Left, x);
+						expectedResult.Right = std::max<int64_t>(expectedResult.Right, x);
+						expectedResult.Top = expectedResult.ChangedPixels == 0 ? y : expectedResult.Top;
+						expectedResult.Bottom = y;
+						++expectedResult.ChangedPixels;
+					}
+
+			AVX256Utils::MotionDetector detector{ static_cast<uint64_t>(width), static_cast<uint64_t>(height), 20, morphology };
+
+			for (int repeat = 0; repeat < 2; ++repeat) // Detectors are reusable
+			{
+				AVX256Utils::MotionResult result = detector.Detect(previous.data(), current.data(), mask.data());
+				assert(mask == expected);
+				assert(result.ChangedPixels == expectedResult.ChangedPixels);
+				assert(result.Left == expectedResult.Left && result.Top == expectedResult.Top && result.Right == expectedResult.Right && result.Bottom == expectedResult.Bottom);
+			}
+		}
+	}
+
+	std::vector<uint8_t> frame(40 * 40, 0), moved(frame); // An 8x6 block that moved is found, while a single noisy pixel is removed by opening
+	for (int y = 10; y < 16; ++y) for (int x = 20; x < 28; ++x) moved[y * 40 + x] = 200;
+	moved[35 * 40 + 3] = 255;
+
+	AVX256Utils::MotionResult result = AVX256Utils::MotionDetector{ 40, 40, 50 }.Detect(frame.data(), moved.data(), nullptr);
+	assert(result.ChangedPixels == 48 && result.Left == 20 && result.Top == 10 && result.Right == 27 && result.Bottom == 15);
+}
+
+template <typename T>
+void testBlend(T step)
+{
+	for (int count : { 0, 1, 15, 16, 33, 100 })
+	{
+		std::vector<T> a(count), b(count), out(count);
+		for (int i = 0; i < count; ++i) a[i] = static_cast<T>(i * step), b[i] = static_cast<T>(std::numeric_limits<T>::max() - i * step * 3);
+
+		for (float alpha : { 0.0f, 0.25f, 0.3f, 0.5f, 0.999f, 1.0f })
+		{
+			AVX256Utils::Blend(a.data(), b.data(), out.data(), count, alpha);
+			for (int i = 0; i < count; ++i) assert(std::abs(out[i] - (alpha * a[i] + (1 - alpha) * b[i])) <= std::numeric_limits<T>::max() / 256.0 + 0.5);
+
+			if (alpha == 0.0f || alpha == 1.0f || alpha == 0.25f || alpha == 0.5f) // Exactly representable weights
+				for (int i = 0; i < count; ++i) assert(out[i] == static_cast<T>(std::floor(alpha * a[i] + (1 - alpha) * b[i] + 0.5)));
+
+			std::vector<T> inPlace = a;
+			AVX256Utils::Blend(inPlace.data(), b.data(), inPlace.data(), count, alpha);
+			assert(inPlace == out);
+		}
+	}
+}
+
+template <typename T>
+void testBlendAlpha(T step)
+{
+	constexpr uint64_t MAX = std::numeric_limits<T>::max();
+
+	for (int channels : { 1, 2, 3, 4 })
+	{
+		for (int pixels : { 0, 1, 16, 33, 100 })
+		{
+			std::vector<T> a(pixels * channels), b(pixels * channels), alpha(pixels), out(pixels * channels);
+			for (int i = 0; i < a.size(); ++i) a[i] = static_cast<T>(i * step), b[i] = static_cast<T>(i * step * 7 + 13);
+			for (int i = 0; i < pixels; ++i) alpha[i] = static_cast<T>(i * step * 5);
+			if (pixels > 1) alpha[0] = 0, alpha[1] = static_cast<T>(MAX);
+
+			AVX256Utils::BlendAlpha(a.data(), b.data(), alpha.data(), out.data(), pixels, channels);
+
+			for (int i = 0; i < a.size(); ++i)
+				assert(out[i] == (a[i] * static_cast<uint64_t>(alpha[i / channels]) + b[i] * (MAX - alpha[i / channels]) + MAX / 2) / MAX);
+		}
+	}
+}
+
+void testBlend()
+{
+	testBlend<uint8_t>(7);
+	testBlend<uint16_t>(1999);
+	testBlendAlpha<uint8_t>(37);
+	testBlendAlpha<uint16_t>(40503);
+}
+
+void testCompositeOver()
+{
+	std::vector<uint8_t> source(19 * 4), destination(19 * 4), premultiplied(19 * 4), expected(19 * 4);
+	for (int i = 0; i < source.size(); ++i) source[i] = static_cast<uint8_t>(i * 2654435761u >> 24), destination[i] = static_cast<uint8_t>(i * 40503u >> 8);
+
+	AVX256Utils::Premultiply(source.data(), premultiplied.data(), 19);
+
+	for (int p = 0; p < 19; ++p)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			int colour = c == 3 ? source[p * 4 + 3] : (source[p * 4 + c] * source[p * 4 + 3] + 127) / 255;
+			assert(premultiplied[p * 4 + c] == colour);
+			expected[p * 4 + c] = static_cast<uint8_t>(std::min(colour + (destination[p * 4 + c] * (255 - source[p * 4 + 3]) + 127) / 255, 255));
+		}
+	}
+
+	AVX256Utils::CompositeOver(premultiplied.data(), destination.data(), 19);
+	assert(destination == expected);
+
+	AVX256Utils::Premultiply(source.data(), source.data(), 19); // In place
+	assert(source == premultiplied);
+}
+
+template <typename T>
+void testIntegralImage()
+{
+	for (int width : { 0, 1, 7, 8, 19, 64 })
+	{
+		for (int height : { 0, 1, 5 })
+		{
+			uint64_t srcStride = width + 3, stride = width + 5;
+			std::vector<uint8_t> src(srcStride * height);
+			for (int i = 0; i < src.size(); ++i) src[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+			std::vector<T> sum(stride * (height + 1), 1), squaredSum(stride * (height + 1), 1);
+			AVX256Utils::IntegralImage(src.data(), srcStride, sum.data(), stride, width, height, squaredSum.data(), stride);
+
+			for (int y = 0; y <= height; ++y)
+			{
+				for (int x = 0; x <= width; ++x)
+				{
+					uint64_t expected = 0, squaredExpected = 0;
+					for (int j = 0; j < y; ++j) for (int i = 0; i < x; ++i) expected += src[j * srcStride + i], squaredExpected += src[j * srcStride + i] * src[j * srcStride + i];
+
+					assert(sum[y * stride + x] == static_cast<T>(expected));
+					assert(squaredSum[y * stride + x] == static_cast<T>(squaredExpected));
+				}
+			}
+
+			if (width > 3 && height > 2)
+			{
+				uint64_t expected = 0;
+				for (int j = 1; j < 3; ++j) for (int i = 2; i < 4; ++i) expected += src[j * srcStride + i];
+				assert(AVX256Utils::BoxSum(sum.data(), stride, 2, 1, 2, 2) == static_cast<T>(expected));
+			}
+		}
+	}
+}
+
+void testIntegralImage()
+{
+	testIntegralImage<uint32_t>();
+	testIntegralImage<float>();
+	testIntegralImage<double>();
+
+	std::vector<uint8_t> src(9 * 2, 5); // Without squared sums
+	std::vector<uint32_t> sum(10 * 3);
+	AVX256Utils::IntegralImage(src.data(), 9, sum.data(), 10, 9, 2);
+	assert(sum.back() == 5 * 9 * 2 && sum[10 + 9] == 5 * 9);
+}
+
+void testBackgroundModel()
+{
+	for (uint8_t varianceFactor : { 0, 3 })
+	{
+		for (int pixels : { 1, 16, 37 })
+		{
+			const int decayShift = 3, threshold = 20;
+			AVX256Utils::BackgroundModel model{ static_cast<uint64_t>(pixels), decayShift, threshold, varianceFactor };
+			std::vector<uint16_t> averages(pixels), variances(pixels);
+			std::vector<uint8_t> frame(pixels), mask(pixels), background(pixels);
+
+			for (int f = 0; f < 40; ++f)
+			{
+				for (int i = 0; i < pixels; ++i) frame[i] = static_cast<uint8_t>(f > 20 && i % 3 == 0 ? 250 - f : 100 + (i * f * 2654435761u >> 28));
+
+				uint64_t foreground = model.Update(frame.data(), mask.data()), expectedForeground = 0;
+
+				for (int i = 0; i < pixels; ++i) // Scalar model
+				{
+					if (f == 0)
+					{
+						averages[i] = frame[i] << 8, variances[i] = threshold * threshold;
+						assert(mask[i] == 0);
+						continue;
+					}
+
+					int value = frame[i] << 8, difference = std::abs(value - averages[i]) >> 8, square = difference * difference;
+					bool isForeground = difference > threshold && (varianceFactor == 0 || square > std::min<int>(variances[i] * varianceFactor * varianceFactor, UINT16_MAX));
+					averages[i] += value > averages[i] ? (value - averages[i]) >> decayShift : -((averages[i] - value) >> decayShift);
+					variances[i] += square > variances[i] ? (square - variances[i]) >> decayShift : -((variances[i] - square) >> decayShift);
+
+					assert(mask[i] == (isForeground ? 255 : 0));
+					expectedForeground += isForeground;
+				}
+
+				assert(foreground == expectedForeground);
+			}
+
+			model.Background(background.data());
+			for (int i = 0; i < pixels; ++i) assert(background[i] == (averages[i] + 128) >> 8);
+
+			model.Reset(); // The next frame initialises the model, in place
+			assert(model.Update(frame.data(), frame.data()) == 0 && std::all_of(frame.begin(), frame.end(), [](uint8_t value) { return value == 0; }));
+		}
+	}
+}
+
+void testApplyLUT()
+{
+	std::array<uint8_t, 4 * 256> tables{};
+	for (int i = 0; i < tables.size(); ++i) tables[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+	for (int count : { 0, 1, 31, 32, 33, 100 })
+	{
+		std::vector<uint8_t> src(count), dst(count);
+		for (int i = 0; i < count; ++i) src[i] = static_cast<uint8_t>(i * 97 + 5);
+
+		AVX256Utils::ApplyLUT256(src.data(), dst.data(), count, tables.data());
+		for (int i = 0; i < count; ++i) assert(dst[i] == tables[src[i]]);
+
+		AVX256Utils::ApplyLUT16(src.data(), dst.data(), count, tables.data());
+		for (int i = 0; i < count; ++i) assert(dst[i] == tables[src[i] & 15]);
+
+		for (int channels : { 1, 2, 3, 4 })
+		{
+			std::vector<uint8_t> pixels(count * channels);
+			for (int i = 0; i < pixels.size(); ++i) pixels[i] = static_cast<uint8_t>(i * 31 + 7);
+			std::vector<uint8_t> original = pixels;
+
+			AVX256Utils::ApplyLUT256(pixels.data(), pixels.data(), count, channels, tables.data()); // In place
+			for (int i = 0; i < pixels.size(); ++i) assert(pixels[i] == tables[256 * (i % channels) + original[i]]);
+		}
+	}
+
+	std::array<uint8_t, 3 * 256> sameTables{};
+	std::vector<uint8_t> pixels(50 * 3), expected(50 * 3);
+	for (int i = 0; i < sameTables.size(); ++i) sameTables[i] = tables[i % 256];
+	for (int i = 0; i < pixels.size(); ++i) pixels[i] = static_cast<uint8_t>(i * 11), expected[i] = tables[pixels[i]];
+	AVX256Utils::ApplyLUT256(pixels.data(), pixels.data(), 50, 3, sameTables.data());
+	assert(pixels == expected);
+
+	std::array<uint8_t, 32> values{};
+	std::iota(values.begin(), values.end(), 240);
+	AVX256<uint8_t> avxValues{ values.data() };
+	AVX256Utils::ApplyLUT16(AVX256Utils::ApplyLUT256(avxValues, tables.data()), tables.data() + 16);
+	for (int i = 0; i < 32; ++i) assert(values[i] == tables[16 + (tables[static_cast<uint8_t>(240 + i)] & 15)]);
+}
+
+// Returns the RGB pixel (in floating point) of a YUV pixel
+std::array<double, 3> yuvToRGBReference(int y, int u, int v, AVX256Utils::YUVStandard standard, AVX256Utils::YUVRange range)
+{
+	double kr = standard == AVX256Utils::YUVStandard::BT601 ? 0.299 : 0.2126, kb = standard == AVX256Utils::YUVStandard::BT601 ? 0.114 : 0.0722, kg = 1 - kr - kb;
+	bool limited = range == AVX256Utils::YUVRange::Limited;
+	double luma = (y - (limited ? 16 : 0)) * (limited ? 255.0 / 219 : 1), cu = (u - 128) * (limited ? 255.0 / 224 : 1), cv = (v - 128) * (limited ? 255.0 / 224 : 1);
+	return { luma + (2 - 2 * kr) * cv, luma - (2 - 2 * kb) * kb / kg * cu - (2 - 2 * kr) * kr / kg * cv, luma + (2 - 2 * kb) * cu };
+}
+
+void testYUVToRGB()
+{
+	using namespace AVX256Utils;
+
+	for (YUVStandard standard : { YUVStandard::BT601, YUVStandard::BT709 })
+	{
+		for (YUVRange range : { YUVRange::Limited, YUVRange::Full })
+		{
+			for (RGBFormat format : { RGBFormat::BGR, RGBFormat::RGB, RGBFormat::BGRA })
+			{
+				for (int width : { 2, 34, 70 })
+				{
+					const int height = 3, chromaWidth = (width + 1) / 2, pixelSize = format == RGBFormat::BGRA ? 4 : 3;
+					std::vector<uint8_t> y(width * height), u(chromaWidth * 2), v(chromaWidth * 2), uv(chromaWidth * 2 * 2), yuyv(width * 2 * height);
+					for (int i = 0; i < y.size(); ++i) y[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+					for (int i = 0; i < u.size(); ++i) u[i] = static_cast<uint8_t>(i * 40503u >> 7), v[i] = static_cast<uint8_t>(i * 97 + 200), uv[2 * i] = u[i], uv[2 * i + 1] = v[i];
+					for (int row = 0; row < height; ++row)
+						for (int x = 0; x < width; ++x) yuyv[row * width * 2 + 2 * x] = y[row * width + x], yuyv[row * width * 2 + 2 * x + 1] = x % 2 == 0 ? u[x / 2] : v[x / 2];
+
+					std::vector<uint8_t> nv12(width * height * pixelSize), i420(nv12.size()), packed(nv12.size());
+					NV12ToRGB(y.data(), width, uv.data(), chromaWidth * 2, nv12.data(), width * pixelSize, width, height, format, standard, range);
+					I420ToRGB(y.data(), width, u.data(), chromaWidth, v.data(), chromaWidth, i420.data(), width * pixelSize, width, height, format, standard, range);
+					YUYVToRGB(yuyv.data(), width * 2, packed.data(), width * pixelSize, width, 1, format, standard, range); // The first row has the same chroma as the other formats' first 2 rows
+					assert(nv12 == i420);
+
+					for (int row = 0; row < height; ++row)
+					{
+						for (int x = 0; x < width; ++x)
+						{
+							std::array<double, 3> expected = yuvToRGBReference(y[row * width + x], u[row / 2 * chromaWidth + x / 2], v[row / 2 * chromaWidth + x / 2], standard, range);
+							const uint8_t* pixel = nv12.data() + (row * width + x) * pixelSize;
+							int r = pixel[format == RGBFormat::RGB ? 0 : 2], g = pixel[1], b = pixel[format == RGBFormat::RGB ? 2 : 0];
+
+							assert(std::abs(r - std::clamp(expected[0], 0.0, 255.0)) <= 1.5 && std::abs(g - std::clamp(expected[1], 0.0, 255.0)) <= 1.5 && std::abs(b - std::clamp(expected[2], 0.0, 255.0)) <= 1.5);
+							if (format == RGBFormat::BGRA) assert(pixel[3] == 255);
+							if (row == 0) assert(std::equal(pixel, pixel + pixelSize, packed.data() + x * pixelSize));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void testRGBToYUV()
+{
+	using namespace AVX256Utils;
+
+	for (YUVStandard standard : { YUVStandard::BT601, YUVStandard::BT709 })
+	{
+		for (YUVRange range : { YUVRange::Limited, YUVRange::Full })
+		{
+			for (RGBFormat format : { RGBFormat::BGR, RGBFormat::RGB, RGBFormat::BGRA })
+			{
+				for (int width : { 2, 33, 66 })
+				{
+					for (int height : { 1, 4 })
+					{
+						const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2, pixelSize = format == RGBFormat::BGRA ? 4 : 3;
+						std::vector<uint8_t> src(width * height * pixelSize);
+						for (int i = 0; i < src.size(); ++i) src[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+						std::vector<uint8_t> y(width * height), uv(chromaWidth * 2 * chromaHeight), i420Y(y.size()), u(chromaWidth * chromaHeight), v(u.size());
+						RGBToNV12(src.data(), width * pixelSize, y.data(), width, uv.data(), chromaWidth * 2, width, height, format, standard, range);
+						RGBToI420(src.data(), width * pixelSize, i420Y.data(), width, u.data(), chromaWidth, v.data(), chromaWidth, width, height, format, standard, range);
+						assert(y == i420Y);
+
+						for (int i = 0; i < u.size(); ++i) assert(uv[2 * i] == u[i] && uv[2 * i + 1] == v[i]);
+
+						double kr = standard == YUVStandard::BT601 ? 0.299 : 0.2126, kb = standard == YUVStandard::BT601 ? 0.114 : 0.0722, kg = 1 - kr - kb;
+						double yRange = range == YUVRange::Limited ? 219.0 / 255 : 1, cRange = range == YUVRange::Limited ? 224.0 / 255 : 1, yOffset = range == YUVRange::Limited ? 16 : 0;
+						auto channel = [&](int x, int row, int c) { return src[(std::min(row, height - 1) * width + std::min(x, width - 1)) * pixelSize + (format == RGBFormat::RGB ? c : 2 - c)]; }; // c: 0 = R, 1 = G, 2 = B
+
+						for (int row = 0; row < height; ++row)
+							for (int x = 0; x < width; ++x) assert(std::abs(y[row * width + x] - (yOffset + yRange * (kr * channel(x, row, 0) + kg * channel(x, row, 1) + kb * channel(x, row, 2)))) <= 0.6);
+
+						for (int row = 0; row < chromaHeight; ++row)
+						{
+							for (int x = 0; x < chromaWidth; ++x)
+							{
+								double r = 0, g = 0, b = 0;
+								for (int dy = 0; dy < 2; ++dy) for (int dx = 0; dx < 2; ++dx) r += channel(2 * x + dx, 2 * row + dy, 0) / 4.0, g += channel(2 * x + dx, 2 * row + dy, 1) / 4.0, b += channel(2 * x + dx, 2 * row + dy, 2) / 4.0;
+
+								double luma = kr * r + kg * g + kb * b;
+								assert(std::abs(u[row * chromaWidth + x] - std::clamp(128 + cRange * (b - luma) / (2 - 2 * kb), 0.0, 255.0)) <= 0.6);
+								assert(std::abs(v[row * chromaWidth + x] - std::clamp(128 + cRange * (r - luma) / (2 - 2 * kr), 0.0, 255.0)) <= 0.6);
+							}
+						}
+
+						if (width % 2 == 0)
+						{
+							std::vector<uint8_t> yuyv(width * 2 * height);
+							RGBToYUYV(src.data(), width * pixelSize, yuyv.data(), width * 2, width, height, format, standard, range);
+							for (int row = 0; row < height; ++row)
+								for (int x = 0; x < width; ++x) assert(yuyv[row * width * 2 + 2 * x] == y[row * width + x]);
+
+							if (height == 1) // A single row's 2 x 2 chroma is the same as its 2 x 1 chroma
+								for (int x = 0; x < width; x += 2) assert(yuyv[2 * x + 1] == u[x / 2] && yuyv[2 * x + 3] == v[x / 2]);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename T>
+void checkStats(const AVX256Utils::Statistics<T>& stats, const std::vector<T>& values)
+{
+	assert(stats.Count == values.size());
+	if (values.empty()) return void(assert(stats.Sum == 0 && stats.Min == 0 && stats.Max == 0 && stats.MinIndex == 0 && stats.MaxIndex == 0));
+
+	uint64_t minIndex = std::min_element(values.begin(), values.end()) - values.begin(), maxIndex = std::max_element(values.begin(), values.end()) - values.begin();
+	double sum = 0, squares = 0;
+	for (T value : values) sum += static_cast<double>(value), squares += static_cast<double>(value) * static_cast<double>(value);
+	double mean = sum / values.size(), deviation = std::sqrt(std::max(0.0, squares / values.size() - mean * mean));
+
+	assert(stats.Min == values[minIndex] && stats.MinIndex == minIndex && stats.Max == values[maxIndex] && stats.MaxIndex == maxIndex);
+	assert(std::abs(stats.Sum - sum) <= 1e-9 * std::abs(sum) && std::abs(stats.SumOfSquares - squares) <= 1e-9 * squares);
+	assert(std::abs(stats.Mean - mean) <= 1e-9 * (std::abs(mean) + 1) && std::abs(stats.StandardDeviation - deviation) <= 1e-6 * (deviation + 1));
+}
+
+template <typename T>
+void testStats()
+{
+	constexpr uint64_t LANES = 32 / sizeof(T);
+
+	for (uint64_t count : { uint64_t{ 0 }, uint64_t{ 1 }, LANES - 1, LANES + 1, 3 * LANES, 255 * LANES + 5, 600 * LANES + 3 })
+	{
+		std::vector<T> values(count);
+		for (uint64_t i = 0; i < count; ++i) values[i] = static_cast<T>(static_cast<int64_t>(i * 2654435761u >> 16) % 200 - (std::is_signed_v<T> ? 100 : 0));
+		checkStats(AVX256Utils::Stats(values.data(), count), values);
+
+		if (count > 2 * LANES) // The extremes of the integer types, repeated so that the first occurrences must be found across lanes and blocks
+		{
+			T lowest = std::is_integral_v<T> ? std::numeric_limits<T>::lowest() : static_cast<T>(-1e6), highest = std::is_integral_v<T> ? std::numeric_limits<T>::max() : static_cast<T>(1e6);
+			values[count - 1] = values[LANES + 3] = values[count / 2] = lowest;
+			values[count - 2] = values[LANES + 2] = values[count / 2 + 1] = highest;
+			checkStats(AVX256Utils::Stats(values.data(), count), values);
+		}
+	}
+
+	std::vector<T> equal(5 * LANES + 3, static_cast<T>(7)); // Every element ties
+	checkStats(AVX256Utils::Stats(equal.data(), equal.size()), equal);
+
+	uint64_t width = 2 * LANES + 5, height = 7, stride = width + 9;
+	std::vector<T> image(stride * height, std::numeric_limits<T>::max()), region;
+	for (uint64_t y = 0; y < height; ++y)
+		for (uint64_t x = 0; x < width; ++x) region.push_back(image[y * stride + x] = static_cast<T>((x * 7 + y * 13) % 50));
+
+	checkStats(AVX256Utils::Stats(image.data(), stride, width, height), region);
+}
+
+void testStats()
+{
+	testStats<uint8_t>();
+	testStats<int8_t>();
+	testStats<uint16_t>();
+	testStats<int16_t>();
+	testStats<uint32_t>();
+	testStats<int32_t>();
+	testStats<float>();
+	testStats<double>();
+
+	std::vector<float> values(40, 2.0f); // NaNs are ignored by min and max
+	values[3] = values[37] = std::numeric_limits<float>::quiet_NaN(), values[20] = 1.0f, values[38] = 3.0f;
+	AVX256Utils::Statistics<float> stats = AVX256Utils::Stats(values.data(), values.size());
+	assert(stats.Min == 1.0f && stats.MinIndex == 20 && stats.Max == 3.0f && stats.MaxIndex == 38);
+
+	// A lane that starts with a NaN takes its first number, even an infinity, rather than keeping the infinity it starts at with the NaN's index
+	std::vector<float> infinities(16, std::numeric_limits<float>::infinity());
+	infinities[0] = std::numeric_limits<float>::quiet_NaN();
+	stats = AVX256Utils::Stats(infinities.data(), infinities.size());
+	assert(stats.Min == std::numeric_limits<float>::infinity() && stats.MinIndex == 1 && stats.MaxIndex == 1);
+
+	for (uint64_t count : { 3, 40 }) // Only NaNs, in the tail or in vectors
+	{
+		std::vector<double> nans(count, std::numeric_limits<double>::quiet_NaN());
+		AVX256Utils::Statistics<double> nanStats = AVX256Utils::Stats(nans.data(), nans.size());
+		assert(nanStats.Count == count && std::isnan(nanStats.Min) && std::isnan(nanStats.Max) && nanStats.MinIndex == 0 && nanStats.MaxIndex == 0);
+	}
+}
+
+void testThreadPool()
+{
+	for (unsigned threads : { 1u, 4u })
+	{
+		AVX256Utils::ThreadPool pool{ threads };
+		assert(pool.Threads() == threads);
+
+		for (uint64_t tasks : { 0, 1, 3, 1000 })
+		{
+			std::vector<std::atomic<int>> runs(tasks);
+			std::vector<unsigned> taskThreads(tasks);
+			pool.Run(tasks, [&](uint64_t i, unsigned thread) { ++runs[i], taskThreads[i] = thread; });
+			assert(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& count) { return count == 1; }));
+			assert(std::all_of(taskThreads.begin(), taskThreads.end(), [&](unsigned thread) { return thread < threads; }));
+		}
+
+		std::atomic<int> nestedRuns{ 0 }; // Nested jobs run on the calling thread
+		pool.Run(8, [&](uint64_t, unsigned thread) { pool.Run(4, [&](uint64_t, unsigned nestedThread) { assert(nestedThread == thread); ++nestedRuns; }); });
+		assert(nestedRuns == 32);
+	}
+}
+
+void testParallelFor()
+{
+	AVX256Utils::ThreadPool pool{ 4 };
+
+	for (uint64_t count : { 0, 1, 31, 64, 1000, 100003 })
+	{
+		for (uint64_t grain : { 0, 1, 100 })
+		{
+			std::vector<uint8_t> buffer(count, 0);
+			std::atomic<uint64_t> chunks{ 0 };
+			AVX256Utils::ParallelFor(buffer.data(), count, grain, [&](uint8_t* chunk, uint64_t chunkCount, uint64_t begin)
+				{
+					assert(chunk == buffer.data() + begin && begin % 64 == 0 && (chunkCount % 64 == 0 || begin + chunkCount == count));
+					for (uint64_t i = 0; i < chunkCount; ++i) ++chunk[i];
+					++chunks;
+				}, pool
+			);
+			assert(std::all_of(buffer.begin(), buffer.end(), [](uint8_t value) { return value == 1; }));
+			assert(grain != 1 || chunks == (count + 63) / 64);
+
+			std::vector<uint8_t> image(count), expected(count);
+			for (uint64_t i = 0; i < count; ++i) expected[i] = ((image[i] = static_cast<uint8_t>(i * 37)) > 100) * UINT8_MAX;
+			AVX256<uint8_t> boundary{};
+			boundary = 100;
+			AVX256Utils::ParallelForEachVector(image.data(), count, grain, [&](AVX256<uint8_t>& values, uint64_t) { values = values > boundary; }, pool);
+			assert(image == expected);
+		}
+	}
+
+	std::vector<double> values(1001); // Indices are the element indices of each vector
+	AVX256Utils::ParallelForEachVector(values.data(), values.size(), 0, [](AVX256<double>& vector, uint64_t index) { for (int i = 0; i < 4; ++i) vector[i] = static_cast<double>(index + i); }, pool);
+	for (uint64_t i = 0; i < values.size(); ++i) assert(values[i] == i);
+}
+
+void testParallelReduce()
+{
+	AVX256Utils::ThreadPool pool{ 4 };
+
+	for (uint64_t count : { 0, 1, 33, 100000 })
+	{
+		std::vector<uint8_t> bytes(count);
+		std::vector<int16_t> words(count);
+		std::vector<float> floats(count);
+		for (uint64_t i = 0; i < count; ++i) bytes[i] = static_cast<uint8_t>(i * 2654435761u >> 24), words[i] = static_cast<int16_t>(i * 7919 - 30000), floats[i] = static_cast<float>(i % 10);
+
+		assert(AVX256Utils::ParallelSum(bytes.data(), count, 0, pool) == std::accumulate(bytes.begin(), bytes.end(), uint64_t{ 0 }));
+		assert(AVX256Utils::ParallelSum(words.data(), count, 1, pool) == std::accumulate(words.begin(), words.end(), int64_t{ 0 }));
+		assert(AVX256Utils::ParallelSum(floats.data(), count, 0, pool) == std::accumulate(floats.begin(), floats.end(), 0.0));
+
+		uint64_t histogram[256], expected[256] = {};
+		for (uint8_t byte : bytes) ++expected[byte];
+		AVX256Utils::ParallelHistogram(bytes.data(), count, histogram, 1000, pool);
+		assert(std::equal(histogram, histogram + 256, expected));
+
+		uint8_t max = AVX256Utils::ParallelReduce(bytes.data(), count, 0, uint8_t{ 0 }, [](const uint8_t* chunk, uint64_t chunkCount, uint64_t) { return *std::max_element(chunk, chunk + chunkCount); },
+			[](uint8_t a, uint8_t b) { return std::max(a, b); }, pool);
+		assert(max == (count == 0 ? 0 : *std::max_element(bytes.begin(), bytes.end())));
+	}
+}
+
+void testChaseLevDeque()
+{
+	AVX256Utils::ChaseLevDeque<uint64_t, 4> deque;
+	uint64_t value;
+
+	assert(!deque.Pop(value) && !deque.Steal(value));
+	for (uint64_t i = 0; i < 4; ++i) assert(deque.Push(i));
+	assert(!deque.Push(4) && deque.Size() == 4);
+	assert(deque.Steal(value) && value == 0 && deque.Pop(value) && value == 3); // Steals from the top, pops from the bottom
+	assert(deque.Push(5) && deque.Push(6) && !deque.Push(7));
+	assert(deque.Pop(value) && value == 6 && deque.Steal(value) && value == 1 && deque.Steal(value) && value == 2 && deque.Pop(value) && value == 5);
+	assert(!deque.Pop(value) && !deque.Steal(value) && deque.Size() == 0);
+
+	AVX256Utils::ChaseLevDeque<uint64_t, 1024> shared; // Each value is taken exactly once while thieves race the owner
+	std::vector<std::atomic<int>> taken(100000);
+	std::atomic<bool> done{ false };
+	std::vector<std::thread> thieves;
+
+	for (int t = 0; t < 3; ++t) thieves.emplace_back([&] { for (uint64_t stolen; !done || shared.Size() != 0; ) if (shared.Steal(stolen)) ++taken[stolen]; });
+
+	for (uint64_t i = 0; i < taken.size(); ++i)
+	{
+		while (!shared.Push(i)) if (shared.Pop(value)) ++taken[value];
+		if (i % 3 == 0 && shared.Pop(value)) ++taken[value];
+	}
+
+	while (shared.Pop(value)) ++taken[value];
+	done = true;
+	for (std::thread& thief : thieves) thief.join();
+	assert(std::all_of(taken.begin(), taken.end(), [](const std::atomic<int>& count) { return count == 1; }));
+}
+
+void testWorkStealingScheduler()
+{
+	for (unsigned threads : { 1u, 4u })
+	{
+		AVX256Utils::WorkStealingScheduler scheduler{ threads };
+		assert(scheduler.Threads() == threads);
+
+		for (uint64_t count : { 0, 1, 100, 12345 })
+		{
+			for (uint64_t chunkSize : { 1, 7, 1000 })
+			{
+				std::vector<std::atomic<int>> runs(count);
+				scheduler.Run(count, chunkSize, [&](uint64_t begin, uint64_t end, unsigned thread)
+					{
+						assert(begin % chunkSize == 0 && end - begin <= chunkSize && thread < threads);
+						for (uint64_t i = begin; i < end; ++i) ++runs[i];
+						if (begin % 10 == 0) std::this_thread::sleep_for(std::chrono::microseconds{ 20 }); // Uneven work
+					}
+				);
+				assert(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& count) { return count == 1; }));
+			}
+		}
+
+		std::atomic<int> nestedRuns{ 0 }; // Nested runs run on the calling thread
+		scheduler.Run(8, 1, [&](uint64_t, uint64_t, unsigned thread) { scheduler.Run(4, 1, [&](uint64_t, uint64_t, unsigned nestedThread) { assert(nestedThread == thread); ++nestedRuns; }); });
+		assert(nestedRuns == 32);
+	}
+
+	AVX256Utils::WorkStealingScheduler scheduler{ 3, true };
+	std::vector<uint8_t> image(100003), expected(image.size());
+	for (uint64_t i = 0; i < image.size(); ++i) expected[i] = ((image[i] = static_cast<uint8_t>(i * 37)) > 100) * UINT8_MAX;
+
+	AVX256Utils::ParallelForStealing(image.data(), image.size(), 64, [](uint8_t* chunk, uint64_t chunkCount, uint64_t begin)
+		{
+			assert(begin % 64 == 0);
+			for (uint64_t i = 0; i < chunkCount; ++i) chunk[i] = (chunk[i] > 100) * UINT8_MAX;
+		}, scheduler
+	);
+	assert(image == expected);
+}
+
+void testSPSCRing()
+{
+	AVX256Utils::SPSCRing<int> ring{ 3 };
+	int value;
+
+	assert(ring.Capacity() == 4 && !ring.TryPop(value));
+	for (int i = 0; i < 4; ++i) assert(ring.TryPush(i));
+	assert(!ring.TryPush(4) && ring.TryPop(value) && value == 0 && ring.TryPush(4));
+	for (int i = 1; i <= 4; ++i) assert(ring.TryPop(value) && value == i);
+	assert(!ring.TryPop(value));
+
+	AVX256Utils::SPSCRing<uint64_t> shared{ 16 }; // Values arrive in order across threads
+	std::thread producer{ [&] { for (uint64_t i = 0; i < 100000; ++i) while (!shared.TryPush(i)) std::this_thread::yield(); } };
+	for (uint64_t i = 0, popped; i < 100000; ++i)
+	{
+		while (!shared.TryPop(popped)) std::this_thread::yield();
+		assert(popped == i);
+	}
+	producer.join();
+}
+
+void testFramePipeline()
+{
+	struct Frame
+	{
+		std::vector<uint8_t> Pixels = std::vector<uint8_t>(100);
+		int Index = -1;
+	};
+
+	AVX256Utils::FramePipeline<Frame> pipeline{ 3 };
+	int captured = 0, sunk = 0;
+	std::set<const uint8_t*> buffers;
+
+	AVX256Utils::PipelineStatistics stats = pipeline.Run(
+		[&](Frame& frame)
+		{
+			if (captured == 50) return false;
+			frame.Index = captured++;
+			std::fill(frame.Pixels.begin(), frame.Pixels.end(), static_cast<uint8_t>(frame.Index));
+			return true;
+		},
+		[](Frame& frame) { AVX256Utils::ParallelForEachVector(frame.Pixels.data(), frame.Pixels.size(), 0, [](AVX256<uint8_t>& values, uint64_t) { values.Add(values.Data); }); },
+		[&](Frame& frame)
+		{
+			assert(frame.Index == sunk++); // In order, and computed
+			assert(std::all_of(frame.Pixels.begin(), frame.Pixels.end(), [&](uint8_t pixel) { return pixel == static_cast<uint8_t>(2 * frame.Index); }));
+			buffers.insert(frame.Pixels.data());
+			return true;
+		}
+	);
+
+	assert(sunk == 50 && buffers.size() == 3); // Only the preallocated frames were used
+	assert(stats.Capture.Frames == 51 && stats.Compute.Frames == 50 && stats.Sink.Frames == 50);
+	assert(stats.MaxLatencySeconds >= stats.MeanLatencySeconds && stats.Sink.MaxSeconds >= stats.Sink.MeanSeconds());
+
+	sunk = 0; // The sink stops the pipeline early, and the frames in flight are dropped
+	stats = pipeline.Run([](Frame&) { return true; }, [](Frame&) {}, [&](Frame&) { return ++sunk != 10; });
+	assert(sunk == 10 && stats.Sink.Frames == 10 && stats.Compute.Frames <= 10 + 3);
+}
+
+void testFrameBufferPool()
+{
+	for (bool hugePages : { false, true })
+	{
+		AVX256Utils::FrameBufferPool pool{ 1920 * 1080 * 3, 2, hugePages };
+		assert(pool.Allocations() == 2 && pool.Available() == 2 && pool.Size() == 1920 * 1080 * 3);
+
+		AVX256Utils::FrameBuffer a = pool.Acquire(), b = pool.Acquire();
+		assert(a && b && a.Data() != b.Data() && reinterpret_cast<uintptr_t>(a.Data()) % 64 == 0 && reinterpret_cast<uintptr_t>(b.Data()) % 64 == 0);
+		std::fill(a.Data(), a.Data() + pool.Size(), 1); // The whole buffer is writable
+
+		{
+			AVX256Utils::FrameBuffer shared = a;
+			assert(a.References() == 2 && shared.Data() == a.Data());
+		}
+
+		uint8_t* data = a.Data();
+		a.Reset(); // Recycled once the last reference is released
+		assert(!a && a.Data() == nullptr && pool.Available() == 1);
+		assert(pool.Acquire().Data() == data);
+		assert(pool.Available() == 1);
+
+		for (int frame = 0; frame < 100; ++frame) // A steady state loop doesn't allocate
+		{
+			AVX256Utils::FrameBuffer current = pool.Acquire(), copy = current;
+			b = std::move(copy);
+		}
+		assert(pool.Allocations() == 2);
+
+		AVX256Utils::FrameBuffer c = pool.Acquire(), d = pool.Acquire(); // Grows when every buffer is in use
+		assert(pool.Allocations() == 3 && pool.Available() == 0);
+		b.Reset(), c.Reset(), d.Reset();
+		assert(pool.Available() == 3);
+
+		AVX256Utils::DoubleBuffer frames{ pool };
+		uint8_t* first = frames.Current(), * second = frames.Previous();
+		assert(first != second && pool.Available() == 1);
+		frames.Swap();
+		assert(frames.Current() == second && frames.Previous() == first);
+	}
+}
+
+void testBenchmark()
+{
+	AVX256Utils::BenchmarkOptions options;
+	options.Warmup = 3, options.Repetitions = 7;
+	int prepares = 0, runs = 0;
+
+	AVX256Utils::BenchmarkResult result = AVX256Utils::Benchmark("kernel", "AVX256", 1000, 250, options, [&] { ++prepares; }, [&] { ++runs; });
+	assert(prepares == 10 && runs == 10 && result.Samples.size() == 7 && result.Kernel == "kernel" && result.Variant == "AVX256");
+	assert(result.MinSeconds <= result.MedianSeconds && result.MedianSeconds <= result.P95Seconds && result.P95Seconds <= result.P99Seconds);
+
+	result.Samples = { 0.005, 0.001, 0.003, 0.002, 0.004 }; // Unsorted, in the order they ran
+	AVX256Utils::Summarise(result);
+	assert(result.MinSeconds == 0.001 && std::abs(result.MeanSeconds - 0.003) < 1e-12 && result.MedianSeconds == 0.003);
+	assert(std::abs(result.P95Seconds - 0.0048) < 1e-12 && std::abs(result.P99Seconds - 0.00496) < 1e-12);
+	assert(std::abs(result.GBPerSecond() - 1000 / 0.003 / 1e9) < 1e-12 && std::abs(result.ElementsPerSecond() - 250 / 0.003) < 1e-6);
+
+	std::ostringstream csv, json;
+	AVX256Utils::WriteCSV(csv, { result });
+	assert(csv.str().rfind("kernel,variant,bytes,elements,repetitions,", 0) == 0 && csv.str().find("\nkernel,AVX256,1000,250,5,0.001,") != std::string::npos);
+	AVX256Utils::WriteJSON(json, options, { result });
+	assert(json.str().find("\"kernel\": \"kernel\", \"variant\": \"AVX256\", \"bytes\": 1000") != std::string::npos && json.str().find("\"median_s\": 0.003,") != std::string::npos);
+}
+
+void testParseBenchmarkOptions()
+{
+	AVX256Utils::BenchmarkOptions options;
+	std::ostringstream errors;
+
+	const char* arguments[] = { "benchmark", "--size", "64M", "--warmup", "0", "--repetitions", "500", "--format", "json", "--input", "frame.raw", "--filter", "blend", "--suite", "operations",
+		"--counters", "on" };
+	assert(AVX256Utils::ParseBenchmarkOptions(17, arguments, options, errors) && errors.str().empty());
+	assert(options.Size == 64 << 20 && options.Warmup == 0 && options.Repetitions == 500 && options.Format == AVX256Utils::BenchmarkFormat::JSON);
+	assert(options.Suite == AVX256Utils::BenchmarkSuite::Operations && options.Counters);
+	assert(options.Input == "frame.raw" && options.Filter == "blend" && options.Output.empty());
+
+	const char* invalid[][3] = { { "benchmark", "--size", "0" }, { "benchmark", "--size", "12X" }, { "benchmark", "--repetitions", "0" }, { "benchmark", "--repetitions", "2M" },
+		{ "benchmark", "--warmup", "1K" }, { "benchmark", "--warmup", "-1" }, { "benchmark", "--format", "xml" }, { "benchmark", "--suite", "all" }, { "benchmark", "--counters", "yes" },
+		{ "benchmark", "--sizes", "1" } };
+	for (const char* const* arguments : invalid) assert(!AVX256Utils::ParseBenchmarkOptions(3, arguments, options, errors));
+	assert(!AVX256Utils::ParseBenchmarkOptions(2, arguments, options, errors)); // Missing value
+
+	const char* help[] = { "benchmark", "--size", "1M", "--help" }; // --help takes no value
+	AVX256Utils::BenchmarkOptions helpOptions;
+	assert(AVX256Utils::ParseBenchmarkOptions(4, help, helpOptions, errors) && helpOptions.Help && helpOptions.Size == 1 << 20);
+	std::ostringstream usage;
+	AVX256Utils::WriteBenchmarkUsage(usage);
+	assert(usage.str().find("--repetitions <runs>") != std::string::npos && usage.str().find("--help") != std::string::npos);
+}
+
+void testMeasureOperation()
+{
+	AVX256Utils::BenchmarkOptions options;
+	options.Warmup = 1, options.Repetitions = 5;
+
+	std::array<int32_t, 8> initial{ 1, 2, 3, 4, 5, 6, 7, 8 };
+	std::vector<int32_t> operands(AVX256Utils::BenchDetail::OPERANDS * 8, 3);
+	int scalarCalls = 0;
+
+	std::vector<AVX256Utils::OperationResult> results = AVX256Utils::MeasureOperation("Add", "int32_t", [](int32_t* v, const int32_t* o) { AVX256<int32_t>{ v }.Add(o); },
+		[&](int32_t* v, const int32_t* o) { ++scalarCalls; for (int i = 0; i < 8; ++i) v[i] += o[i]; }, initial.data(), operands.data(), options
+	);
+
+	assert(results.size() == 2 && results[0].Mode == AVX256Utils::OperationMode::Memory && results[1].Mode == AVX256Utils::OperationMode::Register);
+	for (const AVX256Utils::OperationResult& result : results)
+		assert(result.Operation == "Add" && result.Type == "int32_t" && result.Latency > 0 && result.Throughput > 0 && result.ScalarLatency > 0 && result.ScalarThroughput > 0);
+
+	// Each mode runs one chain (latency) and CHAINS chains (throughput) of STEPS operations per run
+	assert(scalarCalls == 2 * 6 * AVX256Utils::BenchDetail::STEPS * (1 + AVX256Utils::BenchDetail::CHAINS));
+
+	AVX256Utils::OperationResult slower;
+	slower.Operation = "Mul", slower.Type = "int8_t", slower.Throughput = 4, slower.ScalarThroughput = 2;
+	assert(slower.Speedup() == 0.5);
+
+	std::ostringstream table, csv;
+	AVX256Utils::WriteTable(table, { slower, results[1] });
+	assert(table.str().find("| Mul | int8_t | Memory | 0.00 | 4.00 | 0.00 | 2.00 | 0.50x (slower than scalar) |") != std::string::npos);
+	assert(table.str().find("| Add | int32_t | Register |") != std::string::npos && table.str().find("slower") == table.str().rfind("slower"));
+	AVX256Utils::WriteCSV(csv, { slower });
+	assert(csv.str() == "operation,type,mode,latency,throughput,scalar_latency,scalar_throughput,speedup\nMul,int8_t,memory,0,4,0,2,0.5\n");
+}
+
+void testPerfCounters()
+{
+	using AVX256Utils::PerfEvent;
+
+	AVX256Utils::PerfCounters counters;
+	counters.Values = { 2000, 3000, 40, 8, 2, 500, 0, 0 };
+	counters.Available = { true, true, true, true, true, true, false, false };
+	counters.Bytes = 4096, counters.Regions = 1;
+
+	assert(counters[PerfEvent::Instructions] == 3000 && counters.IsAvailable(PerfEvent::LLCMisses) && !counters.IsAvailable(PerfEvent::Throttle));
+	assert(counters.IPC() == 1.5 && counters.BytesPerCycle() == 2.048 && counters.PerKB(PerfEvent::L1DMisses) == 10 && counters.PerKB(PerfEvent::LLCMisses) == 2);
+	assert(counters.CycleFraction(PerfEvent::Level1License) == 0.25 && counters.CycleFraction(PerfEvent::Level2License) == 0);
+
+	// An event is only available in a sum if it was counted in every region
+	AVX256Utils::PerfCounters sum, partial = counters;
+	partial.Available[static_cast<int>(PerfEvent::BranchMisses)] = false;
+	sum += counters, sum += partial;
+	assert(sum.Regions == 2 && sum.Bytes == 8192 && sum[PerfEvent::Cycles] == 4000 && sum.IPC() == 1.5);
+	assert(sum.IsAvailable(PerfEvent::Cycles) && !sum.IsAvailable(PerfEvent::BranchMisses) && sum.PerKB(PerfEvent::BranchMisses) == 0);
+
+	// Counters are unavailable without a PMU or permission, in which case the probe still counts the region and its bytes but every metric reads 0
+	AVX256Utils::PerfCounters probed;
+	std::vector<uint8_t> buffer(1 << 16, 1), ones(32, 1);
+	{
+		AVX256Utils::PerfProbe probe(probed, buffer.size());
+		for (uint64_t i = 0; i < buffer.size(); i += 32) AVX256<uint8_t>{ &buffer[i] }.Add(ones.data());
+	}
+	assert(probed.Regions == 1 && probed.Bytes == buffer.size() && buffer[0] == 2);
+	for (int i = 0; i < static_cast<int>(PerfEvent::Count); ++i)
+		assert(AVX256Utils::PerfEvents::ForThread().IsAvailable(static_cast<PerfEvent>(i)) || (!probed.Available[i] && probed.Values[i] == 0));
+	for (int i = 0; i < static_cast<int>(PerfEvent::Count); ++i) // Events are counted in groups led by a Cycles counter
+		assert(!probed.Available[i] || probed.IsAvailable(PerfEvent::Cycles));
+	if (probed.IsAvailable(PerfEvent::Cycles) && probed.IsAvailable(PerfEvent::Instructions)) assert(probed[PerfEvent::Cycles] > 0 && probed.IPC() > 0);
+	else assert(probed.IPC() == 0);
+
+	AVX256Utils::BenchmarkOptions options;
+	options.Warmup = 1, options.Repetitions = 4, options.Counters = true;
+	AVX256Utils::BenchmarkResult result = AVX256Utils::Benchmark("kernel", "AVX256", 1000, 250, options, [] {}, [] {});
+	assert(result.Counters.Regions == 4 && result.Counters.Bytes == 4000);
+
+	std::ostringstream csv, json, table;
+	result.Counters = counters;
+	AVX256Utils::WriteCSV(csv, { result });
+	assert(csv.str().find(",cycles_per_byte,ipc,bytes_per_cycle,l1d_misses_per_kb,llc_misses_per_kb,") != std::string::npos && csv.str().find(",1.5,2.048,10,2,0.5,0.25,,\n") != std::string::npos);
+	AVX256Utils::WriteJSON(json, options, { result });
+	assert(json.str().find("\"counters\": { \"ipc\": 1.5, \"bytes_per_cycle\": 2.048,") != std::string::npos && json.str().find("\"throttle_fraction\": null }") != std::string::npos);
+	AVX256Utils::WriteTable(table, { result });
+	assert(table.str().find("IPC") != std::string::npos && table.str().find("1.500") != std::string::npos);
+}
+
+void testRoofline()
+{
+	using AVX256Utils::MemoryLevel;
+
+	AVX256Utils::CacheSizes caches = AVX256Utils::DetectCacheSizes();
+	assert(caches.L1 > 0 && caches.L1 <= caches.L2 && caches.L2 <= caches.L3);
+	assert(AVX256Utils::WorkingSetSize(MemoryLevel::L1, caches) == caches.L1 / 2 && AVX256Utils::WorkingSetSize(MemoryLevel::DRAM, caches) == caches.L3 * 4);
+
+	AVX256Utils::BenchmarkOptions options;
+	options.Warmup = 1, options.Repetitions = 3;
+	AVX256Utils::StreamResult stream = AVX256Utils::MeasureStream(MemoryLevel::L1, 24 << 10, options);
+	assert(stream.Level == MemoryLevel::L1 && stream.WorkingSet == 24 << 10);
+	assert(stream.Copy > 0 && stream.Scale > 0 && stream.Add > 0 && stream.Triad > 0 && stream.Attainable() >= stream.Triad);
+	assert(AVX256Utils::MeasureComputePeak(options) > 0);
+
+	// Under a compute ceiling of 4 Gelements/s, a kernel processing one element per two bytes reaches it in L1, and in DRAM is bound by the 2 GB/s attainable there to 1 Gelements/s, of which it achieves half
+	AVX256Utils::BenchmarkResult l1, dram;
+	l1.Kernel = dram.Kernel = "kernel", l1.Variant = dram.Variant = "AVX256", l1.Bytes = dram.Bytes = 2000, l1.Elements = dram.Elements = 1000;
+	l1.MedianSeconds = 0.25e-6, dram.MedianSeconds = 2e-6;
+
+	AVX256Utils::StreamResult l1Stream, dramStream;
+	l1Stream.Level = MemoryLevel::L1, l1Stream.Copy = 100, dramStream.Level = MemoryLevel::DRAM, dramStream.Triad = 2;
+
+	std::vector<AVX256Utils::RooflineResult> roofline = AVX256Utils::Roofline({ { MemoryLevel::L1, l1 }, { MemoryLevel::DRAM, dram } }, { l1Stream, dramStream }, 4e9);
+	assert(roofline.size() == 2 && roofline[0].Level == MemoryLevel::L1 && roofline[1].Level == MemoryLevel::DRAM);
+	assert(roofline[0].Intensity == 0.5 && roofline[0].PeakElementsPerSecond == 4e9 && roofline[1].PeakElementsPerSecond == 4e9);
+	assert(!roofline[0].MemoryBound() && std::abs(roofline[0].Fraction() - 1) < 1e-9 && std::abs(roofline[0].BandwidthFraction() - 0.08) < 1e-9);
+	assert(roofline[1].MemoryBound() && std::abs(roofline[1].RooflineElementsPerSecond() - 1e9) < 1 && std::abs(roofline[1].Fraction() - 0.5) < 1e-9);
+
+	// A kernel faster than the bandwidth or compute ceiling measured raises it, so it is at 100% of the roofline rather than beyond it
+	l1Stream.Copy = 4;
+	std::vector<AVX256Utils::RooflineResult> raised = AVX256Utils::Roofline({ { MemoryLevel::L1, l1 } }, { l1Stream }, 1e9);
+	assert(raised[0].AttainableGBPerSecond == 8 && raised[0].PeakElementsPerSecond == 4e9 && raised[0].BandwidthFraction() == 1 && raised[0].Fraction() == 1);
+	l1Stream.Copy = 100;
+
+	AVX256Utils::RooflineReport report{ { l1Stream, dramStream }, roofline };
+	std::ostringstream csv, json, table;
+	AVX256Utils::WriteCSV(csv, report);
+	assert(csv.str().find("\nkernel,AVX256,DRAM,2000,1,2,0.5,0.5,5e+08,4e+09,1e+09,0.5,memory\n") != std::string::npos);
+	AVX256Utils::WriteJSON(json, options, report);
+	assert(json.str().find("{ \"level\": \"DRAM\", \"working_set\": 0, \"copy\": 0, \"scale\": 0, \"add\": 0, \"triad\": 2 }") != std::string::npos);
+	AVX256Utils::WriteTable(table, report);
+	assert(table.str().find("| kernel | AVX256 | L1 | 8.00 | 8.00% | 0.50 | 4000.00 | 100.00% | Compute |") != std::string::npos);
+
+	const char* arguments[] = { "benchmark", "--suite", "roofline" };
+	std::ostringstream errors;
+	assert(AVX256Utils::ParseBenchmarkOptions(3, arguments, options, errors) && options.Suite == AVX256Utils::BenchmarkSuite::Roofline);
+}
+
+void testBaseline()
+{
+	// Every sample slower than every baseline sample is significant, and identical samples are not
+	std::vector<double> baselineSamples{ 1.0, 1.1, 0.9, 1.05, 0.95, 1.0, 1.02, 0.98 }, slower{ 1.3, 1.4, 1.25, 1.35, 1.3, 1.32, 1.28, 1.31 };
+	assert(AVX256Utils::MannWhitneyPValue(baselineSamples, slower) < 0.001 && AVX256Utils::MannWhitneyPValue(slower, baselineSamples) > 0.999);
+	assert(AVX256Utils::MannWhitneyPValue(baselineSamples, baselineSamples) > 0.4 && AVX256Utils::MannWhitneyPValue({ 1, 1 }, { 1, 1 }) == 1);
+	assert(AVX256Utils::MannWhitneyPValue({}, slower) == 1);
+
+	// U = 8 of a possible 9: the exact one-sided p is 2/20, which the normal approximation is close to
+	double p = AVX256Utils::MannWhitneyPValue({ 1, 2, 4 }, { 3, 5, 6 });
+	assert(p > 0.05 && p < 0.1);
+
+	AVX256Utils::BenchmarkResult result;
+	result.Kernel = "blend", result.Variant = "AVX256", result.Samples = baselineSamples;
+	AVX256Utils::Baseline baseline = AVX256Utils::MakeBaseline(std::vector<AVX256Utils::BenchmarkResult>{ result });
+	assert(baseline.Suite == "kernels" && baseline.Entries.size() == 1 && baseline.Entries[0].Name == "blend/AVX256" && !baseline.Machine.empty());
+	baseline.Machine = "CPU \"quoted\" / compiler";
+
+	AVX256Utils::OperationResult operation;
+	operation.Operation = "Sum", operation.Type = "float", operation.Mode = AVX256Utils::OperationMode::Register, operation.Samples = { 1e-9 };
+	assert(AVX256Utils::MakeBaseline(std::vector<AVX256Utils::OperationResult>{ operation }).Entries[0].Name == "Sum<float>/register");
+
+	std::stringstream file;
+	AVX256Utils::WriteBaseline(file, baseline);
+	AVX256Utils::Baseline read;
+	assert(AVX256Utils::ReadBaseline(file, read) && read.Machine == baseline.Machine && read.Suite == "kernels" && read.Entries.size() == 1);
+	assert(read.Entries[0].Name == "blend/AVX256" && read.Entries[0].Samples == baselineSamples);
+
+	std::istringstream malformed{ "{ \"machine\": \"cpu\", \"suite\": \"kernels\", \"results\": [ { \"name\": \"blend/AVX256\", \"samples\": [1, x] } ] }" };
+	assert(!AVX256Utils::ReadBaseline(malformed, read));
+
+	AVX256Utils::Baseline current = baseline, faster = baseline;
+	current.Entries[0].Samples = slower, current.Entries.push_back({ "threshold/AVX256", { 1.0 } }); // Not in the baseline, so skipped
+	for (double& sample : faster.Entries[0].Samples) sample *= 0.5;
+
+	AVX256Utils::BenchmarkOptions options;
+	std::vector<AVX256Utils::BaselineComparison> comparisons = AVX256Utils::CompareBaseline(baseline, current, options);
+	assert(comparisons.size() == 1 && comparisons[0].Name == "blend/AVX256" && comparisons[0].Regression && std::abs(comparisons[0].Change() - 0.305) < 1e-9);
+	assert(!AVX256Utils::CompareBaseline(baseline, faster, options)[0].Regression && !AVX256Utils::CompareBaseline(baseline, baseline, options)[0].Regression);
+
+	options.Threshold = 50; // A significant slowdown below the threshold isn't a regression
+	assert(!AVX256Utils::CompareBaseline(baseline, current, options)[0].Regression);
+
+	std::ostringstream csv, table;
+	AVX256Utils::WriteCSV(csv, comparisons);
+	assert(csv.str().rfind("name,baseline_median_s,median_s,change_percent,p_value,regression\nblend/AVX256,1,1.305,30.5,", 0) == 0 && csv.str().find(",true\n") != std::string::npos);
+	AVX256Utils::WriteTable(table, comparisons);
+	assert(table.str().find("| blend/AVX256 | 1000000.000 | 1305000.000 | +30.5% |") != std::string::npos && table.str().find("| Regression |") != std::string::npos);
+
+	const char* arguments[] = { "benchmark", "--baseline", "old.json", "--save-baseline", "new.json", "--threshold", "2.5", "--significance", "0.05" };
+	std::ostringstream errors;
+	assert(AVX256Utils::ParseBenchmarkOptions(9, arguments, options, errors) && options.Baseline == "old.json" && options.SaveBaseline == "new.json");
+	assert(options.Threshold == 2.5 && options.Significance == 0.05);
+	const char* invalid[][3] = { { "benchmark", "--threshold", "-1" }, { "benchmark", "--significance", "1" }, { "benchmark", "--threshold", "5%" } };
+	for (const char* const* arguments : invalid) assert(!AVX256Utils::ParseBenchmarkOptions(3, arguments, options, errors));
+}
+
+void testDispatchKernels()
+{
+	using AVX256Utils::InstructionSet;
+
+	assert(AVX256Utils::Kernels().Set == AVX256Utils::BestInstructionSet());
+	assert(AVX256Utils::IsSupported(InstructionSet::AVX2) == true);
+	assert(AVX256Utils::BestInstructionSet(AVX256Utils::CPUFeatures{}) == InstructionSet::Scalar);
+	assert(std::string{ AVX256Utils::InstructionSetName(InstructionSet::SSE41) } == "SSE4.1");
+
+	AVX256Utils::CPUFeatures avx2Only{};
+	avx2Only.SSE41 = avx2Only.AVX = avx2Only.AVX2 = true;
+	assert(AVX256Utils::BestInstructionSet(avx2Only) == InstructionSet::AVX2);
+
+	// Every size up to two 64-byte vectors and a tail, at unaligned offsets, against the scalar kernels
+	std::vector<uint8_t> a(200), b(200), expected(200), actual(200);
+	uint32_t state = 12345;
+	for (uint64_t i = 0; i < a.size(); ++i)
+	{
+		state ^= state << 13, state ^= state >> 17, state ^= state << 5;
+		a[i] = static_cast<uint8_t>(state), b[i] = static_cast<uint8_t>(state >> 8);
+	}
+	a[3] = 0, a[4] = 127, a[5] = 128, a[6] = 254, a[7] = 255;
+
+	const AVX256Utils::BufferKernels& scalar = AVX256Utils::KernelsFor(InstructionSet::Scalar);
+
+	for (InstructionSet set : { InstructionSet::SSE41, InstructionSet::AVX2, InstructionSet::AVX512 })
+	{
+		if (!AVX256Utils::IsSupported(set)) continue;
+		const AVX256Utils::BufferKernels& kernels = AVX256Utils::KernelsFor(set);
+		assert(kernels.Set == set);
+
+		for (uint64_t count = 0; count <= 150; ++count)
+		{
+			for (uint8_t threshold : { 0, 127, 128, 254, 255 })
+			{
+				std::fill(actual.begin(), actual.end(), 42);
+				scalar.Threshold(a.data() + 1, expected.data(), count, threshold);
+				kernels.Threshold(a.data() + 1, actual.data(), count, threshold);
+				assert(std::equal(expected.begin(), expected.begin() + count, actual.begin()));
+				assert(actual[count] == 42);
+			}
+
+			std::fill(actual.begin(), actual.end(), 42);
+			scalar.AbsoluteDifference(a.data() + 3, b.data() + 1, expected.data(), count);
+			kernels.AbsoluteDifference(a.data() + 3, b.data() + 1, actual.data(), count);
+			assert(std::equal(expected.begin(), expected.begin() + count, actual.begin()));
+			assert(actual[count] == 42);
+
+			assert(kernels.Sum(a.data() + 5, count) == std::accumulate(a.begin() + 5, a.begin() + 5 + count, uint64_t{ 0 }));
+		}
+	}
+
+	std::vector<uint8_t> ones(100000, 255);
+	assert(AVX256Utils::Kernels().Sum(ones.data(), ones.size()) == 25500000);
+}
+
+// Applies 'operation' to each 'Bits'-bit vector of the 64 bytes of 'a' with the matching vector of 'b', and returns the result
+template <int Bits, typename T, typename Operation>
+std::array<T, 64 / sizeof(T)> applySIMD(std::array<T, 64 / sizeof(T)> a, const std::array<T, 64 / sizeof(T)>& b, const Operation& operation)
+{
+	for (size_t i = 0; i < a.size(); i += SIMD<T, Bits>::Count)
+	{
+		SIMD<T, Bits> vector{ a.data() + i };
+		operation(vector, b.data() + i);
+	}
+
+	return a;
+}
+
+// Asserts that 'operation' writes the same bytes with every available backend. The shared SIMD code is the same at each width, and the AVX256 tests check the 256-bit backend against known results
+template <typename T, typename Operation>
+void checkSIMDWidths(const std::array<T, 64 / sizeof(T)>& a, const std::array<T, 64 / sizeof(T)>& b, const Operation& operation)
+{
+	std::array<T, 64 / sizeof(T)> expected = applySIMD<256>(a, b, operation), actual = applySIMD<128>(a, b, operation);
+	assert(std::memcmp(actual.data(), expected.data(), 64) == 0);
+#if AVX256_HAS_AVX512
+	actual = applySIMD<512>(a, b, operation);
+	assert(std::memcmp(actual.data(), expected.data(), 64) == 0);
+#endif
+}
+
+// Asserts that 'operation', which the 128-bit backend doesn't provide, writes the same bytes with the 256 and 512-bit backends
+template <typename T, typename Operation>
+void checkWideSIMDWidths([[maybe_unused]] const std::array<T, 64 / sizeof(T)>& a, [[maybe_unused]] const std::array<T, 64 / sizeof(T)>& b, [[maybe_unused]] const Operation& operation)
+{
+#if AVX256_HAS_AVX512
+	std::array<T, 64 / sizeof(T)> expected = applySIMD<256>(a, b, operation), actual = applySIMD<512>(a, b, operation);
+	assert(std::memcmp(actual.data(), expected.data(), 64) == 0);
+#endif
+}
+
+// Returns the sum of the 64 bytes of 'data' as computed by Sum() on each 'Bits'-bit vector
+template <int Bits, typename T>
+auto sumSIMD(std::array<T, 64 / sizeof(T)> data)
+{
+	decltype(SIMD<T, Bits>{}.Sum()) sum{};
+	for (size_t i = 0; i < data.size(); i += SIMD<T, Bits>::Count) sum += SIMD<T, Bits>{ data.data() + i }.Sum();
+	return sum;
+}
+
+template <typename T>
+void testSIMDWidthsOf()
+{
+	std::array<T, 64 / sizeof(T)> a, b;
+	uint64_t state = 88172645463325252ull;
+
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+		if constexpr (std::is_floating_point_v<T>) a[i] = static_cast<T>(static_cast<int32_t>(state) % 100000) / 64, b[i] = static_cast<T>(static_cast<int32_t>(state >> 7) % 100000) / 64;
+		else std::memcpy(&a[i], &state, sizeof(T)), b[i] = static_cast<T>(state >> 9);
+	}
+
+	a[0] = std::numeric_limits<T>::max(), b[0] = std::numeric_limits<T>::max(); // Saturation, equality and the extremes of each type
+	a[1] = std::numeric_limits<T>::lowest(), b[1] = std::numeric_limits<T>::max();
+	a[2] = 0, b[2] = std::numeric_limits<T>::lowest();
+	b[3] = a[3];
+
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Add(y); });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Sub(y); });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x += y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x -= y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Mul(y); });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Set(y); });
+	checkSIMDWidths(a, b, [&a](auto& x, const T*) { x.Set(a[4]); });
+	checkSIMDWidths(a, b, [](auto& x, const T*) { x.Clear(); });
+	checkSIMDWidths(a, b, [](auto& x, const T*) { x = ~x; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x = x & y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x |= y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x ^= y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x = x == y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x = x > y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x = x < y; });
+	checkSIMDWidths(a, b, [](auto& x, const T* y) { x = x.IsZero() ? y : x.Data; });
+
+	if constexpr (std::is_floating_point_v<T>)
+	{
+		checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Div(y); });
+		checkSIMDWidths(a, b, [](auto& x, const T* y) { x.AbsoluteDifference(y).Sqrt(); });
+		checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Min(y); });
+		checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Max(y); });
+		checkSIMDWidths(a, b, [](auto& x, const T*) { x.Floor(); });
+		checkSIMDWidths(a, b, [](auto& x, const T*) { x.Ceil(); });
+	}
+	else
+	{
+		if constexpr (sizeof(T) <= 2) checkSIMDWidths(a, b, [](auto& x, const T* y) { x.AddSaturate(y).SubSaturate(y); });
+		if constexpr (sizeof(T) <= 2) checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Average(y); });
+		if constexpr (sizeof(T) <= 4) checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Min(y); });
+		if constexpr (sizeof(T) <= 4) checkSIMDWidths(a, b, [](auto& x, const T* y) { x.Max(y); });
+		if constexpr (sizeof(T) <= 4 && std::is_signed_v<T>) checkSIMDWidths(a, b, [](auto& x, const T*) { x.Absolute(); });
+		if constexpr (sizeof(T) <= 4 && std::is_unsigned_v<T>) checkSIMDWidths(a, b, [](auto& x, const T* y) { x.AbsoluteDifference(y); });
+		if constexpr (sizeof(T) >= 2) checkSIMDWidths(a, b, [](auto& x, const T*) { x <<= 3; });
+		if constexpr (sizeof(T) >= 2 && (sizeof(T) <= 4 || std::is_unsigned_v<T>)) checkSIMDWidths(a, b, [](auto& x, const T*) { x = x >> 5; });
+
+		std::array<T, 64 / sizeof(T)> shifts; // Including counts of at least the element width
+		for (size_t i = 0; i < shifts.size(); ++i) shifts[i] = static_cast<T>(b[i] & (16 * sizeof(T) - 1));
+		if constexpr (sizeof(T) >= 4) checkWideSIMDWidths(a, shifts, [](auto& x, const T* y) { x <<= y; });
+		if constexpr (sizeof(T) == 4 || (sizeof(T) == 8 && std::is_unsigned_v<T>)) checkWideSIMDWidths(a, shifts, [](auto& x, const T* y) { x = x >> y; });
+	}
+
+	std::array<T, 64 / sizeof(T)> summands = a; // Without the extremes of floating-point types, and small enough that the 32-bit sums of each vector don't overflow when added up
+	if constexpr (std::is_floating_point_v<T>) summands[0] = summands[1] = 0;
+	if constexpr (std::is_integral_v<T> && sizeof(T) == 4) for (T& x : summands) x /= 64;
+
+	if constexpr (std::is_floating_point_v<T>) assert(std::abs(sumSIMD<128>(summands) - sumSIMD<256>(summands)) <= std::abs(sumSIMD<256>(summands)) * 1e-5);
+	else if constexpr (sizeof(T) <= 4) assert(sumSIMD<128>(summands) == sumSIMD<256>(summands));
+
+#if AVX256_HAS_AVX512
+	if constexpr (std::is_floating_point_v<T>) assert(std::abs(sumSIMD<512>(summands) - sumSIMD<256>(summands)) <= std::abs(sumSIMD<256>(summands)) * 1e-5);
+	else if constexpr (sizeof(T) <= 4) assert(sumSIMD<512>(summands) == sumSIMD<256>(summands));
+#endif
+}
+
+void testSIMDWidths()
+{
+	testSIMDWidthsOf<double>();
+	testSIMDWidthsOf<float>();
+	testSIMDWidthsOf<uint64_t>();
+	testSIMDWidthsOf<int64_t>();
+	testSIMDWidthsOf<uint32_t>();
+	testSIMDWidthsOf<int32_t>();
+	testSIMDWidthsOf<uint16_t>();
+	testSIMDWidthsOf<int16_t>();
+	testSIMDWidthsOf<uint8_t>();
+	testSIMDWidthsOf<int8_t>();
+
+	static_assert(std::is_same_v<AVX256<float>, SIMD<float, 256>> && std::is_same_v<SIMD<float>, AVX256<float>>);
+	static_assert(SSE128<double>::Count == 2 && AVX256<uint16_t>::Count == 16);
+
+	SSE128<uint8_t> bytes{ std::array<uint8_t, 16>{ 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 } };
+	assert(bytes.Sum() == 16 * 255);
+	assert((bytes * std::array<uint8_t, 16>{ 1, 0 })[0] == 255 && (bytes * std::array<uint8_t, 16>{ 1, 0 })[1] == 0);
+	assert((bytes += bytes.Data)[0] == 255);
+
+	SSE128<int8_t> signedBytes{ std::array<int8_t, 16>{ -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 127 } };
+	assert(signedBytes.Sum() == 15 * -128 + 127);
+
+	SSE128<uint16_t> words{ std::array<uint16_t, 8>{ 65535, 65535, 65535, 65535, 65535, 65535, 65535, 65535 } };
+	assert(words.Sum() == 8u * 65535);
+
+	SSE128<float> floats{ std::array<float, 4>{ 1, 4, 16, 0.25f } };
+	assert(floats.Sum() == 21.25f);
+	SSE128<float> reciprocals{ floats }, reciprocalRoots{ floats };
+	reciprocals.Inverse(), reciprocalRoots.InverseSqrt();
+	for (int i = 0; i < 4; ++i) assert(std::abs(reciprocals[i] * floats[i] - 1) < 1e-3f && std::abs(reciprocalRoots[i] * std::sqrt(floats[i]) - 1) < 1e-3f);
+
+	std::ostringstream out;
+	out << SSE128<int32_t>{ std::array<int32_t, 4>{ 1, -2, 3, -4 } };
+	assert(out.str() == "|1|-2|3|-4|");
+
+#if AVX256_HAS_AVX512
+	AVX512<float> wide{ std::array<float, 16>{ 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768 } };
+	AVX512<float> wideReciprocals{ wide };
+	wideReciprocals.Inverse();
+	static_assert(AVX512<uint8_t>::Count == 64);
+	for (int i = 0; i < 16; ++i) assert(std::abs(wideReciprocals[i] * wide[i] - 1) < 1e-4f);
+	assert(wide.Sum() == 65535);
+
+	std::array<uint16_t, 32> wordShifts; // 16-bit variable shifts are only available at 512 bits
+	for (int i = 0; i < 32; ++i) wordShifts[i] = static_cast<uint16_t>(i);
+	AVX512<uint16_t> wideWords{ std::array<uint16_t, 32>{} };
+	wideWords.Set(static_cast<uint16_t>(1));
+	wideWords <<= wordShifts;
+	AVX512<int16_t> wideSignedWords{ std::array<int16_t, 32>{} };
+	wideSignedWords.Set(static_cast<int16_t>(-256));
+	wideSignedWords >>= reinterpret_cast<const int16_t*>(wordShifts.data());
+	for (int i = 0; i < 32; ++i) assert(wideWords[i] == (i < 16 ? 1 << i : 0) && wideSignedWords[i] == (i < 16 ? -256 >> i : -1));
+#endif
+}
+
+// Set(values, count) and Store(destination, count) don't access past 'count' elements at any width
+template <typename T, int Bits>
+void testSIMDPartialOf()
+{
+	constexpr int count = SIMD<T, Bits>::Count;
+	std::array<T, count + 1> source, destination;
+	for (int i = 0; i <= count; ++i) source[i] = static_cast<T>(i + 1);
+
+	SIMD<T, Bits> vector;
+	for (int n = 0; n <= count; ++n)
+	{
+		vector.Set(static_cast<T>(42));
+		vector.Set(source.data(), n);
+		for (int i = 0; i < count; ++i) assert(vector[i] == (i < n ? source[i] : 0));
+
+		destination.fill(static_cast<T>(7));
+		vector.Store(destination.data(), n);
+		for (int i = 0; i <= count; ++i) assert(destination[i] == (i < n ? source[i] : 7));
+	}
+}
+
+void testSIMDPartial()
+{
+	testSIMDPartialOf<uint8_t, 128>();
+	testSIMDPartialOf<double, 128>();
+	testSIMDPartialOf<uint8_t, 256>();
+	testSIMDPartialOf<int32_t, 256>();
+#if AVX256_HAS_AVX512
+	testSIMDPartialOf<uint8_t, 512>();
+	testSIMDPartialOf<float, 512>();
+#endif
+}
+
 void runTests()
 {
 	testHasCPUIDSupport();
 	testHasAVX2Support();
+	testCPUFeatures();
 	testAVX256Constructor();
 	testAVX256SubscriptOperator();
 	testAVX256PrintOperator();
@@ -944,6 +2717,51 @@ void runTests()
 	testAVX256Sqrt();
 	testAVX256InverseSqrt();
 	testAVX256Permute();
+	testBuffersEqual();
+	testIsAllZero();
+	testFirstDifference();
+	testSort();
+	testSortPairs();
+	testMergeSorted();
+	testAdler32();
+	testFletcher();
+	testCRC32C();
+	testHash64();
+	testDot();
+	testAxpy();
+	testNrm2();
+	testGemv();
+	testGemm();
+	testSeparableFilter();
+	testBlur();
+	testBGRToRGB();
+	testBGRToGray();
+	testMotionDetector();
+	testBlend();
+	testCompositeOver();
+	testIntegralImage();
+	testBackgroundModel();
+	testApplyLUT();
+	testYUVToRGB();
+	testRGBToYUV();
+	testStats();
+	testThreadPool();
+	testParallelFor();
+	testParallelReduce();
+	testChaseLevDeque();
+	testWorkStealingScheduler();
+	testSPSCRing();
+	testFramePipeline();
+	testFrameBufferPool();
+	testBenchmark();
+	testParseBenchmarkOptions();
+	testMeasureOperation();
+	testPerfCounters();
+	testRoofline();
+	testBaseline();
+	testDispatchKernels();
+	testSIMDWidths();
+	testSIMDPartial();
 
 	assert(std::cout << "All tests passed\n"); // Only display this when in debug build i.e. when assertions are enabled
 }
@@ -8,6 +8,9 @@
 
 #include "test.h"
 #include "avx256.h"
+#include "avx256_buffer.h"
+#include "avx256_framepool.h"
+#include "avx256_color.h"
 #include "demo.h"
 
 #ifndef TEST
@@ -15,11 +18,11 @@
 // Convert the image to a binary image using the specified boundary with cv::threshold() (simd)
 int thresholdOpenCVSIMD(cv::Mat& image, uint8_t boundary)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	cv::threshold(image, image, boundary, UINT8_MAX, cv::THRESH_BINARY);
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
@@ -27,7 +30,7 @@ int thresholdOpenCVSIMD(cv::Mat& image, uint8_t boundary)
 // Convert the image to a binary image using the specified boundary with AVX256 operations
 int thresholdAVX256(cv::Mat& image, uint8_t boundary)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	AVX256<uint8_t> avxImage{ image.data };
 	AVX256<uint8_t> avxBoundary{}; 
@@ -43,7 +46,7 @@ int thresholdAVX256(cv::Mat& image, uint8_t boundary)
 	for (uint64_t i = size - residualCount; i < size; ++i)
 		image.data[i] = (image.data[i] > boundary) * UINT8_MAX;
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
@@ -51,14 +54,14 @@ int thresholdAVX256(cv::Mat& image, uint8_t boundary)
 // Convert the image to a binary image using the specified boundary with scalar operations
 int thresholdScalar(cv::Mat& image, uint8_t boundary)
 {
-	std::chrono::steady_clock::time_point start = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
 	uint64_t size = static_cast<uint64_t>(image.rows) * image.cols * image.channels();
 
 	for (uint64_t i = 0; i < size; ++i)
 		image.data[i] = (image.data[i] > boundary) * UINT8_MAX;
 
-	std::chrono::steady_clock::time_point end = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
 	return static_cast<int>(1 / std::chrono::duration_cast<std::chrono::duration<double, std::ratio<1, 1>>>(end - start).count());
 }
@@ -66,9 +69,14 @@ int thresholdScalar(cv::Mat& image, uint8_t boundary)
 // Convert the frames of the video into a binary image using scalar, AVX256, and cv::threshold() (with SIMD acceleration). The threshold boundary is configurable by a trackbar element
 void thresholdDemo(const std::string& videoPath)
 {
-	cv::Mat frame, result;
-	cv::Mat frameScalar, frameAVX256, frameOpenCVSIMD;
+	cv::Mat frameBGR, frame, frameScalarBGR, result;
 	cv::VideoCapture video{ videoPath };
+	int width = video.get(cv::CAP_PROP_FRAME_WIDTH), height = video.get(cv::CAP_PROP_FRAME_HEIGHT);
+
+	// Each method thresholds a copy of the frame in its own preallocated, aligned buffer, rather than a clone allocated every frame
+	AVX256Utils::FrameBufferPool pool{ static_cast<uint64_t>(width) * height, 3 };
+	AVX256Utils::FrameBuffer buffers[3] = { pool.Acquire(), pool.Acquire(), pool.Acquire() };
+	cv::Mat frameScalar(height, width, CV_8UC1, buffers[0].Data()), frameAVX256(height, width, CV_8UC1, buffers[1].Data()), frameOpenCVSIMD(height, width, CV_8UC1, buffers[2].Data());
 
 	int xmax = video.get(cv::CAP_PROP_FRAME_COUNT), ymax = 20000, avgRange = 15;
 	cv::Mat plot = createFPSPlot(cv::Size(video.get(cv::CAP_PROP_FRAME_WIDTH), video.get(cv::CAP_PROP_FRAME_HEIGHT) / 3), std::pair<int, int>{xmax, ymax}, avgRange);
@@ -82,27 +90,29 @@ void thresholdDemo(const std::string& videoPath)
 
 	while (true)
 	{
-		while (video.read(frame))
+		while (video.read(frameBGR))
 		{
-			cv::cvtColor(frame, frame, cv::COLOR_BGR2GRAY);
+			frame.create(frameBGR.rows, frameBGR.cols, CV_8UC1);
+			AVX256Utils::BGRToGray(frameBGR.data, frame.data, static_cast<uint64_t>(frameBGR.rows) * frameBGR.cols);
 
-			frameScalar = frame.clone();
+			frame.copyTo(frameScalar);
 			fpss[0][frameCount] = thresholdScalar(frameScalar, boundary);
 
-			frameAVX256 = frame.clone();
+			frame.copyTo(frameAVX256);
 			fpss[1][frameCount] = thresholdAVX256(frameAVX256, boundary);
 
-			frameOpenCVSIMD = frame.clone();
+			frame.copyTo(frameOpenCVSIMD);
 			fpss[2][frameCount] = thresholdOpenCVSIMD(frameOpenCVSIMD, boundary);
 
 			++frameCount;
 
-			if (cv::sum(frameScalar != frameAVX256) != cv::Scalar(0) || cv::sum(frameScalar != frameOpenCVSIMD) != cv::Scalar(0)) return;
-			cv::cvtColor(frameScalar, frameScalar, cv::COLOR_GRAY2BGR);
+			uint64_t size = static_cast<uint64_t>(frame.rows) * frame.cols * frame.channels();
+			if (!AVX256Utils::BuffersEqual(frameScalar.data, frameAVX256.data, size) || !AVX256Utils::BuffersEqual(frameScalar.data, frameOpenCVSIMD.data, size)) return;
+			cv::cvtColor(frameScalar, frameScalarBGR, cv::COLOR_GRAY2BGR);
 			plotFPS(plot, std::pair<int, int>{xmax, ymax}, frameCount, avgRange, fpss);
-			writeFPS(frameScalar, frameCount, fpss);
+			writeFPS(frameScalarBGR, frameCount, fpss);
 
-			cv::vconcat(std::array<cv::Mat, 2>{frameScalar, plot}, result);
+			cv::vconcat(std::array<cv::Mat, 2>{frameScalarBGR, plot}, result);
 			cv::imshow("Output", result);
 
 			if (cv::pollKey() != -1) { cv::destroyAllWindows(); return; }